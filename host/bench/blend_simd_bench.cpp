@@ -0,0 +1,309 @@
+/**
+ * @file blend_simd_bench.cpp
+ *
+ * The SSE2/AVX2 blending of lv_draw_sw (LV_DRAW_SW_ASM_X86,
+ * `lib/lvgl/src/draw/sw/blend/x86`) against the C implementation.
+ *
+ * First every kernel is run on random rows: random widths, strides and
+ * alignments, masks and alphas which are often 0 and 255, and the
+ * destination is compared byte by byte, padding included, with what the C
+ * implementation made of the same input. Any difference is an error.
+ *
+ * Then the throughput of every kernel on a 40 lines band of the dashboard,
+ * in megapixels per second, with the C implementation, SSE2 and AVX2 (if
+ * the CPU has it).
+ *
+ * Usage: blend_simd_bench [-n random_runs] [-t seconds_per_kernel]
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "dashboard.h"
+#include "host_display.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_X86
+#include "src/draw/sw/blend/lv_draw_sw_blend_to_rgb565.h"
+#include "src/draw/sw/blend/x86/lv_blend_x86.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define MAX_W      (DASHBOARD_HOR_RES + 37)
+#define MAX_H      4
+#define MAX_PAD    64       /* bytes of padding after a row and at the start */
+#define BAND_H     40
+#define ISA_CNT    3
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+  SRC_COLOR,
+  SRC_RGB565,
+  SRC_XRGB8888,
+  SRC_ARGB8888,
+} src_t;
+
+typedef struct {
+  const char *name;
+  src_t src;
+  bool mask;
+  bool opa;
+} kernel_t;
+
+typedef struct {
+  int32_t w;
+  int32_t h;
+  uint8_t *dest;
+  int32_t dest_stride;
+  const uint8_t *src;
+  int32_t src_stride;
+  const lv_opa_t *mask;
+  int32_t mask_stride;
+  lv_color_t color;
+  lv_opa_t opa;
+} run_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void blend(const kernel_t *k, const run_t *r);
+static uint32_t check(const kernel_t *k, uint32_t runs, uint32_t isa_max);
+static double throughput(const kernel_t *k, double seconds);
+static void fill_random(uint8_t *buf, size_t size, bool extremes);
+static uint32_t rnd(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const kernel_t kernels[] = {
+    {"fill -> RGB565, opa", SRC_COLOR, false, true},
+    {"fill -> RGB565, mask", SRC_COLOR, true, false},
+    {"fill -> RGB565, mask+opa", SRC_COLOR, true, true},
+    {"RGB565 -> RGB565, opa", SRC_RGB565, false, true},
+    {"RGB565 -> RGB565, mask", SRC_RGB565, true, false},
+    {"RGB565 -> RGB565, mask+opa", SRC_RGB565, true, true},
+    {"XRGB8888 -> RGB565", SRC_XRGB8888, false, false},
+    {"XRGB8888 -> RGB565, opa", SRC_XRGB8888, false, true},
+    {"XRGB8888 -> RGB565, mask", SRC_XRGB8888, true, false},
+    {"XRGB8888 -> RGB565, mask+opa", SRC_XRGB8888, true, true},
+    {"ARGB8888 -> RGB565", SRC_ARGB8888, false, false},
+    {"ARGB8888 -> RGB565, opa", SRC_ARGB8888, false, true},
+    {"ARGB8888 -> RGB565, mask", SRC_ARGB8888, true, false},
+    {"ARGB8888 -> RGB565, mask+opa", SRC_ARGB8888, true, true},
+};
+
+static uint32_t rnd_state = 0x12345678;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char **argv) {
+  uint32_t runs = 20000;
+  double seconds = 0.3;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      runs = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+      seconds = atof(argv[++i]);
+    } else {
+      fprintf(stderr, "usage: %s [-n random_runs] [-t seconds_per_kernel]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (seconds <= 0) return 1;
+
+  lv_init();
+  lv_blend_x86_isa_t isa_max = lv_blend_x86_get_isa();
+  printf("CPU: %s; %u random runs per kernel, then %d x %d px at once\n\n", lv_blend_x86_isa_to_str(isa_max),
+         (unsigned)runs, DASHBOARD_HOR_RES, BAND_H);
+
+  printf("%-30s %10s %10s %10s %10s %8s\n", "kernel", "vs C", "C [Mpx/s]", "SSE2", "AVX2", "speedup");
+  uint32_t errors = 0;
+  for (size_t i = 0; i < sizeof(kernels) / sizeof(kernels[0]); i++) {
+    const kernel_t *k = &kernels[i];
+    uint32_t bad = check(k, runs, isa_max);
+    errors += bad;
+
+    double mpx[ISA_CNT] = {0};
+    for (uint32_t isa = LV_BLEND_X86_ISA_NONE; isa <= isa_max; isa++) {
+      lv_blend_x86_set_isa((lv_blend_x86_isa_t)isa);
+      mpx[isa] = throughput(k, seconds);
+    }
+
+    char result[16];
+    snprintf(result, sizeof(result), bad ? "%u BAD" : "same", (unsigned)bad);
+    char avx2[16] = "-";
+    if (isa_max >= LV_BLEND_X86_ISA_AVX2) snprintf(avx2, sizeof(avx2), "%.0f", mpx[LV_BLEND_X86_ISA_AVX2]);
+    printf("%-30s %10s %10.0f %10.0f %10s %7.1fx\n", k->name, result, mpx[LV_BLEND_X86_ISA_NONE],
+           mpx[LV_BLEND_X86_ISA_SSE2], avx2, mpx[isa_max] / mpx[LV_BLEND_X86_ISA_NONE]);
+  }
+  lv_blend_x86_set_isa(isa_max);
+
+  if (errors) printf("\n%u runs differ from the C implementation\n", (unsigned)errors);
+  lv_deinit();
+  return errors ? 1 : 0;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* What the blending of lv_draw_sw calls for the layer's and the source's format */
+static void blend(const kernel_t *k, const run_t *r) {
+  if (k->src == SRC_COLOR) {
+    _lv_draw_sw_blend_fill_dsc_t dsc;
+    memset(&dsc, 0, sizeof(dsc));
+    dsc.dest_buf = r->dest;
+    dsc.dest_w = r->w;
+    dsc.dest_h = r->h;
+    dsc.dest_stride = r->dest_stride;
+    dsc.mask_buf = r->mask;
+    dsc.mask_stride = r->mask_stride;
+    dsc.color = r->color;
+    dsc.opa = r->opa;
+    lv_draw_sw_blend_color_to_rgb565(&dsc);
+    return;
+  }
+
+  _lv_draw_sw_blend_image_dsc_t dsc;
+  memset(&dsc, 0, sizeof(dsc));
+  dsc.dest_buf = r->dest;
+  dsc.dest_w = r->w;
+  dsc.dest_h = r->h;
+  dsc.dest_stride = r->dest_stride;
+  dsc.mask_buf = r->mask;
+  dsc.mask_stride = r->mask_stride;
+  dsc.src_buf = r->src;
+  dsc.src_stride = r->src_stride;
+  dsc.src_color_format = k->src == SRC_RGB565     ? LV_COLOR_FORMAT_RGB565
+                         : k->src == SRC_XRGB8888 ? LV_COLOR_FORMAT_XRGB8888
+                                                  : LV_COLOR_FORMAT_ARGB8888;
+  dsc.opa = r->opa;
+  dsc.blend_mode = LV_BLEND_MODE_NORMAL;
+  lv_draw_sw_blend_image_to_rgb565(&dsc);
+}
+
+/* Random rows blended with C and with every instruction set; returns the
+ * runs with any difference */
+static uint32_t check(const kernel_t *k, uint32_t runs, uint32_t isa_max) {
+  const size_t dest_size = MAX_PAD + MAX_H * (MAX_W * 2 + MAX_PAD);
+  std::vector<uint8_t> dest_ori(dest_size), dest_c(dest_size), dest_simd(dest_size);
+  std::vector<uint8_t> src(MAX_PAD + MAX_H * (MAX_W * 4 + MAX_PAD));
+  std::vector<uint8_t> mask(MAX_PAD + MAX_H * (MAX_W + MAX_PAD));
+
+  uint32_t bad = 0;
+  for (uint32_t i = 0; i < runs; i++) {
+    run_t r;
+    r.w = 1 + (int32_t)(rnd() % (i % 4 == 0 ? MAX_W : 40));
+    r.h = 1 + (int32_t)(rnd() % MAX_H);
+    uint32_t src_px_size = k->src == SRC_RGB565 ? 2 : 4;
+    /* Odd offsets and strides for the mask, pixel aligned ones for the rest */
+    uint32_t dest_ofs = (rnd() % (MAX_PAD / 4)) * 2;
+    r.dest_stride = r.w * 2 + (rnd() % (MAX_PAD / 4)) * 2;
+    uint32_t src_ofs = (rnd() % (MAX_PAD / 4)) * src_px_size;
+    r.src_stride = r.w * src_px_size + (rnd() % (MAX_PAD / 4)) * src_px_size;
+    uint32_t mask_ofs = rnd() % MAX_PAD;
+    r.mask_stride = r.w + rnd() % MAX_PAD;
+
+    r.color = lv_color_hex(rnd() & 0xFFFFFF);
+    r.opa = k->opa ? (lv_opa_t)(rnd() % LV_OPA_MAX) : (lv_opa_t)(LV_OPA_MAX + rnd() % (256 - LV_OPA_MAX));
+    fill_random(dest_ori.data(), dest_ori.size(), false);
+    fill_random(src.data(), src.size(), true);
+    fill_random(mask.data(), mask.size(), true);
+    r.src = src.data() + src_ofs;
+    r.mask = k->mask ? mask.data() + mask_ofs : NULL;
+
+    dest_c = dest_ori;
+    lv_blend_x86_set_isa(LV_BLEND_X86_ISA_NONE);
+    r.dest = dest_c.data() + dest_ofs;
+    blend(k, &r);
+
+    for (uint32_t isa = LV_BLEND_X86_ISA_SSE2; isa <= isa_max; isa++) {
+      dest_simd = dest_ori;
+      lv_blend_x86_set_isa((lv_blend_x86_isa_t)isa);
+      r.dest = dest_simd.data() + dest_ofs;
+      blend(k, &r);
+      if (dest_simd != dest_c) {
+        if (bad == 0) {
+          printf("%s with %s differs: %dx%d, opa %u\n", k->name, lv_blend_x86_isa_to_str((lv_blend_x86_isa_t)isa),
+                 (int)r.w, (int)r.h, (unsigned)r.opa);
+        }
+        bad++;
+        break;
+      }
+    }
+  }
+  return bad;
+}
+
+/* Megapixels per second blending a band of the screen */
+static double throughput(const kernel_t *k, double seconds) {
+  std::vector<uint8_t> dest(DASHBOARD_HOR_RES * BAND_H * 2);
+  std::vector<uint8_t> src(DASHBOARD_HOR_RES * BAND_H * 4);
+  std::vector<uint8_t> mask(DASHBOARD_HOR_RES * BAND_H);
+  fill_random(dest.data(), dest.size(), false);
+  fill_random(src.data(), src.size(), true);
+  fill_random(mask.data(), mask.size(), true);
+
+  run_t r;
+  r.w = DASHBOARD_HOR_RES;
+  r.h = BAND_H;
+  r.dest = dest.data();
+  r.dest_stride = DASHBOARD_HOR_RES * 2;
+  r.src = src.data();
+  r.src_stride = DASHBOARD_HOR_RES * (k->src == SRC_RGB565 ? 2 : 4);
+  r.mask = k->mask ? mask.data() : NULL;
+  r.mask_stride = DASHBOARD_HOR_RES;
+  r.color = lv_color_hex(0x3080C0);
+  r.opa = k->opa ? LV_OPA_60 : LV_OPA_COVER;
+
+  uint64_t px = 0;
+  double t0 = host_wall_us();
+  double t = 0;
+  do {
+    for (int i = 0; i < 16; i++) blend(k, &r);
+    px += 16ull * DASHBOARD_HOR_RES * BAND_H;
+    t = host_wall_us() - t0;
+  } while (t < seconds * 1e6);
+  return px / t;
+}
+
+/* Random bytes; with `extremes` a third of them 0 and a third 255, as masks
+ * and alpha channels mostly are */
+static void fill_random(uint8_t *buf, size_t size, bool extremes) {
+  for (size_t i = 0; i < size; i++) {
+    uint32_t v = rnd();
+    if (extremes && v % 3 == 0) {
+      buf[i] = 0;
+    } else if (extremes && v % 3 == 1) {
+      buf[i] = 0xFF;
+    } else {
+      buf[i] = (uint8_t)(v >> 8);
+    }
+  }
+}
+
+/* xorshift32 */
+static uint32_t rnd(void) {
+  rnd_state ^= rnd_state << 13;
+  rnd_state ^= rnd_state >> 17;
+  rnd_state ^= rnd_state << 5;
+  return rnd_state;
+}
+
+#else
+
+int main(void) {
+  printf("not an x86 build, LV_USE_DRAW_SW_ASM is not LV_DRAW_SW_ASM_X86\n");
+  return 0;
+}
+
+#endif /*LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_X86*/
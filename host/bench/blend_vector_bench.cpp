@@ -0,0 +1,235 @@
+/**
+ * @file blend_vector_bench.cpp
+ *
+ * The RGB565 kernels written with GCC/Clang vector extensions
+ * (`lib/lvgl/src/draw/sw/blend/vector`) against the C implementation of
+ * lv_draw_sw: the opaque fill, the masked fill and the image blend with
+ * opacity, each at several widths. Below 16 pixels the kernels leave the
+ * area to C, so both columns time the C implementation there.
+ *
+ * For every width the output is compared with C on random pixels and masks
+ * (exit code 1 if any pixel differs), then both are timed on about a 40 line
+ * band of the dashboard in megapixels per second. In the x86 build the SSE2/
+ * AVX2 backend is shown next to them.
+ *
+ * Usage: blend_vector_bench [-t seconds_per_run]
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "dashboard.h"
+#include "host_display.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "src/draw/sw/blend/lv_draw_sw_blend_to_rgb565.h"
+#include "src/draw/sw/blend/vector/lv_blend_vector.h"
+#if LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_X86
+#include "src/draw/sw/blend/x86/lv_blend_x86.h"
+#endif
+
+#if LV_BLEND_VECTOR_SUPPORTED && LV_USE_DRAW_SW_ASM != LV_DRAW_SW_ASM_VECTOR
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BAND_PX   (DASHBOARD_HOR_RES * 40)
+#define PAD       16  /* pixels after every row, checked for overwrites */
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+  KERNEL_FILL,
+  KERNEL_FILL_MASK,
+  KERNEL_IMAGE_OPA,
+  KERNEL_CNT
+} kernel_t;
+
+typedef enum {
+  IMPL_C,
+  IMPL_VECTOR,
+  IMPL_X86,
+  IMPL_CNT
+} impl_t;
+
+typedef struct {
+  int32_t w;
+  int32_t h;
+  std::vector<uint16_t> dest;
+  std::vector<uint16_t> src;
+  std::vector<lv_opa_t> mask;
+} bufs_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void blend(kernel_t k, impl_t impl, bufs_t *b);
+static void init_bufs(bufs_t *b, int32_t w, int32_t h);
+static double throughput(kernel_t k, impl_t impl, int32_t w, double seconds);
+static uint32_t rnd(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const char *kernel_names[KERNEL_CNT] = {"opaque fill", "masked fill", "image, opa"};
+static const int32_t widths[] = {7, 12, 16, 24, 33, 100, DASHBOARD_HOR_RES};
+static uint32_t rnd_state = 0x9E3779B9;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char **argv) {
+  double seconds = 0.2;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+      seconds = atof(argv[++i]);
+    } else {
+      fprintf(stderr, "usage: %s [-t seconds_per_run]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (seconds <= 0) return 1;
+
+  lv_init();
+  bool x86 = false;
+#if LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_X86
+  x86 = true;
+  lv_blend_x86_isa_t isa = lv_blend_x86_get_isa();
+  printf("x86 backend: %s\n", lv_blend_x86_isa_to_str(isa));
+#endif
+  printf("%-12s %6s %8s %12s %12s %8s %12s\n", "kernel", "width", "vs C", "C [Mpx/s]", "vector", "speedup",
+         x86 ? "x86" : "");
+
+  uint32_t errors = 0;
+  for (int k = 0; k < KERNEL_CNT; k++) {
+    for (size_t i = 0; i < sizeof(widths) / sizeof(widths[0]); i++) {
+      int32_t w = widths[i];
+
+      /* The same random input through both */
+      bufs_t c, vec;
+      init_bufs(&c, w, 8);
+      vec = c;
+      blend((kernel_t)k, IMPL_C, &c);
+      blend((kernel_t)k, IMPL_VECTOR, &vec);
+      bool same = c.dest == vec.dest;
+      errors += !same;
+
+      double mpx[IMPL_CNT] = {0};
+      for (int impl = IMPL_C; impl < (x86 ? IMPL_CNT : IMPL_X86); impl++) {
+        mpx[impl] = throughput((kernel_t)k, (impl_t)impl, w, seconds);
+      }
+      char x86_col[16] = "";
+      if (x86) snprintf(x86_col, sizeof(x86_col), "%.0f", mpx[IMPL_X86]);
+      printf("%-12s %6d %8s %12.0f %12.0f %7.1fx %12s\n", i == 0 ? kernel_names[k] : "", (int)w,
+             same ? "same" : "BAD", mpx[IMPL_C], mpx[IMPL_VECTOR], mpx[IMPL_VECTOR] / mpx[IMPL_C], x86_col);
+    }
+  }
+
+  if (errors) printf("\n%u results differ from the C implementation\n", (unsigned)errors);
+  lv_deinit();
+  return errors ? 1 : 0;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* Like the hooks of lv_draw_sw: C if the kernel leaves the area to it */
+static void blend(kernel_t k, impl_t impl, bufs_t *b) {
+#if LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_X86
+  /* The x86 backend takes the hooks of the C functions, or falls back to C */
+  lv_blend_x86_set_isa(impl == IMPL_X86 ? LV_BLEND_X86_ISA_AVX2 : LV_BLEND_X86_ISA_NONE);
+#endif
+  int32_t stride = (b->w + PAD) * sizeof(uint16_t);
+
+  if (k == KERNEL_IMAGE_OPA) {
+    _lv_draw_sw_blend_image_dsc_t dsc;
+    memset(&dsc, 0, sizeof(dsc));
+    dsc.dest_buf = b->dest.data();
+    dsc.dest_w = b->w;
+    dsc.dest_h = b->h;
+    dsc.dest_stride = stride;
+    dsc.src_buf = b->src.data();
+    dsc.src_stride = stride;
+    dsc.src_color_format = LV_COLOR_FORMAT_RGB565;
+    dsc.opa = LV_OPA_60;
+    dsc.blend_mode = LV_BLEND_MODE_NORMAL;
+    if (impl != IMPL_VECTOR || _lv_rgb565_blend_normal_to_rgb565_with_opa_vector(&dsc) == LV_RESULT_INVALID) {
+      lv_draw_sw_blend_image_to_rgb565(&dsc);
+    }
+    return;
+  }
+
+  _lv_draw_sw_blend_fill_dsc_t dsc;
+  memset(&dsc, 0, sizeof(dsc));
+  dsc.dest_buf = b->dest.data();
+  dsc.dest_w = b->w;
+  dsc.dest_h = b->h;
+  dsc.dest_stride = stride;
+  dsc.color = lv_color_hex(0x3080C0);
+  dsc.opa = LV_OPA_COVER;
+  if (k == KERNEL_FILL_MASK) {
+    dsc.mask_buf = b->mask.data();
+    dsc.mask_stride = b->w + PAD;
+  }
+  lv_result_t res = LV_RESULT_INVALID;
+  if (impl == IMPL_VECTOR) {
+    res = k == KERNEL_FILL ? _lv_color_blend_to_rgb565_vector(&dsc) : _lv_color_blend_to_rgb565_with_mask_vector(&dsc);
+  }
+  if (res == LV_RESULT_INVALID) lv_draw_sw_blend_color_to_rgb565(&dsc);
+}
+
+/* Random pixels, and a mask like anti-aliased shapes: mostly 0 and 255 */
+static void init_bufs(bufs_t *b, int32_t w, int32_t h) {
+  b->w = w;
+  b->h = h;
+  size_t px = (size_t)(w + PAD) * h;
+  b->dest.resize(px);
+  b->src.resize(px);
+  b->mask.resize(px);
+  for (size_t i = 0; i < px; i++) {
+    b->dest[i] = (uint16_t)rnd();
+    b->src[i] = (uint16_t)rnd();
+    uint32_t m = rnd() % 4;
+    b->mask[i] = m == 0 ? 0 : m == 1 ? 0xFF : (lv_opa_t)(rnd() >> 8);
+  }
+}
+
+/* Megapixels per second on a band of about BAND_PX pixels */
+static double throughput(kernel_t k, impl_t impl, int32_t w, double seconds) {
+  bufs_t b;
+  init_bufs(&b, w, BAND_PX / w > 0 ? BAND_PX / w : 1);
+
+  uint64_t px = 0;
+  double t0 = host_wall_us();
+  double t = 0;
+  do {
+    for (int i = 0; i < 16; i++) blend(k, impl, &b);
+    px += 16ull * b.w * b.h;
+    t = host_wall_us() - t0;
+  } while (t < seconds * 1e6);
+  return px / t;
+}
+
+/* xorshift32 */
+static uint32_t rnd(void) {
+  rnd_state ^= rnd_state << 13;
+  rnd_state ^= rnd_state >> 17;
+  rnd_state ^= rnd_state << 5;
+  return rnd_state;
+}
+
+#else
+
+int main(void) {
+  printf("the C path of this build is the vector one, or the compiler has no vector extensions\n");
+  return 0;
+}
+
+#endif /*LV_BLEND_VECTOR_SUPPORTED && LV_USE_DRAW_SW_ASM != LV_DRAW_SW_ASM_VECTOR*/
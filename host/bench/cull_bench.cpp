@@ -0,0 +1,165 @@
+/**
+ * @file cull_bench.cpp
+ *
+ * Runs the dashboard with and without occlusion culling of the draw tasks
+ * (LV_USE_DRAW_CULL, `lv_display_set_draw_cull()`): the draw tasks of a band
+ * are collected first, then the ones under a newer opaque fill (e.g. the
+ * screen background under the white bars and containers) are dropped or
+ * clipped.
+ *
+ * Two runs per setting:
+ *   - drive: the dashboard update stream
+ *   - full:  the same, with the whole screen redrawn every frame
+ *
+ * Reported per frame: the render time, the culled tasks and pixels
+ * (`lv_display_get_flush_stats()`) and the blended pixels (the refresh
+ * heatmap's count). After every frame the panel content has to be the same
+ * with and without culling (the exit code says if it was).
+ *
+ * Usage: cull_bench [-n frames]
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "dashboard.h"
+#include "host_display.h"
+#include "telemetry.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if LV_USE_DRAW_CULL
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+  double frame_us;
+  double culled_tasks;
+  double culled_px;
+  double blended_px;
+} result_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void run(bool cull, bool full, uint32_t frames, result_t *res, std::vector<uint32_t> *screens);
+static void make_frame(uint32_t i, telemetry_data_t *d);
+static uint32_t hash_screen(void);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char **argv) {
+  uint32_t frames = 1000;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      frames = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else {
+      fprintf(stderr, "usage: %s [-n frames]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (frames == 0) return 1;
+
+  lv_init();
+
+  printf("%u frames of the dashboard\n\n", (unsigned)frames);
+  printf("%-6s %-5s %10s %13s %12s %12s\n", "run", "cull", "frame [us]", "culled tasks", "culled px",
+         "blended px");
+  uint32_t diff = 0;
+  for (int full = 0; full < 2; full++) {
+    result_t res[2];
+    std::vector<uint32_t> screens[2];
+    run(false, full, frames, &res[0], &screens[0]);
+    run(true, full, frames, &res[1], &screens[1]);
+    for (uint32_t i = 0; i < frames; i++) {
+      if (screens[0][i] != screens[1][i]) diff++;
+    }
+
+    for (int m = 0; m < 2; m++) {
+      printf("%-6s %-5s %10.1f %13.1f %12.0f %12.0f\n", m ? "" : full ? "full" : "drive", m ? "on" : "off",
+             res[m].frame_us, res[m].culled_tasks, res[m].culled_px, res[m].blended_px);
+    }
+  }
+  printf("\n%u frames with a different screen\n", (unsigned)diff);
+
+  lv_deinit();
+  return diff == 0 ? 0 : 1;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void run(bool cull, bool full, uint32_t frames, result_t *res, std::vector<uint32_t> *screens) {
+  lv_display_t *disp = host_display_create();
+  host_tick_set(0);
+  lv_display_set_draw_cull(disp, cull);
+
+  create_ev_dashboard_ui();
+  telemetry_data_t d;
+  telemetry_data_init(&d);
+  update_dashboard(&d);
+  lv_refr_now(disp);
+  lv_refr_heatmap_enable(disp, NULL, NULL, 0);
+
+  memset(res, 0, sizeof(*res));
+  double frame_us = 0;
+  for (uint32_t i = 0; i < frames; i++) {
+    host_tick_inc(LV_DEF_REFR_PERIOD);
+    make_frame(i, &d);
+    update_dashboard(&d);
+    update_time_display(host_tick_get());
+    if (full) lv_obj_invalidate(lv_screen_active());
+
+    double t0 = host_wall_us();
+    lv_refr_now(disp);
+    frame_us += host_wall_us() - t0;
+
+    const lv_display_flush_stats_t *st = lv_display_get_flush_stats(disp);
+    res->culled_tasks += st->culled_tasks;
+    res->culled_px += st->culled_px;
+    screens->push_back(hash_screen());
+  }
+
+  res->frame_us = frame_us / frames;
+  res->culled_tasks /= frames;
+  res->culled_px /= frames;
+  res->blended_px = (double)lv_refr_heatmap_get_stats(disp)->blended_px / frames;
+
+  lv_refr_heatmap_disable(disp);
+  host_display_delete(disp);
+}
+
+/* A drive: the speed changes every frame, the rest now and then */
+static void make_frame(uint32_t i, telemetry_data_t *d) {
+  d->speed = (int)((i * 7) % 120);
+  d->range = 200 - (int)(i / 50) % 200;
+  d->avg_wh = 120 + (int)(i / 20) % 30;
+  d->avg_kmh = 40 + (int)(i / 40) % 20;
+  d->trip = (int)(i / 10);
+  d->odo = 12000 + (int)(i / 10);
+  d->motor_temp = 40 + (int)(i / 100) % 30;
+  d->battery_temp = 30 + (int)(i / 150) % 20;
+}
+
+static uint32_t hash_screen(void) {
+  const uint16_t *fb = host_display_get_framebuffer();
+  uint32_t h = 2166136261u;
+  for (uint32_t i = 0; i < DASHBOARD_HOR_RES * DASHBOARD_VER_RES; i++) h = (h ^ fb[i]) * 16777619u;
+  return h;
+}
+
+#else
+
+int main(void) {
+  printf("LV_USE_DRAW_CULL is 0 in this build\n");
+  return 0;
+}
+
+#endif /*LV_USE_DRAW_CULL*/
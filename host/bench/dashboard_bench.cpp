@@ -0,0 +1,285 @@
+/**
+ * @file dashboard_bench.cpp
+ *
+ * Headless run of the EV dashboard for render benchmarks.
+ *
+ * The dashboard is drawn into a memory-only display (same resolution, color
+ * format and buffer size as the board) with a simulated tick, so a run only
+ * depends on its input. Telemetry is read from a file, stdin ("-") or, without
+ * an argument, generated.
+ *
+ * Usage: dashboard_bench [-p period_ms] [-n frames] [-w capture] [-l flushes.csv]
+ *                        [-s screen.ppm|.png] [-g golden.ppm] [file|-]
+ *   -p  simulated time between two telemetry frames (default 20 ms = 50 Hz)
+ *   -n  number of generated frames when no file is given (default 2000)
+ *   -w  also record the input as a capture for telemetry_replay
+ *   -l  write every flushed area: tick, x1, y1, x2, y2, last of the refresh
+ *   -s  save the final screen
+ *   -g  compare the final screen with a golden image saved with -s, the exit
+ *       code is 2 if it differs
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "dashboard.h"
+#include "telemetry.h"
+#include "telemetry_rec.h"
+#include "host_display.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define CHUNK_SIZE 64
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+  uint32_t period_ms;
+  uint32_t frame_cnt;
+  const char *path;
+  const char *rec_path;
+  const char *flush_log_path;
+  const char *screen_path;
+  const char *golden_path;
+} options_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool parse_args(int argc, char **argv, options_t *opt);
+static size_t generate_stream(uint32_t frame_cnt, std::vector<uint8_t> *out);
+static double percentile(std::vector<double> v, double p);
+static size_t file_write_cb(void *user_data, const uint8_t *data, size_t len);
+static bool write_flush_log(const char *path);
+static bool has_suffix(const char *s, const char *suffix);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char **argv) {
+  options_t opt;
+  if (!parse_args(argc, argv, &opt)) {
+    fprintf(stderr,
+            "usage: %s [-p period_ms] [-n frames] [-w capture] [-l flushes.csv] [-s screen.ppm|.png] "
+            "[-g golden.ppm] [file|-]\n",
+            argv[0]);
+    return 1;
+  }
+
+  std::vector<uint8_t> input;
+  if (opt.path) {
+    FILE *f = strcmp(opt.path, "-") == 0 ? stdin : fopen(opt.path, "rb");
+    if (f == NULL) {
+      perror(opt.path);
+      return 1;
+    }
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) input.insert(input.end(), chunk, chunk + n);
+    if (f != stdin) fclose(f);
+  } else {
+    generate_stream(opt.frame_cnt, &input);
+  }
+
+  FILE *rec_file = NULL;
+  telemetry_rec_t rec;
+  if (opt.rec_path) {
+    rec_file = fopen(opt.rec_path, "wb");
+    if (rec_file == NULL) {
+      perror(opt.rec_path);
+      return 1;
+    }
+    telemetry_rec_start(&rec, file_write_cb, rec_file);
+  }
+
+  lv_init();
+  lv_display_t *disp = host_display_create();
+
+  static telemetry_rx_t rx;
+  telemetry_rx_init(&rx);
+  telemetry_data_t dash;
+  telemetry_data_init(&dash);
+
+  create_ev_dashboard_ui();
+  update_dashboard(&dash);
+  lv_refr_now(disp);
+
+  dashboard_attach_stats(disp);
+  dashboard_reset_stats();
+  if (opt.flush_log_path) host_display_record_flushes(true);
+
+  std::vector<double> render_us;
+  uint64_t bus_us = 0;
+  uint32_t frames = 0;
+  size_t pos = 0;
+  while (pos < input.size()) {
+    size_t n = std::min<size_t>(CHUNK_SIZE, input.size() - pos);
+    n = telemetry_rx_push(&rx, &input[pos], n);
+    if (rec_file) telemetry_rec_add(&rec, host_tick_get(), &input[pos], n);
+    pos += n;
+
+    while (telemetry_rx_poll(&rx, &dash, NULL) != TELEMETRY_FORMAT_NONE) {
+      update_dashboard(&dash);
+      update_time_display(host_tick_get());
+      frames++;
+
+      /* Let the refresh timer decide when to render, exactly like loop() */
+      host_tick_inc(opt.period_ms);
+      uint32_t flushes = dashboard_get_stats()->flushes;
+      double t0 = host_wall_us();
+      lv_timer_handler();
+      double t = host_wall_us() - t0;
+      if (dashboard_get_stats()->flushes != flushes) {
+        render_us.push_back(t);
+        bus_us += lv_display_get_flush_stats(disp)->bus_time_us;
+      }
+    }
+  }
+
+  const dashboard_stats_t *st = dashboard_get_stats();
+  double sum = 0;
+  for (double v : render_us) sum += v;
+
+  printf("telemetry frames:   %u (every %u ms simulated)\n", frames, opt.period_ms);
+  printf("refreshes:          %zu\n", render_us.size());
+  if (!render_us.empty()) {
+    printf("render time:        avg %.1f us, p99 %.1f us, max %.1f us\n", sum / render_us.size(),
+           percentile(render_us, 0.99), *std::max_element(render_us.begin(), render_us.end()));
+  }
+  if (frames > 0) {
+    printf("labels per frame:   %.2f touched, %.2f skipped\n", (double)st->labels_touched / frames,
+           (double)st->labels_skipped / frames);
+    printf("flushed per frame:  %.0f bytes (%.0f px) in %.2f flushes\n", (double)st->bytes_flushed / frames,
+           (double)st->px_flushed / frames, (double)st->flushes / frames);
+    printf("bus time per frame: %.1f us estimated (27 MHz SPI)\n", (double)bus_us / frames);
+  }
+
+  if (rec_file) fclose(rec_file);
+
+  /* What's still invalid, so the screen matches the last frame */
+  if (opt.screen_path || opt.golden_path) lv_refr_now(disp);
+
+  int ret = 0;
+  if (opt.flush_log_path && !write_flush_log(opt.flush_log_path)) {
+    perror(opt.flush_log_path);
+    ret = 1;
+  }
+  if (opt.screen_path) {
+    bool ok = has_suffix(opt.screen_path, ".png") ? host_display_save_png(opt.screen_path)
+                                                  : host_display_save_ppm(opt.screen_path);
+    if (!ok) {
+      perror(opt.screen_path);
+      ret = 1;
+    }
+  }
+  if (opt.golden_path) {
+    int32_t diff = host_display_compare_ppm(opt.golden_path);
+    if (diff < 0) {
+      fprintf(stderr, "%s: not a %dx%d PPM\n", opt.golden_path, DASHBOARD_HOR_RES, DASHBOARD_VER_RES);
+      ret = 1;
+    } else {
+      printf("golden image:       %s (%d px differ)\n", diff ? "DIFFERENT" : "same", (int)diff);
+      if (diff && ret == 0) ret = 2;
+    }
+  }
+
+  lv_deinit();
+  return ret;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static bool parse_args(int argc, char **argv, options_t *opt) {
+  opt->period_ms = 20;
+  opt->frame_cnt = 2000;
+  opt->path = NULL;
+  opt->rec_path = NULL;
+  opt->flush_log_path = NULL;
+  opt->screen_path = NULL;
+  opt->golden_path = NULL;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+      opt->period_ms = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      opt->frame_cnt = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+      opt->rec_path = argv[++i];
+    } else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc) {
+      opt->flush_log_path = argv[++i];
+    } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+      opt->screen_path = argv[++i];
+    } else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) {
+      opt->golden_path = argv[++i];
+    } else if (argv[i][0] != '-' || strcmp(argv[i], "-") == 0) {
+      opt->path = argv[i];
+    } else {
+      return false;
+    }
+  }
+  return opt->period_ms > 0;
+}
+
+/* Binary frames of a drive: speed changes every frame, the rest now and then */
+static size_t generate_stream(uint32_t frame_cnt, std::vector<uint8_t> *out) {
+  telemetry_data_t d;
+  telemetry_data_init(&d);
+  static const char *modes[] = {"Eco", "Normal", "Sport"};
+
+  for (uint32_t i = 0; i < frame_cnt; i++) {
+    d.speed = (int)((i / 2) % 120);
+    if (i % 50 == 0) d.range = 130 - (int)(i / 500);
+    if (i % 100 == 0) d.trip = 130 + (int)(i / 100);
+    if (i % 100 == 0) d.odo = 1300 + (int)(i / 100);
+    if (i % 200 == 0) d.avg_kmh = 40 + (int)(i / 200) % 10;
+    if (i % 250 == 0) d.motor_temp = 30 + (int)(i / 250) % 40;
+    if (i % 400 == 0) d.battery_temp = 30 + (int)(i / 400) % 20;
+    if (i % 1000 == 0) strcpy(d.mode, modes[(i / 1000) % 3]);
+    strcpy(d.status, i < 20 ? "DISARMED" : "ARMED");
+
+    uint8_t frame[TELEMETRY_FRAME_MAX];
+    size_t n = telemetry_encode_frame(&d, TELEMETRY_FIELD_ALL, (uint16_t)i, frame, sizeof(frame));
+    out->insert(out->end(), frame, frame + n);
+  }
+  return out->size();
+}
+
+static double percentile(std::vector<double> v, double p) {
+  std::sort(v.begin(), v.end());
+  size_t i = (size_t)(p * (v.size() - 1) + 0.5);
+  return v[i];
+}
+
+static size_t file_write_cb(void *user_data, const uint8_t *data, size_t len) {
+  return fwrite(data, 1, len, (FILE *)user_data);
+}
+
+static bool write_flush_log(const char *path) {
+  FILE *f = fopen(path, "w");
+  if (f == NULL) return false;
+
+  uint32_t cnt;
+  const host_flush_t *fl = host_display_get_flushes(&cnt);
+  fprintf(f, "tick,x1,y1,x2,y2,last\n");
+  for (uint32_t i = 0; i < cnt; i++) {
+    fprintf(f, "%u,%d,%d,%d,%d,%d\n", (unsigned)fl[i].tick, (int)fl[i].area.x1, (int)fl[i].area.y1,
+            (int)fl[i].area.x2, (int)fl[i].area.y2, fl[i].last ? 1 : 0);
+  }
+  return fclose(f) == 0;
+}
+
+static bool has_suffix(const char *s, const char *suffix) {
+  size_t n = strlen(s), m = strlen(suffix);
+  return n >= m && strcmp(s + n - m, suffix) == 0;
+}
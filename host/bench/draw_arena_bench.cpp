@@ -0,0 +1,184 @@
+/**
+ * @file draw_arena_bench.cpp
+ *
+ * The draw tasks, their descriptors and the copied label texts of a frame
+ * allocated from the per-layer arena (LV_DRAW_ARENA_CHUNK_SIZE,
+ * `lib/lvgl/src/draw/lv_draw_arena.c`) instead of one by one with
+ * `lv_malloc()` / `lv_free()`.
+ *
+ * Runs the dashboard update stream, with a full screen refresh every 100
+ * frames, and reports from `lv_draw_get_arena_stats()`:
+ *   - the allocations per frame from the arena, i.e. the `lv_malloc()` and
+ *     `lv_free()` pairs saved
+ *   - the chunks allocated after the first frame (0 once the arena grew to
+ *     the largest frame)
+ *   - the high-water mark of a frame and the bytes held in chunks
+ * Then it replays the allocations of the largest frame both ways (a task and
+ * a fill descriptor per draw call, freed oldest first like the dispatcher
+ * does) to show the CPU time they cost.
+ *
+ * Exit code 1 if deleting the display didn't give back all the chunks.
+ *
+ * Usage: draw_arena_bench [-n frames]
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "dashboard.h"
+#include "host_display.h"
+#include "telemetry.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if LV_DRAW_ARENA_CHUNK_SIZE
+
+/*********************
+ *      DEFINES
+ *********************/
+#define FULL_REFRESH_PERIOD 100
+#define REPLAY_ROUNDS       2000
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void make_frame(uint32_t i, telemetry_data_t *d);
+static double replay_malloc_us(uint32_t cnt);
+static double replay_arena_us(uint32_t cnt);
+static size_t block_size(uint32_t i);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char **argv) {
+  uint32_t frames = 1000;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      frames = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else {
+      fprintf(stderr, "usage: %s [-n frames]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (frames == 0) return 1;
+
+  lv_init();
+  lv_display_t *disp = host_display_create();
+  host_tick_set(0);
+
+  create_ev_dashboard_ui();
+  telemetry_data_t d;
+  telemetry_data_init(&d);
+  update_dashboard(&d);
+  lv_draw_reset_arena_stats();
+  lv_refr_now(disp);
+  const lv_draw_arena_stats_t *st = lv_draw_get_arena_stats();
+  uint32_t first_chunks = st->chunk_alloc_cnt;
+
+  uint64_t alloc_cnt = 0;
+  uint32_t chunk_cnt = 0;
+  uint32_t max_alloc = 0;
+  uint32_t max_high_water = st->high_water;
+  uint32_t resets = 0;
+  for (uint32_t i = 0; i < frames; i++) {
+    host_tick_inc(LV_DEF_REFR_PERIOD);
+    make_frame(i, &d);
+    update_dashboard(&d);
+    update_time_display(host_tick_get());
+    if (i % FULL_REFRESH_PERIOD == FULL_REFRESH_PERIOD - 1) lv_obj_invalidate(lv_screen_active());
+
+    lv_draw_reset_arena_stats();
+    lv_refr_now(disp);
+
+    alloc_cnt += st->alloc_cnt;
+    chunk_cnt += st->chunk_alloc_cnt;
+    resets += st->reset_cnt;
+    if (st->alloc_cnt > max_alloc) max_alloc = st->alloc_cnt;
+    if (st->high_water > max_high_water) max_high_water = st->high_water;
+  }
+  uint32_t held = st->size;
+
+  printf("%u frames of the dashboard drive, %d byte chunks\n\n", (unsigned)frames, LV_DRAW_ARENA_CHUNK_SIZE);
+  printf("allocations per frame:  avg %.1f, max %u (lv_malloc + lv_free pairs saved)\n", (double)alloc_cnt / frames,
+         (unsigned)max_alloc);
+  printf("arena resets per frame: %.2f (one per finished band or layer)\n", (double)resets / frames);
+  printf("chunk allocations:      %u in the first frame, %u after\n", (unsigned)first_chunks, (unsigned)chunk_cnt);
+  printf("high-water mark:        %u bytes before a reset\n", (unsigned)max_high_water);
+  printf("held in chunks:         %u bytes\n", (unsigned)held);
+
+  /* The largest frame's allocations, each way */
+  if (max_alloc) {
+    double malloc_us = replay_malloc_us(max_alloc);
+    double arena_us = replay_arena_us(max_alloc);
+    printf("\n%u allocations of %u and %u bytes:\n", (unsigned)max_alloc, (unsigned)block_size(0),
+           (unsigned)block_size(1));
+    printf("  lv_malloc + lv_free   %8.2f us\n", malloc_us);
+    printf("  arena + reset         %8.2f us (%.1fx)\n", arena_us, malloc_us / arena_us);
+  }
+
+  host_display_delete(disp);
+  bool freed = st->size == 0;
+  if (!freed) printf("\n%u bytes of chunks left after deleting the display\n", (unsigned)st->size);
+  lv_deinit();
+  return freed ? 0 : 1;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* A drive: the speed changes every frame, the rest now and then */
+static void make_frame(uint32_t i, telemetry_data_t *d) {
+  d->speed = (int)((i * 7) % 120);
+  d->range = 200 - (int)(i / 50) % 200;
+  d->avg_wh = 120 + (int)(i / 20) % 30;
+  d->avg_kmh = 40 + (int)(i / 40) % 20;
+  d->trip = (int)(i / 10);
+  d->odo = 12000 + (int)(i / 10);
+  d->motor_temp = 40 + (int)(i / 100) % 30;
+  d->battery_temp = 30 + (int)(i / 150) % 20;
+}
+
+/* Allocate `cnt` blocks and free them oldest first, average of a round */
+static double replay_malloc_us(uint32_t cnt) {
+  std::vector<void *> blocks(cnt);
+  double t0 = host_wall_us();
+  for (uint32_t r = 0; r < REPLAY_ROUNDS; r++) {
+    for (uint32_t i = 0; i < cnt; i++) blocks[i] = lv_malloc(block_size(i));
+    for (uint32_t i = 0; i < cnt; i++) lv_free(blocks[i]);
+  }
+  return (host_wall_us() - t0) / REPLAY_ROUNDS;
+}
+
+/* The same from an arena, which is reset at the end of a round */
+static double replay_arena_us(uint32_t cnt) {
+  _lv_draw_arena_t arena;
+  lv_memzero(&arena, sizeof(arena));
+  volatile uintptr_t sink = 0;
+  double t0 = host_wall_us();
+  for (uint32_t r = 0; r < REPLAY_ROUNDS; r++) {
+    for (uint32_t i = 0; i < cnt; i++) sink = sink + (uintptr_t)_lv_draw_arena_alloc(&arena, block_size(i));
+    _lv_draw_arena_reset(&arena);
+  }
+  double us = (host_wall_us() - t0) / REPLAY_ROUNDS;
+  _lv_draw_arena_deinit(&arena);
+  return us;
+}
+
+/* A draw task, then its descriptor */
+static size_t block_size(uint32_t i) {
+  return (i & 1) ? sizeof(lv_draw_fill_dsc_t) : sizeof(lv_draw_task_t);
+}
+
+#else
+
+int main(void) {
+  printf("LV_DRAW_ARENA_CHUNK_SIZE is 0 in this build\n");
+  return 0;
+}
+
+#endif /*LV_DRAW_ARENA_CHUNK_SIZE*/
@@ -0,0 +1,299 @@
+/**
+ * @file draw_task_index_bench.cpp
+ *
+ * Dispatching the draw tasks of a layer with the task index
+ * (LV_DRAW_TASK_INDEX_CELLS, `lib/lvgl/src/draw/lv_draw_task_index.c`) and
+ * with the walk over all the older tasks it replaces.
+ *
+ * Two scenes are queued on a screen sized layer:
+ *   - stress:  objects of random size all over the screen, some with shadow,
+ *              like the stress demo
+ *   - widgets: a screen background and a grid of cards with shadow, border,
+ *              labels and a bar, like the widgets demo
+ * and taken by 1, 2 and 4 simulated draw units with
+ * `lv_draw_get_next_available_task()`, like the SW draw units do. A task
+ * costs as much time as its pixels; the units only change its state, the
+ * finished tasks are removed with `lv_draw_dispatch_layer()`.
+ *
+ * Both ways must give the units the same tasks in the same order, and the
+ * same `lv_draw_get_dependent_count()` (exit code 1 otherwise). Reported per
+ * scene and unit count: the speedup of the units over one (from the
+ * simulated time) and the CPU time of adding and dispatching the tasks of a
+ * frame.
+ *
+ * The demos themselves are not built for the host, and the number of SW draw
+ * units is fixed at build time, so the scenes and units are simulated.
+ *
+ * Usage: draw_task_index_bench [-t seconds_per_run]
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "dashboard.h"
+#include "host_display.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "src/core/lv_global.h"
+
+#if LV_DRAW_TASK_INDEX_CELLS
+
+/*********************
+ *      DEFINES
+ *********************/
+#define UNIT_MAX 4
+#define UNIT_ID  1 /* Any ID but LV_DRAW_UNIT_ID_ANY */
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+  lv_area_t area;
+  lv_area_t real_area; // Larger for shadows
+} task_area_t;
+
+typedef struct {
+  const char *name;
+  std::vector<task_area_t> tasks;
+} scene_t;
+
+typedef struct {
+  double sim_time;               // Simulated time of the frame, in pixels
+  std::vector<uint32_t> order;   // `_seq` of the tasks as the units took them
+  std::vector<uint32_t> dep_cnt; // Their dependent count
+} frame_res_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void stress_scene(scene_t *scene, uint32_t obj_cnt);
+static void widgets_scene(scene_t *scene);
+static void add_task(scene_t *scene, const lv_area_t *area, int32_t shadow);
+static bool run_frame(const scene_t *scene, uint32_t unit_cnt, bool use_index, frame_res_t *res);
+static double frame_us(const scene_t *scene, uint32_t unit_cnt, bool use_index, double seconds);
+static int32_t rnd(int32_t min, int32_t max);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static uint32_t rnd_state = 0x9E3779B9;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char **argv) {
+  double seconds = 0.2;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+      seconds = atof(argv[++i]);
+    } else {
+      fprintf(stderr, "usage: %s [-t seconds_per_run]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (seconds <= 0) return 1;
+
+  lv_init();
+  host_display_create();
+
+  /* The real draw units stay out: only the simulated ones take tasks */
+  lv_draw_unit_t *units = LV_GLOBAL_DEFAULT()->draw_info.unit_head;
+  LV_GLOBAL_DEFAULT()->draw_info.unit_head = NULL;
+
+  scene_t scenes[3];
+  stress_scene(&scenes[0], 50);
+  stress_scene(&scenes[1], 150);
+  widgets_scene(&scenes[2]);
+
+  printf("%-14s %6s %6s %10s %8s %14s %14s %8s\n", "scene", "tasks", "units", "vs walk", "parallel",
+         "walk [us/fr]", "index [us/fr]", "speedup");
+  uint32_t errors = 0;
+  for (size_t s = 0; s < sizeof(scenes) / sizeof(scenes[0]); s++) {
+    double one_unit_time = 0;
+    for (uint32_t unit_cnt = 1; unit_cnt <= UNIT_MAX; unit_cnt *= 2) {
+      frame_res_t walk, index;
+      bool ok = run_frame(&scenes[s], unit_cnt, false, &walk) && run_frame(&scenes[s], unit_cnt, true, &index);
+      bool same = ok && walk.order == index.order && walk.dep_cnt == index.dep_cnt;
+      errors += !same;
+      if (unit_cnt == 1) one_unit_time = index.sim_time;
+
+      double walk_us = frame_us(&scenes[s], unit_cnt, false, seconds);
+      double index_us = frame_us(&scenes[s], unit_cnt, true, seconds);
+      printf("%-14s %6u %6u %10s %7.2fx %14.1f %14.1f %7.1fx\n", unit_cnt == 1 ? scenes[s].name : "",
+             (unsigned)scenes[s].tasks.size(), (unsigned)unit_cnt, !ok ? "STUCK" : same ? "same" : "BAD",
+             one_unit_time / index.sim_time, walk_us, index_us, walk_us / index_us);
+    }
+  }
+
+  if (errors) printf("\n%u runs differ between the walk and the index\n", (unsigned)errors);
+  LV_GLOBAL_DEFAULT()->draw_info.unit_head = units;
+  lv_deinit();
+  return errors ? 1 : 0;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* Objects of random size and position, with a background, a border and
+ * maybe a label or a shadow */
+static void stress_scene(scene_t *scene, uint32_t obj_cnt) {
+  static char names[2][32];
+  char *name = names[obj_cnt > 50];
+  snprintf(name, sizeof(names[0]), "stress %u", (unsigned)obj_cnt);
+  scene->name = name;
+
+  for (uint32_t i = 0; i < obj_cnt; i++) {
+    int32_t w = rnd(20, 160);
+    int32_t h = rnd(20, 120);
+    lv_area_t a;
+    a.x1 = rnd(-w / 2, DASHBOARD_HOR_RES - w / 2);
+    a.y1 = rnd(-h / 2, DASHBOARD_VER_RES - h / 2);
+    a.x2 = a.x1 + w - 1;
+    a.y2 = a.y1 + h - 1;
+
+    if (rnd(0, 4) == 0) add_task(scene, &a, 10);
+    add_task(scene, &a, 0);
+    add_task(scene, &a, 0);
+    if (rnd(0, 1)) {
+      lv_area_t label = {a.x1 + 5, a.y1 + 5, a.x2 - 5, a.y1 + 20};
+      add_task(scene, &label, 0);
+    }
+  }
+}
+
+/* A screen background and a grid of cards */
+static void widgets_scene(scene_t *scene) {
+  scene->name = "widgets";
+
+  lv_area_t screen = {0, 0, DASHBOARD_HOR_RES - 1, DASHBOARD_VER_RES - 1};
+  add_task(scene, &screen, 0);
+
+  for (int32_t y = 10; y + 70 <= DASHBOARD_VER_RES; y += 80) {
+    for (int32_t x = 10; x + 105 <= DASHBOARD_HOR_RES; x += 115) {
+      lv_area_t card = {x, y, x + 104, y + 69};
+      add_task(scene, &card, 8); // Shadow
+      add_task(scene, &card, 0); // Background
+      add_task(scene, &card, 0); // Border
+      for (int32_t row = 0; row < 3; row++) {
+        lv_area_t label = {x + 8, y + 6 + row * 16, x + 96, y + 19 + row * 16};
+        add_task(scene, &label, 0);
+      }
+      lv_area_t bar = {x + 8, y + 56, x + 96, y + 62};
+      add_task(scene, &bar, 0);
+      bar.x2 = x + 8 + rnd(0, 88);
+      add_task(scene, &bar, 0); // Indicator
+    }
+  }
+}
+
+static void add_task(scene_t *scene, const lv_area_t *area, int32_t shadow) {
+  task_area_t t;
+  t.area = *area;
+  t.real_area = *area;
+  if (shadow) {
+    lv_area_increase(&t.real_area, shadow, shadow);
+    lv_area_move(&t.real_area, 0, shadow / 2);
+  }
+  scene->tasks.push_back(t);
+}
+
+/* Queue the tasks of a scene and let `unit_cnt` units take them until all
+ * are ready. false if the units got stuck with tasks left. */
+static bool run_frame(const scene_t *scene, uint32_t unit_cnt, bool use_index, frame_res_t *res) {
+  lv_layer_t layer;
+  lv_memzero(&layer, sizeof(layer));
+  lv_area_set(&layer.buf_area, 0, 0, DASHBOARD_HOR_RES - 1, DASHBOARD_VER_RES - 1);
+  layer._clip_area = layer.buf_area;
+  layer.color_format = LV_COLOR_FORMAT_RGB565;
+  /* As if the index could not be allocated: LVGL walks the list of tasks */
+  layer._task_index.failed = !use_index;
+
+  for (size_t i = 0; i < scene->tasks.size(); i++) {
+    lv_draw_task_t *t = lv_draw_add_task(&layer, &scene->tasks[i].area);
+    t->type = LV_DRAW_TASK_TYPE_FILL;
+    t->draw_dsc = lv_malloc_zeroed(sizeof(lv_draw_fill_dsc_t));
+    t->_real_area = scene->tasks[i].real_area;
+    lv_draw_finalize_task_creation(&layer, t);
+  }
+
+  if (res) {
+    res->order.clear();
+    res->dep_cnt.clear();
+  }
+
+  lv_draw_task_t *running[UNIT_MAX] = {NULL};
+  double done[UNIT_MAX] = {0};
+  double now = 0;
+  while (true) {
+    /* The idle units take what they can */
+    for (uint32_t u = 0; u < unit_cnt; u++) {
+      if (running[u]) continue;
+      lv_draw_task_t *t = lv_draw_get_next_available_task(&layer, NULL, UNIT_ID);
+      if (t == NULL) break;
+      t->state = LV_DRAW_TASK_STATE_IN_PROGRESS;
+      running[u] = t;
+      done[u] = now + lv_area_get_size(&t->_real_area);
+      if (res) {
+        res->order.push_back(t->_seq);
+        res->dep_cnt.push_back(lv_draw_get_dependent_count(t));
+      }
+    }
+
+    /* The first one to finish */
+    int32_t first = -1;
+    for (uint32_t u = 0; u < unit_cnt; u++) {
+      if (running[u] && (first < 0 || done[u] < done[first])) first = u;
+    }
+    if (first < 0) break;
+
+    now = done[first];
+    running[first]->state = LV_DRAW_TASK_STATE_READY;
+    running[first] = NULL;
+    lv_draw_dispatch_layer(NULL, &layer);
+  }
+
+  bool finished = layer.draw_task_head == NULL;
+  while (layer.draw_task_head) {
+    layer.draw_task_head->state = LV_DRAW_TASK_STATE_READY;
+    lv_draw_dispatch_layer(NULL, &layer);
+  }
+  _lv_draw_layer_deinit(&layer);
+  if (res) res->sim_time = now;
+  return finished;
+}
+
+/* CPU time of queueing and dispatching a frame */
+static double frame_us(const scene_t *scene, uint32_t unit_cnt, bool use_index, double seconds) {
+  uint32_t frames = 0;
+  double t0 = host_wall_us();
+  double t = 0;
+  do {
+    run_frame(scene, unit_cnt, use_index, NULL);
+    frames++;
+    t = host_wall_us() - t0;
+  } while (t < seconds * 1e6);
+  return t / frames;
+}
+
+/* xorshift32, uniform in [min, max] */
+static int32_t rnd(int32_t min, int32_t max) {
+  rnd_state ^= rnd_state << 13;
+  rnd_state ^= rnd_state >> 17;
+  rnd_state ^= rnd_state << 5;
+  return min + (int32_t)(rnd_state % (uint32_t)(max - min + 1));
+}
+
+#else
+
+int main(void) {
+  printf("LV_DRAW_TASK_INDEX_CELLS is 0 in this build\n");
+  return 0;
+}
+
+#endif /*LV_DRAW_TASK_INDEX_CELLS*/
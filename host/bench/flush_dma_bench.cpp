@@ -0,0 +1,275 @@
+/**
+ * @file flush_dma_bench.cpp
+ *
+ * How much rendering and sending overlap with two draw buffers and a DMA
+ * flush (lv_tft_espi_create_dma()) compared with the blocking flush of one
+ * buffer (lv_tft_espi_create()), and with a render/flush pipeline of 3 and 4
+ * buffers (lv_display_set_pipeline()): the driver queues the flushes, so
+ * rendering the next band never waits for the previous flush to start. The
+ * panel link is simulated in real time by host_display_create_link(), at SPI
+ * speed plus a fixed cost per flush.
+ *
+ * Two workloads: full screen redraws, and dashboard updates from generated
+ * telemetry. Both are refreshed with lv_refr_now() and timed on the wall
+ * clock. The ideal frame time is the larger one of rendering alone and
+ * sending alone. Per band LVGL reports the time rendering, the time from
+ * flush_cb until the flush was ready, and the time stalled waiting for a
+ * buffer (`lv_display_get_flush_stats()`). At the end every mode has to have
+ * the same screen on the panel as the memory display (the exit code says if
+ * it had).
+ *
+ * The host renders many times faster than the ESP32, which hides the gain.
+ * -c stretches the rendering of every band by spinning, to get the board's
+ * ratio of rendering to sending.
+ *
+ * Usage: flush_dma_bench [-b bytes_per_s] [-f flush_us] [-c cpu_slowdown] [-n frames]
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "dashboard.h"
+#include "host_display.h"
+#include "telemetry.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+  MODE_RENDER,    // memory display, no link
+  MODE_BLOCKING,  // one buffer, flush_cb waits for the transfer
+  MODE_DMA,       // two buffers, the link completes the flush
+  MODE_PIPE3,     // three buffers, the link queues the flushes
+  MODE_PIPE4,     // four buffers
+  MODE_CNT
+} mode_t_;
+
+typedef enum {
+  WORK_FULL,
+  WORK_DRIVE,
+  WORK_CNT
+} work_t;
+
+typedef struct {
+  double frame_us;
+  double wait_us;
+  double busy_us;
+  uint32_t flushes;
+  uint32_t max_queued;
+  uint64_t bands;
+  uint64_t render_us;
+  uint64_t flush_us;
+  uint64_t stall_us;
+  uint32_t screen;  // hash of the panel content at the end
+} result_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void run(mode_t_ mode, work_t work, uint32_t frames, const host_link_config_t *link, result_t *res);
+static void make_frame(uint32_t i, telemetry_data_t *d);
+static void slowdown_event_cb(lv_event_t *e);
+static void render_ready_cb(lv_event_t *e);
+static void spin(double render_us);
+static uint32_t hash_screen(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const char *mode_names[MODE_CNT] = {"render only", "1 buf, blocking", "2 bufs, DMA", "3 bufs, pipeline",
+                                           "4 bufs, pipeline"};
+static const uint32_t mode_pipeline[MODE_CNT] = {0, 0, 0, 3, 4};
+static const char *work_names[WORK_CNT] = {"full screen", "dashboard updates"};
+
+static double cpu_slowdown = 1;
+static double t_band_start;
+static double t_wait_start;
+static double waited_us;
+static bool pipelined;
+static bool rendered;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char **argv) {
+  host_link_config_t link;
+  link.bytes_per_s = 5000000;
+  link.flush_us = 20;
+  uint32_t frames = 200;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+      link.bytes_per_s = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+      link.flush_us = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+      cpu_slowdown = atof(argv[++i]);
+    } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      frames = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else {
+      fprintf(stderr, "usage: %s [-b bytes_per_s] [-f flush_us] [-c cpu_slowdown] [-n frames]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (link.bytes_per_s == 0 || frames == 0 || cpu_slowdown < 1) return 1;
+
+  lv_init();
+
+  printf("link: %.1f MB/s, %u us per flush; rendering %.0fx slower; %u frames per run\n\n",
+         link.bytes_per_s / 1e6, (unsigned)link.flush_us, cpu_slowdown, (unsigned)frames);
+  printf("%-18s %-16s %10s %10s %10s %8s %7s   %s\n", "workload", "mode", "frame [us]", "wait [us]", "link [us]",
+         "flushes", "queued", "per band: render / flush / stall [us]");
+
+  int ret = 0;
+  for (int w = 0; w < WORK_CNT; w++) {
+    result_t res[MODE_CNT];
+    for (int m = 0; m < MODE_CNT; m++) {
+      run((mode_t_)m, (work_t)w, frames, &link, &res[m]);
+      char band[64] = "-";
+      if (m != MODE_RENDER && res[m].bands) {
+        snprintf(band, sizeof(band), "%.0f / %.0f / %.0f", (double)res[m].render_us / res[m].bands,
+                 (double)res[m].flush_us / res[m].bands, (double)res[m].stall_us / res[m].bands);
+      }
+      printf("%-18s %-16s %10.0f %10.0f %10.0f %8.1f %7u   %s\n", m == 0 ? work_names[w] : "", mode_names[m],
+             res[m].frame_us, res[m].wait_us, res[m].busy_us, (double)res[m].flushes / frames,
+             (unsigned)res[m].max_queued, band);
+      if (res[m].screen != res[MODE_RENDER].screen) {
+        printf("%-18s the screen differs from the memory display's\n", "");
+        ret = 1;
+      }
+    }
+
+    double ideal = res[MODE_RENDER].frame_us > res[MODE_BLOCKING].busy_us ? res[MODE_RENDER].frame_us
+                                                                          : res[MODE_BLOCKING].busy_us;
+    printf("%-18s speedup: DMA %.2fx, pipeline %.2fx / %.2fx, ideal %.2fx\n\n", "",
+           res[MODE_BLOCKING].frame_us / res[MODE_DMA].frame_us, res[MODE_BLOCKING].frame_us / res[MODE_PIPE3].frame_us,
+           res[MODE_BLOCKING].frame_us / res[MODE_PIPE4].frame_us, res[MODE_BLOCKING].frame_us / ideal);
+  }
+
+  lv_deinit();
+  return ret;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void run(mode_t_ mode, work_t work, uint32_t frames, const host_link_config_t *link, result_t *res) {
+  host_link_config_t cfg = *link;
+  cfg.dma = mode >= MODE_DMA;
+  cfg.double_buffered = mode == MODE_DMA;
+  cfg.pipeline = mode_pipeline[mode];
+  lv_display_t *disp = mode == MODE_RENDER ? host_display_create() : host_display_create_link(&cfg);
+
+  pipelined = cfg.pipeline != 0;
+  if (cpu_slowdown > 1) lv_display_add_event_cb(disp, slowdown_event_cb, LV_EVENT_ALL, NULL);
+
+  create_ev_dashboard_ui();
+  telemetry_data_t d;
+  telemetry_data_init(&d);
+  update_dashboard(&d);
+  lv_refr_now(disp);
+  host_link_wait();
+  host_link_reset_stats();
+  lv_display_add_event_cb(disp, render_ready_cb, LV_EVENT_RENDER_READY, NULL);
+
+  memset(res, 0, sizeof(*res));
+  double t0 = host_wall_us();
+  for (uint32_t i = 0; i < frames; i++) {
+    host_tick_inc(LV_DEF_REFR_PERIOD);
+    if (work == WORK_FULL) {
+      lv_obj_invalidate(lv_screen_active());
+    } else {
+      make_frame(i, &d);
+      update_dashboard(&d);
+    }
+    rendered = false;
+    lv_refr_now(disp);
+
+    /* The statistics are of the last frame which rendered something. The
+     * last flush of a frame is ready only during the next one, so its time
+     * is counted there. */
+    if (rendered) {
+      const lv_display_flush_stats_t *fs = lv_display_get_flush_stats(disp);
+      res->bands += fs->bands;
+      res->render_us += fs->render_time_us;
+      res->flush_us += fs->flush_time_us;
+      res->stall_us += fs->stall_time_us;
+    }
+  }
+  /* The last transfer has to be on the panel too */
+  host_link_wait();
+  double t = host_wall_us() - t0;
+
+  const host_link_stats_t *st = host_link_get_stats();
+  res->frame_us = t / frames;
+  res->wait_us = st->wait_us / frames;
+  res->busy_us = st->busy_us / frames;
+  res->flushes = st->flushes;
+  res->max_queued = st->max_queued;
+  res->screen = hash_screen();
+
+  host_display_delete(disp);
+}
+
+/* A drive: the speed changes every frame, the rest now and then */
+static void make_frame(uint32_t i, telemetry_data_t *d) {
+  d->speed = (int)((i * 7) % 120);
+  d->range = 200 - (int)(i / 50) % 200;
+  d->avg_wh = 120 + (int)(i / 20) % 30;
+  d->avg_kmh = 40 + (int)(i / 40) % 20;
+  d->trip = (int)(i / 10);
+  d->odo = 12000 + (int)(i / 10);
+  d->motor_temp = 40 + (int)(i / 100) % 30;
+  d->battery_temp = 30 + (int)(i / 150) % 20;
+}
+
+/* Spin for (slowdown - 1) times the time a band took to render. The band is
+ * rendered when it's flushed, or with two buffers when LVGL starts to wait
+ * for the other one. A pipeline waits for a free buffer before rendering,
+ * so there it's at the flush again. */
+static void slowdown_event_cb(lv_event_t *e) {
+  lv_display_t *disp = (lv_display_t *)lv_event_get_target(e);
+  bool double_buffered = lv_display_is_double_buffered(disp) && !pipelined;
+  double now = host_wall_us();
+  switch (lv_event_get_code(e)) {
+    case LV_EVENT_REFR_START:
+    case LV_EVENT_FLUSH_FINISH:
+      t_band_start = now;
+      waited_us = 0;
+      break;
+    case LV_EVENT_FLUSH_WAIT_START:
+      if (double_buffered) spin(now - t_band_start);
+      t_wait_start = host_wall_us();
+      break;
+    case LV_EVENT_FLUSH_WAIT_FINISH:
+      waited_us += now - t_wait_start;
+      break;
+    case LV_EVENT_FLUSH_START:
+      if (!double_buffered) spin(now - t_band_start - waited_us);
+      break;
+    default:
+      break;
+  }
+}
+
+static void render_ready_cb(lv_event_t *e) {
+  LV_UNUSED(e);
+  rendered = true;
+}
+
+static void spin(double render_us) {
+  double t_end = host_wall_us() + render_us * (cpu_slowdown - 1);
+  while (host_wall_us() < t_end) {}
+}
+
+static uint32_t hash_screen(void) {
+  const uint16_t *fb = host_display_get_framebuffer();
+  uint32_t h = 2166136261u;
+  for (uint32_t i = 0; i < DASHBOARD_HOR_RES * DASHBOARD_VER_RES; i++) h = (h ^ fb[i]) * 16777619u;
+  return h;
+}
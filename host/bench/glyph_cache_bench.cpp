@@ -0,0 +1,198 @@
+/**
+ * @file glyph_cache_bench.cpp
+ *
+ * Renders text with and without the cache of decoded glyph bitmaps
+ * (LV_FONT_FMT_TXT_CACHE_SIZE, `lv_font_fmt_txt_set_cache_size()`): with it
+ * the A8 bitmap of a glyph is decoded once and copied from the cache every
+ * time it's drawn again. Without it every glyph is unpacked (or
+ * decompressed) for every draw.
+ *
+ * Two runs per setting, the whole screen redrawn every frame:
+ *   - dash:  the dashboard update stream, plain 4 bpp Montserrat fonts
+ *   - label: a screen of labels in the compressed 3 bpp Montserrat 28 and
+ *            the 48 of the speed, their numbers changing every frame
+ *
+ * Reported per frame: the render time and the glyphs copied from and added
+ * to the cache (`lv_font_fmt_txt_get_cache_stats()`). Then the bytes of
+ * bitmaps cached. After every frame the panel content has to be the same
+ * with and without the cache (the exit code says if it was).
+ *
+ * Usage: glyph_cache_bench [-n frames]
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "dashboard.h"
+#include "host_display.h"
+#include "telemetry.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if LV_FONT_FMT_TXT_CACHE_SIZE && LV_FONT_MONTSERRAT_28_COMPRESSED && LV_FONT_MONTSERRAT_48
+
+/*********************
+ *      DEFINES
+ *********************/
+#define LABEL_ROWS 6
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+  double frame_us;
+  double hits;
+  double misses;
+  uint32_t cache_size;
+} result_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void run(bool cache, bool labels, uint32_t frames, result_t *res, std::vector<uint32_t> *screens);
+static void create_label_screen(lv_obj_t **rows, lv_obj_t **big);
+static void make_frame(uint32_t i, telemetry_data_t *d);
+static uint32_t hash_screen(void);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char **argv) {
+  uint32_t frames = 500;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      frames = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else {
+      fprintf(stderr, "usage: %s [-n frames]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (frames == 0) return 1;
+
+  lv_init();
+
+  printf("%u frames, whole screen redrawn, %d byte glyph cache\n\n", (unsigned)frames, LV_FONT_FMT_TXT_CACHE_SIZE);
+  printf("%-6s %-6s %10s %10s %10s %12s\n", "run", "cache", "frame [us]", "hits", "misses", "cached [B]");
+  uint32_t diff = 0;
+  for (int labels = 0; labels < 2; labels++) {
+    result_t res[2];
+    std::vector<uint32_t> screens[2];
+    run(false, labels, frames, &res[0], &screens[0]);
+    run(true, labels, frames, &res[1], &screens[1]);
+    for (uint32_t i = 0; i < frames; i++) {
+      if (screens[0][i] != screens[1][i]) diff++;
+    }
+
+    for (int m = 0; m < 2; m++) {
+      printf("%-6s %-6s %10.1f %10.1f %10.2f %12u\n", m ? "" : labels ? "label" : "dash", m ? "on" : "off",
+             res[m].frame_us, res[m].hits, res[m].misses, (unsigned)res[m].cache_size);
+    }
+  }
+  printf("\n%u frames with a different screen\n", (unsigned)diff);
+
+  lv_deinit();
+  return diff == 0 ? 0 : 1;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void run(bool cache, bool labels, uint32_t frames, result_t *res, std::vector<uint32_t> *screens) {
+  lv_display_t *disp = host_display_create();
+  host_tick_set(0);
+  lv_font_fmt_txt_set_cache_size(cache ? LV_FONT_FMT_TXT_CACHE_SIZE : 0);
+
+  lv_obj_t *rows[LABEL_ROWS];
+  lv_obj_t *big = NULL;
+  telemetry_data_t d;
+  telemetry_data_init(&d);
+  if (labels) {
+    create_label_screen(rows, &big);
+  } else {
+    create_ev_dashboard_ui();
+    update_dashboard(&d);
+  }
+  lv_refr_now(disp);
+  lv_font_fmt_txt_reset_cache_stats();
+
+  memset(res, 0, sizeof(*res));
+  double frame_us = 0;
+  for (uint32_t i = 0; i < frames; i++) {
+    host_tick_inc(LV_DEF_REFR_PERIOD);
+    if (labels) {
+      for (uint32_t r = 0; r < LABEL_ROWS; r++) {
+        lv_label_set_text_fmt(rows[r], "Cell %u: %u.%03u V", (unsigned)r + 1, 3 + (unsigned)((i + r) % 2),
+                              (unsigned)((i * 37 + r * 101) % 1000));
+      }
+      lv_label_set_text_fmt(big, "%u", (unsigned)((i * 7) % 120));
+    } else {
+      make_frame(i, &d);
+      update_dashboard(&d);
+      update_time_display(host_tick_get());
+    }
+    lv_obj_invalidate(lv_screen_active());
+
+    double t0 = host_wall_us();
+    lv_refr_now(disp);
+    frame_us += host_wall_us() - t0;
+    screens->push_back(hash_screen());
+  }
+
+  lv_font_fmt_txt_cache_stats_t st;
+  lv_font_fmt_txt_get_cache_stats(&st);
+  res->frame_us = frame_us / frames;
+  res->hits = (double)st.hit_cnt / frames;
+  res->misses = (double)st.miss_cnt / frames;
+  res->cache_size = st.size;
+
+  host_display_delete(disp);
+}
+
+static void create_label_screen(lv_obj_t **rows, lv_obj_t **big) {
+  lv_obj_t *scr = lv_obj_create(NULL);
+  lv_obj_set_style_bg_color(scr, lv_color_white(), 0);
+  lv_screen_load(scr);
+
+  for (uint32_t r = 0; r < LABEL_ROWS; r++) {
+    rows[r] = lv_label_create(scr);
+    lv_obj_set_style_text_font(rows[r], &lv_font_montserrat_28_compressed, 0);
+    lv_obj_set_pos(rows[r], 10, 10 + (int32_t)r * 36);
+  }
+
+  *big = lv_label_create(scr);
+  lv_obj_set_style_text_font(*big, &lv_font_montserrat_48, 0);
+  lv_obj_align(*big, LV_ALIGN_RIGHT_MID, -20, 0);
+}
+
+/* A drive: the speed changes every frame, the rest now and then */
+static void make_frame(uint32_t i, telemetry_data_t *d) {
+  d->speed = (int)((i * 7) % 120);
+  d->range = 200 - (int)(i / 50) % 200;
+  d->avg_wh = 120 + (int)(i / 20) % 30;
+  d->avg_kmh = 40 + (int)(i / 40) % 20;
+  d->trip = (int)(i / 10);
+  d->odo = 12000 + (int)(i / 10);
+  d->motor_temp = 40 + (int)(i / 100) % 30;
+  d->battery_temp = 30 + (int)(i / 150) % 20;
+}
+
+static uint32_t hash_screen(void) {
+  const uint16_t *fb = host_display_get_framebuffer();
+  uint32_t h = 2166136261u;
+  for (uint32_t i = 0; i < DASHBOARD_HOR_RES * DASHBOARD_VER_RES; i++) h = (h ^ fb[i]) * 16777619u;
+  return h;
+}
+
+#else
+
+int main(void) {
+  printf("LV_FONT_FMT_TXT_CACHE_SIZE, LV_FONT_MONTSERRAT_28_COMPRESSED or LV_FONT_MONTSERRAT_48 is 0 in this build\n");
+  return 0;
+}
+
+#endif /*LV_FONT_FMT_TXT_CACHE_SIZE*/
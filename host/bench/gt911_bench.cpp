@@ -0,0 +1,270 @@
+/**
+ * @file gt911_bench.cpp
+ *
+ * Touch input from a mock GT911 (host/common/gt911_mock.h) in simulated time,
+ * read two ways:
+ *   - polling:   the old `my_touch_read()`, which asks the controller for a
+ *                report on every indev read period
+ *   - interrupt: the driver in lib/GT911, which reads once per INT pulse and
+ *                feeds an indev in LV_INDEV_MODE_EVENT
+ *
+ * The same generated session of taps and swipes with idle gaps in between is
+ * played to both. Reported are the I2C traffic (in total and while idle), how
+ * old a report was when it was read, how many scans the controller dropped
+ * because nobody read them, and the time from a scan until LVGL sends
+ * LV_EVENT_PRESSED / LV_EVENT_RELEASED. (A swipe that leaves the pressed
+ * object ends with LV_EVENT_PRESS_LOST instead of LV_EVENT_RELEASED.)
+ *
+ * Usage: gt911_bench [-t seconds] [-r scan_period_ms]
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "dashboard.h"
+#include "gt911.h"
+#include "gt911_mock.h"
+#include "host_display.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/*********************
+ *      DEFINES
+ *********************/
+/* The controller's own resolution: portrait, mounted rotated */
+#define PANEL_HOR_RES 320
+#define PANEL_VER_RES 480
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+  uint32_t t_down;
+  uint32_t t_up;
+  int32_t x0, y0;
+  int32_t x1, y1;
+} gesture_t;
+
+typedef struct {
+  gt911_mock_stats_t bus;
+  uint32_t pressed;
+  uint32_t released;
+  double press_avg, press_max;
+  double release_avg, release_max;
+} result_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static std::vector<gesture_t> make_session(uint32_t duration_ms, uint32_t seed);
+static void run(bool interrupt, const std::vector<gesture_t> &session, uint32_t duration_ms, result_t *res);
+static void polling_read_cb(lv_indev_t *indev, lv_indev_data_t *data);
+static void mock_irq_cb(void *user_data);
+static void indev_event_cb(lv_event_t *e);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static uint32_t scan_period = 10;
+static gt911_mock_t mock;
+static gt911_t ts;
+
+/* Set by the session for the event callback */
+static uint32_t t_first_scan;
+static uint32_t t_release_scan;
+static std::vector<uint32_t> press_lat;
+static std::vector<uint32_t> release_lat;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char **argv) {
+  double seconds = 600;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+      seconds = atof(argv[++i]);
+    } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+      scan_period = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else {
+      fprintf(stderr, "usage: %s [-t seconds] [-r scan_period_ms]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (scan_period == 0 || seconds <= 0) return 1;
+
+  lv_init();
+  host_display_create();
+  create_ev_dashboard_ui();
+
+  uint32_t duration_ms = (uint32_t)(seconds * 1000);
+  std::vector<gesture_t> session = make_session(duration_ms, 1);
+
+  result_t res[2];
+  run(false, session, duration_ms, &res[0]);
+  run(true, session, duration_ms, &res[1]);
+
+  printf("%u gestures in %.0f s, a scan every %u ms while touched, indev read period %u ms\n\n",
+         (unsigned)session.size(), seconds, (unsigned)scan_period, (unsigned)LV_DEF_REFR_PERIOD);
+  printf("                          polling   interrupt\n");
+  printf("I2C transactions       %10u  %10u\n", res[0].bus.reads + res[0].bus.writes,
+         res[1].bus.reads + res[1].bus.writes);
+  printf("  while idle           %10u  %10u\n", res[0].bus.idle, res[1].bus.idle);
+  printf("bus time [ms/s]        %10.2f  %10.2f\n", res[0].bus.bus_us / 1000 / seconds,
+         res[1].bus.bus_us / 1000 / seconds);
+  printf("reports read           %10u  %10u\n", res[0].bus.acked, res[1].bus.acked);
+  printf("scans dropped          %10u  %10u\n", res[0].bus.lost, res[1].bus.lost);
+  printf("report age avg [ms]    %10.1f  %10.1f\n",
+         res[0].bus.acked ? (double)res[0].bus.age_ms_sum / res[0].bus.acked : 0,
+         res[1].bus.acked ? (double)res[1].bus.age_ms_sum / res[1].bus.acked : 0);
+  printf("report age max [ms]    %10u  %10u\n", res[0].bus.age_ms_max, res[1].bus.age_ms_max);
+  printf("PRESSED events         %10u  %10u\n", res[0].pressed, res[1].pressed);
+  printf("  latency avg [ms]     %10.1f  %10.1f\n", res[0].press_avg, res[1].press_avg);
+  printf("  latency max [ms]     %10.0f  %10.0f\n", res[0].press_max, res[1].press_max);
+  printf("RELEASED events        %10u  %10u\n", res[0].released, res[1].released);
+  printf("  latency avg [ms]     %10.1f  %10.1f\n", res[0].release_avg, res[1].release_avg);
+  printf("  latency max [ms]     %10.0f  %10.0f\n", res[0].release_max, res[1].release_max);
+
+  lv_deinit();
+  return res[1].pressed == session.size() && res[1].bus.idle == 0 ? 0 : 1;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* Taps and swipes separated by 0.3..5 s of nothing */
+static std::vector<gesture_t> make_session(uint32_t duration_ms, uint32_t seed) {
+  std::vector<gesture_t> session;
+  uint32_t rand = seed;
+  uint32_t t = 1000;
+  while (true) {
+    rand = rand * 1103515245 + 12345;
+    bool swipe = (rand >> 16) % 10 < 4;
+    rand = rand * 1103515245 + 12345;
+    uint32_t len = swipe ? 200 + (rand >> 16) % 600 : 60 + (rand >> 16) % 140;
+    if (t + len + 100 > duration_ms) break;
+
+    gesture_t g;
+    g.t_down = t;
+    g.t_up = t + len;
+    rand = rand * 1103515245 + 12345;
+    g.x0 = 20 + (rand >> 16) % (PANEL_HOR_RES - 40);
+    rand = rand * 1103515245 + 12345;
+    g.y0 = 20 + (rand >> 16) % (PANEL_VER_RES - 40);
+    g.x1 = swipe ? PANEL_HOR_RES - 1 - g.x0 : g.x0;
+    g.y1 = g.y0;
+    session.push_back(g);
+
+    rand = rand * 1103515245 + 12345;
+    t = g.t_up + 300 + (rand >> 16) % 4700;
+  }
+  return session;
+}
+
+/* The controller scans every scan_period while touched and once more after
+ * the lift; each scan stores a report and pulses INT */
+static void run(bool interrupt, const std::vector<gesture_t> &session, uint32_t duration_ms, result_t *res) {
+  gt911_mock_init(&mock, PANEL_HOR_RES, PANEL_VER_RES);
+  gt911_i2c_t i2c = gt911_mock_get_i2c(&mock);
+  gt911_init(&ts, &i2c);
+  gt911_probe(&ts);
+  gt911_set_flags(&ts, GT911_SWAP_XY | GT911_INVERT_X);
+  lv_memzero(&mock.stats, sizeof(mock.stats));
+
+  lv_indev_t *indev;
+  if (interrupt) {
+    gt911_mock_set_irq_cb(&mock, mock_irq_cb, &ts);
+    indev = gt911_create_indev(&ts);
+  } else {
+    indev = lv_indev_create();
+    lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_read_cb(indev, polling_read_cb);
+  }
+  lv_indev_add_event_cb(indev, indev_event_cb, LV_EVENT_ALL, NULL);
+
+  press_lat.clear();
+  release_lat.clear();
+  size_t g = 0;
+  for (uint32_t t = 0; t < duration_ms; t++) {
+    host_tick_set(t);
+
+    if (g < session.size() && t >= session[g].t_down) {
+      const gesture_t *ges = &session[g];
+      uint32_t since = t - ges->t_down;
+      if (t < ges->t_up) {
+        if (since % scan_period == 0) {
+          gt911_point_t p;
+          p.id = 0;
+          p.x = (uint16_t)(ges->x0 + (ges->x1 - ges->x0) * (int32_t)since / (int32_t)(ges->t_up - ges->t_down));
+          p.y = (uint16_t)ges->y0;
+          p.size = 30;
+          if (since == 0) t_first_scan = t;
+          gt911_mock_scan(&mock, &p, 1);
+        }
+      } else if (since % scan_period == 0) {
+        t_release_scan = t;
+        gt911_mock_scan(&mock, NULL, 0);
+        g++;
+      }
+    }
+
+    /* The INT pulse wakes the run loop right away */
+    if (interrupt) gt911_handle(&ts);
+    lv_timer_handler();
+  }
+
+  res->bus = mock.stats;
+  res->pressed = (uint32_t)press_lat.size();
+  res->released = (uint32_t)release_lat.size();
+  res->press_avg = res->press_max = res->release_avg = res->release_max = 0;
+  for (uint32_t l : press_lat) {
+    res->press_avg += l;
+    if (l > res->press_max) res->press_max = l;
+  }
+  for (uint32_t l : release_lat) {
+    res->release_avg += l;
+    if (l > res->release_max) res->release_max = l;
+  }
+  if (res->pressed) res->press_avg /= res->pressed;
+  if (res->released) res->release_avg /= res->released;
+
+  lv_indev_delete(indev);
+  gt911_mock_set_irq_cb(&mock, NULL, NULL);
+}
+
+/* What `my_touch_read()` did through the GT911 Arduino library: read the
+ * status, then the points if there are any, then clear the status */
+static void polling_read_cb(lv_indev_t *indev, lv_indev_data_t *data) {
+  LV_UNUSED(indev);
+  gt911_i2c_t i2c = gt911_mock_get_i2c(&mock);
+
+  uint8_t status = 0;
+  i2c.read(i2c.user_data, 0x814E, &status, 1);
+  uint8_t cnt = (status & 0x80) ? (status & 0x0F) : 0;
+  if (status & 0x80) {
+    uint8_t points[GT911_MAX_POINTS * 8];
+    if (cnt) i2c.read(i2c.user_data, 0x814F, points, cnt * 8);
+    uint8_t zero = 0;
+    i2c.write(i2c.user_data, 0x814E, &zero, 1);
+
+    if (cnt) {
+      data->point.x = DASHBOARD_HOR_RES - (points[3] | (points[4] << 8));
+      data->point.y = points[1] | (points[2] << 8);
+    }
+  }
+  data->state = cnt ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+}
+
+static void mock_irq_cb(void *user_data) {
+  gt911_irq((gt911_t *)user_data);
+}
+
+static void indev_event_cb(lv_event_t *e) {
+  lv_event_code_t code = lv_event_get_code(e);
+  if (code == LV_EVENT_PRESSED) press_lat.push_back(lv_tick_get() - t_first_scan);
+  else if (code == LV_EVENT_RELEASED) release_lat.push_back(lv_tick_get() - t_release_scan);
+}
@@ -0,0 +1,417 @@
+/**
+ * @file inv_region_bench.cpp
+ *
+ * Replays invalidation traces through two ways of collecting the areas to
+ * redraw:
+ *   - legacy: LVGL 9.1's `_lv_inv_area()` with `lv_refr_join_area()`. Areas
+ *             are kept as they come, joined pairwise after the frame (O(n^2))
+ *             when the bounding box is smaller than the two, and when more
+ *             than LV_INV_BUF_SIZE areas come the whole screen is redrawn.
+ *   - region: lv_region (src/misc/lv_region.h), which the display uses now.
+ *             Areas are merged on arrival when that's cheaper with a fixed
+ *             cost per area, kept disjoint, and a full set is merged where
+ *             it adds the fewest pixels.
+ *   - bus:    lv_region with the cost of the link, as after
+ *             `lv_display_set_flush_cost()`: a flush costs `-f` against the
+ *             pixels at `-b`, and an area costs a flush per band of the draw
+ *             buffer.
+ *
+ * The traces are recorded from LVGL itself (LV_EVENT_INVALIDATE_AREA):
+ *   - dashboard drive: the EV dashboard with generated telemetry
+ *   - sensor grid:     a diagnostics page with 64 small labels, most of them
+ *                      changing every frame
+ * and one is generated:
+ *   - random areas:    up to 48 overlapping areas of any size per frame, to
+ *                      check the corner cases
+ *
+ * Reported per frame: the areas, the flushes (areas cut into bands of the
+ * 40 line draw buffer), the pixels, the estimated bus time on the SPI link,
+ * and the CPU time of the bookkeeping. Every frame is checked: the result has
+ * to cover every invalidated pixel, and the region's areas must not overlap.
+ *
+ * Usage: inv_region_bench [-n frames] [-a area_cost_px] [-b bytes_per_s] [-f flush_us]
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "dashboard.h"
+#include "host_display.h"
+#include "src/display/lv_display_private.h"
+#include "telemetry.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BUF_PX         (DASHBOARD_HOR_RES * 40)
+#define GRID_COLS      8
+#define GRID_ROWS      8
+#define REPLAY_REPEATS 20
+#define TRACE_CNT      3
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef std::vector<lv_area_t> frame_t;
+typedef std::vector<frame_t> trace_t;
+
+typedef enum {
+  ENGINE_LEGACY,
+  ENGINE_REGION,
+  ENGINE_BUS,
+  ENGINE_CNT
+} engine_t;
+
+typedef struct {
+  double areas;
+  double flushes;
+  double px;
+  double bus_us;
+  double cpu_ns;    // per invalidation
+  uint32_t full;    // frames redrawn in full because the buffer overflowed
+  uint32_t errors;  // frames with uncovered pixels or overlapping areas
+} result_t;
+
+/* LVGL 9.1's buffer of invalid areas */
+typedef struct {
+  lv_area_t areas[LV_INV_BUF_SIZE];
+  uint8_t joined[LV_INV_BUF_SIZE];
+  uint32_t cnt;
+  bool full;
+} legacy_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static trace_t record_dashboard(uint32_t frames);
+static trace_t record_grid(uint32_t frames);
+static trace_t make_random(uint32_t frames);
+static void record_event_cb(lv_event_t *e);
+static void replay(engine_t engine, const trace_t &trace, result_t *res);
+static uint32_t collect(engine_t engine, const frame_t &frame, lv_area_t *out, bool *full);
+static void legacy_add(legacy_t *l, const lv_area_t *a);
+static void legacy_join(legacy_t *l);
+static uint32_t check(const frame_t &frame, const lv_area_t *areas, uint32_t cnt, bool disjoint);
+static uint32_t dirty_px(const frame_t &frame);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const char *engine_names[ENGINE_CNT] = {"legacy", "region", "bus"};
+
+static frame_t *rec_frame;
+static uint32_t area_cost = LV_INV_AREA_COST;
+static uint32_t bytes_per_s = 5000000;
+static uint32_t flush_us = 20;
+static std::vector<uint8_t> cover;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char **argv) {
+  uint32_t frames = 500;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      frames = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+      area_cost = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+      bytes_per_s = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+      flush_us = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else {
+      fprintf(stderr, "usage: %s [-n frames] [-a area_cost_px] [-b bytes_per_s] [-f flush_us]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (frames == 0 || bytes_per_s == 0) return 1;
+
+  lv_init();
+  host_display_create();
+  cover.resize(DASHBOARD_HOR_RES * DASHBOARD_VER_RES);
+
+  const char *trace_names[TRACE_CNT] = {"dashboard drive", "sensor grid", "random areas"};
+  trace_t traces[TRACE_CNT];
+  traces[0] = record_dashboard(frames);
+  traces[1] = record_grid(frames);
+  traces[2] = make_random(frames);
+
+  printf("%u frames per trace, %u areas max, area cost %u px, link %.1f MB/s + %u us per flush\n\n",
+         (unsigned)frames, (unsigned)LV_INV_BUF_SIZE, (unsigned)area_cost, bytes_per_s / 1e6, (unsigned)flush_us);
+  printf("%-16s %-7s %8s %8s %8s %9s %10s %8s %8s %6s\n", "trace", "engine", "inv", "areas", "flushes", "px",
+         "bus [us]", "ns/inv", "full", "errors");
+  printf("(inv: invalidations, px: redrawn pixels, all per frame; dirty px: the invalidated pixels)\n\n");
+
+  uint32_t errors = 0;
+  for (int t = 0; t < TRACE_CNT; t++) {
+    size_t inv = 0;
+    double dirty = 0;
+    for (const frame_t &f : traces[t]) {
+      inv += f.size();
+      dirty += dirty_px(f);
+    }
+
+    for (int e = 0; e < ENGINE_CNT; e++) {
+      result_t res;
+      replay((engine_t)e, traces[t], &res);
+      printf("%-16s %-7s %8.1f %8.1f %8.1f %9.0f %10.0f %8.0f %8u %6u\n", e == 0 ? trace_names[t] : "",
+             engine_names[e], (double)inv / traces[t].size(), res.areas, res.flushes, res.px, res.bus_us,
+             res.cpu_ns, (unsigned)res.full, (unsigned)res.errors);
+      errors += res.errors;
+    }
+    printf("%-16s dirty px %.0f\n\n", "", dirty / traces[t].size());
+  }
+
+  lv_deinit();
+  return errors == 0 ? 0 : 1;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* A drive: the speed changes every frame, the rest now and then */
+static trace_t record_dashboard(uint32_t frames) {
+  lv_obj_t *scr = lv_obj_create(NULL);
+  lv_screen_load(scr);
+  create_ev_dashboard_ui();
+  telemetry_data_t d;
+  telemetry_data_init(&d);
+  update_dashboard(&d);
+  lv_refr_now(NULL);
+
+  trace_t trace;
+  lv_display_add_event_cb(lv_display_get_default(), record_event_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+  for (uint32_t i = 0; i < frames; i++) {
+    trace.push_back(frame_t());
+    rec_frame = &trace.back();
+    d.speed = (int)((i * 7) % 120);
+    d.range = 200 - (int)(i / 50) % 200;
+    d.avg_wh = 120 + (int)(i / 20) % 30;
+    d.avg_kmh = 40 + (int)(i / 40) % 20;
+    d.trip = (int)(i / 10);
+    d.odo = 12000 + (int)(i / 10);
+    d.motor_temp = 40 + (int)(i / 100) % 30;
+    d.battery_temp = 30 + (int)(i / 150) % 20;
+    update_dashboard(&d);
+    lv_refr_now(NULL);
+  }
+  lv_display_remove_event_cb_with_user_data(lv_display_get_default(), record_event_cb, NULL);
+  lv_obj_delete(scr);
+  return trace;
+}
+
+/* Labels of different widths in a grid; each frame about 3/4 of them change */
+static trace_t record_grid(uint32_t frames) {
+  lv_obj_t *scr = lv_obj_create(NULL);
+  lv_obj_set_style_bg_color(scr, lv_color_black(), 0);
+  lv_screen_load(scr);
+
+  lv_obj_t *labels[GRID_COLS * GRID_ROWS];
+  for (int i = 0; i < GRID_COLS * GRID_ROWS; i++) {
+    labels[i] = lv_label_create(scr);
+    lv_obj_set_style_text_color(labels[i], lv_color_white(), 0);
+    lv_obj_set_pos(labels[i], 8 + (i % GRID_COLS) * (DASHBOARD_HOR_RES / GRID_COLS),
+                   8 + (i / GRID_COLS) * (DASHBOARD_VER_RES / GRID_ROWS));
+    lv_label_set_text(labels[i], "0");
+  }
+  lv_refr_now(NULL);
+
+  trace_t trace;
+  uint32_t rand = 1;
+  lv_display_add_event_cb(lv_display_get_default(), record_event_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+  for (uint32_t f = 0; f < frames; f++) {
+    trace.push_back(frame_t());
+    rec_frame = &trace.back();
+    for (int i = 0; i < GRID_COLS * GRID_ROWS; i++) {
+      rand = rand * 1103515245 + 12345;
+      if ((rand >> 16) % 4 == 0) continue;
+      rand = rand * 1103515245 + 12345;
+      lv_label_set_text_fmt(labels[i], "%u", (unsigned)((rand >> 16) % 10000));
+    }
+    lv_refr_now(NULL);
+  }
+  lv_display_remove_event_cb_with_user_data(lv_display_get_default(), record_event_cb, NULL);
+  lv_obj_delete(scr);
+  return trace;
+}
+
+/* Anything from a few pixels to most of the screen, also off the edges */
+static trace_t make_random(uint32_t frames) {
+  lv_area_t screen;
+  lv_area_set(&screen, 0, 0, DASHBOARD_HOR_RES - 1, DASHBOARD_VER_RES - 1);
+  trace_t trace;
+  uint32_t rand = 7;
+  for (uint32_t f = 0; f < frames; f++) {
+    trace.push_back(frame_t());
+    rand = rand * 1103515245 + 12345;
+    uint32_t n = 1 + (rand >> 16) % 48;
+    for (uint32_t i = 0; i < n; i++) {
+      int32_t v[4];
+      for (int k = 0; k < 4; k++) {
+        rand = rand * 1103515245 + 12345;
+        v[k] = (int32_t)((rand >> 16) % 0x7fff);
+      }
+      /* Mostly small areas, like labels and icons */
+      int32_t max_w = (v[3] & 3) == 0 ? DASHBOARD_HOR_RES : 64;
+      lv_area_t a;
+      a.x1 = v[0] % (DASHBOARD_HOR_RES + 32) - 16;
+      a.y1 = v[1] % (DASHBOARD_VER_RES + 32) - 16;
+      a.x2 = a.x1 + v[2] % max_w;
+      a.y2 = a.y1 + (v[2] >> 7) % max_w;
+      if (!_lv_area_intersect(&a, &a, &screen)) continue;
+      trace.back().push_back(a);
+    }
+  }
+  return trace;
+}
+
+static void record_event_cb(lv_event_t *e) {
+  const lv_area_t *a = (const lv_area_t *)lv_event_get_param(e);
+  if (rec_frame) rec_frame->push_back(*a);
+}
+
+static void replay(engine_t engine, const trace_t &trace, result_t *res) {
+  memset(res, 0, sizeof(*res));
+  lv_area_t out[LV_INV_BUF_SIZE];
+
+  for (const frame_t &frame : trace) {
+    bool full = false;
+    uint32_t cnt = collect(engine, frame, out, &full);
+    if (full) res->full++;
+    res->errors += check(frame, out, cnt, engine != ENGINE_LEGACY);
+
+    res->areas += cnt;
+    for (uint32_t i = 0; i < cnt; i++) {
+      int32_t w = lv_area_get_width(&out[i]);
+      int32_t h = lv_area_get_height(&out[i]);
+      int32_t rows = BUF_PX / w;
+      res->flushes += (h + rows - 1) / rows;
+      res->px += (double)w * h;
+    }
+  }
+
+  /* Only the bookkeeping, several times over for the timer's resolution */
+  size_t inv = 0;
+  double t0 = host_wall_us();
+  for (int r = 0; r < REPLAY_REPEATS; r++) {
+    for (const frame_t &frame : trace) {
+      bool full;
+      collect(engine, frame, out, &full);
+      inv += frame.size();
+    }
+  }
+  res->cpu_ns = inv ? (host_wall_us() - t0) * 1000 / inv : 0;
+
+  size_t n = trace.size();
+  res->areas /= n;
+  res->flushes /= n;
+  res->px /= n;
+  res->bus_us = res->px * 2 * 1e6 / bytes_per_s + res->flushes * flush_us;
+}
+
+/* The areas one frame redraws */
+static uint32_t collect(engine_t engine, const frame_t &frame, lv_area_t *out, bool *full) {
+  if (engine == ENGINE_LEGACY) {
+    static legacy_t l;
+    l.cnt = 0;
+    l.full = false;
+    for (const lv_area_t &a : frame) legacy_add(&l, &a);
+    legacy_join(&l);
+    uint32_t cnt = 0;
+    for (uint32_t i = 0; i < l.cnt; i++) {
+      if (!l.joined[i]) out[cnt++] = l.areas[i];
+    }
+    *full = l.full;
+    return cnt;
+  }
+
+  lv_region_t region;
+  _lv_region_init(&region, out, LV_INV_BUF_SIZE, area_cost);
+  if (engine == ENGINE_BUS) {
+    /* The flush in pixels of RGB565 */
+    _lv_region_set_cost(&region, (uint32_t)((uint64_t)flush_us * bytes_per_s / 2000000), BUF_PX);
+  }
+  for (const lv_area_t &a : frame) _lv_region_add(&region, &a);
+  *full = false;
+  return region.cnt;
+}
+
+static void legacy_add(legacy_t *l, const lv_area_t *a) {
+  for (uint32_t i = 0; i < l->cnt; i++) {
+    if (_lv_area_is_in(a, &l->areas[i], 0)) return;
+  }
+  if (l->cnt >= LV_INV_BUF_SIZE) {
+    l->cnt = 0;
+    lv_area_set(&l->areas[0], 0, 0, DASHBOARD_HOR_RES - 1, DASHBOARD_VER_RES - 1);
+    l->joined[0] = 0;
+    l->cnt = 1;
+    l->full = true;
+    return;
+  }
+  l->areas[l->cnt] = *a;
+  l->joined[l->cnt] = 0;
+  l->cnt++;
+}
+
+static void legacy_join(legacy_t *l) {
+  lv_area_t joined_area;
+  for (uint32_t join_in = 0; join_in < l->cnt; join_in++) {
+    if (l->joined[join_in]) continue;
+    for (uint32_t join_from = 0; join_from < l->cnt; join_from++) {
+      if (l->joined[join_from] || join_in == join_from) continue;
+      if (!_lv_area_is_on(&l->areas[join_in], &l->areas[join_from])) continue;
+      _lv_area_join(&joined_area, &l->areas[join_in], &l->areas[join_from]);
+      if (lv_area_get_size(&joined_area) <
+          lv_area_get_size(&l->areas[join_in]) + lv_area_get_size(&l->areas[join_from])) {
+        l->areas[join_in] = joined_area;
+        l->joined[join_from] = 1;
+      }
+    }
+  }
+}
+
+/* 1 if a pixel of the frame isn't covered, or two areas overlap when they
+ * shouldn't */
+static uint32_t check(const frame_t &frame, const lv_area_t *areas, uint32_t cnt, bool disjoint) {
+  std::fill(cover.begin(), cover.end(), 0);
+  for (uint32_t i = 0; i < cnt; i++) {
+    for (int32_t y = areas[i].y1; y <= areas[i].y2; y++) {
+      for (int32_t x = areas[i].x1; x <= areas[i].x2; x++) {
+        uint8_t *c = &cover[y * DASHBOARD_HOR_RES + x];
+        if (*c && disjoint) return 1;
+        *c = 1;
+      }
+    }
+  }
+  for (const lv_area_t &a : frame) {
+    for (int32_t y = a.y1; y <= a.y2; y++) {
+      for (int32_t x = a.x1; x <= a.x2; x++) {
+        if (!cover[y * DASHBOARD_HOR_RES + x]) return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+static uint32_t dirty_px(const frame_t &frame) {
+  std::fill(cover.begin(), cover.end(), 0);
+  uint32_t px = 0;
+  for (const lv_area_t &a : frame) {
+    for (int32_t y = a.y1; y <= a.y2; y++) {
+      for (int32_t x = a.x1; x <= a.x2; x++) {
+        uint8_t *c = &cover[y * DASHBOARD_HOR_RES + x];
+        px += !*c;
+        *c = 1;
+      }
+    }
+  }
+  return px;
+}
@@ -0,0 +1,250 @@
+/**
+ * @file overdraw_bench.cpp
+ *
+ * Runs the dashboard drive with the refresh heatmap (LV_USE_REFR_HEATMAP,
+ * `lv_refr_heatmap_enable()`) to find what is redrawn more than needed.
+ *
+ * Reported:
+ *   - per frame: the invalidated, rendered and blended pixels, and the
+ *     overdraw (blends per rendered pixel)
+ *   - per object, the most invalidated pixels first: the invalidations and
+ *     their reasons, the invalidated pixels, and how many of those changed on
+ *     the panel. A low "changed" share is a widget which repaints far more
+ *     area than it needs to.
+ *
+ * The blends of every frame are summed up, and saved with -o as a PPM: black
+ * is never drawn, then blue, green, yellow and red for the pixels drawn most.
+ *
+ * Usage: overdraw_bench [-n frames] [-t top_objects] [-o heatmap.ppm]
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "dashboard.h"
+#include "host_display.h"
+#include "telemetry.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define OBJ_MAX 128
+#define SCREEN_PX (DASHBOARD_HOR_RES * DASHBOARD_VER_RES)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/* What the bench adds to LVGL's report of an object */
+typedef struct {
+  uint32_t inv_cnt;      // at the end of the last frame
+  uint64_t changed_px;   // pixels of its invalidated areas which changed on the panel
+  uint64_t checked_px;   // pixels of its invalidated areas which were compared
+} obj_extra_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void make_frame(uint32_t i, telemetry_data_t *d);
+static void count_changes(const lv_refr_heatmap_obj_t *objs, uint32_t cnt, const uint16_t *prev);
+static void print_report(const lv_refr_heatmap_obj_t *objs, uint32_t cnt, uint32_t frames, uint32_t top);
+static void describe(const lv_refr_heatmap_obj_t *o, char *buf, size_t size);
+static bool save_heatmap(const char *path, const std::vector<uint32_t> &heat);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static uint16_t heatmap[SCREEN_PX];
+static lv_refr_heatmap_obj_t objs[OBJ_MAX];
+static obj_extra_t extra[OBJ_MAX];
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char **argv) {
+  uint32_t frames = 1000;
+  uint32_t top = 15;
+  const char *out_path = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      frames = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+      top = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+      out_path = argv[++i];
+    } else {
+      fprintf(stderr, "usage: %s [-n frames] [-t top_objects] [-o heatmap.ppm]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (frames == 0) return 1;
+
+  lv_init();
+  lv_display_t *disp = host_display_create();
+  host_tick_set(0);
+
+  create_ev_dashboard_ui();
+  telemetry_data_t d;
+  telemetry_data_init(&d);
+  update_dashboard(&d);
+  lv_refr_now(disp);
+
+  lv_refr_heatmap_enable(disp, heatmap, objs, OBJ_MAX);
+
+  std::vector<uint32_t> heat(SCREEN_PX);
+  std::vector<uint16_t> prev(SCREEN_PX);
+  for (uint32_t i = 0; i < frames; i++) {
+    memcpy(prev.data(), host_display_get_framebuffer(), SCREEN_PX * sizeof(uint16_t));
+    uint32_t rendered = lv_refr_heatmap_get_stats(disp)->frames;
+
+    host_tick_inc(LV_DEF_REFR_PERIOD);
+    make_frame(i, &d);
+    update_dashboard(&d);
+    update_time_display(host_tick_get());
+    lv_refr_now(disp);
+
+    uint32_t cnt;
+    const lv_refr_heatmap_obj_t *o = lv_refr_heatmap_get_objs(disp, &cnt);
+    count_changes(o, cnt, prev.data());
+    if (lv_refr_heatmap_get_stats(disp)->frames != rendered) {
+      for (uint32_t p = 0; p < SCREEN_PX; p++) heat[p] += heatmap[p];
+    }
+  }
+
+  const lv_refr_heatmap_stats_t *st = lv_refr_heatmap_get_stats(disp);
+  printf("%u frames of the dashboard drive, %u rendered something\n\n", (unsigned)frames, (unsigned)st->frames);
+  printf("per frame:   %.0f px invalidated, %.0f px rendered, %.0f px blended\n", (double)st->inv_px / frames,
+         (double)st->rendered_px / frames, (double)st->blended_px / frames);
+  printf("overdraw:    %.2f blends per rendered px, at most %u in the last frame\n",
+         st->rendered_px ? (double)st->blended_px / st->rendered_px : 0.0, (unsigned)st->max_blends);
+  if (st->dropped) printf("             %u invalidations of objects over %d not listed\n", (unsigned)st->dropped, OBJ_MAX);
+  printf("\n");
+
+  uint32_t cnt;
+  const lv_refr_heatmap_obj_t *o = lv_refr_heatmap_get_objs(disp, &cnt);
+  print_report(o, cnt, frames, top);
+
+  int ret = 0;
+  if (out_path && !save_heatmap(out_path, heat)) {
+    perror(out_path);
+    ret = 1;
+  }
+
+  lv_refr_heatmap_disable(disp);
+  lv_deinit();
+  return ret;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* A drive: the speed changes every frame, the rest now and then */
+static void make_frame(uint32_t i, telemetry_data_t *d) {
+  d->speed = (int)((i * 7) % 120);
+  d->range = 200 - (int)(i / 50) % 200;
+  d->avg_wh = 120 + (int)(i / 20) % 30;
+  d->avg_kmh = 40 + (int)(i / 40) % 20;
+  d->trip = (int)(i / 10);
+  d->odo = 12000 + (int)(i / 10);
+  d->motor_temp = 40 + (int)(i / 100) % 30;
+  d->battery_temp = 30 + (int)(i / 150) % 20;
+}
+
+/* For the objects which invalidated something in this frame: how much of
+ * their last invalidated area changed on the panel */
+static void count_changes(const lv_refr_heatmap_obj_t *o, uint32_t cnt, const uint16_t *prev) {
+  const uint16_t *fb = host_display_get_framebuffer();
+  for (uint32_t i = 0; i < cnt; i++) {
+    if (o[i].inv_cnt == extra[i].inv_cnt) continue;
+    extra[i].inv_cnt = o[i].inv_cnt;
+
+    const lv_area_t *a = &o[i].last_area;
+    for (int32_t y = a->y1; y <= a->y2; y++) {
+      for (int32_t x = a->x1; x <= a->x2; x++) {
+        uint32_t p = y * DASHBOARD_HOR_RES + x;
+        extra[i].changed_px += fb[p] != prev[p];
+      }
+    }
+    extra[i].checked_px += lv_area_get_size(a);
+  }
+}
+
+static void print_report(const lv_refr_heatmap_obj_t *o, uint32_t cnt, uint32_t frames, uint32_t top) {
+  std::vector<uint32_t> order(cnt);
+  for (uint32_t i = 0; i < cnt; i++) order[i] = i;
+  std::sort(order.begin(), order.end(), [o](uint32_t a, uint32_t b) { return o[a].inv_px > o[b].inv_px; });
+
+  printf("%-34s %9s %11s %8s  %s\n", "object (last area)", "inv/frame", "px/frame", "changed", "reasons");
+  for (uint32_t k = 0; k < cnt && k < top; k++) {
+    uint32_t i = order[k];
+    char name[64];
+    describe(&o[i], name, sizeof(name));
+
+    char changed[16] = "-";
+    if (extra[i].checked_px) {
+      snprintf(changed, sizeof(changed), "%.1f%%", 100.0 * extra[i].changed_px / extra[i].checked_px);
+    }
+
+    char reasons[128] = "";
+    size_t len = 0;
+    for (int r = 0; r < _LV_INV_REASON_LAST; r++) {
+      if (o[i].reason_cnt[r] == 0 || len >= sizeof(reasons)) continue;
+      len += snprintf(reasons + len, sizeof(reasons) - len, "%s%s %u", len ? ", " : "",
+                      lv_refr_heatmap_reason_to_str((lv_inv_reason_t)r), (unsigned)o[i].reason_cnt[r]);
+    }
+
+    printf("%-34s %9.2f %11.0f %8s  %s\n", name, (double)o[i].inv_cnt / frames, (double)o[i].inv_px / frames,
+           changed, reasons);
+  }
+}
+
+/* The class, the text of labels, and where it was last invalidated */
+static void describe(const lv_refr_heatmap_obj_t *o, char *buf, size_t size) {
+  const lv_area_t *a = &o->last_area;
+  if (o->obj == NULL) {
+    snprintf(buf, size, "(display) %d,%d %dx%d", (int)a->x1, (int)a->y1, (int)lv_area_get_width(a),
+             (int)lv_area_get_height(a));
+    return;
+  }
+
+  char text[16] = "";
+  if (o->class_p == &lv_label_class && lv_obj_is_valid(o->obj)) {
+    snprintf(text, sizeof(text), " \"%.10s\"", lv_label_get_text(o->obj));
+  }
+  snprintf(buf, size, "%s%s %d,%d %dx%d", o->class_p->name ? o->class_p->name : "obj", text, (int)a->x1,
+           (int)a->y1, (int)lv_area_get_width(a), (int)lv_area_get_height(a));
+}
+
+/* Black for never drawn, then blue, green, yellow, red, relative to the most
+ * drawn pixel */
+static bool save_heatmap(const char *path, const std::vector<uint32_t> &heat) {
+  FILE *f = fopen(path, "wb");
+  if (f == NULL) return false;
+
+  uint32_t max = *std::max_element(heat.begin(), heat.end());
+  static const uint8_t ramp[5][3] = {{0, 0, 0}, {0, 0, 255}, {0, 255, 0}, {255, 255, 0}, {255, 0, 0}};
+
+  fprintf(f, "P6\n%d %d\n255\n", DASHBOARD_HOR_RES, DASHBOARD_VER_RES);
+  std::vector<uint8_t> rgb(SCREEN_PX * 3);
+  for (uint32_t p = 0; p < SCREEN_PX; p++) {
+    uint8_t *c = &rgb[p * 3];
+    if (heat[p] == 0 || max == 0) {
+      c[0] = c[1] = c[2] = 0;
+      continue;
+    }
+    /* 1..max onto the ramp after black */
+    double v = 1 + 3.0 * (heat[p] - 1) / (max > 1 ? max - 1 : 1);
+    int k = v >= 4 ? 3 : (int)v;
+    double t = v - k;
+    for (int ch = 0; ch < 3; ch++) c[ch] = (uint8_t)(ramp[k][ch] + t * (ramp[k + 1 < 5 ? k + 1 : 4][ch] - ramp[k][ch]));
+  }
+  size_t n = fwrite(rgb.data(), 1, rgb.size(), f);
+  return fclose(f) == 0 && n == rgb.size();
+}
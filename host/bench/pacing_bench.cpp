@@ -0,0 +1,255 @@
+/**
+ * @file pacing_bench.cpp
+ *
+ * The fixed refresh period (LV_DEF_REFR_PERIOD, or a short one) against the
+ * adaptive one of `lv_display_set_pacing()`, on the real clock with the
+ * simulated DMA link of the board.
+ *
+ * Two workloads: the dashboard getting telemetry at 50 Hz, and the same with
+ * the whole screen redrawn every 10 ms like a full screen animation, which
+ * needs more time on the bus than the refresh period gives it.
+ *
+ * Reported per run: the refreshes per second, the CPU time refreshing, the
+ * time LVGL waited for the link, the latency from a telemetry update until
+ * it was on the panel (the LVGL latency monitor), and with the adaptive
+ * period its state at the end.
+ *
+ * The host renders many times faster than the ESP32; -c stretches the
+ * rendering of every refresh by spinning.
+ *
+ * Usage: pacing_bench [-t seconds_per_run] [-c cpu_slowdown] [-b bytes_per_s] [-f flush_us]
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "dashboard.h"
+#include "host_display.h"
+#include "telemetry.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TELEMETRY_PERIOD 20  /* ms, 50 Hz */
+#define ANIM_PERIOD      10  /* ms */
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+  const char *name;
+  uint32_t period;  // fixed period in ms, 0: adaptive
+} mode_dsc_t;
+
+typedef enum {
+  WORK_DRIVE,
+  WORK_ANIM,
+  WORK_CNT
+} work_t;
+
+typedef struct {
+  uint32_t refreshes;
+  double refr_us;   // wall time in refreshes, with the spinning
+  double wait_us;   // of that waiting for a buffer
+} measured_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void run(lv_display_t *disp, const mode_dsc_t *mode, work_t work, double seconds);
+static void telemetry_cb(lv_timer_t *t);
+static void anim_cb(lv_timer_t *t);
+static void refr_event_cb(lv_event_t *e);
+static uint32_t real_tick(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const mode_dsc_t modes[] = {
+    {"fixed 33 ms", LV_DEF_REFR_PERIOD},
+    {"fixed 5 ms", 5},
+    {"adaptive", 0},
+};
+static const char *work_names[WORK_CNT] = {"telemetry 50 Hz", "+ full screen anim"};
+
+/* 5 ... 100 ms, refreshing takes at most half of the CPU */
+static const lv_display_pacing_t pacing = {5, 100, 50};
+
+static double cpu_slowdown = 20;
+static telemetry_data_t dash;
+static uint32_t frame_i;
+static measured_t measured;
+static double t_refr_start;
+static double t_render_start;
+static double t_wait_start;
+static double waited_us;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char **argv) {
+  host_link_config_t link;
+  memset(&link, 0, sizeof(link));
+  link.bytes_per_s = 5000000;
+  link.flush_us = 20;
+  link.dma = true;
+  link.double_buffered = true;
+  double seconds = 3;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+      seconds = atof(argv[++i]);
+    } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+      cpu_slowdown = atof(argv[++i]);
+    } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+      link.bytes_per_s = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+      link.flush_us = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else {
+      fprintf(stderr, "usage: %s [-t seconds_per_run] [-c cpu_slowdown] [-b bytes_per_s] [-f flush_us]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (seconds <= 0 || cpu_slowdown < 1 || link.bytes_per_s == 0) return 1;
+
+  lv_init();
+  lv_display_t *disp = host_display_create_link(&link);
+  lv_tick_set_cb(real_tick);
+  lv_display_add_event_cb(disp, refr_event_cb, LV_EVENT_ALL, NULL);
+
+  create_ev_dashboard_ui();
+  telemetry_data_init(&dash);
+  update_dashboard(&dash);
+  lv_refr_now(disp);
+
+  printf("link: %.1f MB/s, %u us per flush; rendering %.0fx slower; %.1f s per run\n",
+         link.bytes_per_s / 1e6, (unsigned)link.flush_us, cpu_slowdown, seconds);
+  printf("adaptive: %u ... %u ms, %u%% CPU budget\n\n", (unsigned)pacing.min_period, (unsigned)pacing.max_period,
+         (unsigned)pacing.cpu_budget);
+  printf("%-19s %-12s %8s %8s %9s %10s %10s   %s\n", "workload", "period", "refr/s", "CPU [%]", "wait [%]",
+         "lag [ms]", "p95 [ms]", "adaptive state");
+
+  for (int w = 0; w < WORK_CNT; w++) {
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+      printf("%-19s ", m == 0 ? work_names[w] : "");
+      run(disp, &modes[m], (work_t)w, seconds);
+    }
+    printf("\n");
+  }
+
+  host_display_delete(disp);
+  lv_deinit();
+  return 0;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void run(lv_display_t *disp, const mode_dsc_t *mode, work_t work, double seconds) {
+  lv_display_set_pacing(disp, NULL);
+  if (mode->period) {
+    lv_timer_set_period(lv_display_get_refr_timer(disp), mode->period);
+  } else {
+    lv_display_set_pacing(disp, &pacing);
+  }
+
+  lv_timer_t *telemetry_timer = lv_timer_create(telemetry_cb, TELEMETRY_PERIOD, NULL);
+  lv_timer_t *anim_timer = work == WORK_ANIM ? lv_timer_create(anim_cb, ANIM_PERIOD, NULL) : NULL;
+
+  host_link_wait();
+  host_link_reset_stats();
+  lv_sysmon_latency_reset();
+  memset(&measured, 0, sizeof(measured));
+
+  double t0 = host_wall_us();
+  double t_end = t0 + seconds * 1e6;
+  while (host_wall_us() < t_end) {
+    uint32_t idle_ms = lv_timer_handler();
+    if (idle_ms) std::this_thread::sleep_for(std::chrono::milliseconds(idle_ms < 1 ? idle_ms : 1));
+  }
+  double t = host_wall_us() - t0;
+
+  lv_timer_delete(telemetry_timer);
+  if (anim_timer) lv_timer_delete(anim_timer);
+  host_link_wait();
+
+  lv_sysmon_latency_t lat;
+  lv_sysmon_get_latency(&lat);
+  const host_link_stats_t *st = host_link_get_stats();
+
+  char state[96] = "-";
+  const lv_display_pacing_state_t *ps = lv_display_get_pacing(disp);
+  if (ps) {
+    snprintf(state, sizeof(state), "%u ms, refr %u us, bus %u us%s, %u overruns", (unsigned)ps->period,
+             (unsigned)ps->cost_avg_us, (unsigned)ps->bus_avg_us, ps->saturated ? " (saturated)" : "",
+             (unsigned)ps->overruns);
+  }
+
+  printf("%-12s %8.1f %8.1f %9.1f %10u %10u   %s\n", mode->name, measured.refreshes * 1e6 / t,
+         100 * measured.refr_us / t, 100 * st->wait_us / t, (unsigned)lat.flush.avg, (unsigned)lat.flush.p95, state);
+}
+
+/* A drive: the speed changes every frame, the rest now and then */
+static void telemetry_cb(lv_timer_t *t) {
+  LV_UNUSED(t);
+  uint32_t i = frame_i++;
+  dash.speed = (int)((i * 7) % 120);
+  dash.range = 200 - (int)(i / 50) % 200;
+  dash.avg_wh = 120 + (int)(i / 20) % 30;
+  dash.avg_kmh = 40 + (int)(i / 40) % 20;
+  dash.trip = (int)(i / 10);
+  dash.odo = 12000 + (int)(i / 10);
+  dash.motor_temp = 40 + (int)(i / 100) % 30;
+  dash.battery_temp = 30 + (int)(i / 150) % 20;
+  if (update_dashboard(&dash)) lv_sysmon_latency_input(lv_tick_get());
+}
+
+static void anim_cb(lv_timer_t *t) {
+  LV_UNUSED(t);
+  lv_obj_invalidate(lv_screen_active());
+}
+
+/* Measure the refreshes, and spin for (slowdown - 1) times the rendering
+ * without the waits for the link */
+static void refr_event_cb(lv_event_t *e) {
+  double now = host_wall_us();
+  switch (lv_event_get_code(e)) {
+    case LV_EVENT_REFR_START:
+      t_refr_start = now;
+      break;
+    case LV_EVENT_RENDER_START:
+      t_render_start = now;
+      waited_us = 0;
+      break;
+    case LV_EVENT_FLUSH_WAIT_START:
+      t_wait_start = now;
+      break;
+    case LV_EVENT_FLUSH_WAIT_FINISH:
+      waited_us += now - t_wait_start;
+      break;
+    case LV_EVENT_RENDER_READY: {
+      double t_spin_end = now + (now - t_render_start - waited_us) * (cpu_slowdown - 1);
+      while (host_wall_us() < t_spin_end) {}
+      measured.refreshes++;
+      break;
+    }
+    case LV_EVENT_REFR_READY:
+      measured.refr_us += now - t_refr_start;
+      measured.wait_us += waited_us;
+      waited_us = 0;
+      break;
+    default:
+      break;
+  }
+}
+
+static uint32_t real_tick(void) {
+  return (uint32_t)(host_wall_us() / 1000);
+}
@@ -0,0 +1,197 @@
+/**
+ * @file render_cache_bench.cpp
+ *
+ * Runs the dashboard with and without a render cache on its top bar
+ * (LV_OBJ_RENDER_CACHE_SIZE, `LV_OBJ_FLAG_RENDER_CACHE`): the bar is
+ * rendered once into a buffer and drawn from it until something in it
+ * changes, e.g. the clock. The dashboard itself doesn't set the flag, the
+ * bench adds it.
+ *
+ * Two runs per setting:
+ *   - drive: the dashboard update stream
+ *   - full:  the same, with the whole screen redrawn every frame
+ *
+ * Reported per frame: the render time, the blended pixels (the refresh
+ * heatmap's count) and the subtrees rendered into and drawn from a cache
+ * (`lv_obj_get_render_cache_stats()`). Then the bytes held by the caches and
+ * the LVGL heap used at the end.
+ *
+ * Every 10th frame the panel content with and without the caches is
+ * compared. Only opaque subtrees are cached, so it has to be the same (the
+ * exit code says if it was).
+ *
+ * Usage: render_cache_bench [-n frames]
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "dashboard.h"
+#include "host_display.h"
+#include "telemetry.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if LV_OBJ_RENDER_CACHE_SIZE
+
+/*********************
+ *      DEFINES
+ *********************/
+#define COMPARE_PERIOD 10
+#define SCREEN_PX      (DASHBOARD_HOR_RES * DASHBOARD_VER_RES)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+  double frame_us;
+  double blended_px;
+  double renders;
+  double hits;
+  uint32_t drops;
+  uint32_t skips;
+  uint32_t cache_size;
+  uint32_t heap_used;
+} result_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void run(bool cache, bool full, uint32_t frames, result_t *res, std::vector<uint16_t> *screens);
+static void make_frame(uint32_t i, telemetry_data_t *d);
+static uint32_t channel_diff(uint16_t a, uint16_t b);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char **argv) {
+  uint32_t frames = 1000;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      frames = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else {
+      fprintf(stderr, "usage: %s [-n frames]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (frames == 0) return 1;
+
+  lv_init();
+
+  printf("%u frames of the dashboard, %d byte render cache limit\n\n", (unsigned)frames, LV_OBJ_RENDER_CACHE_SIZE);
+  printf("%-6s %-6s %10s %12s %8s %8s %6s %6s %12s %10s\n", "run", "cache", "frame [us]", "blended px", "renders",
+         "hits", "drops", "skips", "cached [B]", "heap [B]");
+  uint64_t diff_px = 0;
+  uint32_t max_diff = 0;
+  for (int full = 0; full < 2; full++) {
+    result_t res[2];
+    std::vector<uint16_t> screens[2];
+    run(false, full, frames, &res[0], &screens[0]);
+    run(true, full, frames, &res[1], &screens[1]);
+    for (size_t i = 0; i < screens[0].size(); i++) {
+      uint32_t d = channel_diff(screens[0][i], screens[1][i]);
+      if (d) diff_px++;
+      if (d > max_diff) max_diff = d;
+    }
+
+    for (int m = 0; m < 2; m++) {
+      printf("%-6s %-6s %10.1f %12.0f %8.3f %8.3f %6u %6u %12u %10u\n", m ? "" : full ? "full" : "drive",
+             m ? "on" : "off", res[m].frame_us, res[m].blended_px, res[m].renders, res[m].hits,
+             (unsigned)res[m].drops, (unsigned)res[m].skips, (unsigned)res[m].cache_size,
+             (unsigned)res[m].heap_used);
+    }
+  }
+  printf("\n%llu different pixels in the compared frames, at most %u step(s) in a channel\n",
+         (unsigned long long)diff_px, (unsigned)max_diff);
+
+  bool freed = lv_obj_get_render_cache_stats()->size == 0;
+  if (!freed) printf("%u bytes of caches left after deleting the display\n", (unsigned)lv_obj_get_render_cache_stats()->size);
+
+  lv_deinit();
+  return diff_px == 0 && freed ? 0 : 1;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void run(bool cache, bool full, uint32_t frames, result_t *res, std::vector<uint16_t> *screens) {
+  lv_display_t *disp = host_display_create();
+  host_tick_set(0);
+
+  create_ev_dashboard_ui();
+  /* The top bar is the first child of the screen */
+  if (cache) lv_obj_add_flag(lv_obj_get_child(lv_screen_active(), 0), LV_OBJ_FLAG_RENDER_CACHE);
+  telemetry_data_t d;
+  telemetry_data_init(&d);
+  update_dashboard(&d);
+  lv_refr_now(disp);
+  lv_refr_heatmap_enable(disp, NULL, NULL, 0);
+  lv_obj_reset_render_cache_stats();
+
+  memset(res, 0, sizeof(*res));
+  double frame_us = 0;
+  for (uint32_t i = 0; i < frames; i++) {
+    host_tick_inc(LV_DEF_REFR_PERIOD);
+    make_frame(i, &d);
+    update_dashboard(&d);
+    update_time_display(host_tick_get());
+    if (full) lv_obj_invalidate(lv_screen_active());
+
+    double t0 = host_wall_us();
+    lv_refr_now(disp);
+    frame_us += host_wall_us() - t0;
+    if (i % COMPARE_PERIOD == 0) {
+      const uint16_t *fb = host_display_get_framebuffer();
+      screens->insert(screens->end(), fb, fb + SCREEN_PX);
+    }
+  }
+
+  const lv_obj_render_cache_stats_t *st = lv_obj_get_render_cache_stats();
+  res->frame_us = frame_us / frames;
+  res->blended_px = (double)lv_refr_heatmap_get_stats(disp)->blended_px / frames;
+  res->renders = (double)st->render_cnt / frames;
+  res->hits = (double)st->hit_cnt / frames;
+  res->drops = st->drop_cnt;
+  res->skips = st->skip_cnt;
+  res->cache_size = st->size;
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  res->heap_used = mon.total_size - mon.free_size;
+
+  lv_refr_heatmap_disable(disp);
+  host_display_delete(disp);
+}
+
+/* A drive: the speed changes every frame, the rest now and then */
+static void make_frame(uint32_t i, telemetry_data_t *d) {
+  d->speed = (int)((i * 7) % 120);
+  d->range = 200 - (int)(i / 50) % 200;
+  d->avg_wh = 120 + (int)(i / 20) % 30;
+  d->avg_kmh = 40 + (int)(i / 40) % 20;
+  d->trip = (int)(i / 10);
+  d->odo = 12000 + (int)(i / 10);
+  d->motor_temp = 40 + (int)(i / 100) % 30;
+  d->battery_temp = 30 + (int)(i / 150) % 20;
+}
+
+/* The largest difference of the red, green and blue channels of two RGB565 pixels */
+static uint32_t channel_diff(uint16_t a, uint16_t b) {
+  int32_t r = abs((a >> 11) - (b >> 11));
+  int32_t g = abs(((a >> 5) & 0x3f) - ((b >> 5) & 0x3f));
+  int32_t bl = abs((a & 0x1f) - (b & 0x1f));
+  return (uint32_t)LV_MAX(r, LV_MAX(g, bl));
+}
+
+#else
+
+int main(void) {
+  printf("LV_OBJ_RENDER_CACHE_SIZE is 0 in this build\n");
+  return 0;
+}
+
+#endif /*LV_OBJ_RENDER_CACHE_SIZE*/
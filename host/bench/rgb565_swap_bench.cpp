@@ -0,0 +1,208 @@
+/**
+ * @file rgb565_swap_bench.cpp
+ *
+ * The panel takes RGB565 high byte first, LVGL renders it low byte first on
+ * the ESP32. Three ways to get the bytes in order:
+ *   - swap at flush:  `pushColors(px_map, n, true)`, swapping every pixel while
+ *                     it's written to the SPI FIFO
+ *   - swap pass:      `lv_draw_sw_rgb565_swap()` over the buffer, then sending
+ *                     it as is (what pushImageDMA() does with setSwapBytes)
+ *   - native swapped: rendering in LV_COLOR_FORMAT_RGB565_SWAPPED and sending
+ *                     the buffer as is
+ *
+ * Every flush copies the area into a FIFO-sized transmit buffer, like the SPI
+ * driver does; only the swapping differs. Reported is the time per frame spent
+ * rendering and flushing. The words sent are hashed, and all three have to
+ * send the same bytes (the exit code says if they did).
+ *
+ * Two workloads: full screen redraws, and dashboard updates from generated
+ * telemetry.
+ *
+ * Usage: rgb565_swap_bench [-n frames]
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "dashboard.h"
+#include "host_display.h"
+#include "telemetry.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/*********************
+ *      DEFINES
+ *********************/
+/* 64 bytes of ESP32 SPI FIFO */
+#define FIFO_PX 32
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+  MODE_SWAP_AT_FLUSH,
+  MODE_SWAP_PASS,
+  MODE_NATIVE_SWAPPED,
+  MODE_CNT
+} mode_t_;
+
+typedef enum {
+  WORK_FULL,
+  WORK_DRIVE,
+  WORK_CNT
+} work_t;
+
+typedef struct {
+  double frame_us;
+  double flush_us;
+  uint64_t px;
+  uint32_t hash;
+} result_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void run(mode_t_ mode, work_t work, uint32_t frames, result_t *res);
+static void make_frame(uint32_t i, telemetry_data_t *d);
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map);
+static void send(const uint32_t *fifo, uint32_t n);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const char *mode_names[MODE_CNT] = {"swap at flush", "swap pass", "native swapped"};
+static const char *work_names[WORK_CNT] = {"full screen", "dashboard updates"};
+
+static mode_t_ cur_mode;
+static double flush_us;
+static uint64_t flushed_px;
+static uint32_t hash;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char **argv) {
+  uint32_t frames = 300;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      frames = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else {
+      fprintf(stderr, "usage: %s [-n frames]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (frames == 0) return 1;
+
+  lv_init();
+
+  printf("%u frames per run\n\n", (unsigned)frames);
+  printf("%-18s %-15s %10s %10s %10s %9s\n", "workload", "mode", "frame [us]", "flush [us]", "px/frame", "hash");
+
+  bool same = true;
+  for (int w = 0; w < WORK_CNT; w++) {
+    result_t res[MODE_CNT];
+    for (int m = 0; m < MODE_CNT; m++) {
+      run((mode_t_)m, (work_t)w, frames, &res[m]);
+      printf("%-18s %-15s %10.1f %10.1f %10.0f %08x\n", m == 0 ? work_names[w] : "", mode_names[m],
+             res[m].frame_us, res[m].flush_us, (double)res[m].px / frames, (unsigned)res[m].hash);
+      if (res[m].hash != res[0].hash) same = false;
+    }
+    printf("%-18s native swapped saves %.1f us/frame against swap at flush, %.1f us against swap pass\n\n", "",
+           res[MODE_SWAP_AT_FLUSH].frame_us - res[MODE_NATIVE_SWAPPED].frame_us,
+           res[MODE_SWAP_PASS].frame_us - res[MODE_NATIVE_SWAPPED].frame_us);
+  }
+
+  if (!same) printf("ERROR: the modes sent different pixels\n");
+
+  lv_deinit();
+  return same ? 0 : 1;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void run(mode_t_ mode, work_t work, uint32_t frames, result_t *res) {
+  lv_display_t *disp = host_display_create();
+  lv_display_set_flush_cb(disp, flush_cb);
+  if (mode == MODE_NATIVE_SWAPPED) lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+  cur_mode = mode;
+
+  create_ev_dashboard_ui();
+  telemetry_data_t d;
+  telemetry_data_init(&d);
+  update_dashboard(&d);
+  lv_refr_now(disp);
+
+  flush_us = 0;
+  flushed_px = 0;
+  hash = 2166136261u;
+
+  double t0 = host_wall_us();
+  for (uint32_t i = 0; i < frames; i++) {
+    host_tick_inc(LV_DEF_REFR_PERIOD);
+    if (work == WORK_FULL) {
+      lv_obj_invalidate(lv_screen_active());
+    } else {
+      make_frame(i, &d);
+      update_dashboard(&d);
+    }
+    lv_refr_now(disp);
+  }
+  double t = host_wall_us() - t0;
+
+  res->frame_us = t / frames;
+  res->flush_us = flush_us / frames;
+  res->px = flushed_px;
+  res->hash = hash;
+
+  host_display_delete(disp);
+}
+
+/* A drive: the speed changes every frame, the rest now and then */
+static void make_frame(uint32_t i, telemetry_data_t *d) {
+  d->speed = (int)((i * 7) % 120);
+  d->range = 200 - (int)(i / 50) % 200;
+  d->avg_wh = 120 + (int)(i / 20) % 30;
+  d->avg_kmh = 40 + (int)(i / 40) % 20;
+  d->trip = (int)(i / 10);
+  d->odo = 12000 + (int)(i / 10);
+  d->motor_temp = 40 + (int)(i / 100) % 30;
+  d->battery_temp = 30 + (int)(i / 150) % 20;
+}
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map) {
+  double t0 = host_wall_us();
+  uint32_t n = (uint32_t)lv_area_get_size(area);
+
+  if (cur_mode == MODE_SWAP_PASS) lv_draw_sw_rgb565_swap(px_map, n);
+
+  const uint16_t *px = (const uint16_t *)px_map;
+  uint32_t fifo32[FIFO_PX / 2];
+  uint16_t *fifo = (uint16_t *)fifo32;
+  for (uint32_t i = 0; i < n; i += FIFO_PX) {
+    uint32_t len = n - i < FIFO_PX ? n - i : FIFO_PX;
+    if (len & 1) fifo[len] = 0;
+    if (cur_mode == MODE_SWAP_AT_FLUSH) {
+      for (uint32_t j = 0; j < len; j++) fifo[j] = (uint16_t)((px[i + j] >> 8) | (px[i + j] << 8));
+    } else {
+      memcpy(fifo, &px[i], len * sizeof(uint16_t));
+    }
+    send(fifo32, (len + 1) / 2);
+  }
+
+  flushed_px += n;
+  flush_us += host_wall_us() - t0;
+  lv_display_flush_ready(disp);
+}
+
+/* Stands in for writing the FIFO registers: a hash of the words in the order
+ * they go out, the same work in every mode */
+static void send(const uint32_t *fifo, uint32_t n) {
+  uint32_t h = hash;
+  for (uint32_t i = 0; i < n; i++) h = h * 31 + fifo[i];
+  hash = h;
+}
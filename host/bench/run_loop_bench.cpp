@@ -0,0 +1,227 @@
+/**
+ * @file run_loop_bench.cpp
+ *
+ * Compare the tickless run loop (src/run_loop.cpp) with the old
+ * `lv_timer_handler(); delay(5);` loop on the real clock:
+ *   - timers:  how late periodic LVGL timers run
+ *   - wakeup:  time from another thread signaling new input until a timer
+ *              handles it (the old loop polls like the telemetry drain timer)
+ *   - idle:    CPU use and loop iterations with only the dashboard clock running
+ *
+ * Usage: run_loop_bench [-t seconds_per_phase]
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "dashboard.h"
+#include "host_display.h"
+#include "run_loop.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <time.h>
+#include <vector>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define LEGACY_DELAY_US 5000
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+  uint32_t period;
+  double prev_us;
+  std::vector<double> *late_us;
+} periodic_t;
+
+typedef struct {
+  double late_avg, late_p99, late_max;
+  double wake_avg, wake_p99, wake_max;
+  double idle_cpu, idle_iter;
+} result_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void run_phase(bool tickless, double seconds, uint32_t *iterations);
+static void periodic_cb(lv_timer_t *t);
+static void wake_timer_cb(lv_timer_t *t);
+static void clock_cb(lv_timer_t *t);
+static void summarize(std::vector<double> v, double *avg, double *p99, double *max);
+static uint32_t real_tick(void);
+static double now_us(void);
+static double cpu_us(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static run_loop_t loop;
+static std::atomic<double> signal_us;
+static std::vector<double> wake_us;
+static bool tickless_wake;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char **argv) {
+  double seconds = 2;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+      seconds = atof(argv[++i]);
+    } else {
+      fprintf(stderr, "usage: %s [-t seconds_per_phase]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  lv_init();
+  lv_display_t *disp = host_display_create();
+  lv_tick_set_cb(real_tick);
+  create_ev_dashboard_ui();
+  lv_refr_now(disp);
+  run_loop_init(&loop, 1000);
+
+  result_t res[2];
+  for (int mode = 0; mode < 2; mode++) {
+    bool tickless = mode == 1;
+    result_t *r = &res[mode];
+    uint32_t iterations;
+
+    /* Timers */
+    std::vector<double> late;
+    static const uint32_t periods[] = {7, 13, 29};
+    periodic_t per[3];
+    lv_timer_t *timers[3];
+    for (int i = 0; i < 3; i++) {
+      per[i].period = periods[i];
+      per[i].prev_us = 0;
+      per[i].late_us = &late;
+      timers[i] = lv_timer_create(periodic_cb, periods[i], &per[i]);
+    }
+    run_phase(tickless, seconds, &iterations);
+    for (int i = 0; i < 3; i++) lv_timer_delete(timers[i]);
+    summarize(late, &r->late_avg, &r->late_p99, &r->late_max);
+
+    /* Wakeup */
+    wake_us.clear();
+    signal_us = 0;
+    tickless_wake = tickless;
+    lv_timer_t *wake_timer = lv_timer_create(wake_timer_cb, LV_DEF_REFR_PERIOD, NULL);
+    run_loop_set_wake_timer(&loop, tickless ? wake_timer : NULL);
+
+    std::atomic<bool> stop(false);
+    std::thread producer([&]() {
+      uint32_t rand = 1;
+      while (!stop) {
+        rand = rand * 1103515245 + 12345;
+        std::this_thread::sleep_for(std::chrono::microseconds(2000 + (rand >> 16) % 18000));
+        /* Latency counts from the oldest input not handled yet */
+        double none = 0;
+        signal_us.compare_exchange_strong(none, now_us());
+        if (tickless) run_loop_wake(&loop);
+      }
+    });
+    run_phase(tickless, seconds, &iterations);
+    stop = true;
+    producer.join();
+    lv_timer_delete(wake_timer);
+    run_loop_set_wake_timer(&loop, NULL);
+    summarize(wake_us, &r->wake_avg, &r->wake_p99, &r->wake_max);
+
+    /* Idle */
+    lv_timer_t *clock = lv_timer_create(clock_cb, 1000, NULL);
+    double cpu0 = cpu_us();
+    double t0 = now_us();
+    run_phase(tickless, seconds, &iterations);
+    r->idle_cpu = 100 * (cpu_us() - cpu0) / (now_us() - t0);
+    r->idle_iter = iterations / seconds;
+    lv_timer_delete(clock);
+  }
+
+  printf("                      delay(%d ms) loop    run_loop\n", LEGACY_DELAY_US / 1000);
+  printf("timer late avg [us]   %16.0f %11.0f\n", res[0].late_avg, res[1].late_avg);
+  printf("timer late p99 [us]   %16.0f %11.0f\n", res[0].late_p99, res[1].late_p99);
+  printf("timer late max [us]   %16.0f %11.0f\n", res[0].late_max, res[1].late_max);
+  printf("wakeup avg [us]       %16.0f %11.0f\n", res[0].wake_avg, res[1].wake_avg);
+  printf("wakeup p99 [us]       %16.0f %11.0f\n", res[0].wake_p99, res[1].wake_p99);
+  printf("wakeup max [us]       %16.0f %11.0f\n", res[0].wake_max, res[1].wake_max);
+  printf("idle CPU [%%]          %16.3f %11.3f\n", res[0].idle_cpu, res[1].idle_cpu);
+  printf("idle iterations [1/s] %16.1f %11.1f\n", res[0].idle_iter, res[1].idle_iter);
+
+  run_loop_deinit(&loop);
+  lv_deinit();
+  return 0;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void run_phase(bool tickless, double seconds, uint32_t *iterations) {
+  double t_end = now_us() + seconds * 1e6;
+  *iterations = 0;
+  while (now_us() < t_end) {
+    if (tickless) {
+      run_loop_step(&loop);
+    } else {
+      lv_timer_handler();
+      std::this_thread::sleep_for(std::chrono::microseconds(LEGACY_DELAY_US));
+    }
+    (*iterations)++;
+  }
+}
+
+/* How much later than one period after its previous run the timer runs */
+static void periodic_cb(lv_timer_t *t) {
+  periodic_t *per = (periodic_t *)lv_timer_get_user_data(t);
+  double now = now_us();
+  if (per->prev_us > 0) per->late_us->push_back(now - per->prev_us - per->period * 1000.0);
+  per->prev_us = now;
+}
+
+/* Handle the input signaled by the producer thread, like the telemetry drain timer */
+static void wake_timer_cb(lv_timer_t *t) {
+  double sig = signal_us.exchange(0);
+  if (sig > 0) wake_us.push_back(now_us() - sig);
+  else if (tickless_wake) lv_timer_pause(t);
+}
+
+static void clock_cb(lv_timer_t *t) {
+  LV_UNUSED(t);
+  update_time_display(lv_tick_get());
+}
+
+static void summarize(std::vector<double> v, double *avg, double *p99, double *max) {
+  *avg = *p99 = *max = 0;
+  if (v.empty()) return;
+
+  std::sort(v.begin(), v.end());
+  double sum = 0;
+  for (double x : v) sum += x;
+  *avg = sum / v.size();
+  *p99 = v[(size_t)(0.99 * (v.size() - 1) + 0.5)];
+  *max = v.back();
+}
+
+static uint32_t real_tick(void) {
+  return (uint32_t)(now_us() / 1000);
+}
+
+static double now_us(void) {
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static double cpu_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
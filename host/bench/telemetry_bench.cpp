@@ -0,0 +1,208 @@
+/**
+ * @file telemetry_bench.cpp
+ *
+ * Compares the telemetry decoders in frames per second:
+ *  - legacy: the old String based parser (indexOf/substring/toInt per field),
+ *            reproduced with std::string so it allocates like Arduino String
+ *  - ascii:  `key:value` lines through the telemetry ring buffer
+ *  - binary: binary frames through the telemetry ring buffer
+ *
+ * Usage: telemetry_bench [frame_count]
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "telemetry.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define CHUNK_SIZE 64   /* bytes handed to the decoder per Serial read */
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void make_sample(uint32_t *seed, telemetry_data_t *d);
+static bool same_data(const telemetry_data_t *a, const telemetry_data_t *b);
+static void legacy_parse(const std::string &input, telemetry_data_t *d);
+static double now_s(void);
+static void report(const char *name, size_t frames, size_t bytes, double sec);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char **argv) {
+  size_t frame_cnt = argc > 1 ? strtoul(argv[1], NULL, 10) : 200000;
+  static const char *modes[] = {"Eco", "Normal", "Sport"};
+
+  /* Build identical ASCII and binary streams */
+  std::vector<uint8_t> ascii_stream;
+  std::vector<uint8_t> bin_stream;
+  std::vector<telemetry_data_t> expected(frame_cnt);
+  uint32_t seed = 1;
+  for (size_t i = 0; i < frame_cnt; i++) {
+    telemetry_data_t *d = &expected[i];
+    make_sample(&seed, d);
+    strcpy(d->mode, modes[i % 3]);
+    strcpy(d->status, (i & 1) ? "ARMED" : "DISARMED");
+
+    char line[TELEMETRY_LINE_MAX];
+    int n = snprintf(line, sizeof(line),
+                     "speed:%d,range:%d,avg_wh:%d,trip:%d,odo:%d,avg_kmh:%d,motor:%d,battery:%d,mode:%s,status:%s\n",
+                     d->speed, d->range, d->avg_wh, d->trip, d->odo, d->avg_kmh,
+                     d->motor_temp, d->battery_temp, d->mode, d->status);
+    ascii_stream.insert(ascii_stream.end(), line, line + n);
+
+    uint8_t frame[TELEMETRY_FRAME_MAX];
+    size_t len = telemetry_encode_frame(d, TELEMETRY_FIELD_ALL, (uint16_t)i, frame, sizeof(frame));
+    bin_stream.insert(bin_stream.end(), frame, frame + len);
+  }
+
+  printf("%zu frames, %.1f B/frame ASCII, %.1f B/frame binary\n", frame_cnt,
+         (double)ascii_stream.size() / frame_cnt, (double)bin_stream.size() / frame_cnt);
+
+  /* Legacy: readStringUntil('\n') + String parsing */
+  {
+    telemetry_data_t d;
+    telemetry_data_init(&d);
+    size_t frames = 0;
+    double t0 = now_s();
+    const char *p = (const char *)ascii_stream.data();
+    const char *end = p + ascii_stream.size();
+    while (p < end) {
+      const char *nl = (const char *)memchr(p, '\n', (size_t)(end - p));
+      std::string input(p, nl);
+      legacy_parse(input, &d);
+      frames++;
+      p = nl + 1;
+    }
+    double t = now_s() - t0;
+    report("legacy", frames, ascii_stream.size(), t);
+    if (!same_data(&d, &expected[frame_cnt - 1])) printf("  legacy: MISMATCH\n");
+  }
+
+  /* Ring buffer decoder on both streams */
+  const std::vector<uint8_t> *streams[] = {&ascii_stream, &bin_stream};
+  const char *names[] = {"ascii", "binary"};
+  for (int s = 0; s < 2; s++) {
+    static telemetry_rx_t rx;
+    telemetry_rx_init(&rx);
+    telemetry_data_t d;
+    telemetry_data_init(&d);
+
+    size_t frames = 0;
+    size_t mismatch = 0;
+    const uint8_t *p = streams[s]->data();
+    size_t left = streams[s]->size();
+    double t0 = now_s();
+    while (left > 0) {
+      size_t n = left < CHUNK_SIZE ? left : CHUNK_SIZE;
+      n = telemetry_rx_push(&rx, p, n);
+      p += n;
+      left -= n;
+      while (telemetry_rx_poll(&rx, &d, NULL) != TELEMETRY_FORMAT_NONE) {
+        if (!same_data(&d, &expected[frames])) mismatch++;
+        frames++;
+      }
+    }
+    double t = now_s() - t0;
+    report(names[s], frames, streams[s]->size(), t);
+    if (mismatch || frames != frame_cnt) printf("  %s: %zu mismatches\n", names[s], mismatch);
+    if (rx.stats.crc_errors || rx.stats.overflows) {
+      printf("  %s: %u CRC errors, %u overflows\n", names[s], (unsigned)rx.stats.crc_errors,
+             (unsigned)rx.stats.overflows);
+    }
+  }
+
+  return 0;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void make_sample(uint32_t *seed, telemetry_data_t *d) {
+  int v[8];
+  for (int i = 0; i < 8; i++) {
+    *seed = *seed * 1664525u + 1013904223u;
+    v[i] = (int)((*seed >> 8) % 2000);
+  }
+  memset(d, 0, sizeof(*d));
+  d->speed = v[0] % 200;
+  d->range = v[1] % 400;
+  d->avg_wh = v[2] % 200;
+  d->trip = v[3];
+  d->odo = 10000 + v[4] * 7;
+  d->avg_kmh = v[5] % 120;
+  d->motor_temp = v[6] % 120 - 20;
+  d->battery_temp = v[7] % 80 - 20;
+}
+
+static bool same_data(const telemetry_data_t *a, const telemetry_data_t *b) {
+  return a->speed == b->speed && a->range == b->range && a->avg_wh == b->avg_wh && a->trip == b->trip &&
+         a->odo == b->odo && a->avg_kmh == b->avg_kmh && a->motor_temp == b->motor_temp &&
+         a->battery_temp == b->battery_temp && strcmp(a->mode, b->mode) == 0 &&
+         strcmp(a->status, b->status) == 0;
+}
+
+/* Mirrors the original parse_serial_input(String) */
+static int to_int(const std::string &s) {
+  return atoi(s.c_str());
+}
+
+static std::string trimmed(const std::string &s) {
+  size_t b = s.find_first_not_of(" \t\r\n");
+  size_t e = s.find_last_not_of(" \t\r\n");
+  return b == std::string::npos ? std::string() : s.substr(b, e - b + 1);
+}
+
+static void legacy_field(const std::string &input, const char *key, int *out) {
+  size_t idx = input.find(key);
+  if (idx == std::string::npos) return;
+  size_t comma_pos = input.find(',', idx);
+  if (comma_pos == std::string::npos) comma_pos = input.length();
+  size_t start = idx + strlen(key);
+  *out = to_int(input.substr(start, comma_pos - start));
+}
+
+static void legacy_field_str(const std::string &input, const char *key, char *out, size_t out_size) {
+  size_t idx = input.find(key);
+  if (idx == std::string::npos) return;
+  size_t comma_pos = input.find(',', idx);
+  if (comma_pos == std::string::npos) comma_pos = input.length();
+  size_t start = idx + strlen(key);
+  std::string v = trimmed(input.substr(start, comma_pos - start));
+  snprintf(out, out_size, "%s", v.c_str());
+}
+
+static void legacy_parse(const std::string &raw, telemetry_data_t *d) {
+  std::string input = trimmed(raw);
+  legacy_field(input, "speed:", &d->speed);
+  legacy_field(input, "range:", &d->range);
+  legacy_field(input, "avg_wh:", &d->avg_wh);
+  legacy_field(input, "trip:", &d->trip);
+  legacy_field(input, "odo:", &d->odo);
+  legacy_field(input, "avg_kmh:", &d->avg_kmh);
+  legacy_field(input, "motor:", &d->motor_temp);
+  legacy_field(input, "battery:", &d->battery_temp);
+  legacy_field_str(input, "mode:", d->mode, sizeof(d->mode));
+  legacy_field_str(input, "status:", d->status, sizeof(d->status));
+}
+
+static double now_s(void) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void report(const char *name, size_t frames, size_t bytes, double sec) {
+  printf("%-8s %10.0f frames/s  %8.1f MB/s  (%zu frames in %.3f s)\n", name, frames / sec,
+         bytes / sec / 1e6, frames, sec);
+}
@@ -0,0 +1,187 @@
+/**
+ * @file telemetry_ingest_stress.cpp
+ *
+ * Stress run of the telemetry reader task and its queue on the pthread OSAL.
+ *
+ * The reader task decodes generated binary frames handed out in random chunks
+ * as fast as it can, while the main thread drains the queue like the UI does
+ * once per refresh. Every frame is derived from its number, so each drained
+ * snapshot can be checked for torn or reordered records, and the last one has
+ * to be the last frame sent.
+ *
+ * Usage: telemetry_ingest_stress [-n frames] [-u drain_period_us] [-c max_chunk]
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "telemetry_ingest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+  uint32_t frame_cnt;
+  uint32_t drain_us;
+  uint32_t max_chunk;
+} options_t;
+
+typedef struct {
+  std::vector<uint8_t> bytes;
+  size_t pos;
+  uint32_t max_chunk;
+  uint32_t rand;
+} source_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool parse_args(int argc, char **argv, options_t *opt);
+static void make_frame(uint32_t i, telemetry_data_t *d);
+static bool check_frame(const telemetry_data_t *d);
+static size_t source_read_cb(void *user_data, uint8_t *buf, size_t max_len);
+static double now_s(void);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char **argv) {
+  options_t opt;
+  if (!parse_args(argc, argv, &opt)) {
+    fprintf(stderr, "usage: %s [-n frames] [-u drain_period_us] [-c max_chunk]\n", argv[0]);
+    return 1;
+  }
+
+  static source_t src;
+  src.pos = 0;
+  src.max_chunk = opt.max_chunk;
+  src.rand = 1;
+  for (uint32_t i = 0; i < opt.frame_cnt; i++) {
+    telemetry_data_t d;
+    make_frame(i, &d);
+    uint8_t frame[TELEMETRY_FRAME_MAX];
+    size_t n = telemetry_encode_frame(&d, TELEMETRY_FIELD_ALL, (uint16_t)i, frame, sizeof(frame));
+    src.bytes.insert(src.bytes.end(), frame, frame + n);
+  }
+
+  lv_init();
+
+  static telemetry_ingest_t ing;
+  telemetry_ingest_init(&ing, source_read_cb, &src);
+
+  double t0 = now_s();
+  if (telemetry_ingest_start(&ing, LV_THREAD_PRIO_MID) != LV_RESULT_OK) {
+    fprintf(stderr, "failed to start the reader task (LV_USE_OS?)\n");
+    return 1;
+  }
+
+  uint32_t errors = 0;
+  int32_t last = -1;
+  uint32_t drains = 0;
+  while (last != (int32_t)opt.frame_cnt - 1) {
+    if (opt.drain_us) std::this_thread::sleep_for(std::chrono::microseconds(opt.drain_us));
+
+    telemetry_data_t d;
+    uint16_t changed;
+    if (telemetry_ingest_drain(&ing, &d, &changed, NULL) == 0) continue;
+    drains++;
+
+    if (!check_frame(&d)) {
+      if (errors++ < 10) fprintf(stderr, "torn record after frame %d\n", (int)last);
+    } else if (d.trip <= last) {
+      if (errors++ < 10) fprintf(stderr, "frame %d after frame %d\n", d.trip, (int)last);
+    } else if (changed != TELEMETRY_FIELD_ALL) {
+      if (errors++ < 10) fprintf(stderr, "frame %d: changed 0x%x\n", d.trip, changed);
+    }
+    if (d.trip > last) last = d.trip;
+  }
+  double t = now_s() - t0;
+
+  telemetry_ingest_stop(&ing);
+
+  const telemetry_ingest_stats_t *st = &ing.stats;
+  printf("frames:             %u in %.3f s (%.0f frames/s)\n", st->frames, t, st->frames / t);
+  printf("drains:             %u, %.1f records and %.1f frames per drain\n", drains,
+         (double)st->records / drains, (double)st->frames / drains);
+  printf("queue full:         %u records dropped, merged into the next frame by the reader\n", ing.queue.full);
+  printf("errors:             %u\n", errors);
+
+  lv_deinit();
+  return errors == 0 && st->frames == opt.frame_cnt ? 0 : 1;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static bool parse_args(int argc, char **argv, options_t *opt) {
+  opt->frame_cnt = 1000000;
+  opt->drain_us = 0;
+  opt->max_chunk = TELEMETRY_INGEST_CHUNK;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      opt->frame_cnt = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "-u") == 0 && i + 1 < argc) {
+      opt->drain_us = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+      opt->max_chunk = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else {
+      return false;
+    }
+  }
+  return opt->frame_cnt > 0 && opt->max_chunk > 0;
+}
+
+/* Every field is a function of the frame number, which is sent as `trip` */
+static void make_frame(uint32_t i, telemetry_data_t *d) {
+  telemetry_data_init(d);
+  d->trip = (int)i;
+  d->odo = (int)(i * 2);
+  d->speed = (int)(i % 30000);
+  d->range = (int)((i * 7) % 30000);
+  d->avg_wh = (int)(i % 1000);
+  d->avg_kmh = (int)(i % 200);
+  d->motor_temp = (int)(i % 150);
+  d->battery_temp = (int)(i % 90);
+  snprintf(d->mode, sizeof(d->mode), "M%u", (unsigned)(i % 1000));
+  snprintf(d->status, sizeof(d->status), "S%u", (unsigned)i);
+}
+
+static bool check_frame(const telemetry_data_t *d) {
+  telemetry_data_t exp;
+  make_frame((uint32_t)d->trip, &exp);
+  return d->odo == exp.odo && d->speed == exp.speed && d->range == exp.range && d->avg_wh == exp.avg_wh &&
+         d->avg_kmh == exp.avg_kmh && d->motor_temp == exp.motor_temp && d->battery_temp == exp.battery_temp &&
+         strcmp(d->mode, exp.mode) == 0 && strcmp(d->status, exp.status) == 0;
+}
+
+/* Hand out the stream in random chunks; wait like a serial port once it ends */
+static size_t source_read_cb(void *user_data, uint8_t *buf, size_t max_len) {
+  source_t *src = (source_t *)user_data;
+  if (src->pos == src->bytes.size()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return 0;
+  }
+
+  src->rand = src->rand * 1103515245 + 12345;
+  size_t n = 1 + (src->rand >> 16) % src->max_chunk;
+  if (n > max_len) n = max_len;
+  if (n > src->bytes.size() - src->pos) n = src->bytes.size() - src->pos;
+
+  memcpy(buf, &src->bytes[src->pos], n);
+  src->pos += n;
+  return n;
+}
+
+static double now_s(void) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
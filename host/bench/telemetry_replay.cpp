@@ -0,0 +1,361 @@
+/**
+ * @file telemetry_replay.cpp
+ *
+ * Replays recorded telemetry against the dashboard.
+ *
+ * The input is a capture written by the recorder (see telemetry_rec.h) or a
+ * plain text file with one ASCII telemetry line per `-p` milliseconds.
+ *
+ * LVGL runs on a simulated clock driven by the capture timestamps, so the
+ * rendered frames, the per-frame latencies and the final framebuffer checksum
+ * only depend on the input and the code under test: two builds can be compared
+ * on identical input. `-s` only changes how fast the replay runs in wall time.
+ *
+ * Every decoded telemetry frame ends up in one of these states:
+ *  - shown:     drawn by a refresh on its own
+ *  - merged:    drawn by a refresh together with later frames
+ *  - unchanged: did not change any label, nothing to draw
+ *  - dropped:   decoded but never drawn (only at the end of the capture)
+ * Bytes rejected by the decoder (CRC errors, overflows...) are reported separately.
+ *
+ * Usage: telemetry_replay [-s speed] [-p period_ms] [-o log.csv] [-d device] capture
+ *   -s  0: as fast as possible (default), 1: real time, N: N times faster
+ *   -p  line period of plain text input (default 20 ms)
+ *   -o  write one CSV line per telemetry frame
+ *   -d  don't render, write the bytes to `device` (e.g. a tty) with the capture's timing
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "dashboard.h"
+#include "telemetry.h"
+#include "telemetry_rec.h"
+#include "host_display.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define DRAIN_MS 1000   /* simulated time to keep rendering after the last record */
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+  double speed;
+  uint32_t period_ms;
+  const char *log_path;
+  const char *device_path;
+  const char *path;
+} options_t;
+
+typedef enum {
+  FRAME_PENDING,
+  FRAME_SHOWN,
+  FRAME_MERGED,
+  FRAME_UNCHANGED,
+} frame_state_t;
+
+typedef struct {
+  uint32_t t_arrive;
+  uint32_t t_shown;
+  double render_us;
+  frame_state_t state;
+} frame_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool parse_args(int argc, char **argv, options_t *opt);
+static bool load_input(const options_t *opt, std::vector<uint8_t> *file, std::vector<telemetry_rec_entry_t> *entries);
+static void advance_to(uint32_t t_ms);
+static void refr_event_cb(lv_event_t *e);
+static int replay_to_device(const options_t *opt, const std::vector<telemetry_rec_entry_t> &entries);
+static uint32_t framebuffer_checksum(void);
+static uint32_t percentile(std::vector<uint32_t> v, double p);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static std::vector<frame_t> frames;
+static size_t first_pending;
+static size_t applied_at_refr_start;
+static double refr_start_us;
+static uint32_t refreshes;
+
+static double speed;
+static uint32_t t_first;
+static double wall_first;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char **argv) {
+  options_t opt;
+  if (!parse_args(argc, argv, &opt)) {
+    fprintf(stderr, "usage: %s [-s speed] [-p period_ms] [-o log.csv] [-d device] capture\n", argv[0]);
+    return 1;
+  }
+
+  std::vector<uint8_t> file;
+  std::vector<telemetry_rec_entry_t> entries;
+  if (!load_input(&opt, &file, &entries)) return 1;
+  if (entries.empty()) {
+    fprintf(stderr, "%s: no records\n", opt.path);
+    return 1;
+  }
+
+  speed = opt.speed;
+  t_first = entries[0].t_ms;
+  wall_first = host_wall_us();
+
+  if (opt.device_path) return replay_to_device(&opt, entries);
+
+  lv_init();
+  lv_display_t *disp = host_display_create();
+  host_tick_set(t_first);
+
+  static telemetry_rx_t rx;
+  telemetry_rx_init(&rx);
+  telemetry_data_t dash;
+  telemetry_data_init(&dash);
+
+  create_ev_dashboard_ui();
+  update_dashboard(&dash);
+  lv_refr_now(disp);
+
+  dashboard_attach_stats(disp);
+  dashboard_reset_stats();
+  lv_display_add_event_cb(disp, refr_event_cb, LV_EVENT_REFR_START, NULL);
+  lv_display_add_event_cb(disp, refr_event_cb, LV_EVENT_RENDER_READY, NULL);
+
+  for (const telemetry_rec_entry_t &e : entries) {
+    /* Run the timers that are due before the record arrives, like an idle loop() would */
+    while (true) {
+      uint32_t next = lv_timer_handler();
+      uint32_t now = host_tick_get();
+      if (next == LV_NO_TIMER_READY || now + next >= e.t_ms) break;
+      advance_to(now + (next > 0 ? next : 1));
+    }
+    advance_to(e.t_ms);
+
+    size_t pos = 0;
+    while (pos < e.len) {
+      pos += telemetry_rx_push(&rx, e.data + pos, e.len - pos);
+      while (telemetry_rx_poll(&rx, &dash, NULL) != TELEMETRY_FORMAT_NONE) {
+        bool changed = update_dashboard(&dash);
+        update_time_display(host_tick_get());
+        if (changed) lv_sysmon_latency_input(host_tick_get());
+
+        frame_t f;
+        f.t_arrive = host_tick_get();
+        f.t_shown = 0;
+        f.render_us = 0;
+        f.state = changed ? FRAME_PENDING : FRAME_UNCHANGED;
+        frames.push_back(f);
+      }
+    }
+  }
+
+  /* Let the last frames render */
+  uint32_t t_end = host_tick_get() + DRAIN_MS;
+  while (host_tick_get() < t_end) {
+    uint32_t next = lv_timer_handler();
+    if (next == LV_NO_TIMER_READY) break;
+    advance_to(std::min(t_end, host_tick_get() + (next > 0 ? next : 1)));
+  }
+
+  /* Report */
+  uint32_t cnt[4] = {0};
+  std::vector<uint32_t> latency;
+  double render_sum = 0;
+  FILE *log = opt.log_path ? fopen(opt.log_path, "w") : NULL;
+  if (log) fprintf(log, "frame,t_arrive_ms,t_shown_ms,latency_ms,state,render_us\n");
+  static const char *state_names[] = {"dropped", "shown", "merged", "unchanged"};
+  for (size_t i = 0; i < frames.size(); i++) {
+    const frame_t &f = frames[i];
+    cnt[f.state]++;
+    bool drawn = f.state == FRAME_SHOWN || f.state == FRAME_MERGED;
+    if (drawn) {
+      latency.push_back(f.t_shown - f.t_arrive);
+      render_sum += f.render_us;
+    }
+    if (log) {
+      fprintf(log, "%zu,%u,%u,%d,%s,%.1f\n", i, f.t_arrive - t_first, drawn ? f.t_shown - t_first : 0,
+              drawn ? (int)(f.t_shown - f.t_arrive) : -1, state_names[f.state], f.render_us);
+    }
+  }
+  if (log) fclose(log);
+
+  const dashboard_stats_t *st = dashboard_get_stats();
+  printf("capture:          %zu records, %u ms\n", entries.size(), entries.back().t_ms - t_first);
+  printf("frames:           %zu decoded, %u shown, %u merged, %u unchanged, %u dropped\n", frames.size(),
+         cnt[FRAME_SHOWN], cnt[FRAME_MERGED], cnt[FRAME_UNCHANGED], cnt[FRAME_PENDING]);
+  printf("decoder rejects:  %u CRC, %u version, %u long lines, %u overflow bytes\n", rx.stats.crc_errors,
+         rx.stats.version_errors, rx.stats.line_too_long, rx.stats.overflows);
+  printf("lost frames:      %u (gaps in the sequence numbers)\n", rx.stats.frames_lost);
+  printf("refreshes:        %u, %u bytes flushed\n", refreshes, st->bytes_flushed);
+  if (!latency.empty()) {
+    uint32_t sum = 0;
+    for (uint32_t v : latency) sum += v;
+    printf("latency [sim ms]: min %u, avg %.1f, p95 %u, p99 %u, max %u\n",
+           *std::min_element(latency.begin(), latency.end()), (double)sum / latency.size(),
+           percentile(latency, 0.95), percentile(latency, 0.99), *std::max_element(latency.begin(), latency.end()));
+    printf("render [wall us]: avg %.1f per drawn frame\n", render_sum / latency.size());
+  }
+
+  /* The same from the sysmon latency monitor, up to the flush of the last area */
+  lv_sysmon_latency_t mon;
+  lv_sysmon_get_latency(&mon);
+  if (mon.flush.cnt > 0) {
+    printf("sysmon [sim ms]:  %u inputs, %u refreshes, flushed min %u, avg %u, p95 %u, p99 %u, max %u\n",
+           mon.input_cnt, mon.flush.cnt, mon.flush.min, mon.flush.avg, mon.flush.p95, mon.flush.p99, mon.flush.max);
+  }
+  printf("framebuffer:      %08x\n", framebuffer_checksum());
+
+  lv_deinit();
+  return 0;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static bool parse_args(int argc, char **argv, options_t *opt) {
+  opt->speed = 0;
+  opt->period_ms = 20;
+  opt->log_path = NULL;
+  opt->device_path = NULL;
+  opt->path = NULL;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+      opt->speed = strtod(argv[++i], NULL);
+    } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+      opt->period_ms = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+      opt->log_path = argv[++i];
+    } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+      opt->device_path = argv[++i];
+    } else if (argv[i][0] != '-') {
+      opt->path = argv[i];
+    } else {
+      return false;
+    }
+  }
+  return opt->path != NULL && opt->speed >= 0;
+}
+
+static bool load_input(const options_t *opt, std::vector<uint8_t> *file, std::vector<telemetry_rec_entry_t> *entries) {
+  FILE *f = fopen(opt->path, "rb");
+  if (f == NULL) {
+    perror(opt->path);
+    return false;
+  }
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) file->insert(file->end(), chunk, chunk + n);
+  fclose(f);
+
+  const uint8_t *buf = file->data();
+  if (telemetry_rec_is_capture(buf, file->size())) {
+    size_t pos = TELEMETRY_REC_MAGIC_SIZE;
+    telemetry_rec_entry_t e;
+    while (telemetry_rec_next(buf, file->size(), &pos, &e)) entries->push_back(e);
+    if (pos != file->size()) fprintf(stderr, "%s: truncated after %zu records\n", opt->path, entries->size());
+    return true;
+  }
+
+  /* Plain text: one line per period */
+  size_t start = 0;
+  uint32_t t = 0;
+  for (size_t i = 0; i < file->size(); i++) {
+    if (buf[i] != '\n') continue;
+    telemetry_rec_entry_t e;
+    e.t_ms = t;
+    e.len = (uint16_t)std::min<size_t>(i + 1 - start, TELEMETRY_REC_MAX_LEN);
+    e.data = &buf[start];
+    entries->push_back(e);
+    t += opt->period_ms;
+    start = i + 1;
+  }
+  return true;
+}
+
+/* Move the simulated clock, sleeping to keep the requested pace */
+static void advance_to(uint32_t t_ms) {
+  if (t_ms > host_tick_get()) host_tick_set(t_ms);
+  if (speed <= 0) return;
+
+  double target = wall_first + (t_ms - t_first) * 1000.0 / speed;
+  double wait = target - host_wall_us();
+  if (wait > 0) std::this_thread::sleep_for(std::chrono::microseconds((long long)wait));
+}
+
+/* Frames applied before a refresh starts are on screen when it is rendered */
+static void refr_event_cb(lv_event_t *e) {
+  if (lv_event_get_code(e) == LV_EVENT_REFR_START) {
+    applied_at_refr_start = frames.size();
+    refr_start_us = host_wall_us();
+    return;
+  }
+
+  /* LV_EVENT_RENDER_READY */
+  refreshes++;
+  double render_us = host_wall_us() - refr_start_us;
+  std::vector<size_t> drawn;
+  for (size_t i = first_pending; i < applied_at_refr_start; i++) {
+    if (frames[i].state == FRAME_PENDING) drawn.push_back(i);
+  }
+  for (size_t i : drawn) {
+    frames[i].state = drawn.size() > 1 ? FRAME_MERGED : FRAME_SHOWN;
+    frames[i].t_shown = host_tick_get();
+    frames[i].render_us = render_us;
+  }
+  first_pending = applied_at_refr_start;
+}
+
+static int replay_to_device(const options_t *opt, const std::vector<telemetry_rec_entry_t> &entries) {
+  FILE *dev = fopen(opt->device_path, "wb");
+  if (dev == NULL) {
+    perror(opt->device_path);
+    return 1;
+  }
+
+  size_t bytes = 0;
+  for (const telemetry_rec_entry_t &e : entries) {
+    advance_to(e.t_ms);
+    fwrite(e.data, 1, e.len, dev);
+    fflush(dev);
+    bytes += e.len;
+  }
+  fclose(dev);
+  printf("sent %zu records, %zu bytes in %.1f s\n", entries.size(), bytes, (host_wall_us() - wall_first) / 1e6);
+  return 0;
+}
+
+/* FNV-1a over the framebuffer */
+static uint32_t framebuffer_checksum(void) {
+  const uint8_t *p = (const uint8_t *)host_display_get_framebuffer();
+  size_t len = DASHBOARD_HOR_RES * DASHBOARD_VER_RES * sizeof(uint16_t);
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < len; i++) {
+    h ^= p[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
+static uint32_t percentile(std::vector<uint32_t> v, double p) {
+  std::sort(v.begin(), v.end());
+  return v[(size_t)(p * (v.size() - 1) + 0.5)];
+}
@@ -0,0 +1,168 @@
+/**
+ * @file text_measure_bench.cpp
+ *
+ * Measures text with and without the glyph lookup tables of the fonts
+ * (LV_USE_FONT_FMT_TXT_LUT, `lv_font_fmt_txt_create_lut()`): with them a
+ * code point is found in a direct table (U+0000..U+00FF) or a hash table
+ * instead of going through the cmaps and binary searching the sparse ones.
+ *
+ * One run per script, `lv_text_get_size()` wrapping a paragraph into
+ * 200 px wide lines, i.e. every glyph is looked up for the line breaking and
+ * the measurement, and its right neighbour for the kerning:
+ *   - latin:  Montserrat 16, ASCII
+ *   - cjk:    SimSun 16 CJK, sparse cmaps
+ *   - he/fa:  DejaVu 16 Persian/Hebrew, Hebrew and Persian letters
+ *
+ * Reported: the time per letter and the size of the table. Every glyph
+ * descriptor up to U+2FFFF and the measured sizes have to be the same with
+ * and without the table (the exit code says if they were).
+ *
+ * Usage: text_measure_bench [-n repeats]
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "host_display.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if LV_USE_FONT_FMT_TXT_LUT && LV_FONT_SIMSUN_16_CJK && LV_FONT_DEJAVU_16_PERSIAN_HEBREW
+
+/*********************
+ *      DEFINES
+ *********************/
+#define LINE_WIDTH   200
+#define LAST_LETTER  0x2FFFF
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+  const char *name;
+  const lv_font_t *font;
+  const char *text;
+} script_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static double measure(const script_t *s, uint32_t repeats, lv_point_t *size);
+static void get_glyphs(const lv_font_t *font, std::vector<lv_font_glyph_dsc_t> *glyphs);
+static uint32_t compare_glyphs(const std::vector<lv_font_glyph_dsc_t> &a, const std::vector<lv_font_glyph_dsc_t> &b);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const script_t scripts[] = {
+    {"latin", &lv_font_montserrat_16,
+     "Range 214 km, battery 78 %, motor 52 C. Average 134 Wh/km at 47 km/h over the last trip of 36.4 km; "
+     "the odometer shows 12 480 km. Regenerative braking recovered 1.8 kWh today."},
+    {"cjk", &lv_font_simsun_16_cjk,
+     "我们的电动车今天行驶了一百公里，电池还有百分之六十。前方道路畅通，预计到达时间为下午三点。"
+     "请注意安全驾驶，保持车距，不要疲劳驾驶。系统正常，电机温度在正常范围内。"},
+    {"he/fa", &lv_font_dejavu_16_persian_hebrew,
+     "שלום עולם, הסוללה טעונה ונסיעה טובה לכולם. "
+     "سلام دنیا، باتری شارژ شده است و سفر خوبی داشته باشید. "
+     "מהירות ממוצעת וטמפרטורת המנוע תקינות. سرعت متوسط و دمای موتور عادی است."},
+};
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char **argv) {
+  uint32_t repeats = 2000;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      repeats = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else {
+      fprintf(stderr, "usage: %s [-n repeats]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (repeats == 0) return 1;
+
+  lv_init();
+
+  printf("%u measurements of each paragraph, %d px wide lines\n\n", (unsigned)repeats, LINE_WIDTH);
+  printf("%-6s %8s %12s %12s %8s %10s %10s\n", "script", "letters", "off [ns/l]", "on [ns/l]", "speedup",
+         "table [B]", "diff");
+  uint32_t diff = 0;
+  for (size_t i = 0; i < sizeof(scripts) / sizeof(scripts[0]); i++) {
+    const script_t *s = &scripts[i];
+    uint32_t letters = _lv_text_get_encoded_length(s->text);
+
+    lv_point_t size_off, size_on;
+    std::vector<lv_font_glyph_dsc_t> glyphs_off, glyphs_on;
+    double off_us = measure(s, repeats, &size_off);
+    get_glyphs(s->font, &glyphs_off);
+    if (lv_font_fmt_txt_create_lut(s->font) != LV_RESULT_OK) {
+      printf("%-6s can't build the table\n", s->name);
+      diff++;
+      continue;
+    }
+    double on_us = measure(s, repeats, &size_on);
+
+    get_glyphs(s->font, &glyphs_on);
+    uint32_t d = compare_glyphs(glyphs_off, glyphs_on);
+    if (size_off.x != size_on.x || size_off.y != size_on.y) d++;
+    diff += d;
+
+    double per_letter = 1000.0 / ((double)repeats * letters);
+    printf("%-6s %8u %12.1f %12.1f %7.2fx %10u %10u\n", s->name, (unsigned)letters, off_us * per_letter,
+           on_us * per_letter, off_us / on_us, (unsigned)lv_font_fmt_txt_get_lut_size(s->font), (unsigned)d);
+    lv_font_fmt_txt_delete_lut(s->font);
+  }
+  printf("\n%u differences with the tables\n", (unsigned)diff);
+
+  lv_deinit();
+  return diff == 0 ? 0 : 1;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* The time of measuring the paragraph `repeats` times in microseconds */
+static double measure(const script_t *s, uint32_t repeats, lv_point_t *size) {
+  double t0 = host_wall_us();
+  for (uint32_t i = 0; i < repeats; i++) {
+    lv_text_get_size(size, s->text, s->font, 0, 0, LINE_WIDTH, LV_TEXT_FLAG_NONE);
+  }
+  return host_wall_us() - t0;
+}
+
+/* The glyph descriptors of every code point, zeroed if the font doesn't have it */
+static void get_glyphs(const lv_font_t *font, std::vector<lv_font_glyph_dsc_t> *glyphs) {
+  glyphs->resize(LAST_LETTER + 1);
+  memset(glyphs->data(), 0, glyphs->size() * sizeof(lv_font_glyph_dsc_t));
+  for (uint32_t letter = 1; letter <= LAST_LETTER; letter++) {
+    lv_font_glyph_dsc_t *g = &(*glyphs)[letter];
+    if (!font->get_glyph_dsc(font, g, letter, 'A')) memset(g, 0, sizeof(*g));
+  }
+}
+
+/* The number of code points whose glyph descriptors differ */
+static uint32_t compare_glyphs(const std::vector<lv_font_glyph_dsc_t> &a, const std::vector<lv_font_glyph_dsc_t> &b) {
+  uint32_t d = 0;
+  for (size_t i = 0; i < a.size(); i++) {
+    if (a[i].adv_w != b[i].adv_w || a[i].box_w != b[i].box_w || a[i].box_h != b[i].box_h ||
+        a[i].ofs_x != b[i].ofs_x || a[i].ofs_y != b[i].ofs_y || a[i].format != b[i].format) {
+      d++;
+    }
+  }
+  return d;
+}
+
+#else
+
+int main(void) {
+  printf("LV_USE_FONT_FMT_TXT_LUT, LV_FONT_SIMSUN_16_CJK or LV_FONT_DEJAVU_16_PERSIAN_HEBREW is 0 in this build\n");
+  return 0;
+}
+
+#endif /*LV_USE_FONT_FMT_TXT_LUT*/
@@ -0,0 +1,201 @@
+/**
+ * @file tile_hash_bench.cpp
+ *
+ * Runs the dashboard update stream with and without the tile hash
+ * (`lv_display_set_tile_hash()`): with it the invalidated areas are rounded to
+ * 16x16 tiles, and only the tiles which rendered differently from what was
+ * flushed before go to the panel. E.g. "Range 130 km" -> "Range 129 km" sends
+ * the digits, and setting the clock to the same time sends nothing.
+ *
+ * Two displays:
+ *   - memory: flushing copies to the framebuffer, so it's about the CPU time
+ *   - DMA:    two buffers sent through the simulated SPI link like on the
+ *             board (host_display_create_link()), the frame is done when the
+ *             link sent its last byte. With two buffers all the changed tiles
+ *             of a band go in one flush, a second one would wait for the first.
+ *
+ * Reported per frame: the time to render and flush, the flushes, the bytes
+ * and the estimated time on the board's SPI bus (`lv_display_get_flush_stats()`),
+ * and the tiles left out. After every frame the panel content (the host
+ * display's framebuffer) has to be the same in all runs (the exit code says
+ * if it was).
+ *
+ * Usage: tile_hash_bench [-n frames] [-b bytes_per_s] [-f flush_us]
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "dashboard.h"
+#include "host_display.h"
+#include "src/display/lv_display_private.h"
+#include "telemetry.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+  double frame_us;
+  double flushes;
+  double bytes;
+  double bus_us;
+  uint64_t tiles_checked;
+  uint64_t tiles_skipped;
+} result_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void run(bool tile_hash, const host_link_config_t *link, uint32_t frames, result_t *res,
+                std::vector<uint32_t> *screens);
+static void make_frame(uint32_t i, telemetry_data_t *d);
+static uint32_t hash_screen(void);
+static void render_ready_cb(lv_event_t *e);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static bool rendered;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char **argv) {
+  uint32_t frames = 2000;
+  host_link_config_t link;
+  memset(&link, 0, sizeof(link));
+  link.bytes_per_s = 5000000;
+  link.flush_us = 20;
+  link.dma = true;
+  link.double_buffered = true;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      frames = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+      link.bytes_per_s = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+      link.flush_us = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else {
+      fprintf(stderr, "usage: %s [-n frames] [-b bytes_per_s] [-f flush_us]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (frames == 0 || link.bytes_per_s == 0) return 1;
+
+  lv_init();
+
+  /* memory off/on, DMA off/on */
+  result_t res[4];
+  std::vector<uint32_t> screens[4];
+  for (int m = 0; m < 4; m++) run(m & 1, m >= 2 ? &link : NULL, frames, &res[m], &screens[m]);
+
+  uint32_t diff = 0;
+  for (uint32_t i = 0; i < frames; i++) {
+    for (int m = 1; m < 4; m++) {
+      if (screens[0][i] != screens[m][i]) {
+        diff++;
+        break;
+      }
+    }
+  }
+
+  printf("%u frames of the dashboard drive, %d px tiles, DMA link %.1f MB/s, %u us per flush\n\n", (unsigned)frames,
+         LV_TILE_HASH_SIZE, link.bytes_per_s / 1e6, (unsigned)link.flush_us);
+  printf("%-8s %-10s %10s %8s %10s %10s %14s\n", "display", "tile hash", "frame [us]", "flushes", "bytes",
+         "bus [us]", "tiles skipped");
+  for (int m = 0; m < 4; m++) {
+    char skipped[32] = "-";
+    if (res[m].tiles_checked) {
+      snprintf(skipped, sizeof(skipped), "%.1f%% of %.0f", 100.0 * res[m].tiles_skipped / res[m].tiles_checked,
+               (double)res[m].tiles_checked / frames);
+    }
+    printf("%-8s %-10s %10.1f %8.2f %10.0f %10.0f %14s\n", m == 0 ? "memory" : m == 2 ? "DMA" : "",
+           (m & 1) ? "on" : "off", res[m].frame_us, res[m].flushes, res[m].bytes, res[m].bus_us, skipped);
+  }
+  printf("\nspeedup: memory %.2fx, DMA %.2fx\n", res[0].frame_us / res[1].frame_us, res[2].frame_us / res[3].frame_us);
+  printf("%u frames with a different screen\n", (unsigned)diff);
+
+  lv_deinit();
+  return diff == 0 ? 0 : 1;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void run(bool tile_hash, const host_link_config_t *link, uint32_t frames, result_t *res,
+                std::vector<uint32_t> *screens) {
+  lv_display_t *disp = link ? host_display_create_link(link) : host_display_create();
+  host_tick_set(0);
+
+  create_ev_dashboard_ui();
+  telemetry_data_t d;
+  telemetry_data_init(&d);
+  update_dashboard(&d);
+  lv_refr_now(disp);
+  if (tile_hash) lv_display_set_tile_hash(disp, true);
+  lv_display_add_event_cb(disp, render_ready_cb, LV_EVENT_RENDER_READY, NULL);
+
+  memset(res, 0, sizeof(*res));
+  double frame_us = 0;
+  for (uint32_t i = 0; i < frames; i++) {
+    host_tick_inc(LV_DEF_REFR_PERIOD);
+    make_frame(i, &d);
+    update_dashboard(&d);
+    update_time_display(host_tick_get());
+
+    rendered = false;
+    double t0 = host_wall_us();
+    lv_refr_now(disp);
+    if (link) host_link_wait();
+    frame_us += host_wall_us() - t0;
+
+    /* The statistics are of the last frame which rendered something */
+    if (rendered) {
+      const lv_display_flush_stats_t *st = lv_display_get_flush_stats(disp);
+      res->flushes += st->flush_cnt;
+      res->bytes += st->bytes;
+      res->bus_us += st->bus_time_us;
+      res->tiles_checked += st->tiles_checked;
+      res->tiles_skipped += st->tiles_skipped;
+    }
+    screens->push_back(hash_screen());
+  }
+
+  res->frame_us = frame_us / frames;
+  res->flushes /= frames;
+  res->bytes /= frames;
+  res->bus_us /= frames;
+
+  host_display_delete(disp);
+}
+
+/* A drive: the speed changes every frame, the rest now and then */
+static void make_frame(uint32_t i, telemetry_data_t *d) {
+  d->speed = (int)((i * 7) % 120);
+  d->range = 200 - (int)(i / 50) % 200;
+  d->avg_wh = 120 + (int)(i / 20) % 30;
+  d->avg_kmh = 40 + (int)(i / 40) % 20;
+  d->trip = (int)(i / 10);
+  d->odo = 12000 + (int)(i / 10);
+  d->motor_temp = 40 + (int)(i / 100) % 30;
+  d->battery_temp = 30 + (int)(i / 150) % 20;
+}
+
+static uint32_t hash_screen(void) {
+  const uint16_t *fb = host_display_get_framebuffer();
+  uint32_t h = 2166136261u;
+  for (uint32_t i = 0; i < DASHBOARD_HOR_RES * DASHBOARD_VER_RES; i++) h = (h ^ fb[i]) * 16777619u;
+  return h;
+}
+
+static void render_ready_cb(lv_event_t *e) {
+  LV_UNUSED(e);
+  rendered = true;
+}
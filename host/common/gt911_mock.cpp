@@ -0,0 +1,142 @@
+/**
+ * @file gt911_mock.cpp
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "gt911_mock.h"
+
+#include <cstring>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define REG_MODULE_SWITCH1 0x804D
+#define REG_PRODUCT_ID     0x8140
+#define REG_STATUS         0x814E
+#define REG_POINTS         0x814F
+
+#define STATUS_READY 0x80
+#define POINT_SIZE   8
+
+/* 400 kHz, 9 bits per byte with the ACK. A register access is START, address,
+ * 2 register bytes, then the data (a read adds a repeated START and the
+ * address again), STOP. */
+#define BIT_US       2.5
+#define READ_BITS(n)  (1 + 9 + 18 + 1 + 9 + 9 * (n) + 1)
+#define WRITE_BITS(n) (1 + 9 + 18 + 9 * (n) + 1)
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool i2c_read_cb(void *user_data, uint16_t reg, uint8_t *buf, size_t len);
+static bool i2c_write_cb(void *user_data, uint16_t reg, const uint8_t *buf, size_t len);
+static bool in_range(uint16_t reg, size_t len);
+static void count_idle(gt911_mock_t *m);
+static void put_le16(uint8_t *p, uint16_t v);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void gt911_mock_init(gt911_mock_t *m, uint16_t hor_res, uint16_t ver_res) {
+  memset(m, 0, sizeof(*m));
+
+  uint8_t *info = &m->regs[REG_PRODUCT_ID - GT911_MOCK_REG_BASE];
+  memcpy(info, "911", 4);
+  put_le16(&info[4], 0x1060);  // firmware version
+  put_le16(&info[6], hor_res);
+  put_le16(&info[8], ver_res);
+
+  m->regs[REG_MODULE_SWITCH1 - GT911_MOCK_REG_BASE] = 0x01;  // falling edge
+}
+
+void gt911_mock_set_irq_cb(gt911_mock_t *m, gt911_mock_irq_cb_t irq_cb, void *user_data) {
+  m->irq_cb = irq_cb;
+  m->irq_user_data = user_data;
+}
+
+void gt911_mock_scan(gt911_mock_t *m, const gt911_point_t *points, uint8_t cnt) {
+  m->touching = cnt > 0;
+
+  uint8_t *status = &m->regs[REG_STATUS - GT911_MOCK_REG_BASE];
+  if (*status & STATUS_READY) {
+    m->stats.lost++;
+    return;
+  }
+
+  for (uint8_t i = 0; i < cnt; i++) {
+    uint8_t *p = &m->regs[REG_POINTS - GT911_MOCK_REG_BASE + i * POINT_SIZE];
+    p[0] = points[i].id;
+    put_le16(&p[1], points[i].x);
+    put_le16(&p[3], points[i].y);
+    put_le16(&p[5], points[i].size);
+    p[7] = 0;
+  }
+  *status = STATUS_READY | cnt;
+  m->t_ready = lv_tick_get();
+  m->stats.reports++;
+
+  if (m->irq_cb) m->irq_cb(m->irq_user_data);
+}
+
+gt911_i2c_t gt911_mock_get_i2c(gt911_mock_t *m) {
+  gt911_i2c_t i2c;
+  i2c.read = i2c_read_cb;
+  i2c.write = i2c_write_cb;
+  i2c.user_data = m;
+  return i2c;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static bool i2c_read_cb(void *user_data, uint16_t reg, uint8_t *buf, size_t len) {
+  gt911_mock_t *m = (gt911_mock_t *)user_data;
+  m->stats.reads++;
+  m->stats.bus_us += READ_BITS(len) * BIT_US;
+  count_idle(m);
+
+  if (!in_range(reg, len)) return false;
+  memcpy(buf, &m->regs[reg - GT911_MOCK_REG_BASE], len);
+  return true;
+}
+
+static bool i2c_write_cb(void *user_data, uint16_t reg, const uint8_t *buf, size_t len) {
+  gt911_mock_t *m = (gt911_mock_t *)user_data;
+  m->stats.writes++;
+  m->stats.bus_us += WRITE_BITS(len) * BIT_US;
+  count_idle(m);
+
+  if (!in_range(reg, len)) return false;
+
+  /* Clearing a stored report acknowledges it */
+  uint8_t *status = &m->regs[REG_STATUS - GT911_MOCK_REG_BASE];
+  bool ack = reg <= REG_STATUS && reg + len > REG_STATUS && (*status & STATUS_READY) &&
+             !(buf[REG_STATUS - reg] & STATUS_READY);
+  if (ack) {
+    uint32_t age = lv_tick_elaps(m->t_ready);
+    m->stats.acked++;
+    m->stats.age_ms_sum += age;
+    if (age > m->stats.age_ms_max) m->stats.age_ms_max = age;
+  }
+
+  memcpy(&m->regs[reg - GT911_MOCK_REG_BASE], buf, len);
+  return true;
+}
+
+static bool in_range(uint16_t reg, size_t len) {
+  return reg >= GT911_MOCK_REG_BASE && reg + len <= GT911_MOCK_REG_BASE + GT911_MOCK_REG_SIZE;
+}
+
+static void count_idle(gt911_mock_t *m) {
+  if (!m->touching && !(m->regs[REG_STATUS - GT911_MOCK_REG_BASE] & STATUS_READY)) m->stats.idle++;
+}
+
+static void put_le16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)(v & 0xFF);
+  p[1] = (uint8_t)(v >> 8);
+}
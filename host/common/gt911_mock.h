@@ -0,0 +1,80 @@
+/**
+ * @file gt911_mock.h
+ *
+ * GT911 register model behind a gt911_i2c_t, for running the touch driver on
+ * the host. Like the real controller it doesn't update the coordinates until
+ * the previous report was acknowledged by clearing the status register, and
+ * it pulses INT (the irq callback) for every report it stores.
+ *
+ * Bus time is estimated for 400 kHz I2C.
+ */
+
+#ifndef GT911_MOCK_H
+#define GT911_MOCK_H
+
+#include "gt911.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define GT911_MOCK_REG_BASE 0x8000
+#define GT911_MOCK_REG_SIZE 0x200
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef void (*gt911_mock_irq_cb_t)(void *user_data);
+
+typedef struct {
+  uint32_t reads;       // read transactions
+  uint32_t writes;      // write transactions
+  uint32_t idle;        // transactions while nobody touched and nothing was pending
+  double bus_us;        // time on the bus
+  uint32_t reports;     // reports stored
+  uint32_t lost;        // scans dropped because the previous report wasn't acknowledged
+  uint32_t acked;       // reports acknowledged
+  uint64_t age_ms_sum;  // time from storing until acknowledging a report
+  uint32_t age_ms_max;
+} gt911_mock_stats_t;
+
+typedef struct {
+  uint8_t regs[GT911_MOCK_REG_SIZE];
+  bool touching;
+  uint32_t t_ready;  // when the report in the registers was stored
+  gt911_mock_irq_cb_t irq_cb;
+  void *irq_user_data;
+  gt911_mock_stats_t stats;
+} gt911_mock_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * @param hor_res   the controller's resolution, as read by gt911_probe()
+ */
+void gt911_mock_init(gt911_mock_t *m, uint16_t hor_res, uint16_t ver_res);
+
+void gt911_mock_set_irq_cb(gt911_mock_t *m, gt911_mock_irq_cb_t irq_cb, void *user_data);
+
+/**
+ * One scan of the panel: store `cnt` points (0 after a lift) and pulse INT,
+ * unless the previous report wasn't acknowledged yet.
+ */
+void gt911_mock_scan(gt911_mock_t *m, const gt911_point_t *points, uint8_t cnt);
+
+/**
+ * The transport for gt911_init() or any other reader.
+ */
+gt911_i2c_t gt911_mock_get_i2c(gt911_mock_t *m);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* GT911_MOCK_H */
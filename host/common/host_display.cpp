@@ -0,0 +1,408 @@
+/**
+ * @file host_display.cpp
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "host_display.h"
+#include "dashboard.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BUF_LINES 40  /* same as the board's draw buffer */
+
+/* The board's flush cost, as lv_tft_espi sets it: SPI_FREQUENCY of TFT_eSPI's
+ * User_Setup.h and LV_TFT_ESPI_FLUSH_COST_NS */
+#define BOARD_SPI_HZ   27000000
+#define BOARD_FLUSH_NS 15000
+
+/* Sleep until this close to the end of a transfer, then spin */
+#define LINK_SPIN_US 200
+
+/* Max. data in a stored (uncompressed) deflate block */
+#define PNG_BLOCK_MAX 65535
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+  lv_area_t area;
+  const uint8_t *px_map;
+} transfer_t;
+
+typedef struct {
+  host_link_config_t cfg;
+  lv_display_t *disp;
+  std::thread thread;
+  std::mutex lock;
+  std::condition_variable cond;
+  std::deque<transfer_t> queue;  // queued or being sent, the front is being sent
+  uint32_t done;                 // transfers completed
+  bool exit;
+  host_link_stats_t stats;
+} link_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map);
+static void link_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map);
+static void link_flush_wait_cb(lv_display_t *disp);
+static void link_thread(link_t *link);
+static uint32_t link_time_cb(void);
+static void record_flush(lv_display_t *disp, const lv_area_t *area);
+static void copy_area(lv_display_t *disp, const lv_area_t *area, const uint8_t *px_map);
+static void to_rgb888(std::vector<uint8_t> *out);
+static void png_chunk(FILE *f, const char *type, const uint8_t *data, size_t len);
+static uint32_t crc32(uint32_t crc, const uint8_t *data, size_t len);
+static void put_u32(uint8_t *p, uint32_t v);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static uint16_t framebuffer[DASHBOARD_HOR_RES * DASHBOARD_VER_RES];
+static uint32_t sim_ms;
+static link_t *link;
+static bool recording;
+static std::vector<host_flush_t> flushes;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+lv_display_t *host_display_create(void) {
+  static uint8_t draw_buf[DASHBOARD_HOR_RES * BUF_LINES * 2];
+
+  lv_tick_set_cb(host_tick_get);
+
+  lv_display_t *disp = lv_display_create(DASHBOARD_HOR_RES, DASHBOARD_VER_RES);
+  lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+  lv_display_set_flush_cb(disp, flush_cb);
+  lv_display_set_buffers(disp, draw_buf, NULL, sizeof(draw_buf), LV_DISPLAY_RENDER_MODE_PARTIAL);
+  lv_display_set_flush_cost(disp, BOARD_FLUSH_NS, (uint32_t)(8000000000ULL / BOARD_SPI_HZ));
+  return disp;
+}
+
+lv_display_t *host_display_create_link(const host_link_config_t *cfg) {
+  static uint8_t draw_buf[LV_DISPLAY_PIPELINE_MAX][DASHBOARD_HOR_RES * BUF_LINES * 2];
+
+  lv_display_t *disp = host_display_create();
+  lv_display_set_flush_cb(disp, link_flush_cb);
+  if (cfg->pipeline) {
+    void *bufs[LV_DISPLAY_PIPELINE_MAX];
+    for (uint32_t i = 0; i < LV_DISPLAY_PIPELINE_MAX; i++) bufs[i] = draw_buf[i];
+    lv_display_set_pipeline(disp, bufs, cfg->pipeline, sizeof(draw_buf[0]));
+  } else {
+    lv_display_set_buffers(disp, draw_buf[0], cfg->double_buffered ? draw_buf[1] : NULL, sizeof(draw_buf[0]),
+                           LV_DISPLAY_RENDER_MODE_PARTIAL);
+  }
+  lv_display_set_time_cb(disp, link_time_cb);
+  lv_display_set_flush_cost(disp, cfg->flush_us * 1000, (uint32_t)(1000000000ULL / cfg->bytes_per_s));
+
+  link = new link_t();
+  link->cfg = *cfg;
+  link->disp = disp;
+  if (cfg->dma) lv_display_set_flush_wait_cb(disp, link_flush_wait_cb);
+  link->thread = std::thread(link_thread, link);
+  return disp;
+}
+
+void host_display_delete(lv_display_t *disp) {
+  lv_display_delete(disp);
+  if (link == NULL || link->disp != disp) return;
+
+  {
+    std::lock_guard<std::mutex> guard(link->lock);
+    link->exit = true;
+  }
+  link->cond.notify_all();
+  link->thread.join();
+  delete link;
+  link = NULL;
+}
+
+void host_link_wait(void) {
+  if (link == NULL) return;
+  std::unique_lock<std::mutex> guard(link->lock);
+  link->cond.wait(guard, [] { return link->queue.empty(); });
+}
+
+const host_link_stats_t *host_link_get_stats(void) {
+  static const host_link_stats_t none = {};
+  return link ? &link->stats : &none;
+}
+
+void host_link_reset_stats(void) {
+  if (link) lv_memzero(&link->stats, sizeof(link->stats));
+}
+
+const uint16_t *host_display_get_framebuffer(void) {
+  return framebuffer;
+}
+
+bool host_display_save_ppm(const char *path) {
+  FILE *f = fopen(path, "wb");
+  if (f == NULL) return false;
+
+  std::vector<uint8_t> rgb;
+  to_rgb888(&rgb);
+  fprintf(f, "P6\n%d %d\n255\n", DASHBOARD_HOR_RES, DASHBOARD_VER_RES);
+  size_t n = fwrite(rgb.data(), 1, rgb.size(), f);
+  return fclose(f) == 0 && n == rgb.size();
+}
+
+bool host_display_save_png(const char *path) {
+  FILE *f = fopen(path, "wb");
+  if (f == NULL) return false;
+
+  std::vector<uint8_t> rgb;
+  to_rgb888(&rgb);
+
+  /* The rows, each with filter type 0 (none) */
+  const size_t row = DASHBOARD_HOR_RES * 3;
+  std::vector<uint8_t> raw;
+  raw.reserve((row + 1) * DASHBOARD_VER_RES);
+  for (size_t y = 0; y < DASHBOARD_VER_RES; y++) {
+    raw.push_back(0);
+    raw.insert(raw.end(), &rgb[y * row], &rgb[y * row] + row);
+  }
+
+  /* A zlib stream of stored deflate blocks, then the Adler-32 of the rows */
+  std::vector<uint8_t> z = {0x78, 0x01};
+  uint32_t a = 1, b = 0;
+  for (size_t pos = 0; pos < raw.size(); pos += PNG_BLOCK_MAX) {
+    size_t len = raw.size() - pos < PNG_BLOCK_MAX ? raw.size() - pos : PNG_BLOCK_MAX;
+    z.push_back(pos + len == raw.size() ? 1 : 0);
+    z.push_back((uint8_t)len);
+    z.push_back((uint8_t)(len >> 8));
+    z.push_back((uint8_t)~len);
+    z.push_back((uint8_t)(~len >> 8));
+    z.insert(z.end(), &raw[pos], &raw[pos] + len);
+    for (size_t i = pos; i < pos + len; i++) {
+      a = (a + raw[i]) % 65521;
+      b = (b + a) % 65521;
+    }
+  }
+  z.resize(z.size() + 4);
+  put_u32(&z[z.size() - 4], (b << 16) | a);
+
+  uint8_t ihdr[13] = {0};
+  put_u32(&ihdr[0], DASHBOARD_HOR_RES);
+  put_u32(&ihdr[4], DASHBOARD_VER_RES);
+  ihdr[8] = 8;  // bits per channel
+  ihdr[9] = 2;  // RGB
+
+  static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+  fwrite(signature, 1, sizeof(signature), f);
+  png_chunk(f, "IHDR", ihdr, sizeof(ihdr));
+  png_chunk(f, "IDAT", z.data(), z.size());
+  png_chunk(f, "IEND", NULL, 0);
+  bool ok = !ferror(f);
+  return fclose(f) == 0 && ok;
+}
+
+int32_t host_display_compare_ppm(const char *path) {
+  FILE *f = fopen(path, "rb");
+  if (f == NULL) return -1;
+
+  int w, h, max;
+  std::vector<uint8_t> golden(DASHBOARD_HOR_RES * DASHBOARD_VER_RES * 3);
+  bool ok = fscanf(f, "P6 %d %d %d", &w, &h, &max) == 3 && fgetc(f) != EOF && w == DASHBOARD_HOR_RES &&
+            h == DASHBOARD_VER_RES && max == 255 && fread(golden.data(), 1, golden.size(), f) == golden.size();
+  fclose(f);
+  if (!ok) return -1;
+
+  std::vector<uint8_t> rgb;
+  to_rgb888(&rgb);
+  int32_t diff = 0;
+  for (size_t i = 0; i < rgb.size(); i += 3) {
+    if (memcmp(&rgb[i], &golden[i], 3) != 0) diff++;
+  }
+  return diff;
+}
+
+void host_display_record_flushes(bool en) {
+  recording = en;
+  if (en) flushes.clear();
+}
+
+const host_flush_t *host_display_get_flushes(uint32_t *cnt) {
+  *cnt = (uint32_t)flushes.size();
+  return flushes.data();
+}
+
+void host_display_clear_flushes(void) {
+  flushes.clear();
+}
+
+uint32_t host_tick_get(void) {
+  return sim_ms;
+}
+
+void host_tick_set(uint32_t ms) {
+  sim_ms = ms;
+}
+
+void host_tick_inc(uint32_t ms) {
+  sim_ms += ms;
+}
+
+double host_wall_us(void) {
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map) {
+  record_flush(disp, area);
+  copy_area(disp, area, px_map);
+  lv_display_flush_ready(disp);
+}
+
+/* Queue the area for the link thread; without DMA also wait for it */
+static void link_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map) {
+  record_flush(disp, area);
+  std::unique_lock<std::mutex> guard(link->lock);
+  link->queue.push_back({*area, px_map});
+  if (link->queue.size() > link->stats.max_queued) link->stats.max_queued = (uint32_t)link->queue.size();
+  link->stats.flushes++;
+  link->stats.bytes += lv_area_get_size(area) * lv_color_format_get_size(lv_display_get_color_format(disp));
+  link->cond.notify_all();
+  if (link->cfg.dma) return;
+
+  double t0 = host_wall_us();
+  link->cond.wait(guard, [] { return link->queue.empty(); });
+  link->stats.wait_us += host_wall_us() - t0;
+  lv_display_flush_ready(disp);
+}
+
+/* Like dmaWait(): block until the running transfer is done. With more
+ * transfers queued, LVGL calls it again while it needs to wait. */
+static void link_flush_wait_cb(lv_display_t *disp) {
+  LV_UNUSED(disp);
+  std::unique_lock<std::mutex> guard(link->lock);
+  if (link->queue.empty()) return;
+
+  double t0 = host_wall_us();
+  uint32_t done = link->done;
+  link->cond.wait(guard, [done] { return link->done != done || link->queue.empty(); });
+  link->stats.wait_us += host_wall_us() - t0;
+}
+
+static void link_thread(link_t *l) {
+  std::unique_lock<std::mutex> guard(l->lock);
+  while (true) {
+    l->cond.wait(guard, [l] { return !l->queue.empty() || l->exit; });
+    if (l->exit) break;
+    lv_area_t area = l->queue.front().area;
+    const uint8_t *px_map = l->queue.front().px_map;
+    guard.unlock();
+
+    uint32_t px_size = lv_color_format_get_size(lv_display_get_color_format(l->disp));
+    double us = l->cfg.flush_us + lv_area_get_size(&area) * px_size * 1e6 / l->cfg.bytes_per_s;
+    double t_end = host_wall_us() + us;
+    if (us > LINK_SPIN_US) std::this_thread::sleep_for(std::chrono::microseconds((int64_t)us - LINK_SPIN_US));
+    while (host_wall_us() < t_end) {}
+    copy_area(l->disp, &area, px_map);
+
+    guard.lock();
+    l->queue.pop_front();
+    l->done++;
+    l->stats.busy_us += us;
+    /* The DMA interrupt */
+    if (l->cfg.dma) lv_display_flush_ready(l->disp);
+    l->cond.notify_all();
+  }
+}
+
+static uint32_t link_time_cb(void) {
+  return (uint32_t)host_wall_us();
+}
+
+static void record_flush(lv_display_t *disp, const lv_area_t *area) {
+  if (!recording) return;
+  host_flush_t fl;
+  fl.area = *area;
+  fl.tick = sim_ms;
+  fl.last = lv_display_flush_is_last(disp);
+  flushes.push_back(fl);
+}
+
+static void copy_area(lv_display_t *disp, const lv_area_t *area, const uint8_t *px_map) {
+  int32_t w = lv_area_get_width(area);
+  bool swapped = lv_display_get_color_format(disp) == LV_COLOR_FORMAT_RGB565_SWAPPED;
+  const uint16_t *src = (const uint16_t *)px_map;
+  for (int32_t y = area->y1; y <= area->y2; y++) {
+    uint16_t *dst = &framebuffer[y * DASHBOARD_HOR_RES + area->x1];
+    if (swapped) {
+      for (int32_t x = 0; x < w; x++) dst[x] = (uint16_t)((src[x] >> 8) | (src[x] << 8));
+    } else {
+      memcpy(dst, src, w * sizeof(uint16_t));
+    }
+    src += w;
+  }
+}
+
+/* The framebuffer as 8 bit R, G, B, the low bits filled from the high ones */
+static void to_rgb888(std::vector<uint8_t> *out) {
+  out->resize(DASHBOARD_HOR_RES * DASHBOARD_VER_RES * 3);
+  uint8_t *p = out->data();
+  for (uint32_t i = 0; i < DASHBOARD_HOR_RES * DASHBOARD_VER_RES; i++) {
+    uint16_t c = framebuffer[i];
+    uint8_t r = c >> 11, g = (c >> 5) & 0x3f, b = c & 0x1f;
+    *p++ = (uint8_t)((r << 3) | (r >> 2));
+    *p++ = (uint8_t)((g << 2) | (g >> 4));
+    *p++ = (uint8_t)((b << 3) | (b >> 2));
+  }
+}
+
+/* Length, type, data, and the CRC of type and data */
+static void png_chunk(FILE *f, const char *type, const uint8_t *data, size_t len) {
+  uint8_t hdr[8];
+  put_u32(hdr, (uint32_t)len);
+  memcpy(&hdr[4], type, 4);
+  uint32_t crc = crc32(0, &hdr[4], 4);
+  if (len) crc = crc32(crc, data, len);
+  uint8_t tail[4];
+  put_u32(tail, crc);
+
+  fwrite(hdr, 1, sizeof(hdr), f);
+  if (len) fwrite(data, 1, len, f);
+  fwrite(tail, 1, sizeof(tail), f);
+}
+
+static uint32_t crc32(uint32_t crc, const uint8_t *data, size_t len) {
+  static uint32_t table[256];
+  if (table[1] == 0) {
+    for (uint32_t n = 0; n < 256; n++) {
+      uint32_t c = n;
+      for (int k = 0; k < 8; k++) c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+      table[n] = c;
+    }
+  }
+  crc = ~crc;
+  for (size_t i = 0; i < len; i++) crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+  return ~crc;
+}
+
+/* Big endian, as everything in a PNG */
+static void put_u32(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t)(v >> 24);
+  p[1] = (uint8_t)(v >> 16);
+  p[2] = (uint8_t)(v >> 8);
+  p[3] = (uint8_t)v;
+}
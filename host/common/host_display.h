@@ -0,0 +1,145 @@
+/**
+ * @file host_display.h
+ *
+ * Memory-only display and simulated tick shared by the host benchmarks.
+ * The display matches the board: 480x320 RGB565, a 40 line partial buffer,
+ * the flush cost of the SPI link. Optionally the flushes go through a
+ * simulated link (bandwidth, cost per flush, DMA completing on a thread,
+ * queueing the flushes of a render/flush pipeline).
+ *
+ * The flushed pixels end up in a framebuffer, as the panel would show them,
+ * which can be saved as PPM or PNG and compared with a golden image. The
+ * flushed areas can be recorded too.
+ */
+
+#ifndef HOST_DISPLAY_H
+#define HOST_DISPLAY_H
+
+#include <lvgl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/* A simulated transport to the panel, e.g. SPI, sending in real time */
+typedef struct {
+  uint32_t bytes_per_s;  // e.g. 5000000 for 40 MHz SPI
+  uint32_t flush_us;     // fixed cost of a flush: address window, CS, ...
+  bool dma;              // flush_cb only starts the transfer, the link completes it
+  bool double_buffered;  // render into a second buffer meanwhile
+  uint32_t pipeline;     // buffers for lv_display_set_pipeline(), 0: not used. Needs dma
+} host_link_config_t;
+
+typedef struct {
+  uint32_t flushes;
+  uint64_t bytes;
+  double busy_us;  // time the link was sending
+  double wait_us;  // time LVGL waited for the link, in flush_cb or for a buffer
+  uint32_t max_queued;  // most flushes queued at once
+} host_link_stats_t;
+
+/* A recorded flush */
+typedef struct {
+  lv_area_t area;
+  uint32_t tick;  // simulated ms when flush_cb was called
+  bool last;      // the last area of the refresh
+} host_flush_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Create the display and make LVGL use the simulated tick.
+ * `lv_init()` has to be called first.
+ */
+lv_display_t *host_display_create(void);
+
+/**
+ * Create the display with its flushes going through a simulated link, and the
+ * link's cost for `lv_display_set_flush_cost()`. Without DMA the flush blocks
+ * for the transfer like `pushColors()`. With DMA a link thread sends it and
+ * calls `lv_display_flush_ready()` when done, like the DMA interrupt of
+ * lv_tft_espi_create_dma(). With a pipeline the link queues the transfers
+ * and completes them in order. The display gets host_wall_us() for the band
+ * times of its flush statistics. Uses the simulated tick too.
+ */
+lv_display_t *host_display_create_link(const host_link_config_t *cfg);
+
+/**
+ * Delete a display from either create function and stop its link.
+ */
+void host_display_delete(lv_display_t *disp);
+
+/**
+ * Wait until the link sent everything, e.g. the last area of a refresh.
+ */
+void host_link_wait(void);
+
+const host_link_stats_t *host_link_get_stats(void);
+
+void host_link_reset_stats(void);
+
+/**
+ * The pixels flushed so far, `DASHBOARD_HOR_RES * DASHBOARD_VER_RES` RGB565 values.
+ * Displays rendering RGB565_SWAPPED are swapped back, so it's always what the
+ * panel shows.
+ */
+const uint16_t *host_display_get_framebuffer(void);
+
+/**
+ * Save the framebuffer as a binary PPM (P6), 8 bits per channel.
+ * @return false if the file couldn't be written
+ */
+bool host_display_save_ppm(const char *path);
+
+/**
+ * Save the framebuffer as a PNG, 8 bits per channel. The image data isn't
+ * compressed, so it's about the size of the PPM.
+ * @return false if the file couldn't be written
+ */
+bool host_display_save_png(const char *path);
+
+/**
+ * Compare the framebuffer with a golden image saved by `host_display_save_ppm()`.
+ * @return the number of different pixels, -1 if the file can't be read or has
+ *         another size
+ */
+int32_t host_display_compare_ppm(const char *path);
+
+/**
+ * Start or stop recording the flushed areas. Starting drops the earlier ones.
+ */
+void host_display_record_flushes(bool en);
+
+/**
+ * The flushes recorded since the start or the last clear, in order.
+ * @param cnt  set to the number of flushes
+ */
+const host_flush_t *host_display_get_flushes(uint32_t *cnt);
+
+void host_display_clear_flushes(void);
+
+/**
+ * Simulated time in milliseconds, as seen by `lv_tick_get()`.
+ */
+uint32_t host_tick_get(void);
+
+void host_tick_set(uint32_t ms);
+
+void host_tick_inc(uint32_t ms);
+
+/**
+ * Monotonic wall clock in microseconds, for measuring real execution time.
+ */
+double host_wall_us(void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* HOST_DISPLAY_H */
@@ -0,0 +1,100 @@
+/**
+ * @file flush_seq_test.cpp
+ *
+ * Checks that the end of a refresh is seen with a render/flush pipeline
+ * when the driver is ready before `flush_cb` returns (a synchronous driver
+ * or a DMA transfer finishing at once): the latency monitor's time of the
+ * last flush has to be taken at the last flush of every refresh, with and
+ * without the tile hash, full and partial redraws.
+ *
+ * The exit code is the number of failed checks.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "dashboard.h"
+#include "host_display.h"
+
+#include "src/display/lv_display_private.h"
+
+#include <cstdio>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define CHECK(cond)                                                     \
+  do {                                                                  \
+    if (!(cond)) {                                                      \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);  \
+      failed++;                                                         \
+    }                                                                   \
+  } while (0)
+
+#define BUF_LINES 40
+#define PIPE_CNT 3
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void test_refreshes(lv_display_t *disp, lv_obj_t *label);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static int failed;
+static uint8_t pipe_buf[PIPE_CNT][DASHBOARD_HOR_RES * BUF_LINES * 2];
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(void) {
+  lv_init();
+
+  /* The memory display calls lv_display_flush_ready() in flush_cb */
+  lv_display_t *disp = host_display_create();
+  void *bufs[PIPE_CNT];
+  for (uint32_t i = 0; i < PIPE_CNT; i++) bufs[i] = pipe_buf[i];
+  lv_display_set_pipeline(disp, bufs, PIPE_CNT, sizeof(pipe_buf[0]));
+
+  lv_obj_t *label = lv_label_create(lv_screen_active());
+  lv_obj_align(label, LV_ALIGN_BOTTOM_MID, 0, 0);
+
+  test_refreshes(disp, label);
+  lv_display_set_tile_hash(disp, true);
+  test_refreshes(disp, label);
+
+  host_display_delete(disp);
+  lv_deinit();
+
+  printf("%d failed check(s)\n", failed);
+  return failed;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_refreshes(lv_display_t *disp, lv_obj_t *label) {
+  static uint32_t ms = 1000;
+
+  /* A full redraw, several bands */
+  ms += 100;
+  host_tick_set(ms);
+  lv_obj_invalidate(lv_screen_active());
+  lv_refr_now(disp);
+  CHECK(disp->flush_done == disp->flush_issued);
+  CHECK(disp->flush_last_seq == disp->flush_issued);
+  CHECK(disp->last_flush_ready == ms);
+
+  /* Only the last band changes */
+  for (int i = 0; i < 3; i++) {
+    ms += 100;
+    host_tick_set(ms);
+    lv_label_set_text_fmt(label, "%d km", i);
+    lv_refr_now(disp);
+    CHECK(disp->flush_last_seq == disp->flush_issued);
+    CHECK(disp->last_flush_ready == ms);
+  }
+}
@@ -0,0 +1,178 @@
+/**
+ * @file telemetry_test.cpp
+ *
+ * Checks the telemetry decoder on streams mixing ASCII lines and binary
+ * frames:
+ *   - a stray 0xA5 (and 0xA5 0x5A) inside a line is a character of the line
+ *   - lines and frames back to back, fed one byte at a time
+ *   - a corrupted frame is skipped up to the next frame or line
+ *
+ * The exit code is the number of failed checks.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "telemetry.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define CHECK(cond)                                                     \
+  do {                                                                  \
+    if (!(cond)) {                                                      \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);  \
+      failed++;                                                         \
+    }                                                                   \
+  } while (0)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+  uint32_t binary;
+  uint32_t ascii;
+} decoded_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void test_stray_sync_in_line(void);
+static void test_mixed_stream(void);
+static void test_bad_frame(void);
+static decoded_t feed(telemetry_rx_t *rx, const std::vector<uint8_t> &stream, size_t chunk, telemetry_data_t *d);
+static void append_str(std::vector<uint8_t> *stream, const char *s);
+static void append_frame(std::vector<uint8_t> *stream, const telemetry_data_t *d, uint16_t mask, uint16_t seq);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static int failed;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(void) {
+  test_stray_sync_in_line();
+  test_mixed_stream();
+  test_bad_frame();
+
+  printf("%d failed check(s)\n", failed);
+  return failed;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_stray_sync_in_line(void) {
+  telemetry_rx_t rx;
+  telemetry_data_t d;
+  telemetry_rx_init(&rx);
+  telemetry_data_init(&d);
+
+  std::vector<uint8_t> stream;
+  append_str(&stream, "speed:42,status:\xA5 ON,range:77\n");
+  append_str(&stream, "trip:5,mode:\xA5\x5A,odo:1234\n");
+  decoded_t n = feed(&rx, stream, 1, &d);
+
+  CHECK(n.ascii == 2 && n.binary == 0);
+  CHECK(d.speed == 42 && d.range == 77);
+  CHECK(strcmp(d.status, "\xA5 ON") == 0);
+  CHECK(d.trip == 5 && d.odo == 1234);
+  CHECK(rx.stats.crc_errors == 0);
+}
+
+static void test_mixed_stream(void) {
+  telemetry_rx_t rx;
+  telemetry_data_t d, sent;
+  telemetry_rx_init(&rx);
+  telemetry_data_init(&d);
+  telemetry_data_init(&sent);
+
+  std::vector<uint8_t> stream;
+  sent.speed = 88;
+  sent.odo = 4321;
+  append_str(&stream, "range:150\n");
+  append_frame(&stream, &sent, TELEMETRY_FIELD_BIT(TELEMETRY_FIELD_SPEED), 1);
+  append_str(&stream, "avg_kmh:61,status:A\xA5Z\n");
+  append_frame(&stream, &sent, TELEMETRY_FIELD_BIT(TELEMETRY_FIELD_ODO), 2);
+  append_frame(&stream, &sent, TELEMETRY_FIELD_BIT(TELEMETRY_FIELD_SPEED), 3);
+  append_str(&stream, "motor:70\n");
+
+  for (size_t chunk = 1; chunk <= 64; chunk *= 4) {
+    telemetry_rx_init(&rx);
+    telemetry_data_init(&d);
+    decoded_t n = feed(&rx, stream, chunk, &d);
+
+    CHECK(n.binary == 3 && n.ascii == 3);
+    CHECK(d.range == 150 && d.speed == 88 && d.avg_kmh == 61 && d.odo == 4321 && d.motor_temp == 70);
+    CHECK(strcmp(d.status, "A\xA5Z") == 0);
+    CHECK(rx.stats.crc_errors == 0 && rx.stats.frames_lost == 0);
+  }
+}
+
+static void test_bad_frame(void) {
+  telemetry_rx_t rx;
+  telemetry_data_t d, sent;
+  telemetry_rx_init(&rx);
+  telemetry_data_init(&d);
+  telemetry_data_init(&sent);
+
+  /* A frame with a broken payload, then a good one right after it */
+  std::vector<uint8_t> stream;
+  sent.speed = 11;
+  append_frame(&stream, &sent, TELEMETRY_FIELD_BIT(TELEMETRY_FIELD_SPEED), 1);
+  stream[TELEMETRY_HEADER_SIZE + 4] ^= 0xFF;
+  sent.speed = 22;
+  append_frame(&stream, &sent, TELEMETRY_FIELD_BIT(TELEMETRY_FIELD_SPEED), 2);
+  decoded_t n = feed(&rx, stream, 7, &d);
+
+  CHECK(n.binary == 1 && n.ascii == 0);
+  CHECK(d.speed == 22);
+  CHECK(rx.stats.crc_errors >= 1);
+
+  /* A frame with a broken payload, then lines: the first one is the end of the bad frame */
+  telemetry_rx_init(&rx);
+  telemetry_data_init(&d);
+  stream.clear();
+  append_frame(&stream, &sent, TELEMETRY_FIELD_BIT(TELEMETRY_FIELD_SPEED), 3);
+  stream[TELEMETRY_HEADER_SIZE + 4] ^= 0xFF;
+  append_str(&stream, "battery:9\n");
+  append_str(&stream, "range:33\n");
+  n = feed(&rx, stream, 5, &d);
+
+  CHECK(n.ascii == 1 && n.binary == 0);
+  CHECK(d.range == 33);
+}
+
+/* Push the stream in chunks and decode everything in between */
+static decoded_t feed(telemetry_rx_t *rx, const std::vector<uint8_t> &stream, size_t chunk, telemetry_data_t *d) {
+  decoded_t n = {0, 0};
+  for (size_t pos = 0; pos < stream.size(); pos += chunk) {
+    size_t len = stream.size() - pos < chunk ? stream.size() - pos : chunk;
+    telemetry_rx_push(rx, &stream[pos], len);
+
+    telemetry_format_t res;
+    while ((res = telemetry_rx_poll(rx, d, NULL)) != TELEMETRY_FORMAT_NONE) {
+      if (res == TELEMETRY_FORMAT_BINARY) n.binary++;
+      else n.ascii++;
+    }
+  }
+  return n;
+}
+
+static void append_str(std::vector<uint8_t> *stream, const char *s) {
+  stream->insert(stream->end(), (const uint8_t *)s, (const uint8_t *)s + strlen(s));
+}
+
+static void append_frame(std::vector<uint8_t> *stream, const telemetry_data_t *d, uint16_t mask, uint16_t seq) {
+  uint8_t frame[TELEMETRY_FRAME_MAX];
+  size_t len = telemetry_encode_frame(d, mask, seq, frame, sizeof(frame));
+  stream->insert(stream->end(), frame, frame + len);
+}
@@ -0,0 +1,74 @@
+/**
+ * @file dashboard.h
+ *
+ * The EV dashboard screen. Only depends on LVGL so the same code runs on the
+ * board and in the host build (see host/).
+ */
+
+#ifndef DASHBOARD_H
+#define DASHBOARD_H
+
+#include <lvgl.h>
+#include "telemetry.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define DASHBOARD_HOR_RES 480
+#define DASHBOARD_VER_RES 320
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/* Render statistics, accumulated until `dashboard_reset_stats()` */
+typedef struct {
+  uint32_t updates;         // update_dashboard() calls
+  uint32_t labels_touched;  // labels whose text was set
+  uint32_t labels_skipped;  // labels left alone because their value did not change
+  uint32_t flushes;         // flush_cb calls
+  uint32_t px_flushed;      // pixels sent to the panel
+  uint32_t bytes_flushed;   // bytes sent to the panel
+} dashboard_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Create the dashboard on the active screen of the default display.
+ */
+void create_ev_dashboard_ui(void);
+
+/**
+ * Update the labels whose value differs from what they show.
+ * Rendering is left to the LVGL refresh timer, so several updates within one
+ * refresh period are drawn only once.
+ * @return          true if a label was changed, i.e. something will be redrawn
+ */
+bool update_dashboard(const telemetry_data_t *data);
+
+/**
+ * Update the clock label. It only changes when the minute does.
+ * @param uptime_ms     time since boot
+ */
+void update_time_display(uint32_t uptime_ms);
+
+/**
+ * Count the flushes of `disp` in the statistics.
+ */
+void dashboard_attach_stats(lv_display_t *disp);
+
+const dashboard_stats_t *dashboard_get_stats(void);
+
+void dashboard_reset_stats(void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* DASHBOARD_H */
@@ -0,0 +1,89 @@
+/**
+ * @file run_loop.h
+ *
+ * Tickless main loop: run the LVGL timers, then sleep until the next timer is
+ * due instead of a fixed delay. The sleep ends early when LVGL resumes a timer
+ * (an invalidation, a new animation, ...) or another task calls
+ * `run_loop_wake()`, e.g. when new telemetry was queued.
+ *
+ * Sleeping uses task notifications with LV_OS_FREERTOS and a condition
+ * variable with LV_OS_PTHREAD. Without an OS it falls back to `lv_delay_ms()`
+ * and can't be woken early.
+ */
+
+#ifndef RUN_LOOP_H
+#define RUN_LOOP_H
+
+#include <lvgl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct {
+  uint32_t iterations;  // lv_timer_handler() calls
+  uint32_t woken;       // sleeps cut short by a wakeup
+  uint32_t slept_ms;    // time spent sleeping
+} run_loop_stats_t;
+
+typedef struct {
+  uint32_t max_sleep_ms;
+  lv_timer_t *wake_timer;
+  bool wake_pending;  // run_loop_wake() was called since the last step
+#if LV_USE_OS == LV_OS_FREERTOS
+  TaskHandle_t task;
+#elif LV_USE_OS == LV_OS_PTHREAD
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  bool signaled;
+#endif
+  run_loop_stats_t stats;
+} run_loop_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize the loop in the task that runs LVGL, after `lv_init()`.
+ * It becomes LVGL's timer resume callback.
+ * @param max_sleep_ms  upper bound of one sleep, e.g. to poll something that can't wake the loop
+ */
+void run_loop_init(run_loop_t *rl, uint32_t max_sleep_ms);
+
+void run_loop_deinit(run_loop_t *rl);
+
+/**
+ * Make `timer` ready (and resume it) on every wakeup from another task, so the
+ * work behind the wakeup is done right away. It may pause itself when idle.
+ */
+void run_loop_set_wake_timer(run_loop_t *rl, lv_timer_t *timer);
+
+/**
+ * Run the due LVGL timers, then sleep until the next one or a wakeup.
+ * @return          the time slept in ms
+ */
+uint32_t run_loop_step(run_loop_t *rl);
+
+/**
+ * Wake the loop from another task.
+ */
+void run_loop_wake(run_loop_t *rl);
+
+#if LV_USE_OS == LV_OS_FREERTOS
+/**
+ * Wake the loop from an interrupt handler.
+ */
+void run_loop_wake_isr(run_loop_t *rl);
+#endif
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* RUN_LOOP_H */
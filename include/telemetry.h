@@ -0,0 +1,189 @@
+/**
+ * @file telemetry.h
+ *
+ * Telemetry decoding for the EV dashboard.
+ *
+ * Two wire formats are accepted on the same stream:
+ *  - binary frames (preferred):
+ *      0xA5 0x5A | version | length | payload[length] | crc16 (LE)
+ *    The CRC is CRC-16/CCITT-FALSE over version, length and payload.
+ *    The payload is a fixed-layout, little-endian record whose fields are
+ *    identified by `telemetry_field_t` bits in `field_mask`. Newer versions
+ *    may only append fields, so a v1 decoder reads the v1 prefix of any
+ *    longer payload.
+ *  - ASCII lines (fallback):
+ *      speed:99,range:130,avg_wh:40,...,mode:Sport,status:ARMED\n
+ *
+ * A binary frame is recognized only where a line could start: at the
+ * beginning of the stream, after a newline or after another frame. Inside a
+ * line 0xA5 is an ordinary byte. After a bad frame the bytes are skipped up
+ * to the next sync byte or newline.
+ *
+ * Nothing in here allocates: bytes are pushed into a fixed ring buffer and
+ * frames/lines are decoded in place.
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TELEMETRY_SYNC0             0xA5
+#define TELEMETRY_SYNC1             0x5A
+#define TELEMETRY_VERSION           1
+#define TELEMETRY_HEADER_SIZE       4   /* sync0, sync1, version, length */
+#define TELEMETRY_CRC_SIZE          2
+#define TELEMETRY_MODE_LEN          8   /* including the terminating 0 */
+#define TELEMETRY_STATUS_LEN        12  /* including the terminating 0 */
+#define TELEMETRY_PAYLOAD_V1_SIZE   44
+#define TELEMETRY_FRAME_MAX         (TELEMETRY_HEADER_SIZE + 255 + TELEMETRY_CRC_SIZE)
+
+/* Longest ASCII line accepted; longer lines are dropped */
+#define TELEMETRY_LINE_MAX          160
+
+/* Must be a power of two and hold at least one maximal frame */
+#define TELEMETRY_RX_BUF_SIZE       512
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/* Field IDs. The numeric values are part of the wire format: never reuse or renumber them. */
+typedef enum {
+  TELEMETRY_FIELD_SPEED        = 0,
+  TELEMETRY_FIELD_RANGE        = 1,
+  TELEMETRY_FIELD_AVG_WH       = 2,
+  TELEMETRY_FIELD_TRIP         = 3,
+  TELEMETRY_FIELD_ODO          = 4,
+  TELEMETRY_FIELD_AVG_KMH      = 5,
+  TELEMETRY_FIELD_MOTOR_TEMP   = 6,
+  TELEMETRY_FIELD_BATTERY_TEMP = 7,
+  TELEMETRY_FIELD_MODE         = 8,
+  TELEMETRY_FIELD_STATUS       = 9,
+  TELEMETRY_FIELD_COUNT
+} telemetry_field_t;
+
+#define TELEMETRY_FIELD_BIT(f)      ((uint16_t)(1u << (f)))
+#define TELEMETRY_FIELD_ALL         ((uint16_t)((1u << TELEMETRY_FIELD_COUNT) - 1))
+
+typedef struct {
+  int speed;
+  int range;
+  int avg_wh;
+  int trip;
+  int odo;
+  int avg_kmh;
+  int motor_temp;
+  int battery_temp;
+  char mode[TELEMETRY_MODE_LEN];
+  char status[TELEMETRY_STATUS_LEN];
+} telemetry_data_t;
+
+typedef enum {
+  TELEMETRY_FORMAT_NONE = 0,
+  TELEMETRY_FORMAT_BINARY,
+  TELEMETRY_FORMAT_ASCII,
+} telemetry_format_t;
+
+typedef struct {
+  uint32_t frames_binary;     /* valid binary frames decoded */
+  uint32_t frames_ascii;      /* ASCII lines decoded */
+  uint32_t crc_errors;        /* binary frames rejected by CRC */
+  uint32_t version_errors;    /* binary frames with an unknown/too short layout */
+  uint32_t overflows;         /* bytes dropped because the ring was full */
+  uint32_t line_too_long;     /* ASCII lines dropped for exceeding TELEMETRY_LINE_MAX */
+  uint32_t frames_lost;       /* binary frames missing from the sequence numbers */
+} telemetry_stats_t;
+
+/* Receive context: a fixed ring buffer and the decoder statistics */
+typedef struct {
+  uint8_t buf[TELEMETRY_RX_BUF_SIZE];
+  uint32_t head;              /* read index (free running) */
+  uint32_t tail;              /* write index (free running) */
+  uint16_t seq;               /* sequence number of the last binary frame */
+  bool seq_valid;             /* `seq` was received, the next frame can be checked for a gap */
+  bool discard_line;          /* skipping the rest of an over-long ASCII line */
+  bool resync;                /* after a bad binary frame: skipping to the next sync byte or newline */
+  telemetry_stats_t stats;
+} telemetry_rx_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize `data` with the values shown at startup.
+ */
+void telemetry_data_init(telemetry_data_t *data);
+
+/**
+ * Reset a receive context.
+ */
+void telemetry_rx_init(telemetry_rx_t *rx);
+
+/**
+ * Append received bytes to the ring buffer.
+ * @return  number of bytes stored; the rest are dropped and counted in `stats.overflows`
+ */
+size_t telemetry_rx_push(telemetry_rx_t *rx, const uint8_t *bytes, size_t len);
+
+/**
+ * Number of bytes that can still be pushed.
+ */
+size_t telemetry_rx_free(const telemetry_rx_t *rx);
+
+/**
+ * Decode the next complete frame or line from the ring buffer into `data`.
+ * Only the fields present in the input are written.
+ * @param rx        receive context
+ * @param data      values to update
+ * @param changed   if not NULL, receives the `TELEMETRY_FIELD_BIT`s written
+ * @return          the format that was decoded or `TELEMETRY_FORMAT_NONE` if more bytes are needed
+ */
+telemetry_format_t telemetry_rx_poll(telemetry_rx_t *rx, telemetry_data_t *data, uint16_t *changed);
+
+/**
+ * Parse one ASCII `key:value,...` line. Unknown keys are ignored.
+ * @param line      the characters of the line (not necessarily 0 terminated)
+ * @param len       length of `line`
+ * @param data      values to update
+ * @return          the `TELEMETRY_FIELD_BIT`s written
+ */
+uint16_t telemetry_parse_line(const char *line, size_t len, telemetry_data_t *data);
+
+/**
+ * Encode the fields in `mask` as a binary frame.
+ * @param data      values to send
+ * @param mask      `TELEMETRY_FIELD_BIT`s to mark as present
+ * @param seq       sequence number
+ * @param out       destination buffer
+ * @param out_size  size of `out`
+ * @return          the length of the frame or 0 if `out` is too small
+ */
+size_t telemetry_encode_frame(const telemetry_data_t *data, uint16_t mask, uint16_t seq,
+                              uint8_t *out, size_t out_size);
+
+/**
+ * CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF).
+ */
+uint16_t telemetry_crc16(uint16_t crc, const uint8_t *data, size_t len);
+
+/**
+ * Name of a field as used by the ASCII format, e.g. "speed".
+ */
+const char *telemetry_field_name(telemetry_field_t field);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TELEMETRY_H */
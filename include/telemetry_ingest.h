@@ -0,0 +1,115 @@
+/**
+ * @file telemetry_ingest.h
+ *
+ * Telemetry reception on its own task. The reader task reads the serial port,
+ * decodes frames (see telemetry.h) and passes them through a telemetry_queue_t;
+ * the UI drains the queue once per refresh and only sees the latest values.
+ *
+ * The task is created with the LVGL OSAL, so LV_USE_OS has to be set
+ * (LV_OS_FREERTOS on the board, LV_OS_PTHREAD on the host). Without an OS
+ * `telemetry_ingest_start()` fails and `telemetry_ingest_poll()` has to be
+ * called from the main loop instead.
+ */
+
+#ifndef TELEMETRY_INGEST_H
+#define TELEMETRY_INGEST_H
+
+#include <lvgl.h>
+#include "telemetry.h"
+#include "telemetry_queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TELEMETRY_INGEST_STACK_SIZE (4 * 1024)
+#define TELEMETRY_INGEST_CHUNK      64
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/* Read at most `max_len` received bytes into `buf` and return their number.
+ * Called in a loop by the reader task: when nothing was received it should
+ * wait a little (e.g. 1 ms) before returning 0. */
+typedef size_t (*telemetry_read_cb_t)(void *user_data, uint8_t *buf, size_t max_len);
+
+/* Called by the reader task after it queued a record, e.g. to wake the UI */
+typedef void (*telemetry_notify_cb_t)(void *user_data);
+
+typedef struct {
+  uint32_t bytes;     // bytes read (reader)
+  uint32_t frames;    // frames decoded (reader)
+  uint32_t merged;    // frames merged into the previous one because the queue was full (reader)
+  uint32_t drains;    // drains that returned at least one record (UI)
+  uint32_t records;   // records taken by the drains (UI)
+} telemetry_ingest_stats_t;
+
+typedef struct {
+  telemetry_queue_t queue;
+
+  /* Reader side */
+  telemetry_read_cb_t read_cb;
+  void *user_data;
+  telemetry_notify_cb_t notify_cb;
+  void *notify_user_data;
+  telemetry_rx_t rx;
+  telemetry_data_t data;
+  uint32_t t_frame;  // when the first byte of the frame being received was read
+  telemetry_record_t pending;
+  bool has_pending;
+  lv_thread_t thread;
+  bool started;
+  bool exit;         // asks the reader task to return
+  bool running;      // cleared by the reader task as it returns
+
+  telemetry_ingest_stats_t stats;
+} telemetry_ingest_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+void telemetry_ingest_init(telemetry_ingest_t *ing, telemetry_read_cb_t read_cb, void *user_data);
+
+/**
+ * Set a callback to run in the reader task whenever a record was queued.
+ * Must be set before `telemetry_ingest_start()`.
+ */
+void telemetry_ingest_set_notify_cb(telemetry_ingest_t *ing, telemetry_notify_cb_t notify_cb, void *user_data);
+
+/**
+ * Start the reader task.
+ * @return          LV_RESULT_INVALID if there is no OS or the task could not be created
+ */
+lv_result_t telemetry_ingest_start(telemetry_ingest_t *ing, lv_thread_prio_t prio);
+
+/**
+ * Stop the reader task started by `telemetry_ingest_start()`.
+ * Returns once the task finished its current read and left the loop.
+ */
+void telemetry_ingest_stop(telemetry_ingest_t *ing);
+
+/**
+ * One step of the reader: read once, decode and queue what was completed.
+ * Called by the reader task or, without one, from the main loop.
+ */
+void telemetry_ingest_poll(telemetry_ingest_t *ing);
+
+/**
+ * UI side: take everything queued since the last call.
+ * @param data      receives the latest values if something was queued
+ * @param changed   if not NULL, receives the TELEMETRY_FIELD_BITs written since the last call
+ * @param t_ms      if not NULL, receives when the oldest of these frames started to arrive (lv_tick_get())
+ * @return          the number of records taken, 0 if `data` was not touched
+ */
+uint32_t telemetry_ingest_drain(telemetry_ingest_t *ing, telemetry_data_t *data, uint16_t *changed, uint32_t *t_ms);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TELEMETRY_INGEST_H */
@@ -0,0 +1,79 @@
+/**
+ * @file telemetry_queue.h
+ *
+ * Lock-free single-producer/single-consumer ring of decoded telemetry, used to
+ * hand frames from the serial reader task to the UI (see telemetry_ingest.h).
+ *
+ * Every record carries the complete `telemetry_data_t` after its frame was
+ * applied, so the consumer can skip to the newest record and still show the
+ * latest value of every field.
+ */
+
+#ifndef TELEMETRY_QUEUE_H
+#define TELEMETRY_QUEUE_H
+
+#include "telemetry.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/* Number of records, must be a power of 2 */
+#define TELEMETRY_QUEUE_LEN 16
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct {
+  telemetry_data_t data;  // all fields after this frame was applied
+  uint16_t changed;       // TELEMETRY_FIELD_BITs written by this frame
+  uint32_t id;            // frame counter of the producer
+  uint32_t t_ms;          // when the first byte of the frame (or of merged frames) was read
+} telemetry_record_t;
+
+/* `head` is only written by the producer, `tail` only by the consumer.
+ * Both are free running and wrap at 2^32. */
+typedef struct {
+  telemetry_record_t rec[TELEMETRY_QUEUE_LEN];
+  uint32_t head;
+  uint32_t tail;
+  uint32_t full;  // records dropped because the queue was full, counted once each by the producer
+} telemetry_queue_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+void telemetry_queue_init(telemetry_queue_t *q);
+
+/**
+ * Producer: append a record.
+ * @return          false if the queue is full; the producer may retry later and counts
+ *                  the record in `full` only if it gives it up
+ */
+bool telemetry_queue_push(telemetry_queue_t *q, const telemetry_record_t *rec);
+
+/**
+ * Consumer: take the oldest record.
+ * @return          false if the queue is empty
+ */
+bool telemetry_queue_pop(telemetry_queue_t *q, telemetry_record_t *rec);
+
+/**
+ * Consumer: take every queued record at once.
+ * @param last      receives the newest record; its `changed` is the OR of all taken records
+ *                  and its `t_ms` the one of the oldest
+ * @return          the number of records taken, 0 if the queue was empty (`last` is untouched)
+ */
+uint32_t telemetry_queue_drain(telemetry_queue_t *q, telemetry_record_t *last);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TELEMETRY_QUEUE_H */
@@ -0,0 +1,89 @@
+/**
+ * @file telemetry_rec.h
+ *
+ * Telemetry capture format, used to record what arrives on the serial port and
+ * replay it later (see host/bench/telemetry_replay.cpp).
+ *
+ * A capture is the magic "EVREC1\n" followed by records:
+ *   t_ms (u32 LE) | len (u16 LE) | bytes[len]
+ * `t_ms` is the time the bytes were handed to the telemetry decoder; `bytes`
+ * are exactly what was read from the port (binary frames and/or ASCII lines,
+ * possibly split at arbitrary places).
+ */
+
+#ifndef TELEMETRY_REC_H
+#define TELEMETRY_REC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TELEMETRY_REC_MAGIC         "EVREC1\n"
+#define TELEMETRY_REC_MAGIC_SIZE    7
+#define TELEMETRY_REC_HEADER_SIZE   6
+#define TELEMETRY_REC_MAX_LEN       0xFFFF
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/* Write `len` bytes to the capture; return the number of bytes written */
+typedef size_t (*telemetry_rec_write_cb_t)(void *user_data, const uint8_t *data, size_t len);
+
+typedef struct {
+  telemetry_rec_write_cb_t write_cb;
+  void *user_data;
+  uint32_t records;
+  uint32_t bytes;
+  uint32_t write_errors;
+} telemetry_rec_t;
+
+/* One record of a capture. `data` points into the capture buffer. */
+typedef struct {
+  uint32_t t_ms;
+  uint16_t len;
+  const uint8_t *data;
+} telemetry_rec_entry_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Start a capture: write the magic.
+ */
+void telemetry_rec_start(telemetry_rec_t *rec, telemetry_rec_write_cb_t write_cb, void *user_data);
+
+/**
+ * Record bytes received at `t_ms`. Longer inputs are split into several records.
+ */
+void telemetry_rec_add(telemetry_rec_t *rec, uint32_t t_ms, const uint8_t *bytes, size_t len);
+
+/**
+ * Check whether `buf` starts with the capture magic.
+ */
+bool telemetry_rec_is_capture(const uint8_t *buf, size_t len);
+
+/**
+ * Read the record at `*pos` of a capture held in memory.
+ * @param buf       the whole capture
+ * @param len       length of `buf`
+ * @param pos       offset of the record; set to the next one on success.
+ *                  Start with `TELEMETRY_REC_MAGIC_SIZE`.
+ * @param entry     receives the record
+ * @return          false at the end of the capture or on a truncated record
+ */
+bool telemetry_rec_next(const uint8_t *buf, size_t len, size_t *pos, telemetry_rec_entry_t *entry);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TELEMETRY_REC_H */
@@ -0,0 +1,201 @@
+/**
+ * @file gt911.cpp
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "gt911.h"
+#include <string.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define REG_MODULE_SWITCH1 0x804D  // bits 0-1: INT trigger
+#define REG_PRODUCT_ID     0x8140  // 4 chars, then firmware version, X and Y resolution
+#define REG_STATUS         0x814E  // bit 7: buffer ready, bits 0-3: number of points
+#define REG_POINTS         0x814F
+
+#define STATUS_READY 0x80
+#define POINT_SIZE   8  // track ID, x, y, size (little endian), reserved
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool read_report(gt911_t *ts, gt911_report_t *r);
+static void queue_report(gt911_t *ts, const gt911_report_t *r);
+static void indev_read_cb(lv_indev_t *indev, lv_indev_data_t *data);
+static void map_point(const gt911_t *ts, const gt911_point_t *p, lv_point_t *out);
+static bool i2c_read(gt911_t *ts, uint16_t reg, uint8_t *buf, size_t len);
+static bool i2c_write(gt911_t *ts, uint16_t reg, const uint8_t *buf, size_t len);
+static uint16_t get_le16(const uint8_t *p);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void gt911_init(gt911_t *ts, const gt911_i2c_t *i2c) {
+  memset(ts, 0, sizeof(*ts));
+  ts->i2c = *i2c;
+}
+
+bool gt911_probe(gt911_t *ts) {
+  uint8_t info[10];
+  if (!i2c_read(ts, REG_PRODUCT_ID, info, sizeof(info))) return false;
+  if (info[0] != '9') return false;
+
+  memcpy(ts->product_id, info, 4);
+  ts->product_id[4] = '\0';
+  ts->hor_res = get_le16(&info[6]);
+  ts->ver_res = get_le16(&info[8]);
+
+  uint8_t sw1;
+  if (!i2c_read(ts, REG_MODULE_SWITCH1, &sw1, 1)) return false;
+  ts->int_trigger = sw1 & 0x03;
+  return true;
+}
+
+void gt911_set_flags(gt911_t *ts, uint8_t flags) {
+  ts->flags = flags;
+}
+
+lv_indev_t *gt911_create_indev(gt911_t *ts) {
+  lv_indev_t *indev = lv_indev_create();
+  lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
+  lv_indev_set_read_cb(indev, indev_read_cb);
+  lv_indev_set_driver_data(indev, ts);
+  /* LVGL still runs the read timer while pressed, for long presses and
+   * scrolling; the read callback answers from the buffer then */
+  lv_indev_set_mode(indev, LV_INDEV_MODE_EVENT);
+  ts->indev = indev;
+  return indev;
+}
+
+bool gt911_handle(gt911_t *ts) {
+  uint32_t irqs = __atomic_load_n(&ts->irq_cnt, __ATOMIC_ACQUIRE);
+  if (irqs == ts->irq_handled) return false;
+  ts->irq_handled = irqs;
+  ts->stats.handled++;
+
+  gt911_report_t r;
+  if (!read_report(ts, &r)) return false;
+  ts->stats.reports++;
+  queue_report(ts, &r);
+
+  /* Each read takes one report. LVGL skips reading during screen animations,
+   * then the rest waits for the next interrupt or the read timer. */
+  if (ts->indev) {
+    for (uint8_t n = ts->len; n > 0 && ts->len > 0; n--) lv_indev_read(ts->indev);
+  }
+  return true;
+}
+
+const gt911_report_t *gt911_get_report(const gt911_t *ts) {
+  return &ts->last;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* Two transactions for one finger: the status with the first point, then
+ * clearing the status. More fingers take one more read. */
+static bool read_report(gt911_t *ts, gt911_report_t *r) {
+  uint8_t buf[1 + GT911_MAX_POINTS * POINT_SIZE];
+  if (!i2c_read(ts, REG_STATUS, buf, 1 + POINT_SIZE)) return false;
+
+  /* Not ready: the pulse came before the coordinates, nothing to clear */
+  uint8_t status = buf[0];
+  if (!(status & STATUS_READY)) return false;
+
+  uint8_t cnt = status & 0x0F;
+  if (cnt > GT911_MAX_POINTS) cnt = GT911_MAX_POINTS;
+  bool ok = cnt <= 1 ||
+            i2c_read(ts, REG_POINTS + POINT_SIZE, &buf[1 + POINT_SIZE], (cnt - 1) * POINT_SIZE);
+
+  /* The controller doesn't update the buffer until the status is cleared */
+  uint8_t zero = 0;
+  if (!i2c_write(ts, REG_STATUS, &zero, 1) || !ok) return false;
+
+  r->cnt = cnt;
+  r->t_ms = lv_tick_get();
+  for (uint8_t i = 0; i < cnt; i++) {
+    const uint8_t *p = &buf[1 + i * POINT_SIZE];
+    r->points[i].id = p[0];
+    r->points[i].x = get_le16(&p[1]);
+    r->points[i].y = get_le16(&p[3]);
+    r->points[i].size = get_le16(&p[5]);
+  }
+  return true;
+}
+
+/* A full buffer keeps the newest report, so a release is never lost */
+static void queue_report(gt911_t *ts, const gt911_report_t *r) {
+  uint8_t i;
+  if (ts->len == GT911_REPORT_QUEUE_LEN) {
+    i = (ts->head + ts->len - 1) % GT911_REPORT_QUEUE_LEN;
+    ts->stats.dropped++;
+  } else {
+    i = (ts->head + ts->len) % GT911_REPORT_QUEUE_LEN;
+    ts->len++;
+  }
+  ts->queue[i] = *r;
+}
+
+static void indev_read_cb(lv_indev_t *indev, lv_indev_data_t *data) {
+  gt911_t *ts = (gt911_t *)lv_indev_get_driver_data(indev);
+
+  if (ts->len > 0) {
+    ts->last = ts->queue[ts->head];
+    ts->head = (ts->head + 1) % GT911_REPORT_QUEUE_LEN;
+    ts->len--;
+  } else if (ts->last.cnt > 0 && lv_tick_elaps(ts->last.t_ms) > GT911_RELEASE_TIMEOUT_MS) {
+    ts->last.cnt = 0;
+    ts->stats.timeouts++;
+  }
+
+  /* A release has no coordinates, LVGL gets the last ones */
+  if (ts->last.cnt > 0) {
+    map_point(ts, &ts->last.points[0], &ts->point);
+    data->state = LV_INDEV_STATE_PRESSED;
+  } else {
+    data->state = LV_INDEV_STATE_RELEASED;
+  }
+  data->point = ts->point;
+}
+
+static void map_point(const gt911_t *ts, const gt911_point_t *p, lv_point_t *out) {
+  int32_t x = p->x, y = p->y;
+  int32_t w = ts->hor_res, h = ts->ver_res;
+  if (ts->flags & GT911_SWAP_XY) {
+    int32_t t = x;
+    x = y;
+    y = t;
+    t = w;
+    w = h;
+    h = t;
+  }
+  if ((ts->flags & GT911_INVERT_X) && x < w) x = w - 1 - x;
+  if ((ts->flags & GT911_INVERT_Y) && y < h) y = h - 1 - y;
+  out->x = x;
+  out->y = y;
+}
+
+static bool i2c_read(gt911_t *ts, uint16_t reg, uint8_t *buf, size_t len) {
+  ts->stats.i2c++;
+  if (ts->i2c.read(ts->i2c.user_data, reg, buf, len)) return true;
+  ts->stats.errors++;
+  return false;
+}
+
+static bool i2c_write(gt911_t *ts, uint16_t reg, const uint8_t *buf, size_t len) {
+  ts->stats.i2c++;
+  if (ts->i2c.write(ts->i2c.user_data, reg, buf, len)) return true;
+  ts->stats.errors++;
+  return false;
+}
+
+static uint16_t get_le16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
@@ -0,0 +1,157 @@
+/**
+ * @file gt911.h
+ *
+ * Interrupt-driven driver for the Goodix GT911 touch controller.
+ *
+ * The GT911 pulses its INT line once per scan while a finger is down and once
+ * more after it was lifted. The interrupt handler only counts the pulse
+ * (`gt911_irq()`); the LVGL task then reads the report over I2C in
+ * `gt911_handle()`, buffers it and feeds it to an indev in
+ * LV_INDEV_MODE_EVENT. The indev read callback never touches the bus, so
+ * there is no I2C traffic while nobody touches the panel.
+ *
+ * I2C goes through `gt911_i2c_t`, so the driver also runs on the host
+ * against a mock device (host/common/gt911_mock.h).
+ */
+
+#ifndef GT911_H
+#define GT911_H
+
+#include <lvgl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+/* 7-bit I2C addresses, selected by the INT level while RST is released */
+#define GT911_ADDR_5D 0x5D  // INT low
+#define GT911_ADDR_14 0x14  // INT high
+
+#define GT911_MAX_POINTS 5
+
+/* Reports buffered until LVGL reads them, e.g. during a screen animation */
+#define GT911_REPORT_QUEUE_LEN 8
+
+/* A pressed state without a new report for this long is released. The
+ * controller reports every ~10 ms while touched, so this only catches a lost
+ * release interrupt. */
+#define GT911_RELEASE_TIMEOUT_MS 100
+
+/* gt911_t.flags: mapping of the controller's coordinates to the display's,
+ * applied in this order */
+#define GT911_SWAP_XY   0x01
+#define GT911_INVERT_X  0x02
+#define GT911_INVERT_Y  0x04
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/* Read `len` bytes starting at the 16-bit register `reg` (one I2C transaction) */
+typedef bool (*gt911_i2c_read_cb_t)(void *user_data, uint16_t reg, uint8_t *buf, size_t len);
+
+/* Write `len` bytes starting at `reg` (one I2C transaction) */
+typedef bool (*gt911_i2c_write_cb_t)(void *user_data, uint16_t reg, const uint8_t *buf, size_t len);
+
+typedef struct {
+  gt911_i2c_read_cb_t read;
+  gt911_i2c_write_cb_t write;
+  void *user_data;
+} gt911_i2c_t;
+
+/* Coordinates as reported by the controller, before the mapping */
+typedef struct {
+  uint8_t id;     // track ID, stays the same while a finger is down
+  uint16_t x;
+  uint16_t y;
+  uint16_t size;
+} gt911_point_t;
+
+typedef struct {
+  uint8_t cnt;  // 0: all fingers lifted
+  gt911_point_t points[GT911_MAX_POINTS];
+  uint32_t t_ms;  // lv_tick_get() when it was read
+} gt911_report_t;
+
+typedef struct {
+  uint32_t handled;   // gt911_handle() calls that found an interrupt
+  uint32_t i2c;       // I2C transactions
+  uint32_t errors;    // failed I2C transactions
+  uint32_t reports;   // reports read, including releases
+  uint32_t dropped;   // reports overwritten because LVGL didn't read the buffer
+  uint32_t timeouts;  // releases after GT911_RELEASE_TIMEOUT_MS
+} gt911_stats_t;
+
+typedef struct {
+  gt911_i2c_t i2c;
+  char product_id[5];
+  uint16_t hor_res;  // the controller's resolution, from gt911_probe()
+  uint16_t ver_res;
+  uint8_t int_trigger;  // 0: rising, 1: falling, 2: low level, 3: high level
+  uint8_t flags;        // GT911_SWAP_XY, ...
+
+  uint32_t irq_cnt;  // INT pulses, written by the interrupt handler
+  uint32_t irq_handled;
+
+  /* LVGL task only */
+  gt911_report_t queue[GT911_REPORT_QUEUE_LEN];
+  uint8_t head;
+  uint8_t len;
+  gt911_report_t last;  // the report LVGL saw last
+  lv_point_t point;     // where the first finger was last, mapped
+  lv_indev_t *indev;
+
+  gt911_stats_t stats;
+} gt911_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * @param i2c       the transport, copied
+ */
+void gt911_init(gt911_t *ts, const gt911_i2c_t *i2c);
+
+/**
+ * Read the product ID, the resolution and the interrupt trigger. The
+ * controller has to be out of reset.
+ * @return          false if it didn't answer or isn't a GT9xx
+ */
+bool gt911_probe(gt911_t *ts);
+
+void gt911_set_flags(gt911_t *ts, uint8_t flags);
+
+/**
+ * Create a pointer indev in LV_INDEV_MODE_EVENT fed by `gt911_handle()`.
+ */
+lv_indev_t *gt911_create_indev(gt911_t *ts);
+
+/**
+ * Note an INT pulse. Only this may be called from an interrupt handler.
+ */
+static inline void gt911_irq(gt911_t *ts) {
+  __atomic_add_fetch(&ts->irq_cnt, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * In the LVGL task: if INT pulsed since the last call, read the report and
+ * pass it to LVGL. Pulses in between are coalesced, the controller only keeps
+ * the latest report anyway.
+ * @return          true if a report was read
+ */
+bool gt911_handle(gt911_t *ts);
+
+/**
+ * The report LVGL saw last, with all fingers. The indev uses the first one.
+ */
+const gt911_report_t *gt911_get_report(const gt911_t *ts);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* GT911_H */
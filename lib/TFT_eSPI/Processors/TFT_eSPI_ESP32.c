@@ -778,6 +778,31 @@ void IRAM_ATTR dma_end_callback(spi_transaction_t *spi_tx)
   WRITE_PERI_REG(SPI_DMA_CONF_REG(spi_host), 0);
 }
 
+/***************************************************************************************
+** Function name:           dma_post_callback
+** Description:             End of a DMA transfer, notify the sketch
+***************************************************************************************/
+static void (*dma_done_cb)(void *user_data) = nullptr;
+static void *dma_done_user_data = nullptr;
+
+static void IRAM_ATTR dma_post_callback(spi_transaction_t *spi_tx)
+{
+  #ifndef CONFIG_IDF_TARGET_ESP32
+    dma_end_callback(spi_tx);
+  #endif
+  if (dma_done_cb) dma_done_cb(dma_done_user_data);
+}
+
+/***************************************************************************************
+** Function name:           setDMADoneCallback
+** Description:             Set the function called when a DMA transfer has completed
+***************************************************************************************/
+void TFT_eSPI::setDMADoneCallback(void (*done)(void *user_data), void *user_data)
+{
+  dma_done_cb = done;
+  dma_done_user_data = user_data;
+}
+
 /***************************************************************************************
 ** Function name:           initDMA
 ** Description:             Initialise the DMA engine - returns true if init OK
@@ -821,11 +846,7 @@ bool TFT_eSPI::initDMA(bool ctrl_cs)
     .flags = SPI_DEVICE_NO_DUMMY, //0,
     .queue_size = 1,
     .pre_cb = 0, //dc_callback, //Callback to handle D/C line
-    #ifdef CONFIG_IDF_TARGET_ESP32
-      .post_cb = 0
-    #else
-      .post_cb = dma_end_callback
-    #endif
+    .post_cb = dma_post_callback
   };
   ret = spi_bus_initialize(spi_host, &buscfg, DMA_CHANNEL);
   ESP_ERROR_CHECK(ret);
@@ -107,6 +107,18 @@
 /*The target buffer size for simple layer chunks.*/
 #define LV_DRAW_LAYER_SIMPLE_BUF_SIZE    (24 * 1024)   /*[bytes]*/
 
+/*Index the pending draw tasks of a layer in a grid of this many cells (e.g. 64) to find the tasks a task overlaps faster, 0: check all of them*/
+#define LV_DRAW_TASK_INDEX_CELLS    0
+
+/*The draw tasks of a layer, their descriptors and label texts are allocated in chunks of this size
+ *(e.g. 4 * 1024) which are reused when all the tasks of the layer are finished, instead of `lv_malloc()`
+ *one by one. 0: allocate and free them one by one*/
+#define LV_DRAW_ARENA_CHUNK_SIZE    0   /*[bytes]*/
+
+/*Don't render what's covered anyway: when all the draw tasks of a layer are added, drop or clip
+ *the ones under a newer opaque fill or image. See `lv_display_set_draw_cull()`*/
+#define LV_USE_DRAW_CULL            0
+
 #define LV_USE_DRAW_SW 1
 #if LV_USE_DRAW_SW == 1
     /* Set the number of draw unit.
@@ -268,6 +280,10 @@
 /*1: Draw random colored rectangles over the redrawn areas*/
 #define LV_USE_REFR_DEBUG 0
 
+/*1: Count the blends of every pixel and the invalidations of every object,
+ *see `lv_refr_heatmap_enable()`*/
+#define LV_USE_REFR_HEATMAP 0
+
 /*1: Draw a red overlay for ARGB layers and a green overlay for RGB layers*/
 #define LV_USE_LAYER_DEBUG 0
 
@@ -296,6 +312,12 @@
  *The main logic is like `LV_CACHE_DEF_SIZE` but for image headers.*/
 #define LV_IMAGE_HEADER_CACHE_DEF_CNT 0
 
+/*Objects with `LV_OBJ_FLAG_RENDER_CACHE` are rendered once with their children into a buffer and drawn
+ *from it until something in them changes. The buffers are accounted in the image cache (`LV_CACHE_DEF_SIZE`
+ *has to be > 0) and this is the limit for all of them, keep it below `LV_CACHE_DEF_SIZE`.
+ *0: ignore the flag*/
+#define LV_OBJ_RENDER_CACHE_SIZE 0
+
 /*Number of stops allowed per gradient. Increase this to allow more stops.
  *This adds (sizeof(lv_color_t) + 1) bytes per additional stop*/
 #define LV_GRADIENT_MAX_STOPS   2
@@ -346,13 +368,14 @@
 /*For big endian systems set to 1*/
 #define LV_BIG_ENDIAN_SYSTEM 0
 
-/*Define a custom attribute to `lv_tick_inc` function*/
+/*Define a custom attribute to `lv_tick_inc` and `lv_tick_get` functions*/
 #define LV_ATTRIBUTE_TICK_INC
 
 /*Define a custom attribute to `lv_timer_handler` function*/
 #define LV_ATTRIBUTE_TIMER_HANDLER
 
-/*Define a custom attribute to `lv_display_flush_ready` function*/
+/*Define a custom attribute to `lv_display_flush_ready` function,
+ *e.g. `IRAM_ATTR` on ESP32 if it's called from a DMA interrupt (set `LV_ATTRIBUTE_TICK_INC` too)*/
 #define LV_ATTRIBUTE_FLUSH_READY
 
 /*Required alignment size for buffers*/
@@ -434,6 +457,15 @@
 /*Enables/disables support for compressed fonts.*/
 #define LV_USE_FONT_COMPRESSED 0
 
+/*Size of the cache of decoded glyph bitmaps in bytes, 0: disable it.
+ *The A8 bitmaps of the built-in and the loaded fonts are kept by font, glyph and bpp,
+ *so e.g. the glyphs of compressed fonts are decompressed once instead of every time they are drawn.*/
+#define LV_FONT_FMT_TXT_CACHE_SIZE 0
+
+/*Enable `lv_font_fmt_txt_create_lut()` to find the glyphs of a font in constant time:
+ *U+0000..U+00FF from a table, the other code points from a hash table, instead of searching the cmaps.*/
+#define LV_USE_FONT_FMT_TXT_LUT 0
+
 /*Enable drawing placeholders when glyph dsc is not found*/
 #define LV_USE_FONT_PLACEHOLDER 1
 
@@ -769,6 +801,17 @@
         #define LV_USE_MEM_MONITOR_POS LV_ALIGN_BOTTOM_LEFT
     #endif
 
+    /*1: Measure the time from an input (see `lv_sysmon_latency_input()`) until the refresh
+     * showing it was flushed. Cheap enough to keep enabled in production.
+     * Requires `LV_USE_SYSMON = 1`*/
+    #define LV_USE_LATENCY_MONITOR 0
+    #if LV_USE_LATENCY_MONITOR
+        #define LV_USE_LATENCY_MONITOR_POS LV_ALIGN_TOP_RIGHT
+
+        /*0: Displays the latency on the screen, 1: Prints it using log, 2: Only the `lv_sysmon_get_latency()` API*/
+        #define LV_USE_LATENCY_MONITOR_LOG_MODE 0
+    #endif
+
 #endif /*LV_USE_SYSMON*/
 
 /*1: Enable the runtime performance profiler*/
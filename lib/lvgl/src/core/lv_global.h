@@ -38,6 +38,7 @@ extern "C" {
 
 #include "../tick/lv_tick.h"
 #include "../layouts/lv_layout.h"
+#include "lv_obj_render_cache.h"
 
 /*********************
  *      DEFINES
@@ -111,6 +112,10 @@ typedef struct _lv_global_t {
     lv_cache_t * img_header_cache;
 #endif
 
+#if LV_OBJ_RENDER_CACHE_SIZE
+    _lv_obj_render_cache_state_t obj_render_cache;
+#endif
+
     lv_draw_global_info_t draw_info;
 #if defined(LV_DRAW_SW_SHADOW_CACHE_SIZE) && LV_DRAW_SW_SHADOW_CACHE_SIZE > 0
     lv_draw_sw_shadow_cache_t sw_shadow_cache;
@@ -175,6 +180,14 @@ typedef struct _lv_global_t {
     lv_font_fmt_rle_t font_fmt_rle;
 #endif
 
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+    lv_font_fmt_txt_cache_t font_fmt_txt_cache;
+#endif
+
+#if LV_USE_FONT_FMT_TXT_LUT
+    lv_font_fmt_txt_lut_t * font_fmt_txt_lut_head;
+#endif
+
 #if LV_USE_SPAN != 0
     struct _snippet_stack * span_snippet_stack;
 #endif
@@ -195,6 +208,10 @@ typedef struct _lv_global_t {
     lv_sysmon_backend_data_t sysmon_mem;
 #endif
 
+#if LV_USE_SYSMON && LV_USE_LATENCY_MONITOR
+    lv_sysmon_backend_data_t sysmon_latency;
+#endif
+
 #if LV_USE_IME_PINYIN != 0
     size_t ime_cand_len;
 #endif
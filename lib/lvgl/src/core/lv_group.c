@@ -78,7 +78,7 @@ void lv_group_delete(lv_group_t * group)
     LV_ASSERT_NULL(group);
     if(group->obj_focus != NULL) {
         lv_obj_send_event(*group->obj_focus, LV_EVENT_DEFOCUSED, get_indev(group));
-        lv_obj_invalidate(*group->obj_focus);
+        _lv_obj_invalidate_for(*group->obj_focus, LV_INV_REASON_STATE);
     }
 
     /*Remove the objects from the group*/
@@ -227,7 +227,7 @@ void lv_group_remove_all_objs(lv_group_t * group)
     /*Defocus the currently focused object*/
     if(group->obj_focus != NULL) {
         lv_obj_send_event(*group->obj_focus, LV_EVENT_DEFOCUSED, get_indev(group));
-        lv_obj_invalidate(*group->obj_focus);
+        _lv_obj_invalidate_for(*group->obj_focus, LV_INV_REASON_STATE);
         group->obj_focus = NULL;
     }
 
@@ -257,7 +257,7 @@ void lv_group_focus_obj(lv_obj_t * obj)
             if(g->obj_focus != NULL && obj != *g->obj_focus) {  /*Do not defocus if the same object needs to be focused again*/
                 lv_result_t res = lv_obj_send_event(*g->obj_focus, LV_EVENT_DEFOCUSED, get_indev(g));
                 if(res != LV_RESULT_OK) return;
-                lv_obj_invalidate(*g->obj_focus);
+                _lv_obj_invalidate_for(*g->obj_focus, LV_INV_REASON_STATE);
             }
 
             g->obj_focus = i;
@@ -266,7 +266,7 @@ void lv_group_focus_obj(lv_obj_t * obj)
                 if(g->focus_cb) g->focus_cb(g);
                 lv_result_t res = lv_obj_send_event(*g->obj_focus, LV_EVENT_FOCUSED, get_indev(g));
                 if(res != LV_RESULT_OK) return;
-                lv_obj_invalidate(*g->obj_focus);
+                _lv_obj_invalidate_for(*g->obj_focus, LV_INV_REASON_STATE);
             }
             break;
         }
@@ -343,7 +343,7 @@ void lv_group_set_editing(lv_group_t * group, bool edit)
         lv_result_t res = lv_obj_send_event(*group->obj_focus, LV_EVENT_FOCUSED, get_indev(group));
         if(res != LV_RESULT_OK) return;
 
-        lv_obj_invalidate(focused);
+        _lv_obj_invalidate_for(focused, LV_INV_REASON_STATE);
     }
 }
 
@@ -495,7 +495,7 @@ static bool focus_next_core(lv_group_t * group, void * (*begin)(const lv_ll_t *)
     if(group->obj_focus) {
         lv_result_t res = lv_obj_send_event(*group->obj_focus, LV_EVENT_DEFOCUSED, get_indev(group));
         if(res != LV_RESULT_OK) return focus_changed;
-        lv_obj_invalidate(*group->obj_focus);
+        _lv_obj_invalidate_for(*group->obj_focus, LV_INV_REASON_STATE);
     }
 
     group->obj_focus = obj_next;
@@ -503,7 +503,7 @@ static bool focus_next_core(lv_group_t * group, void * (*begin)(const lv_ll_t *)
     lv_result_t res = lv_obj_send_event(*group->obj_focus, LV_EVENT_FOCUSED, get_indev(group));
     if(res != LV_RESULT_OK) return focus_changed;
 
-    lv_obj_invalidate(*group->obj_focus);
+    _lv_obj_invalidate_for(*group->obj_focus, LV_INV_REASON_STATE);
 
     if(group->focus_cb) group->focus_cb(group);
     focus_changed = true;
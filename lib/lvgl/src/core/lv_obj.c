@@ -118,7 +118,7 @@ void lv_obj_add_flag(lv_obj_t * obj, lv_obj_flag_t f)
     bool was_on_layout = lv_obj_is_layout_positioned(obj);
 
     /* We must invalidate the area occupied by the object before we hide it as calls to invalidate hidden objects are ignored */
-    if(f & LV_OBJ_FLAG_HIDDEN) lv_obj_invalidate(obj);
+    if(f & LV_OBJ_FLAG_HIDDEN) _lv_obj_invalidate_for(obj, LV_INV_REASON_STATE);
 
     obj->flags |= f;
 
@@ -129,7 +129,7 @@ void lv_obj_add_flag(lv_obj_t * obj, lv_obj_flag_t f)
                 lv_group_focus_next(group);
                 lv_obj_t * next_obj = lv_group_get_focused(group);
                 if(next_obj != NULL) {
-                    lv_obj_invalidate(next_obj);
+                    _lv_obj_invalidate_for(next_obj, LV_INV_REASON_STATE);
                 }
             }
         }
@@ -143,8 +143,8 @@ void lv_obj_add_flag(lv_obj_t * obj, lv_obj_flag_t f)
     if(f & LV_OBJ_FLAG_SCROLLABLE) {
         lv_area_t hor_area, ver_area;
         lv_obj_get_scrollbar_area(obj, &hor_area, &ver_area);
-        lv_obj_invalidate_area(obj, &hor_area);
-        lv_obj_invalidate_area(obj, &ver_area);
+        _lv_obj_invalidate_area_for(obj, &hor_area, LV_INV_REASON_STATE);
+        _lv_obj_invalidate_area_for(obj, &ver_area, LV_INV_REASON_STATE);
     }
 }
 
@@ -156,14 +156,18 @@ void lv_obj_remove_flag(lv_obj_t * obj, lv_obj_flag_t f)
     if(f & LV_OBJ_FLAG_SCROLLABLE) {
         lv_area_t hor_area, ver_area;
         lv_obj_get_scrollbar_area(obj, &hor_area, &ver_area);
-        lv_obj_invalidate_area(obj, &hor_area);
-        lv_obj_invalidate_area(obj, &ver_area);
+        _lv_obj_invalidate_area_for(obj, &hor_area, LV_INV_REASON_STATE);
+        _lv_obj_invalidate_area_for(obj, &ver_area, LV_INV_REASON_STATE);
     }
 
     obj->flags &= (~f);
 
+#if LV_OBJ_RENDER_CACHE_SIZE
+    if(f & LV_OBJ_FLAG_RENDER_CACHE) _lv_obj_render_cache_free(obj);
+#endif
+
     if(f & LV_OBJ_FLAG_HIDDEN) {
-        lv_obj_invalidate(obj);
+        _lv_obj_invalidate_for(obj, LV_INV_REASON_STATE);
         if(lv_obj_is_layout_positioned(obj)) {
             lv_obj_mark_layout_as_dirty(lv_obj_get_parent(obj));
             lv_obj_mark_layout_as_dirty(obj);
@@ -375,6 +379,10 @@ static void lv_obj_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
 
         lv_event_remove_all(&obj->spec_attr->event_list);
 
+#if LV_OBJ_RENDER_CACHE_SIZE
+        _lv_obj_render_cache_free(obj);
+#endif
+
         lv_free(obj->spec_attr);
         obj->spec_attr = NULL;
     }
@@ -668,8 +676,8 @@ static void lv_obj_event(const lv_obj_class_t * class_p, lv_event_t * e)
         if(lv_obj_get_scrollbar_mode(obj) == LV_SCROLLBAR_MODE_ACTIVE) {
             lv_area_t hor_area, ver_area;
             lv_obj_get_scrollbar_area(obj, &hor_area, &ver_area);
-            lv_obj_invalidate_area(obj, &hor_area);
-            lv_obj_invalidate_area(obj, &ver_area);
+            _lv_obj_invalidate_area_for(obj, &hor_area, LV_INV_REASON_SCROLL);
+            _lv_obj_invalidate_area_for(obj, &ver_area, LV_INV_REASON_SCROLL);
         }
     }
     else if(code == LV_EVENT_DEFOCUSED) {
@@ -737,7 +745,7 @@ static void update_obj_state(lv_obj_t * obj, lv_state_t new_state)
     }
 
     /*Invalidate the object in their current state*/
-    lv_obj_invalidate(obj);
+    _lv_obj_invalidate_for(obj, LV_INV_REASON_STATE);
 
     obj->state = new_state;
     _lv_obj_update_layer_type(obj);
@@ -794,7 +802,7 @@ static void update_obj_state(lv_obj_t * obj, lv_state_t new_state)
         lv_obj_refresh_style(obj, LV_PART_ANY, LV_STYLE_PROP_ANY);
     }
     else if(cmp_res == _LV_STYLE_STATE_CMP_DIFF_DRAW_PAD) {
-        lv_obj_invalidate(obj);
+        _lv_obj_invalidate_for(obj, LV_INV_REASON_STATE);
         lv_obj_refresh_ext_draw_size(obj);
     }
 }
@@ -119,7 +119,7 @@ void lv_obj_class_init_obj(lv_obj_t * obj)
         lv_obj_send_event(parent, LV_EVENT_CHILD_CREATED, obj);
 
         /*Invalidate the area if not screen created*/
-        lv_obj_invalidate(obj);
+        _lv_obj_invalidate_for(obj, LV_INV_REASON_TREE);
     }
 }
 
@@ -158,7 +158,7 @@ bool lv_obj_refr_size(lv_obj_t * obj)
     if(lv_obj_get_width(obj) == w && lv_obj_get_height(obj) == h) return false;
 
     /*Invalidate the original area*/
-    lv_obj_invalidate(obj);
+    _lv_obj_invalidate_for(obj, LV_INV_REASON_LAYOUT);
 
     /*Save the original coordinates*/
     lv_area_t ori;
@@ -190,7 +190,7 @@ bool lv_obj_refr_size(lv_obj_t * obj)
     lv_obj_send_event(parent, LV_EVENT_CHILD_CHANGED, obj);
 
     /*Invalidate the new area*/
-    lv_obj_invalidate(obj);
+    _lv_obj_invalidate_for(obj, LV_INV_REASON_LAYOUT);
 
     obj->readjust_scroll_after_layout = 1;
 
@@ -707,7 +707,7 @@ void lv_obj_move_to(lv_obj_t * obj, int32_t x, int32_t y)
     if(diff.x == 0 && diff.y == 0) return;
 
     /*Invalidate the original area*/
-    lv_obj_invalidate(obj);
+    _lv_obj_invalidate_for(obj, LV_INV_REASON_LAYOUT);
 
     /*Save the original coordinates*/
     lv_area_t ori;
@@ -736,7 +736,7 @@ void lv_obj_move_to(lv_obj_t * obj, int32_t x, int32_t y)
     if(parent) lv_obj_send_event(parent, LV_EVENT_CHILD_CHANGED, obj);
 
     /*Invalidate the new area*/
-    lv_obj_invalidate(obj);
+    _lv_obj_invalidate_for(obj, LV_INV_REASON_LAYOUT);
 
     /*If the object was out of the parent invalidate the new scrollbar area too.
      *If it wasn't out of the parent but out now, also invalidate the scrollbars*/
@@ -804,9 +804,24 @@ void lv_obj_get_transformed_area(const lv_obj_t * obj, lv_area_t * area, lv_obj_
 }
 
 void lv_obj_invalidate_area(const lv_obj_t * obj, const lv_area_t * area)
+{
+    _lv_obj_invalidate_area_for(obj, area, LV_INV_REASON_CONTENT);
+}
+
+void lv_obj_invalidate(const lv_obj_t * obj)
+{
+    _lv_obj_invalidate_for(obj, LV_INV_REASON_CONTENT);
+}
+
+void _lv_obj_invalidate_area_for(const lv_obj_t * obj, const lv_area_t * area, lv_inv_reason_t reason)
 {
     LV_ASSERT_OBJ(obj, MY_CLASS);
 
+#if LV_OBJ_RENDER_CACHE_SIZE
+    /*Even if it's not visible now, the caches would be outdated when it is*/
+    _lv_obj_render_cache_invalidate(obj);
+#endif
+
     lv_display_t * disp   = lv_obj_get_display(obj);
     if(!lv_display_is_invalidation_enabled(disp)) return;
 
@@ -820,10 +835,10 @@ void lv_obj_invalidate_area(const lv_obj_t * obj, const lv_area_t * area)
         lv_area_increase(&area_tmp, 5, 5);
     }
 
-    _lv_inv_area(lv_obj_get_display(obj),  &area_tmp);
+    _lv_inv_area_from(lv_obj_get_display(obj), &area_tmp, obj, reason);
 }
 
-void lv_obj_invalidate(const lv_obj_t * obj)
+void _lv_obj_invalidate_for(const lv_obj_t * obj, lv_inv_reason_t reason)
 {
     LV_ASSERT_OBJ(obj, MY_CLASS);
 
@@ -836,7 +851,7 @@ void lv_obj_invalidate(const lv_obj_t * obj)
     obj_coords.x2 += ext_size;
     obj_coords.y2 += ext_size;
 
-    lv_obj_invalidate_area(obj, &obj_coords);
+    _lv_obj_invalidate_area_for(obj, &obj_coords, reason);
 }
 
 bool lv_obj_area_is_visible(const lv_obj_t * obj, lv_area_t * area)
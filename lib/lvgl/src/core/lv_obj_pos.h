@@ -37,6 +37,18 @@ typedef enum {
     LV_OBJ_POINT_TRANSFORM_FLAG_INVERSE_RECURSIVE = 0x03,
 } lv_obj_point_transform_flag_t;
 
+/** Why an area was invalidated, see `LV_USE_REFR_HEATMAP`*/
+typedef enum {
+    LV_INV_REASON_CONTENT,  /**< The widget changed what it draws, e.g. a label's text*/
+    LV_INV_REASON_LAYOUT,   /**< Moved or resized*/
+    LV_INV_REASON_STYLE,    /**< A style property or a transition*/
+    LV_INV_REASON_STATE,    /**< A state or flag changed, e.g. pressed, hidden or focused*/
+    LV_INV_REASON_SCROLL,
+    LV_INV_REASON_TREE,     /**< Created, deleted or moved in the tree*/
+    LV_INV_REASON_DISPLAY,  /**< Not by an object, e.g. a screen load or a new resolution*/
+    _LV_INV_REASON_LAST
+} lv_inv_reason_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -385,6 +397,22 @@ void lv_obj_invalidate_area(const lv_obj_t * obj, const lv_area_t * area);
  */
 void lv_obj_invalidate(const lv_obj_t * obj);
 
+/**
+ * Like `lv_obj_invalidate_area()`, but saying why. `lv_obj_invalidate_area()` is used by the
+ * widgets, so it's `LV_INV_REASON_CONTENT`.
+ * @param obj       pointer to an object
+ * @param area      the area to redraw
+ * @param reason    why it has to be redrawn
+ */
+void _lv_obj_invalidate_area_for(const lv_obj_t * obj, const lv_area_t * area, lv_inv_reason_t reason);
+
+/**
+ * Like `lv_obj_invalidate()`, but saying why.
+ * @param obj       pointer to an object
+ * @param reason    why it has to be redrawn
+ */
+void _lv_obj_invalidate_for(const lv_obj_t * obj, lv_inv_reason_t reason);
+
 /**
  * Tell whether an area of an object is visible (even partially) now or not
  * @param obj       pointer to an object
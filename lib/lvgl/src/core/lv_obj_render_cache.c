@@ -0,0 +1,343 @@
+/**
+ * @file lv_obj_render_cache.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_obj.h"
+#if LV_OBJ_RENDER_CACHE_SIZE
+
+#include "lv_refr.h"
+#include "lv_global.h"
+#include "../display/lv_display.h"
+#include "../display/lv_display_private.h"
+#include "../draw/lv_draw.h"
+#include "../draw/lv_draw_image.h"
+#include "../draw/lv_image_decoder.h"
+#include "../misc/cache/lv_cache.h"
+#include "../stdlib/lv_mem.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define render_cache_p (&LV_GLOBAL_DEFAULT()->obj_render_cache)
+#define img_cache_p (LV_GLOBAL_DEFAULT()->img_cache)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+struct _lv_obj_render_cache_t {
+    lv_draw_buf_t * buf;            /**< The rendered subtree, NULL if there is no valid one*/
+    lv_cache_entry_t * entry;       /**< The image cache entry of `buf`, acquired while it's valid*/
+    lv_area_t area;                 /**< Where `buf` was rendered*/
+    lv_opa_t opa;                   /**< The opacity inherited from the parents when it was rendered*/
+    bool stale;                     /**< Invalidated while rendering, `buf` is dropped when the refresh ends*/
+    _lv_obj_render_cache_t * next_stale;    /**< The next one in `stale_head`*/
+    uint32_t changed_refr;          /**< `refr_cnt` when something in the subtree changed last*/
+};
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static lv_result_t render(lv_display_t * disp, lv_obj_t * obj, _lv_obj_render_cache_t * rc, const lv_area_t * area);
+static bool is_opaque(lv_obj_t * obj, const lv_area_t * area);
+static void drop(_lv_obj_render_cache_t * rc);
+static void decoder_close(lv_image_decoder_t * decoder, lv_image_decoder_dsc_t * dsc);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void _lv_obj_render_cache_init(void)
+{
+    lv_memzero(render_cache_p, sizeof(_lv_obj_render_cache_state_t));
+
+    /*The caches are found by their source in `lv_image_decoder_open()`.
+     *Without `info_cb` this decoder is never asked to open an image.*/
+    lv_image_decoder_t * decoder = lv_image_decoder_create();
+    LV_ASSERT_MALLOC(decoder);
+    if(decoder == NULL) return;
+
+    lv_image_decoder_set_close_cb(decoder, decoder_close);
+    render_cache_p->decoder = decoder;
+}
+
+bool _lv_obj_render_cache_draw(lv_layer_t * layer, lv_obj_t * obj)
+{
+    /*The children drawn out of the object could be anywhere*/
+    if(lv_obj_has_flag(obj, LV_OBJ_FLAG_OVERFLOW_VISIBLE)) return false;
+    if(render_cache_p->decoder == NULL) return false;
+
+    lv_area_t area;
+    lv_obj_get_coords(obj, &area);
+    int32_t ext_draw_size = _lv_obj_get_ext_draw_size(obj);
+    lv_area_increase(&area, ext_draw_size, ext_draw_size);
+
+    /*Like `lv_obj_redraw()` do nothing if it's not on the clip area*/
+    lv_area_t clip_area;
+    if(!_lv_area_intersect(&clip_area, &area, &layer->_clip_area)) return true;
+
+    /*Cache only what's on the display*/
+    lv_display_t * disp = _lv_refr_get_disp_refreshing();
+    lv_area_t disp_area;
+    lv_area_set(&disp_area, 0, 0, lv_display_get_horizontal_resolution(disp) - 1,
+                lv_display_get_vertical_resolution(disp) - 1);
+    if(!_lv_area_intersect(&area, &area, &disp_area)) return true;
+
+    if(obj->spec_attr == NULL || obj->spec_attr->render_cache == NULL) {
+        lv_obj_allocate_spec_attr(obj);
+        _lv_obj_render_cache_t * rc = lv_malloc_zeroed(sizeof(_lv_obj_render_cache_t));
+        LV_ASSERT_MALLOC(rc);
+        if(rc == NULL) return false;
+
+        /*Not known to be stable yet*/
+        rc->changed_refr = render_cache_p->refr_cnt;
+        obj->spec_attr->render_cache = rc;
+    }
+
+    _lv_obj_render_cache_t * rc = obj->spec_attr->render_cache;
+
+    /*Still used by the draw tasks of this refresh, but it doesn't show the subtree anymore*/
+    if(rc->stale) return false;
+
+    lv_opa_t opa = lv_obj_get_style_opa_recursive(obj, LV_PART_MAIN);
+
+    /*Moved, e.g. a parent was scrolled, or a parent's opacity changed*/
+    if(rc->buf && (!_lv_area_is_equal(&rc->area, &area) || rc->opa != opa)) {
+        drop(rc);
+        render_cache_p->stats.drop_cnt++;
+        rc->changed_refr = render_cache_p->refr_cnt;
+    }
+
+    if(rc->buf == NULL) {
+        /*If it changed for this refresh it might change again soon: don't render it twice*/
+        if(rc->changed_refr == render_cache_p->refr_cnt) return false;
+        /*Only what covers its area is cached, so the buffer is copied as it is and the result
+         *is the same as drawing the subtree*/
+        if(!is_opaque(obj, &area)) return false;
+        if(render(disp, obj, rc, &area) != LV_RESULT_OK) return false;
+        rc->opa = opa;
+    }
+    else {
+        render_cache_p->stats.hit_cnt++;
+    }
+
+    lv_draw_image_dsc_t draw_dsc;
+    lv_draw_image_dsc_init(&draw_dsc);
+    draw_dsc.src = rc->buf;
+    lv_draw_image(layer, &draw_dsc, &rc->area);
+
+    return true;
+}
+
+void _lv_obj_render_cache_invalidate(const lv_obj_t * obj)
+{
+    while(obj) {
+        if(obj->spec_attr && obj->spec_attr->render_cache) {
+            _lv_obj_render_cache_t * rc = obj->spec_attr->render_cache;
+            rc->changed_refr = render_cache_p->refr_cnt;
+            if(rc->buf) {
+                /*The queued draw tasks might still use the cache, drop it when the refresh ends*/
+                if(lv_obj_get_display(obj)->rendering_in_progress) {
+                    if(!rc->stale) {
+                        rc->stale = true;
+                        rc->next_stale = render_cache_p->stale_head;
+                        render_cache_p->stale_head = rc;
+                    }
+                }
+                else {
+                    drop(rc);
+                    render_cache_p->stats.drop_cnt++;
+                }
+            }
+        }
+        obj = obj->parent;
+    }
+}
+
+void _lv_obj_render_cache_refr_finished(void)
+{
+    render_cache_p->refr_cnt++;
+
+    while(render_cache_p->stale_head) {
+        _lv_obj_render_cache_t * rc = render_cache_p->stale_head;
+        render_cache_p->stale_head = rc->next_stale;
+        rc->stale = false;
+        rc->next_stale = NULL;
+        drop(rc);
+        render_cache_p->stats.drop_cnt++;
+
+        /*It changed during this refresh: don't cache it again in the next one*/
+        rc->changed_refr = render_cache_p->refr_cnt;
+    }
+}
+
+void _lv_obj_render_cache_free(lv_obj_t * obj)
+{
+    if(obj->spec_attr == NULL || obj->spec_attr->render_cache == NULL) return;
+
+    _lv_obj_render_cache_t * rc = obj->spec_attr->render_cache;
+    if(rc->stale) {
+        _lv_obj_render_cache_t ** next_p = &render_cache_p->stale_head;
+        while(*next_p != rc) next_p = &(*next_p)->next_stale;
+        *next_p = rc->next_stale;
+    }
+
+    drop(obj->spec_attr->render_cache);
+    lv_free(obj->spec_attr->render_cache);
+    obj->spec_attr->render_cache = NULL;
+}
+
+const lv_obj_render_cache_stats_t * lv_obj_get_render_cache_stats(void)
+{
+    return &render_cache_p->stats;
+}
+
+void lv_obj_reset_render_cache_stats(void)
+{
+    /*The size is not a counter, it's what's held now*/
+    uint32_t size = render_cache_p->stats.size;
+    lv_memzero(&render_cache_p->stats, sizeof(lv_obj_render_cache_stats_t));
+    render_cache_p->stats.size = size;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Render an object and its children into a new cache
+ * @param disp      the display being refreshed
+ * @param obj       the object to render
+ * @param rc        its render cache without a buffer
+ * @param area      the area to render, the object's coordinates with the extra draw size on the display
+ * @return          LV_RESULT_OK: rendered; LV_RESULT_INVALID: it doesn't fit into the cache
+ */
+static lv_result_t render(lv_display_t * disp, lv_obj_t * obj, _lv_obj_render_cache_t * rc, const lv_area_t * area)
+{
+    int32_t w = lv_area_get_width(area);
+    int32_t h = lv_area_get_height(area);
+    lv_color_format_t cf = LV_COLOR_FORMAT_NATIVE;
+
+    uint32_t size = lv_draw_buf_width_to_stride(w, cf) * h;
+    if(render_cache_p->stats.size + size > LV_OBJ_RENDER_CACHE_SIZE) {
+        render_cache_p->stats.skip_cnt++;
+        return LV_RESULT_INVALID;
+    }
+
+    lv_draw_buf_t * buf = lv_draw_buf_create(w, h, cf, LV_STRIDE_AUTO);
+    if(buf == NULL) {
+        render_cache_p->stats.skip_cnt++;
+        return LV_RESULT_INVALID;
+    }
+
+    /*Add it first to not render it in vain. The entry is kept acquired, so only `drop()` frees it.*/
+    lv_image_cache_data_t search_key;
+    lv_memzero(&search_key, sizeof(search_key));
+    search_key.src_type = LV_IMAGE_SRC_VARIABLE;
+    search_key.src = buf;
+    search_key.slot.size = buf->data_size;
+    lv_cache_entry_t * entry = lv_image_decoder_add_to_cache(render_cache_p->decoder, &search_key, buf, NULL);
+    if(entry == NULL) {
+        lv_draw_buf_destroy(buf);
+        render_cache_p->stats.skip_cnt++;
+        return LV_RESULT_INVALID;
+    }
+
+    lv_layer_t layer;
+    lv_memzero(&layer, sizeof(layer));
+    layer.draw_buf = buf;
+    layer.buf_area = *area;
+    layer._clip_area = *area;
+    layer.color_format = cf;
+#if LV_USE_DRAW_CULL
+    layer._cull_pending = disp->draw_cull;
+#endif
+
+    /*Like in `lv_snapshot_take_to_draw_buf()` dispatch only this layer and its children,
+     *the display's layers continue after it*/
+    lv_layer_t * layer_head_ori = disp->layer_head;
+    disp->layer_head = &layer;
+
+    lv_obj_redraw(&layer, obj);
+#if LV_USE_DRAW_CULL
+    if(layer._cull_pending) {
+        _lv_draw_cull_layer(&layer);
+        lv_draw_dispatch();
+    }
+#endif
+
+    while(layer.draw_task_head) {
+        lv_draw_dispatch_wait_for_request();
+        lv_draw_dispatch_layer(disp, &layer);
+    }
+    _lv_draw_layer_deinit(&layer);
+
+    disp->layer_head = layer_head_ori;
+
+    rc->buf = buf;
+    rc->entry = entry;
+    rc->area = *area;
+    render_cache_p->stats.size += buf->data_size;
+    render_cache_p->stats.render_cnt++;
+
+    return LV_RESULT_OK;
+}
+
+/**
+ * Check if an object covers its whole cache area with full opacity, i.e. nothing under it shows
+ * through and its cache can be drawn without alpha
+ */
+static bool is_opaque(lv_obj_t * obj, const lv_area_t * area)
+{
+    if(!_lv_area_is_in(area, &obj->coords, 0)) return false;
+    if(lv_obj_get_style_opa_recursive(obj, LV_PART_MAIN) < LV_OPA_MAX) return false;
+    if(lv_obj_get_style_blend_mode(obj, LV_PART_MAIN) != LV_BLEND_MODE_NORMAL) return false;
+
+    lv_cover_check_info_t info;
+    info.res = LV_COVER_RES_COVER;
+    info.area = area;
+    lv_obj_send_event(obj, LV_EVENT_COVER_CHECK, &info);
+    return info.res == LV_COVER_RES_COVER;
+}
+
+/**
+ * Drop the buffer of a render cache. It's freed now, or when the last draw task using it is finished.
+ */
+static void drop(_lv_obj_render_cache_t * rc)
+{
+    if(rc->buf == NULL) return;
+
+    render_cache_p->stats.size -= rc->buf->data_size;
+
+    lv_image_cache_data_t search_key;
+    lv_memzero(&search_key, sizeof(search_key));
+    search_key.src_type = LV_IMAGE_SRC_VARIABLE;
+    search_key.src = rc->buf;
+    lv_cache_drop(img_cache_p, &search_key, NULL);
+    lv_cache_release(img_cache_p, rc->entry, NULL);
+
+    rc->buf = NULL;
+    rc->entry = NULL;
+}
+
+static void decoder_close(lv_image_decoder_t * decoder, lv_image_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(decoder);
+
+    /*Opened only from the cache, release the entry acquired by `lv_image_decoder_open()`*/
+    lv_cache_release(dsc->cache, dsc->cache_entry, NULL);
+}
+
+#endif /*LV_OBJ_RENDER_CACHE_SIZE*/
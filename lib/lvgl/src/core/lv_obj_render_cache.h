@@ -0,0 +1,114 @@
+/**
+ * @file lv_obj_render_cache.h
+ * Render caches of object subtrees.
+ * An object with `LV_OBJ_FLAG_RENDER_CACHE` is rendered with its children into a draw buffer
+ * the first time it's redrawn without having changed since the previous refresh. Until something
+ * in the subtree is invalidated, the buffer is drawn instead of the subtree.
+ * Only objects covering their area with full opacity are cached (in `LV_COLOR_FORMAT_NATIVE`),
+ * so drawing the buffer gives the same pixels as drawing the subtree.
+ * The buffers are entries of the image cache, acquired while they are valid, and all of them
+ * together are limited to `LV_OBJ_RENDER_CACHE_SIZE` bytes.
+ */
+
+#ifndef LV_OBJ_RENDER_CACHE_H
+#define LV_OBJ_RENDER_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_conf_internal.h"
+#include "../misc/lv_types.h"
+
+#if LV_OBJ_RENDER_CACHE_SIZE
+
+#if LV_CACHE_DEF_SIZE == 0
+#error "LV_OBJ_RENDER_CACHE_SIZE needs the image cache, set LV_CACHE_DEF_SIZE > 0 too"
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct _lv_obj_render_cache_t _lv_obj_render_cache_t;
+
+typedef struct {
+    uint32_t render_cnt;    /**< Subtrees rendered into their cache*/
+    uint32_t hit_cnt;       /**< Subtrees drawn from their cache*/
+    uint32_t drop_cnt;      /**< Caches dropped because something in the subtree changed*/
+    uint32_t skip_cnt;      /**< Subtrees drawn directly because their cache didn't fit*/
+    uint32_t size;          /**< Bytes held by the caches now*/
+} lv_obj_render_cache_stats_t;
+
+typedef struct {
+    lv_image_decoder_t * decoder;       /**< Owner of the cache entries, it can't open any image*/
+    lv_obj_render_cache_stats_t stats;
+    uint32_t refr_cnt;                  /**< Finished refreshes*/
+    _lv_obj_render_cache_t * stale_head; /**< Caches invalidated during the current refresh*/
+} _lv_obj_render_cache_state_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize the render caches. Called by `lv_init()` after the image decoders.
+ */
+void _lv_obj_render_cache_init(void);
+
+/**
+ * Draw an object and its children from its render cache, rendering the cache first if it's missing.
+ * @param layer     the layer to draw to
+ * @param obj       an object with `LV_OBJ_FLAG_RENDER_CACHE`
+ * @return          true: drawn; false: the cache can't be used now, draw `obj` as usual
+ */
+bool _lv_obj_render_cache_draw(lv_layer_t * layer, lv_obj_t * obj);
+
+/**
+ * Drop the render caches of an object and its parents because something in them changed.
+ * During a refresh the queued draw tasks might still use them: they are dropped when it ends.
+ * @param obj       an object being invalidated
+ */
+void _lv_obj_render_cache_invalidate(const lv_obj_t * obj);
+
+/**
+ * Count a finished refresh and drop the caches invalidated during it.
+ * Called by `_lv_display_refr_timer()` when all the draw tasks are finished.
+ */
+void _lv_obj_render_cache_refr_finished(void);
+
+/**
+ * Free the render cache of an object. Called when it's deleted or the flag is removed.
+ * @param obj       pointer to an object
+ */
+void _lv_obj_render_cache_free(lv_obj_t * obj);
+
+/**
+ * Get the statistics of the render caches
+ * @return          the counters since the last `lv_obj_reset_render_cache_stats()` and the size held now
+ */
+const lv_obj_render_cache_stats_t * lv_obj_get_render_cache_stats(void);
+
+/**
+ * Reset the counters of the render cache statistics. The size held is kept.
+ */
+void lv_obj_reset_render_cache_stats(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_OBJ_RENDER_CACHE_SIZE*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_OBJ_RENDER_CACHE_H*/
@@ -61,7 +61,7 @@ void lv_obj_set_scrollbar_mode(lv_obj_t * obj, lv_scrollbar_mode_t mode)
 
     if(obj->spec_attr->scrollbar_mode == mode) return;
     obj->spec_attr->scrollbar_mode = mode;
-    lv_obj_invalidate(obj);
+    _lv_obj_invalidate_for(obj, LV_INV_REASON_SCROLL);
 }
 
 void lv_obj_set_scroll_dir(lv_obj_t * obj, lv_dir_t dir)
@@ -420,7 +420,7 @@ lv_result_t _lv_obj_scroll_by_raw(lv_obj_t * obj, int32_t x, int32_t y)
     lv_obj_move_children_by(obj, x, y, true);
     lv_result_t res = lv_obj_send_event(obj, LV_EVENT_SCROLL, NULL);
     if(res != LV_RESULT_OK) return res;
-    lv_obj_invalidate(obj);
+    _lv_obj_invalidate_for(obj, LV_INV_REASON_SCROLL);
     return LV_RESULT_OK;
 }
 
@@ -624,8 +624,8 @@ void lv_obj_scrollbar_invalidate(lv_obj_t * obj)
 
     if(lv_area_get_size(&hor_area) <= 0 && lv_area_get_size(&ver_area) <= 0) return;
 
-    if(lv_area_get_size(&hor_area) > 0) lv_obj_invalidate_area(obj, &hor_area);
-    if(lv_area_get_size(&ver_area) > 0) lv_obj_invalidate_area(obj, &ver_area);
+    if(lv_area_get_size(&hor_area) > 0) _lv_obj_invalidate_area_for(obj, &hor_area, LV_INV_REASON_SCROLL);
+    if(lv_area_get_size(&ver_area) > 0) _lv_obj_invalidate_area_for(obj, &ver_area, LV_INV_REASON_SCROLL);
 }
 
 void lv_obj_readjust_scroll(lv_obj_t * obj, lv_anim_enable_t anim_en)
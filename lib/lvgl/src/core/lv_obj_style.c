@@ -101,7 +101,7 @@ void lv_obj_add_style(lv_obj_t * obj, const lv_style_t * style, lv_style_selecto
     lv_part_t part = lv_obj_style_get_selector_part(selector);
 
     if(style && part == LV_PART_MAIN && style_has_flag(style, LV_STYLE_PROP_FLAG_TRANSFORM)) {
-        lv_obj_invalidate(obj);
+        _lv_obj_invalidate_for(obj, LV_INV_REASON_STYLE);
     }
 
     /*Try removing the style first to be sure it won't be added twice*/
@@ -205,7 +205,7 @@ void lv_obj_remove_style(lv_obj_t * obj, const lv_style_t * style, lv_style_sele
     if(style && style->prop_cnt == 0) prop = LV_STYLE_PROP_INV;
 
     if(style && part == LV_PART_MAIN && style_has_flag(style, LV_STYLE_PROP_FLAG_TRANSFORM)) {
-        lv_obj_invalidate(obj);
+        _lv_obj_invalidate_for(obj, LV_INV_REASON_STYLE);
     }
 
     uint32_t i = 0;
@@ -275,7 +275,7 @@ void lv_obj_refresh_style(lv_obj_t * obj, lv_style_selector_t selector, lv_style
 
     if(!style_refr) return;
 
-    lv_obj_invalidate(obj);
+    _lv_obj_invalidate_for(obj, LV_INV_REASON_STYLE);
 
     lv_part_t part = lv_obj_style_get_selector_part(selector);
 
@@ -306,7 +306,7 @@ void lv_obj_refresh_style(lv_obj_t * obj, lv_style_selector_t selector, lv_style
     if(prop == LV_STYLE_PROP_ANY || is_ext_draw) {
         lv_obj_refresh_ext_draw_size(obj);
     }
-    lv_obj_invalidate(obj);
+    _lv_obj_invalidate_for(obj, LV_INV_REASON_STYLE);
 
     if(prop == LV_STYLE_PROP_ANY || (is_inheritable && (is_ext_draw || is_layout_refr))) {
         if(part != LV_PART_SCROLLBAR) {
@@ -352,7 +352,7 @@ void lv_obj_set_local_style_prop(lv_obj_t * obj, lv_style_prop_t prop, lv_style_
 {
     lv_style_t * style = get_local_style(obj, selector);
     if(selector == LV_PART_MAIN && lv_style_prop_has_flag(prop, LV_STYLE_PROP_FLAG_TRANSFORM)) {
-        lv_obj_invalidate(obj);
+        _lv_obj_invalidate_for(obj, LV_INV_REASON_STYLE);
     }
 
     lv_style_set_prop(style, prop, value);
@@ -774,9 +774,9 @@ static void refresh_children_style(lv_obj_t * obj)
     uint32_t child_cnt = lv_obj_get_child_count(obj);
     for(i = 0; i < child_cnt; i++) {
         lv_obj_t * child = obj->spec_attr->children[i];
-        lv_obj_invalidate(child);
+        _lv_obj_invalidate_for(child, LV_INV_REASON_STYLE);
         lv_obj_send_event(child, LV_EVENT_STYLE_CHANGED, NULL);
-        lv_obj_invalidate(child);
+        _lv_obj_invalidate_for(child, LV_INV_REASON_STYLE);
 
         refresh_children_style(child); /*Check children too*/
     }
@@ -57,7 +57,7 @@ void lv_obj_delete(lv_obj_t * obj)
 
     LV_LOG_TRACE("begin (delete %p)", (void *)obj);
     LV_ASSERT_OBJ(obj, MY_CLASS);
-    lv_obj_invalidate(obj);
+    _lv_obj_invalidate_for(obj, LV_INV_REASON_TREE);
 
     lv_obj_t * par = lv_obj_get_parent(obj);
 
@@ -93,7 +93,7 @@ void lv_obj_clean(lv_obj_t * obj)
     LV_LOG_TRACE("begin (clean %p)", (void *)obj);
     LV_ASSERT_OBJ(obj, MY_CLASS);
 
-    lv_obj_invalidate(obj);
+    _lv_obj_invalidate_for(obj, LV_INV_REASON_TREE);
 
     uint32_t cnt = lv_obj_get_child_count(obj);
     lv_obj_t * child = lv_obj_get_first_not_deleting_child(obj);
@@ -156,7 +156,7 @@ void lv_obj_set_parent(lv_obj_t * obj, lv_obj_t * parent)
         return;
     }
 
-    lv_obj_invalidate(obj);
+    _lv_obj_invalidate_for(obj, LV_INV_REASON_TREE);
 
     lv_obj_allocate_spec_attr(parent);
 
@@ -195,7 +195,7 @@ void lv_obj_set_parent(lv_obj_t * obj, lv_obj_t * parent)
 
     lv_obj_mark_layout_as_dirty(obj);
 
-    lv_obj_invalidate(obj);
+    _lv_obj_invalidate_for(obj, LV_INV_REASON_TREE);
 }
 
 void lv_obj_move_to_index(lv_obj_t * obj, int32_t index)
@@ -244,7 +244,7 @@ void lv_obj_move_to_index(lv_obj_t * obj, int32_t index)
 
     parent->spec_attr->children[index] = obj;
     lv_obj_send_event(parent, LV_EVENT_CHILD_CHANGED, NULL);
-    lv_obj_invalidate(parent);
+    _lv_obj_invalidate_for(parent, LV_INV_REASON_TREE);
 }
 
 void lv_obj_swap(lv_obj_t * obj1, lv_obj_t * obj2)
@@ -272,10 +272,10 @@ void lv_obj_swap(lv_obj_t * obj1, lv_obj_t * obj2)
     lv_obj_send_event(parent2, LV_EVENT_CHILD_CHANGED, obj1);
     lv_obj_send_event(parent2, LV_EVENT_CHILD_CREATED, obj1);
 
-    lv_obj_invalidate(parent);
+    _lv_obj_invalidate_for(parent, LV_INV_REASON_TREE);
 
     if(parent != parent2) {
-        lv_obj_invalidate(parent2);
+        _lv_obj_invalidate_for(parent2, LV_INV_REASON_TREE);
     }
     lv_group_swap_obj(obj1, obj2);
 }
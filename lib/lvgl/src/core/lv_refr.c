@@ -17,6 +17,7 @@
 #include "../draw/lv_draw.h"
 #include "../font/lv_font_fmt_txt.h"
 #include "../stdlib/lv_string.h"
+#include "../others/refr_heatmap/lv_refr_heatmap.h"
 #include "lv_global.h"
 
 /*********************
@@ -26,6 +27,9 @@
 /*Display being refreshed*/
 #define disp_refr LV_GLOBAL_DEFAULT()->disp_refresh
 
+/*The moving averages of the adaptive refresh period weigh the last refresh 1/PACING_AVG_FRAMES*/
+#define PACING_AVG_FRAMES   8
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -33,7 +37,6 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
-static void lv_refr_join_area(void);
 static void refr_invalid_areas(void);
 static void refr_sync_areas(void);
 static void refr_area(const lv_area_t * area_p);
@@ -44,7 +47,17 @@ static void refr_obj(lv_layer_t * layer, lv_obj_t * obj);
 static uint32_t get_max_row(lv_display_t * disp, int32_t area_w, int32_t area_h);
 static void draw_buf_flush(lv_display_t * disp);
 static void call_flush_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map);
+static bool uses_tile_hash(lv_display_t * disp);
+static void round_to_tiles(lv_area_t * area, const lv_area_t * scr_area);
+static void flush_tiles(lv_display_t * disp, const lv_area_t * area, lv_draw_buf_t * draw_buf, bool last);
+static void flush_tile_area(lv_display_t * disp, const lv_area_t * area, lv_draw_buf_t * draw_buf,
+                            const lv_area_t * flush_area, bool last, bool * flushed);
+static uint32_t hash_tile(const uint8_t * px, uint32_t row_bytes, int32_t rows, uint32_t stride);
 static void wait_for_flushing(lv_display_t * disp);
+static void wait_for_free_buf(lv_display_t * disp);
+static uint32_t get_time_us(lv_display_t * disp);
+static uint32_t get_pacing_time_us(lv_display_t * disp);
+static void update_pacing(lv_display_t * disp, uint32_t cost_us);
 
 /**********************
  *  STATIC VARIABLES
@@ -249,6 +262,11 @@ void lv_obj_redraw(lv_layer_t * layer, lv_obj_t * obj)
 }
 
 void _lv_inv_area(lv_display_t * disp, const lv_area_t * area_p)
+{
+    _lv_inv_area_from(disp, area_p, NULL, LV_INV_REASON_DISPLAY);
+}
+
+void _lv_inv_area_from(lv_display_t * disp, const lv_area_t * area_p, const lv_obj_t * obj, lv_inv_reason_t reason)
 {
     if(!disp) disp = lv_display_get_default();
     if(!disp) return;
@@ -258,7 +276,7 @@ void _lv_inv_area(lv_display_t * disp, const lv_area_t * area_p)
 
     /*Clear the invalidate buffer if the parameter is NULL*/
     if(area_p == NULL) {
-        disp->inv_p = 0;
+        _lv_region_clear(&disp->inv_region);
         return;
     }
 
@@ -274,31 +292,30 @@ void _lv_inv_area(lv_display_t * disp, const lv_area_t * area_p)
     suc = _lv_area_intersect(&com_area, area_p, &scr_area);
     if(suc == false)  return; /*Out of the screen*/
 
+#if LV_USE_REFR_HEATMAP
+    _lv_refr_heatmap_add_inv(disp, obj, reason, &com_area);
+#else
+    LV_UNUSED(obj);
+    LV_UNUSED(reason);
+#endif
+
     /*If there were at least 1 invalid area in full refresh mode, redraw the whole screen*/
     if(disp->render_mode == LV_DISPLAY_RENDER_MODE_FULL) {
-        disp->inv_areas[0] = scr_area;
-        disp->inv_p = 1;
+        _lv_region_clear(&disp->inv_region);
+        _lv_region_add(&disp->inv_region, &scr_area);
         lv_display_send_event(disp, LV_EVENT_REFR_REQUEST, NULL);
         return;
     }
 
+    /*Only whole tiles can be compared with what was flushed*/
+    if(uses_tile_hash(disp)) round_to_tiles(&com_area, &scr_area);
+
     lv_result_t res = lv_display_send_event(disp, LV_EVENT_INVALIDATE_AREA, &com_area);
     if(res != LV_RESULT_OK) return;
 
-    /*Save only if this area is not in one of the saved areas*/
-    uint16_t i;
-    for(i = 0; i < disp->inv_p; i++) {
-        if(_lv_area_is_in(&com_area, &disp->inv_areas[i], 0) != false) return;
-    }
-
-    /*Save the area*/
-    lv_area_t * tmp_area_p = &com_area;
-    if(disp->inv_p >= LV_INV_BUF_SIZE) { /*If no place for the area add the screen*/
-        disp->inv_p = 0;
-        tmp_area_p = &scr_area;
-    }
-    lv_area_copy(&disp->inv_areas[disp->inv_p], tmp_area_p);
-    disp->inv_p++;
+    /*Join it with the saved areas where redrawing them together is cheaper.
+     *If there is no place for it, it's joined with the closest one.*/
+    _lv_region_add(&disp->inv_region, &com_area);
 
     lv_display_send_event(disp, LV_EVENT_REFR_REQUEST, NULL);
 }
@@ -350,6 +367,7 @@ void _lv_display_refr_timer(lv_timer_t * tmr)
         return;
     }
 
+    uint32_t t_start = disp_refr->pacing_en ? get_pacing_time_us(disp_refr) : 0;
     lv_display_send_event(disp_refr, LV_EVENT_REFR_START, NULL);
 
     /*Refresh the screen's layout if required*/
@@ -364,20 +382,34 @@ void _lv_display_refr_timer(lv_timer_t * tmr)
 
     /*Do nothing if there is no active screen*/
     if(disp_refr->act_scr == NULL) {
-        disp_refr->inv_p = 0;
+        _lv_region_clear(&disp_refr->inv_region);
         LV_LOG_WARN("there is no active screen");
         goto refr_finish;
     }
 
-    lv_refr_join_area();
     refr_sync_areas();
+#if LV_USE_REFR_HEATMAP
+    if(disp_refr->inv_region.cnt) _lv_refr_heatmap_frame_start(disp_refr);
+#endif
     refr_invalid_areas();
 
-    if(disp_refr->inv_p == 0) goto refr_finish;
+#if LV_OBJ_RENDER_CACHE_SIZE
+    /*What changed before this refresh can be cached from now on*/
+    _lv_obj_render_cache_refr_finished();
+#endif
+
+    if(disp_refr->inv_region.cnt == 0) goto refr_finish;
 
     /*If refresh happened ...*/
     lv_display_send_event(disp_refr, LV_EVENT_RENDER_READY, NULL);
 
+    /*Waiting for the bus isn't spent by the CPU, the bus time is accounted for separately*/
+    if(disp_refr->pacing_en) {
+        uint32_t cost_us = get_pacing_time_us(disp_refr) - t_start;
+        cost_us -= LV_MIN(cost_us, disp_refr->flush_stats.stall_time_us);
+        update_pacing(disp_refr, cost_us);
+    }
+
     if(!lv_display_is_double_buffered(disp_refr) ||
        disp_refr->render_mode != LV_DISPLAY_RENDER_MODE_DIRECT) goto refr_clean_up;
 
@@ -386,18 +418,13 @@ void _lv_display_refr_timer(lv_timer_t * tmr)
     wait_for_flushing(disp_refr);
 
     uint32_t i;
-    for(i = 0; i < disp_refr->inv_p; i++) {
-        if(disp_refr->inv_area_joined[i])
-            continue;
-
+    for(i = 0; i < disp_refr->inv_region.cnt; i++) {
         lv_area_t * sync_area = _lv_ll_ins_tail(&disp_refr->sync_areas);
-        *sync_area = disp_refr->inv_areas[i];
+        *sync_area = disp_refr->inv_region.areas[i];
     }
 
 refr_clean_up:
-    lv_memzero(disp_refr->inv_areas, sizeof(disp_refr->inv_areas));
-    lv_memzero(disp_refr->inv_area_joined, sizeof(disp_refr->inv_area_joined));
-    disp_refr->inv_p = 0;
+    _lv_region_clear(&disp_refr->inv_region);
 
 refr_finish:
 
@@ -415,45 +442,6 @@ refr_finish:
  *   STATIC FUNCTIONS
  **********************/
 
-/**
- * Join the areas which has got common parts
- */
-static void lv_refr_join_area(void)
-{
-    LV_PROFILER_BEGIN;
-    uint32_t join_from;
-    uint32_t join_in;
-    lv_area_t joined_area;
-    for(join_in = 0; join_in < disp_refr->inv_p; join_in++) {
-        if(disp_refr->inv_area_joined[join_in] != 0) continue;
-
-        /*Check all areas to join them in 'join_in'*/
-        for(join_from = 0; join_from < disp_refr->inv_p; join_from++) {
-            /*Handle only unjoined areas and ignore itself*/
-            if(disp_refr->inv_area_joined[join_from] != 0 || join_in == join_from) {
-                continue;
-            }
-
-            /*Check if the areas are on each other*/
-            if(_lv_area_is_on(&disp_refr->inv_areas[join_in], &disp_refr->inv_areas[join_from]) == false) {
-                continue;
-            }
-
-            _lv_area_join(&joined_area, &disp_refr->inv_areas[join_in], &disp_refr->inv_areas[join_from]);
-
-            /*Join two area only if the joined area size is smaller*/
-            if(lv_area_get_size(&joined_area) < (lv_area_get_size(&disp_refr->inv_areas[join_in]) +
-                                                 lv_area_get_size(&disp_refr->inv_areas[join_from]))) {
-                lv_area_copy(&disp_refr->inv_areas[join_in], &joined_area);
-
-                /*Mark 'join_form' is joined into 'join_in'*/
-                disp_refr->inv_area_joined[join_from] = 1;
-            }
-        }
-    }
-    LV_PROFILER_END;
-}
-
 /**
  * Refresh the sync areas
  */
@@ -487,10 +475,7 @@ static void refr_sync_areas(void)
     lv_area_t res[4] = {0};
     int8_t res_c;
     lv_area_t * sync_area, * new_area, * next_area;
-    for(i = 0; i < disp_refr->inv_p; i++) {
-        /*Skip joined areas*/
-        if(disp_refr->inv_area_joined[i]) continue;
-
+    for(i = 0; i < disp_refr->inv_region.cnt; i++) {
         /*Iterate over sync areas*/
         sync_area = _lv_ll_get_head(&disp_refr->sync_areas);
         while(sync_area != NULL) {
@@ -498,7 +483,7 @@ static void refr_sync_areas(void)
             next_area = _lv_ll_get_next(&disp_refr->sync_areas, sync_area);
 
             /*Remove intersect of redraw area from sync area and get remaining areas*/
-            res_c = _lv_area_diff(res, sync_area, &disp_refr->inv_areas[i]);
+            res_c = _lv_area_diff(res, sync_area, &disp_refr->inv_region.areas[i]);
 
             /*New sub areas created after removing intersect*/
             if(res_c != -1) {
@@ -537,18 +522,12 @@ static void refr_sync_areas(void)
  */
 static void refr_invalid_areas(void)
 {
-    if(disp_refr->inv_p == 0) return;
+    if(disp_refr->inv_region.cnt == 0) return;
     LV_PROFILER_BEGIN;
 
-    /*Find the last area which will be drawn*/
+    /*The areas are disjoint, each is drawn*/
     int32_t i;
-    int32_t last_i = 0;
-    for(i = disp_refr->inv_p - 1; i >= 0; i--) {
-        if(disp_refr->inv_area_joined[i] == 0) {
-            last_i = i;
-            break;
-        }
-    }
+    int32_t last_i = (int32_t)disp_refr->inv_region.cnt - 1;
 
     /*Notify the display driven rendering has started*/
     lv_display_send_event(disp_refr, LV_EVENT_RENDER_START, NULL);
@@ -556,15 +535,12 @@ static void refr_invalid_areas(void)
     disp_refr->last_area = 0;
     disp_refr->last_part = 0;
     disp_refr->rendering_in_progress = true;
+    lv_memzero(&disp_refr->flush_stats, sizeof(disp_refr->flush_stats));
 
-    for(i = 0; i < (int32_t)disp_refr->inv_p; i++) {
-        /*Refresh the unjoined areas*/
-        if(disp_refr->inv_area_joined[i] == 0) {
-
-            if(i == last_i) disp_refr->last_area = 1;
-            disp_refr->last_part = 0;
-            refr_area(&disp_refr->inv_areas[i]);
-        }
+    for(i = 0; i < (int32_t)disp_refr->inv_region.cnt; i++) {
+        if(i == last_i) disp_refr->last_area = 1;
+        disp_refr->last_part = 0;
+        refr_area(&disp_refr->inv_region.areas[i]);
     }
 
     disp_refr->rendering_in_progress = false;
@@ -673,10 +649,19 @@ static void refr_area_part(lv_layer_t * layer)
     disp_refr->refreshed_area = layer->_clip_area;
 
     /* In single buffered mode wait here until the buffer is freed.
-     * Else we would draw into the buffer while it's still being transferred to the display*/
-    if(!lv_display_is_double_buffered(disp_refr)) {
+     * Else we would draw into the buffer while it's still being transferred to the display.
+     * In a pipeline only the buffer to render into has to be free.*/
+    if(disp_refr->pipe_cnt) {
+        wait_for_free_buf(disp_refr);
+    }
+    else if(!lv_display_is_double_buffered(disp_refr)) {
         wait_for_flushing(disp_refr);
     }
+    disp_refr->band_start_us = get_time_us(disp_refr);
+#if LV_USE_DRAW_CULL
+    /*Collect the draw tasks of the band and cull the covered ones before rendering*/
+    layer->_cull_pending = disp_refr->draw_cull;
+#endif
     /*If the screen is transparent initialize it when the flushing is ready*/
     if(lv_color_format_has_alpha(disp_refr->color_format)) {
         lv_area_t a = disp_refr->refreshed_area;
@@ -727,6 +712,13 @@ static void refr_area_part(lv_layer_t * layer)
     refr_obj_and_children(layer, lv_display_get_layer_top(disp_refr));
     refr_obj_and_children(layer, lv_display_get_layer_sys(disp_refr));
 
+#if LV_USE_DRAW_CULL
+    if(layer->_cull_pending) {
+        _lv_draw_cull_layer(layer);
+        lv_draw_dispatch();
+    }
+#endif
+
     draw_buf_flush(disp_refr);
     LV_PROFILER_END;
 }
@@ -889,6 +881,9 @@ void refr_obj(lv_layer_t * layer, lv_obj_t * obj)
 
     lv_layer_type_t layer_type = _lv_obj_get_layer_type(obj);
     if(layer_type == LV_LAYER_TYPE_NONE) {
+#if LV_OBJ_RENDER_CACHE_SIZE
+        if(lv_obj_has_flag(obj, LV_OBJ_FLAG_RENDER_CACHE) && _lv_obj_render_cache_draw(layer, obj)) return;
+#endif
         lv_obj_redraw(layer, obj);
     }
     else {
@@ -1005,6 +1000,11 @@ static uint32_t get_max_row(lv_display_t * disp, int32_t area_w, int32_t area_h)
         max_row = tmp.y2 + 1;
     }
 
+    /*Keep the bands on the tiles too*/
+    if(uses_tile_hash(disp) && max_row < area_h && max_row >= LV_TILE_HASH_SIZE) {
+        max_row -= max_row % LV_TILE_HASH_SIZE;
+    }
+
     return max_row;
 }
 
@@ -1021,26 +1021,41 @@ static void draw_buf_flush(lv_display_t * disp)
         lv_draw_dispatch();
     }
 
+    disp->flush_stats.bands++;
+    if(disp->time_cb) disp->flush_stats.render_time_us += get_time_us(disp) - disp->band_start_us;
+
     /* In double buffered mode wait until the other buffer is freed
      * and driver is ready to receive the new buffer.
      * If we need to wait here it means that the content of one buffer is being sent to display
-     * and other buffer already contains the new rendered image. */
-    if(lv_display_is_double_buffered(disp)) {
+     * and other buffer already contains the new rendered image.
+     * A pipeline queues the flush instead.*/
+    if(lv_display_is_double_buffered(disp) && disp->pipe_cnt == 0) {
         wait_for_flushing(disp_refr);
     }
 
-    disp->flushing = 1;
+    bool flushing_last = disp->last_area && disp->last_part;
 
-    if(disp->last_area && disp->last_part) disp->flushing_last = 1;
-    else disp->flushing_last = 0;
+    if(disp->flush_cb && uses_tile_hash(disp) && lv_color_format_get_bpp(layer->draw_buf->header.cf) >= 8) {
+        flush_tiles(disp, &disp->refreshed_area, layer->draw_buf, flushing_last);
+    }
+    else {
+        disp->flushing = 1;
+        disp->flushing_last = flushing_last;
 
-    bool flushing_last = disp->flushing_last;
+        if(disp->flush_cb) {
+            call_flush_cb(disp, &disp->refreshed_area, layer->draw_buf->data);
+        }
+    }
 
-    if(disp->flush_cb) {
-        call_flush_cb(disp, &disp->refreshed_area, layer->draw_buf->data);
+    /*Render the next band into the next buffer of the pipeline*/
+    if(disp->pipe_cnt) {
+        disp->pipe_seq[disp->pipe_act] = disp->flush_issued;
+        disp->pipe_act = (disp->pipe_act + 1) % disp->pipe_cnt;
+        disp->buf_act = &disp->pipe_bufs[disp->pipe_act];
     }
     /*If there are 2 buffers swap them. With direct mode swap only on the last area*/
-    if(lv_display_is_double_buffered(disp) && (disp->render_mode != LV_DISPLAY_RENDER_MODE_DIRECT || flushing_last)) {
+    else if(lv_display_is_double_buffered(disp) &&
+            (disp->render_mode != LV_DISPLAY_RENDER_MODE_DIRECT || flushing_last)) {
         if(disp->buf_act == disp->buf_1) {
             disp->buf_act = disp->buf_2;
         }
@@ -1063,13 +1078,208 @@ static void call_flush_cb(lv_display_t * disp, const lv_area_t * area, uint8_t *
         .y2 = area->y2 + disp->offset_y
     };
 
+    lv_display_flush_stats_t * stats = &disp->flush_stats;
+    stats->flush_cnt++;
+    stats->bytes += lv_area_get_size(area) * lv_color_format_get_bpp(disp->color_format) / 8;
+    stats->bus_time_us = (uint32_t)(((uint64_t)stats->flush_cnt * disp->flush_cost_ns +
+                                     (uint64_t)stats->bytes * disp->byte_cost_ns) / 1000);
+
     lv_display_send_event(disp, LV_EVENT_FLUSH_START, &offset_area);
+
+    /*Count it before the call, the driver might be ready before it returns*/
+    if(disp->flushing_last) disp->flush_last_seq = disp->flush_issued + 1;
+    disp->flush_start_us[disp->flush_issued % LV_DISPLAY_PIPELINE_MAX] = get_time_us(disp);
+    disp->flush_issued++;
     disp->flush_cb(disp, &offset_area, px_map);
     lv_display_send_event(disp, LV_EVENT_FLUSH_FINISH, &offset_area);
 
     LV_PROFILER_END;
 }
 
+static bool uses_tile_hash(lv_display_t * disp)
+{
+    return disp->tile_hash && disp->render_mode == LV_DISPLAY_RENDER_MODE_PARTIAL;
+}
+
+/**
+ * Grow an area to whole tiles
+ * @param area      the area to round, on the screen
+ * @param scr_area  the area of the screen, the tiles at its right and bottom might be cut
+ */
+static void round_to_tiles(lv_area_t * area, const lv_area_t * scr_area)
+{
+    area->x1 -= area->x1 % LV_TILE_HASH_SIZE;
+    area->y1 -= area->y1 % LV_TILE_HASH_SIZE;
+    area->x2 += LV_TILE_HASH_SIZE - 1 - area->x2 % LV_TILE_HASH_SIZE;
+    area->y2 += LV_TILE_HASH_SIZE - 1 - area->y2 % LV_TILE_HASH_SIZE;
+    if(area->x2 > scr_area->x2) area->x2 = scr_area->x2;
+    if(area->y2 > scr_area->y2) area->y2 = scr_area->y2;
+}
+
+/**
+ * Flush the tiles of a rendered area which changed since they were last flushed.
+ * Each row of tiles is flushed from its first to its last changed tile, and rows are
+ * flushed together where one flush is cheaper than two. With two or more buffers the flush is
+ * asynchronous and a second flush from the same buffer would wait for the first one, so all the
+ * changed tiles of the area are flushed together.
+ * @param disp      pointer to a display
+ * @param area      the rendered area, `draw_buf` starts with its first pixel
+ * @param draw_buf  the rendered pixels
+ * @param last      true: it's the last part of the refresh
+ */
+static void flush_tiles(lv_display_t * disp, const lv_area_t * area, lv_draw_buf_t * draw_buf, bool last)
+{
+    int32_t hor_res = lv_display_get_horizontal_resolution(disp);
+    int32_t ver_res = lv_display_get_vertical_resolution(disp);
+    int32_t cols = (hor_res + LV_TILE_HASH_SIZE - 1) / LV_TILE_HASH_SIZE;
+    uint32_t px_size = lv_color_format_get_size(draw_buf->header.cf);
+    uint32_t stride = draw_buf->header.stride;
+    lv_display_flush_stats_t * stats = &disp->flush_stats;
+
+    lv_area_t pending;
+    bool has_pending = false;
+    bool flushed = false;
+    bool one_flush = lv_display_is_double_buffered(disp) || disp->pipe_cnt;
+    uint32_t tiles_sent = 0;
+
+    int32_t y1;
+    int32_t y2;
+    for(y1 = area->y1; y1 <= area->y2; y1 = y2 + 1) {
+        y2 = LV_MIN(y1 - y1 % LV_TILE_HASH_SIZE + LV_TILE_HASH_SIZE - 1, area->y2);
+        bool whole_rows = y1 % LV_TILE_HASH_SIZE == 0 && (y2 - y1 + 1 == LV_TILE_HASH_SIZE || y2 == ver_res - 1);
+
+        lv_area_t changed;
+        lv_area_set(&changed, LV_COORD_MAX, y1, -1, y2);
+
+        int32_t x1;
+        int32_t x2;
+        for(x1 = area->x1; x1 <= area->x2; x1 = x2 + 1) {
+            x2 = LV_MIN(x1 - x1 % LV_TILE_HASH_SIZE + LV_TILE_HASH_SIZE - 1, area->x2);
+            bool whole = whole_rows && x1 % LV_TILE_HASH_SIZE == 0 &&
+                         (x2 - x1 + 1 == LV_TILE_HASH_SIZE || x2 == hor_res - 1);
+
+            /*A cut tile is always flushed, and afterwards it's unknown*/
+            uint32_t hash = 0;
+            if(whole) {
+                const uint8_t * px = draw_buf->data + (y1 - area->y1) * stride + (x1 - area->x1) * px_size;
+                hash = hash_tile(px, (x2 - x1 + 1) * px_size, y2 - y1 + 1, stride);
+            }
+
+            uint32_t * flushed_hash = &disp->tile_hash[(y1 / LV_TILE_HASH_SIZE) * cols + x1 / LV_TILE_HASH_SIZE];
+            if(hash == 0 || hash != *flushed_hash) {
+                if(changed.x1 > x1) changed.x1 = x1;
+                changed.x2 = x2;
+            }
+            *flushed_hash = hash;
+        }
+
+        if(changed.x2 < 0) continue;
+
+        if(has_pending) {
+            lv_area_t joined;
+            _lv_area_join(&joined, &pending, &changed);
+            if(one_flush ||
+               lv_area_get_size(&joined) <= lv_area_get_size(&pending) + lv_area_get_size(&changed) +
+               disp->inv_region.area_cost) {
+                pending = joined;
+                continue;
+            }
+
+            tiles_sent += (pending.x2 / LV_TILE_HASH_SIZE - pending.x1 / LV_TILE_HASH_SIZE + 1) *
+                          (pending.y2 / LV_TILE_HASH_SIZE - pending.y1 / LV_TILE_HASH_SIZE + 1);
+            flush_tile_area(disp, area, draw_buf, &pending, false, &flushed);
+        }
+        pending = changed;
+        has_pending = true;
+    }
+
+    if(has_pending) {
+        tiles_sent += (pending.x2 / LV_TILE_HASH_SIZE - pending.x1 / LV_TILE_HASH_SIZE + 1) *
+                      (pending.y2 / LV_TILE_HASH_SIZE - pending.y1 / LV_TILE_HASH_SIZE + 1);
+        flush_tile_area(disp, area, draw_buf, &pending, last, &flushed);
+    }
+    else if(last) {
+        /*Nothing changed, but drivers might wait for the last flush of the refresh:
+         *flush a single pixel, the same as on the display*/
+        lv_area_t px_area;
+        lv_area_set(&px_area, area->x1, area->y1, area->x1, area->y1);
+        flush_tile_area(disp, area, draw_buf, &px_area, true, &flushed);
+    }
+
+    uint32_t tiles = (area->x2 / LV_TILE_HASH_SIZE - area->x1 / LV_TILE_HASH_SIZE + 1) *
+                     (area->y2 / LV_TILE_HASH_SIZE - area->y1 / LV_TILE_HASH_SIZE + 1);
+    stats->tiles_checked += tiles;
+    stats->tiles_skipped += tiles - tiles_sent;
+}
+
+/**
+ * Flush a part of a rendered area. If it's narrower than the area its rows are moved next to
+ * each other in the draw buffer first.
+ * @param disp          pointer to a display
+ * @param area          the rendered area, `draw_buf` starts with its first pixel
+ * @param draw_buf      the rendered pixels
+ * @param flush_area    the part to flush, full tiles of `area`
+ * @param last          true: it's the last flush of the refresh
+ * @param flushed       true if there was a flush from `draw_buf` already, set to true
+ */
+static void flush_tile_area(lv_display_t * disp, const lv_area_t * area, lv_draw_buf_t * draw_buf,
+                            const lv_area_t * flush_area, bool last, bool * flushed)
+{
+    /*Wait for the previous part of the buffer to go out*/
+    if(*flushed) wait_for_flushing(disp);
+
+    uint32_t px_size = lv_color_format_get_size(draw_buf->header.cf);
+    uint32_t stride = draw_buf->header.stride;
+    uint8_t * px_map = draw_buf->data + (flush_area->y1 - area->y1) * stride;
+
+    int32_t w = lv_area_get_width(flush_area);
+    if(w != lv_area_get_width(area)) {
+        /*Each row moves back, so it doesn't overwrite the rows which move after it*/
+        uint32_t flush_stride = lv_draw_buf_width_to_stride(w, draw_buf->header.cf);
+        const uint8_t * src = px_map + (flush_area->x1 - area->x1) * px_size;
+        int32_t h = lv_area_get_height(flush_area);
+        int32_t y;
+        for(y = 0; y < h; y++) {
+            lv_memmove(px_map + y * flush_stride, src + y * stride, w * px_size);
+        }
+    }
+
+    disp->flushing = 1;
+    disp->flushing_last = last;
+    call_flush_cb(disp, flush_area, px_map);
+    *flushed = true;
+}
+
+/**
+ * Hash the pixels of a tile (FNV-1a on words). A tile differing in one word from another always
+ * has a different hash.
+ * @param px        the first pixel of the tile
+ * @param row_bytes the bytes in a row of the tile
+ * @param rows      the rows of the tile
+ * @param stride    the bytes between two rows
+ * @return          the hash, never 0
+ */
+static uint32_t hash_tile(const uint8_t * px, uint32_t row_bytes, int32_t rows, uint32_t stride)
+{
+    uint32_t hash = 2166136261u;
+    bool words = ((lv_uintptr_t)px & 3) == 0 && (row_bytes & 3) == 0 && (stride & 3) == 0;
+
+    int32_t y;
+    for(y = 0; y < rows; y++) {
+        uint32_t i;
+        if(words) {
+            const uint32_t * px32 = (const uint32_t *)px;
+            for(i = 0; i < row_bytes / 4; i++) hash = (hash ^ px32[i]) * 16777619u;
+        }
+        else {
+            for(i = 0; i < row_bytes; i++) hash = (hash ^ px[i]) * 16777619u;
+        }
+        px += stride;
+    }
+
+    return hash ? hash : 1;
+}
+
 static void wait_for_flushing(lv_display_t * disp)
 {
     LV_PROFILER_BEGIN;
@@ -1077,16 +1287,92 @@ static void wait_for_flushing(lv_display_t * disp)
 
     lv_display_send_event(disp, LV_EVENT_FLUSH_WAIT_START, NULL);
 
-    if(disp->flush_wait_cb) {
+    uint32_t t0 = get_time_us(disp);
+    if(disp->pipe_cnt) {
+        /*Wait for every queued flush*/
+        while(disp->flush_issued != disp->flush_done) {
+            if(disp->flush_wait_cb) disp->flush_wait_cb(disp);
+        }
+    }
+    else if(disp->flush_wait_cb) {
         disp->flush_wait_cb(disp);
     }
     else {
         while(disp->flushing);
     }
     disp->flushing_last = 0;
+    if(disp->time_cb) disp->flush_stats.stall_time_us += get_time_us(disp) - t0;
 
     lv_display_send_event(disp, LV_EVENT_FLUSH_WAIT_FINISH, NULL);
 
     LV_LOG_TRACE("end");
     LV_PROFILER_END;
 }
+
+/**
+ * Wait until the flushes from the buffer to render into are done. The flushes are done in order,
+ * so it's when `flush_done` reaches the buffer's last flush.
+ */
+static void wait_for_free_buf(lv_display_t * disp)
+{
+    const uint32_t * seq = &disp->pipe_seq[disp->pipe_act];
+    if((int32_t)(*seq - disp->flush_done) <= 0) return;
+
+    LV_PROFILER_BEGIN;
+    lv_display_send_event(disp, LV_EVENT_FLUSH_WAIT_START, NULL);
+
+    uint32_t t0 = get_time_us(disp);
+    while((int32_t)(*seq - disp->flush_done) > 0) {
+        if(disp->flush_wait_cb) disp->flush_wait_cb(disp);
+    }
+    if(disp->time_cb) disp->flush_stats.stall_time_us += get_time_us(disp) - t0;
+
+    lv_display_send_event(disp, LV_EVENT_FLUSH_WAIT_FINISH, NULL);
+    LV_PROFILER_END;
+}
+
+static uint32_t get_time_us(lv_display_t * disp)
+{
+    return disp->time_cb ? disp->time_cb() : 0;
+}
+
+static uint32_t get_pacing_time_us(lv_display_t * disp)
+{
+    return disp->time_cb ? disp->time_cb() : lv_tick_get() * 1000;
+}
+
+/**
+ * Set the refresh period from the cost of the refreshes so far, see `lv_display_set_pacing()`
+ * @param disp      the refreshed display
+ * @param cost_us   the time the refresh took to update the layout, render and flush, without
+ *                  waiting for the driver
+ */
+static void update_pacing(lv_display_t * disp, uint32_t cost_us)
+{
+    lv_display_pacing_state_t * st = &disp->pacing_state;
+    const lv_display_pacing_t * cfg = &disp->pacing;
+    uint32_t bus_us = disp->flush_stats.bus_time_us;
+
+    /*Exponential moving averages, the first refresh sets them*/
+    if(st->frames == 0) {
+        st->cost_avg_us = cost_us;
+        st->bus_avg_us = bus_us;
+    }
+    else {
+        st->cost_avg_us = (uint32_t)(((uint64_t)st->cost_avg_us * (PACING_AVG_FRAMES - 1) + cost_us) /
+                                     PACING_AVG_FRAMES);
+        st->bus_avg_us = (uint32_t)(((uint64_t)st->bus_avg_us * (PACING_AVG_FRAMES - 1) + bus_us) /
+                                    PACING_AVG_FRAMES);
+    }
+    st->frames++;
+    if(cost_us > st->period * 1000) st->overruns++;
+
+    /*Refreshing may take `cpu_budget` percent of the CPU time. The bus (e.g. DMA) works besides
+     *the CPU, so it may be busy all the time: a refresh can't run faster than it flushes.*/
+    uint64_t period_us = LV_MAX((uint64_t)st->cost_avg_us * 100 / cfg->cpu_budget, (uint64_t)st->bus_avg_us);
+
+    uint32_t period = (uint32_t)LV_MIN((period_us + 999) / 1000, UINT32_MAX);
+    st->saturated = period >= cfg->max_period;
+    st->period = LV_CLAMP(cfg->min_period, period, cfg->max_period);
+    if(disp->refr_timer) lv_timer_set_period(disp->refr_timer, st->period);
+}
@@ -75,6 +75,15 @@ void lv_obj_redraw(lv_layer_t * layer, lv_obj_t * obj);
  */
 void _lv_inv_area(lv_display_t * disp, const lv_area_t * area_p);
 
+/**
+ * Invalidate an area on display to redraw it, telling who and why (used by `LV_USE_REFR_HEATMAP`)
+ * @param disp      pointer to display where the area should be invalidated (NULL: the default)
+ * @param area_p    pointer to area which should be invalidated (NULL: delete the invalidated areas)
+ * @param obj       the object which needs the redraw, NULL if not an object
+ * @param reason    why it's needed
+ */
+void _lv_inv_area_from(lv_display_t * disp, const lv_area_t * area_p, const lv_obj_t * obj, lv_inv_reason_t reason);
+
 /**
  * Get the display which is being refreshed
  * @return the display being refreshed
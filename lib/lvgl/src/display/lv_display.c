@@ -13,6 +13,7 @@
 #include "../stdlib/lv_string.h"
 #include "../themes/lv_theme.h"
 #include "../core/lv_global.h"
+#include "../others/refr_heatmap/lv_refr_heatmap.h"
 
 #if LV_USE_DRAW_SW
     #include "../draw/sw/lv_draw_sw.h"
@@ -41,6 +42,7 @@ static void set_y_anim(void * obj, int32_t v);
 static void scr_anim_completed(lv_anim_t * a);
 static bool is_out_anim(lv_screen_load_anim_t a);
 static void disp_event_cb(lv_event_t * e);
+static void update_inv_cost(lv_display_t * disp);
 
 /**********************
  *  STATIC VARIABLES
@@ -69,6 +71,9 @@ lv_display_t * lv_display_create(int32_t hor_res, int32_t ver_res)
     disp->offset_x         = 0;
     disp->offset_y         = 0;
     disp->antialiasing     = LV_COLOR_DEPTH > 8 ? 1 : 0;
+#if LV_USE_DRAW_CULL
+    disp->draw_cull        = true;
+#endif
     disp->dpi              = LV_DPI_DEF;
     disp->color_format = LV_COLOR_FORMAT_NATIVE;
 
@@ -84,6 +89,7 @@ lv_display_t * lv_display_create(int32_t hor_res, int32_t ver_res)
     disp->layer_head->color_format = disp->color_format;
 
     disp->inv_en_cnt = 1;
+    _lv_region_init(&disp->inv_region, disp->inv_areas, LV_INV_BUF_SIZE, LV_INV_AREA_COST);
     disp->last_activity_time = lv_tick_get();
 
     _lv_ll_init(&disp->sync_areas, sizeof(lv_area_t));
@@ -187,7 +193,12 @@ void lv_display_delete(lv_display_t * disp)
     if(disp->refr_timer) lv_timer_delete(disp->refr_timer);
 
     if(disp->layer_deinit) disp->layer_deinit(disp, disp->layer_head);
+    _lv_draw_layer_deinit(disp->layer_head);
     lv_free(disp->layer_head);
+    lv_free(disp->tile_hash);
+#if LV_USE_REFR_HEATMAP
+    lv_refr_heatmap_disable(disp);
+#endif
 
     lv_free(disp);
 
@@ -394,6 +405,8 @@ void lv_display_set_draw_buffers(lv_display_t * disp, lv_draw_buf_t * buf1, lv_d
     disp->buf_1 = buf1;
     disp->buf_2 = buf2;
     disp->buf_act = disp->buf_1;
+    disp->pipe_cnt = 0;
+    update_inv_cost(disp);
 }
 
 void lv_display_set_buffers(lv_display_t * disp, void * buf1, void * buf2, uint32_t buf_size,
@@ -432,6 +445,7 @@ void lv_display_set_render_mode(lv_display_t * disp, lv_display_render_mode_t re
     if(disp == NULL) disp = lv_display_get_default();
     if(disp == NULL) return;
     disp->render_mode = render_mode;
+    update_inv_cost(disp);
 }
 
 void lv_display_set_flush_cb(lv_display_t * disp, lv_display_flush_cb_t flush_cb)
@@ -457,10 +471,97 @@ void lv_display_set_color_format(lv_display_t * disp, lv_color_format_t color_fo
 
     disp->color_format = color_format;
     disp->layer_head->color_format = color_format;
+    update_inv_cost(disp);
 
     lv_display_send_event(disp, LV_EVENT_COLOR_FORMAT_CHANGED, NULL);
 }
 
+void lv_display_set_flush_cost(lv_display_t * disp, uint32_t flush_ns, uint32_t byte_ns)
+{
+    if(disp == NULL) disp = lv_display_get_default();
+    if(disp == NULL) return;
+
+    disp->flush_cost_ns = flush_ns;
+    disp->byte_cost_ns = byte_ns;
+    update_inv_cost(disp);
+}
+
+void lv_display_set_tile_hash(lv_display_t * disp, bool en)
+{
+    if(disp == NULL) disp = lv_display_get_default();
+    if(disp == NULL) return;
+
+    lv_free(disp->tile_hash);
+    disp->tile_hash = NULL;
+    if(!en) return;
+
+    int32_t cols = (lv_display_get_horizontal_resolution(disp) + LV_TILE_HASH_SIZE - 1) / LV_TILE_HASH_SIZE;
+    int32_t rows = (lv_display_get_vertical_resolution(disp) + LV_TILE_HASH_SIZE - 1) / LV_TILE_HASH_SIZE;
+    disp->tile_hash = lv_malloc_zeroed(cols * rows * sizeof(uint32_t));
+    LV_ASSERT_MALLOC(disp->tile_hash);
+}
+
+#if LV_USE_DRAW_CULL
+
+void lv_display_set_draw_cull(lv_display_t * disp, bool en)
+{
+    if(disp == NULL) disp = lv_display_get_default();
+    if(disp == NULL) return;
+
+    disp->draw_cull = en;
+}
+
+#endif /*LV_USE_DRAW_CULL*/
+
+void lv_display_set_pipeline(lv_display_t * disp, void * const bufs[], uint32_t cnt, uint32_t buf_size)
+{
+    if(disp == NULL) disp = lv_display_get_default();
+    if(disp == NULL) return;
+
+    LV_ASSERT_NULL(bufs);
+    LV_ASSERT_MSG(cnt >= 2 && cnt <= LV_DISPLAY_PIPELINE_MAX, "2 ... LV_DISPLAY_PIPELINE_MAX buffers are needed");
+    if(cnt > LV_DISPLAY_PIPELINE_MAX) cnt = LV_DISPLAY_PIPELINE_MAX;
+
+    /*Let the queued flushes finish with the old buffers*/
+    while(disp->flush_issued != disp->flush_done) {
+        if(disp->flush_wait_cb) disp->flush_wait_cb(disp);
+    }
+
+    lv_display_set_buffers(disp, bufs[0], bufs[1], buf_size, LV_DISPLAY_RENDER_MODE_PARTIAL);
+
+    uint32_t i;
+    for(i = 0; i < cnt; i++) {
+        lv_draw_buf_t * b = i == 0 ? disp->buf_1 : disp->buf_2;
+        LV_ASSERT_FORMAT_MSG(bufs[i] == lv_draw_buf_align(bufs[i], b->header.cf), "bufs[%d] is not aligned: %p",
+                             (int)i, bufs[i]);
+        lv_draw_buf_init(&disp->pipe_bufs[i], b->header.w, b->header.h, b->header.cf, b->header.stride, bufs[i],
+                         buf_size);
+        disp->pipe_seq[i] = disp->flush_issued;
+    }
+
+    disp->buf_1 = &disp->pipe_bufs[0];
+    disp->buf_2 = &disp->pipe_bufs[1];
+    disp->buf_act = disp->buf_1;
+    disp->pipe_act = 0;
+    disp->pipe_cnt = cnt;
+}
+
+void lv_display_set_time_cb(lv_display_t * disp, lv_display_time_cb_t time_cb)
+{
+    if(disp == NULL) disp = lv_display_get_default();
+    if(disp == NULL) return;
+
+    disp->time_cb = time_cb;
+}
+
+const lv_display_flush_stats_t * lv_display_get_flush_stats(lv_display_t * disp)
+{
+    if(disp == NULL) disp = lv_display_get_default();
+    if(disp == NULL) return NULL;
+
+    return &disp->flush_stats;
+}
+
 lv_color_format_t lv_display_get_color_format(lv_display_t * disp)
 {
     if(disp == NULL) disp = lv_display_get_default();
@@ -487,7 +588,21 @@ bool lv_display_get_antialiasing(lv_display_t * disp)
 
 LV_ATTRIBUTE_FLUSH_READY void lv_display_flush_ready(lv_display_t * disp)
 {
-    disp->flushing = 0;
+    uint32_t done = disp->flush_done;
+    if(done != disp->flush_issued) {
+        if(disp->time_cb) {
+            disp->flush_stats.flush_time_us += disp->time_cb() - disp->flush_start_us[done % LV_DISPLAY_PIPELINE_MAX];
+        }
+        done++;
+    }
+
+#if LV_USE_SYSMON && LV_USE_LATENCY_MONITOR
+    /*In a pipeline later flushes can be queued already*/
+    bool last = disp->pipe_cnt ? done == disp->flush_last_seq : disp->flushing_last;
+    if(last) disp->last_flush_ready = lv_tick_get();
+#endif
+    disp->flush_done = done;
+    disp->flushing = disp->pipe_cnt ? done != disp->flush_issued : 0;
 }
 
 LV_ATTRIBUTE_FLUSH_READY bool lv_display_flush_is_last(lv_display_t * disp)
@@ -885,6 +1000,41 @@ void lv_display_delete_refr_timer(lv_display_t * disp)
 
     lv_timer_delete(disp->refr_timer);
     disp->refr_timer = NULL;
+    disp->pacing_en = false;
+}
+
+void lv_display_set_pacing(lv_display_t * disp, const lv_display_pacing_t * pacing)
+{
+    if(disp == NULL) disp = lv_display_get_default();
+    if(disp == NULL || disp->refr_timer == NULL) return;
+
+    if(pacing == NULL) {
+        if(disp->pacing_en) lv_timer_set_period(disp->refr_timer, disp->pacing_def_period);
+        disp->pacing_en = false;
+        return;
+    }
+
+    LV_ASSERT_MSG(pacing->min_period <= pacing->max_period, "min_period > max_period");
+    LV_ASSERT_MSG(pacing->cpu_budget > 0 && pacing->cpu_budget <= 100, "cpu_budget is not 1 ... 100");
+
+    if(!disp->pacing_en) disp->pacing_def_period = disp->refr_timer->period;
+    disp->pacing = *pacing;
+    if(disp->pacing.cpu_budget == 0 || disp->pacing.cpu_budget > 100) disp->pacing.cpu_budget = 100;
+    if(disp->pacing.max_period < disp->pacing.min_period) disp->pacing.max_period = disp->pacing.min_period;
+
+    /*Start from the period used so far*/
+    lv_memzero(&disp->pacing_state, sizeof(disp->pacing_state));
+    disp->pacing_state.period = LV_CLAMP(disp->pacing.min_period, disp->refr_timer->period, disp->pacing.max_period);
+    lv_timer_set_period(disp->refr_timer, disp->pacing_state.period);
+    disp->pacing_en = true;
+}
+
+const lv_display_pacing_state_t * lv_display_get_pacing(lv_display_t * disp)
+{
+    if(disp == NULL) disp = lv_display_get_default();
+    if(disp == NULL) return NULL;
+
+    return disp->pacing_en ? &disp->pacing_state : NULL;
 }
 
 void lv_display_set_user_data(lv_display_t * disp, void * user_data)
@@ -954,9 +1104,12 @@ static void update_resolution(lv_display_t * disp)
     lv_area_set_height(&disp->bottom_layer->coords, ver_res);
     lv_obj_send_event(disp->bottom_layer, LV_EVENT_SIZE_CHANGED, &prev_coords);
 
-    lv_memzero(disp->inv_areas, sizeof(disp->inv_areas));
-    lv_memzero(disp->inv_area_joined, sizeof(disp->inv_area_joined));
-    disp->inv_p = 0;
+    _lv_region_clear(&disp->inv_region);
+    if(disp->tile_hash) lv_display_set_tile_hash(disp, true);
+#if LV_USE_REFR_HEATMAP
+    /*The heatmap has the old size*/
+    lv_refr_heatmap_disable(disp);
+#endif
     lv_obj_invalidate(disp->sys_layer);
 
     lv_obj_tree_walk(NULL, invalidate_layout_cb, NULL);
@@ -964,6 +1117,24 @@ static void update_resolution(lv_display_t * disp)
     lv_display_send_event(disp, LV_EVENT_RESOLUTION_CHANGED, NULL);
 }
 
+/**
+ * Tell the invalidated areas what an area costs in pixels: a flush compared to a pixel
+ * on the bus, and in partial mode how many pixels fit into a band of the draw buffer.
+ */
+static void update_inv_cost(lv_display_t * disp)
+{
+    uint32_t px_size = lv_color_format_get_size(disp->color_format);
+    uint32_t area_cost = LV_INV_AREA_COST;
+    uint32_t band_px = 0;
+
+    if(disp->byte_cost_ns && px_size) area_cost = disp->flush_cost_ns / (disp->byte_cost_ns * px_size);
+    if(disp->render_mode == LV_DISPLAY_RENDER_MODE_PARTIAL && disp->buf_1 && px_size) {
+        band_px = disp->buf_1->data_size / px_size;
+    }
+
+    _lv_region_set_cost(&disp->inv_region, area_cost, band_px);
+}
+
 static lv_obj_tree_walk_res_t invalidate_layout_cb(lv_obj_t * obj, void * user_data)
 {
     LV_UNUSED(user_data);
@@ -27,6 +27,10 @@ extern "C" {
 #define LV_ATTRIBUTE_FLUSH_READY
 #endif
 
+#ifndef LV_DISPLAY_PIPELINE_MAX
+#define LV_DISPLAY_PIPELINE_MAX 8 /*Most buffers of `lv_display_set_pipeline()`*/
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -80,6 +84,39 @@ typedef enum {
 
 typedef void (*lv_display_flush_cb_t)(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map);
 typedef void (*lv_display_flush_wait_cb_t)(lv_display_t * disp);
+typedef uint32_t (*lv_display_time_cb_t)(void);
+
+/** The flushes of the last refresh. See `lv_display_get_flush_stats()`*/
+typedef struct {
+    uint32_t flush_cnt;     /**< Number of `flush_cb` calls*/
+    uint32_t bytes;         /**< Bytes of rendered pixels passed to `flush_cb`*/
+    uint32_t bus_time_us;   /**< Estimated time on the bus, from `lv_display_set_flush_cost()`*/
+    uint32_t tiles_checked; /**< Rendered tiles compared with what was flushed, see `lv_display_set_tile_hash()`*/
+    uint32_t tiles_skipped; /**< Of those, the tiles left out because they didn't change*/
+    uint32_t bands;         /**< Bands rendered into the draw buffer*/
+    uint32_t render_time_us;/**< Time rendering the bands, from `lv_display_set_time_cb()`*/
+    uint32_t flush_time_us; /**< Time from `flush_cb` until `lv_display_flush_ready()`, summed up*/
+    uint32_t stall_time_us; /**< Time waiting for the driver to finish a flush*/
+    uint32_t culled_tasks;  /**< Draw tasks dropped because opaque ones covered them, see `lv_display_set_draw_cull()`*/
+    uint32_t culled_px;     /**< Pixels of the dropped and clipped draw tasks*/
+} lv_display_flush_stats_t;
+
+/** Limits of the adaptive refresh period, see `lv_display_set_pacing()`*/
+typedef struct {
+    uint32_t min_period;    /**< Shortest refresh period in ms*/
+    uint32_t max_period;    /**< Longest refresh period in ms, also when the refreshes need even more time*/
+    uint32_t cpu_budget;    /**< Share of the time refreshing may take, in percent, 1 ... 100*/
+} lv_display_pacing_t;
+
+/** What the adaptive refresh period is based on, see `lv_display_get_pacing()`*/
+typedef struct {
+    uint32_t period;        /**< The refresh period in ms*/
+    uint32_t cost_avg_us;   /**< Moving average of the layout, render and flush time of a refresh, without the stalls*/
+    uint32_t bus_avg_us;    /**< Moving average of the estimated bus time of a refresh*/
+    uint32_t frames;        /**< Refreshes measured*/
+    uint32_t overruns;      /**< Refreshes which took longer than the period*/
+    bool saturated;         /**< The period is pinned at `max_period`: the refreshes need more time than that*/
+} lv_display_pacing_state_t;
 
 /**********************
  * GLOBAL PROTOTYPES
@@ -271,6 +308,81 @@ void lv_display_set_flush_cb(lv_display_t * disp, lv_display_flush_cb_t flush_cb
  */
 void lv_display_set_flush_wait_cb(lv_display_t * disp, lv_display_flush_wait_cb_t wait_cb);
 
+/**
+ * Tell what sending an area to the display costs, e.g. on an SPI bus setting the address
+ * window and toggling CS, then clocking out the pixels. In partial render mode the areas
+ * to redraw are merged and split to spend the least time on the bus, knowing that each
+ * area is flushed in bands of the draw buffer.
+ * Without it one area costs as much as LV_INV_AREA_COST pixels.
+ * @param disp      pointer to a display
+ * @param flush_ns  fixed cost of one `flush_cb` call in nanoseconds
+ * @param byte_ns   cost of one byte of pixels in nanoseconds, 0 to use LV_INV_AREA_COST
+ */
+void lv_display_set_flush_cost(lv_display_t * disp, uint32_t flush_ns, uint32_t byte_ns);
+
+/**
+ * Get what the last refresh flushed: the number of flushes, the bytes and
+ * the bus time estimated from `lv_display_set_flush_cost()`.
+ * Reset when a refresh starts to render, during the refresh it's the flushes so far.
+ * @param disp      pointer to a display
+ * @return          pointer to the statistics
+ */
+const lv_display_flush_stats_t * lv_display_get_flush_stats(lv_display_t * disp);
+
+/**
+ * Flush only what changed: keep a hash of each LV_TILE_HASH_SIZE x LV_TILE_HASH_SIZE tile as it
+ * was last flushed, and leave out the tiles which were rendered the same again.
+ * Used in partial render mode. The invalidated areas and the bands of the draw buffer are
+ * rounded to the tiles; the rows and columns with changed tiles are flushed, joined when
+ * one flush is cheaper (see `lv_display_set_flush_cost()`).
+ * Enabling it again forgets the hashes, e.g. after something else drew on the display.
+ * The hashes are 32-bit FNV-1a and the pixels aren't kept to compare: a changed tile whose
+ * hash collides with the old one (about 1 in 2^32) is not sent and stays stale until it
+ * changes again. Invalidate the screen now and then if that matters.
+ * Fewer bytes go over the bus, but there may be more, smaller flushes: worth it when the bus
+ * is the bottleneck, not when the per-flush overhead is.
+ * @param disp      pointer to a display
+ * @param en        true: enable, false: disable and free the hashes
+ */
+void lv_display_set_tile_hash(lv_display_t * disp, bool en);
+
+#if LV_USE_DRAW_CULL
+
+/**
+ * Don't render what's covered anyway. The draw tasks of a band are collected first, then the ones
+ * under a newer opaque fill or image (no radius in the covered part) are dropped, and the ones
+ * covered along a whole side are clipped. The same is done in the layers of the widgets.
+ * Enabled by default if `LV_USE_DRAW_CULL` is 1. The culled tasks and pixels are in `lv_display_get_flush_stats()`.
+ * @param disp      pointer to a display
+ * @param en        true: enable, false: render every draw task as soon as it's added
+ */
+void lv_display_set_draw_cull(lv_display_t * disp, bool en);
+
+#endif /*LV_USE_DRAW_CULL*/
+
+/**
+ * Render and flush in a pipeline: while the flushes of up to `cnt - 1` bands are queued in the
+ * driver, the next band is rendered into the next free buffer. Partial render mode only.
+ * `flush_cb` is called as soon as a band is rendered, so the driver has to queue the transfers
+ * and call `lv_display_flush_ready()` once for each, in order. While all buffers are queued,
+ * `flush_wait_cb` (if set) is called until one is free; it should return when a transfer is done.
+ * With two buffers it's like double buffering, but the flush doesn't wait for the previous one.
+ * `lv_display_set_buffers()` and `lv_display_set_draw_buffers()` end the pipeline.
+ * @param disp      pointer to a display
+ * @param bufs      `cnt` buffers, aligned like the ones of `lv_display_set_buffers()`
+ * @param cnt       number of buffers, 2 ... LV_DISPLAY_PIPELINE_MAX
+ * @param buf_size  size of each buffer in bytes
+ */
+void lv_display_set_pipeline(lv_display_t * disp, void * const bufs[], uint32_t cnt, uint32_t buf_size);
+
+/**
+ * Set a microsecond clock for the band, flush and stall times of `lv_display_get_flush_stats()`.
+ * It's also called by `lv_display_flush_ready()`, maybe in an interrupt, so it has to be callable there.
+ * @param disp      pointer to a display
+ * @param time_cb   returns the time in microseconds, e.g. `esp_timer_get_time()`. NULL: no times
+ */
+void lv_display_set_time_cb(lv_display_t * disp, lv_display_time_cb_t time_cb);
+
 /**
  * Set the color format of the display.
  * @param disp              pointer to a display
@@ -308,7 +420,9 @@ bool lv_display_get_antialiasing(lv_display_t * disp);
 //! @cond Doxygen_Suppress
 
 /**
- * Call from the display driver when the flushing is finished
+ * Call from the display driver when the flushing is finished.
+ * If it's called from an interrupt, it, `lv_tick_get()` and the callback of `lv_display_set_time_cb()`
+ * have to be callable there, e.g. in IRAM on ESP32: see `LV_ATTRIBUTE_FLUSH_READY` and `LV_ATTRIBUTE_TICK_INC`.
  * @param disp      pointer to display whose `flush_cb` was called
  */
 LV_ATTRIBUTE_FLUSH_READY void lv_display_flush_ready(lv_display_t * disp);
@@ -530,6 +644,27 @@ lv_timer_t * lv_display_get_refr_timer(lv_display_t * disp);
  */
 void lv_display_delete_refr_timer(lv_display_t * disp);
 
+/**
+ * Adapt the refresh period to what refreshing costs, instead of LV_DEF_REFR_PERIOD.
+ * After every refresh which rendered something the period is set to the shortest one with
+ * which the average refresh time stays within `cpu_budget`. If the flushes need longer on
+ * the bus (see `lv_display_set_flush_cost()`), e.g. during an animation, the period is the bus
+ * time: the bus may be busy all the time, refreshing more often would only wait for it.
+ * The refresh still starts as soon as something is invalidated, if the period since the last
+ * one has passed. The time comes from `lv_display_set_time_cb()`, or the tick in ms; only with
+ * the former the time waiting for the driver is left out of the refresh time.
+ * @param disp      pointer to a display
+ * @param pacing    the limits, copied. NULL: back to the period used before
+ */
+void lv_display_set_pacing(lv_display_t * disp, const lv_display_pacing_t * pacing);
+
+/**
+ * Get the state of the adaptive refresh period.
+ * @param disp      pointer to a display
+ * @return          pointer to the state, NULL if the period isn't adaptive
+ */
+const lv_display_pacing_state_t * lv_display_get_pacing(lv_display_t * disp);
+
 void lv_display_set_user_data(lv_display_t * disp, void * user_data);
 void lv_display_set_driver_data(lv_display_t * disp, void * driver_data);
 void * lv_display_get_user_data(lv_display_t * disp);
@@ -16,6 +16,7 @@ extern "C" {
 #include "../misc/lv_types.h"
 #include "../core/lv_obj.h"
 #include "../draw/lv_draw.h"
+#include "../misc/lv_region.h"
 #include "lv_display.h"
 
 /*********************
@@ -25,6 +26,14 @@ extern "C" {
 #define LV_INV_BUF_SIZE 32 /*Buffer size for invalid areas*/
 #endif
 
+#ifndef LV_TILE_HASH_SIZE
+#define LV_TILE_HASH_SIZE 16 /*Width and height of the tiles compared before flushing, see `lv_display_set_tile_hash()`*/
+#endif
+
+#ifndef LV_INV_AREA_COST
+#define LV_INV_AREA_COST 256 /*Fixed cost of redrawing one more area, in pixels. Near areas closer than this are joined*/
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -79,6 +88,11 @@ struct _lv_display_t {
 
     /*1: It was the last chunk to flush. (It can't be a bit field because when it's cleared from IRQ Read-Modify-Write issue might occur)*/
     volatile int flushing_last;
+
+#if LV_USE_SYSMON && LV_USE_LATENCY_MONITOR
+    /*Tick when `lv_display_flush_ready()` was called for the last chunk of a refresh*/
+    volatile uint32_t last_flush_ready;
+#endif
     volatile uint32_t last_area         : 1; /*1: the last area is being rendered*/
     volatile uint32_t last_part         : 1; /*1: the last part of the current area is being rendered*/
 
@@ -90,12 +104,49 @@ struct _lv_display_t {
 
     lv_color_format_t   color_format;
 
-    /** Invalidated (marked to redraw) areas*/
+    /** Invalidated (marked to redraw) areas, disjoint. `inv_region` stores them in `inv_areas`*/
     lv_area_t inv_areas[LV_INV_BUF_SIZE];
-    uint8_t inv_area_joined[LV_INV_BUF_SIZE];
-    uint32_t inv_p;
+    lv_region_t inv_region;
     int32_t inv_en_cnt;
 
+    /** Cost of a flush on the bus, see `lv_display_set_flush_cost()`. 0 `byte_cost_ns`: not set*/
+    uint32_t flush_cost_ns;
+    uint32_t byte_cost_ns;
+    lv_display_flush_stats_t flush_stats;
+
+    /** Hash of each tile as it was last flushed, row by row. 0: unknown. NULL: not used*/
+    uint32_t * tile_hash;
+
+#if LV_USE_DRAW_CULL
+    /** Cull the draw tasks covered by opaque ones, see `lv_display_set_draw_cull()`*/
+    bool draw_cull;
+#endif
+
+    /** Buffers of `lv_display_set_pipeline()`, `buf_act` is `pipe_bufs[pipe_act]`. 0 `pipe_cnt`: not used*/
+    lv_draw_buf_t pipe_bufs[LV_DISPLAY_PIPELINE_MAX];
+    uint32_t pipe_cnt;
+    uint32_t pipe_act;
+    uint32_t pipe_seq[LV_DISPLAY_PIPELINE_MAX]; /**< `flush_issued` after the last flush from each buffer*/
+
+    /** Flushes started and finished. Only `lv_display_flush_ready()` writes `flush_done`*/
+    volatile uint32_t flush_issued;
+    volatile uint32_t flush_done;
+    uint32_t flush_last_seq;    /**< `flush_issued` after the last flush of a refresh, set before it starts*/
+    lv_display_time_cb_t time_cb;
+    uint32_t flush_start_us[LV_DISPLAY_PIPELINE_MAX];   /**< When the queued flushes started*/
+    uint32_t band_start_us;     /**< When rendering the current band started*/
+
+    /** Adaptive refresh period of `lv_display_set_pacing()`*/
+    bool pacing_en;
+    lv_display_pacing_t pacing;
+    lv_display_pacing_state_t pacing_state;
+    uint32_t pacing_def_period; /**< The refresh timer's period before, restored when disabled*/
+
+#if LV_USE_REFR_HEATMAP
+    /** Counters of `lv_refr_heatmap_enable()`. NULL: not counting*/
+    struct _lv_refr_heatmap_t * refr_heatmap;
+#endif
+
     /** Double buffer sync areas (redrawn during last refresh) */
     lv_ll_t sync_areas;
 
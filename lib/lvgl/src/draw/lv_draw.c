@@ -26,6 +26,7 @@
  *  STATIC PROTOTYPES
  **********************/
 static bool is_independent(lv_layer_t * layer, lv_draw_task_t * t_check);
+static void free_dsc(lv_draw_task_t * t);
 
 static inline uint32_t get_layer_size_kb(uint32_t size_byte)
 {
@@ -84,12 +85,19 @@ void * lv_draw_create_unit(size_t size)
 lv_draw_task_t * lv_draw_add_task(lv_layer_t * layer, const lv_area_t * coords)
 {
     LV_PROFILER_BEGIN;
+#if LV_DRAW_ARENA_CHUNK_SIZE
+    lv_draw_task_t * new_task = _lv_draw_arena_alloc(&layer->_arena, sizeof(lv_draw_task_t));
+    LV_ASSERT_MALLOC(new_task);
+    lv_memzero(new_task, sizeof(lv_draw_task_t));
+#else
     lv_draw_task_t * new_task = lv_malloc_zeroed(sizeof(lv_draw_task_t));
+#endif
 
     new_task->area = *coords;
     new_task->_real_area = *coords;
     new_task->clip_area = layer->_clip_area;
     new_task->state = LV_DRAW_TASK_STATE_QUEUED;
+    new_task->_seq = layer->_task_seq++;
 
     /*Find the tail*/
     if(layer->draw_task_head == NULL) {
@@ -102,10 +110,27 @@ lv_draw_task_t * lv_draw_add_task(lv_layer_t * layer, const lv_area_t * coords)
         tail->next = new_task;
     }
 
+#if LV_DRAW_TASK_INDEX_CELLS
+    _lv_draw_task_index_add(layer, new_task);
+#endif
+
     LV_PROFILER_END;
     return new_task;
 }
 
+void * lv_draw_task_alloc_dsc(lv_layer_t * layer, lv_draw_task_t * t, size_t size)
+{
+#if LV_DRAW_ARENA_CHUNK_SIZE
+    t->draw_dsc = _lv_draw_arena_alloc(&layer->_arena, size);
+    t->_dsc_in_arena = true;
+#else
+    LV_UNUSED(layer);
+    t->draw_dsc = lv_malloc(size);
+#endif
+    LV_ASSERT_MALLOC(t->draw_dsc);
+    return t->draw_dsc;
+}
+
 void lv_draw_finalize_task_creation(lv_layer_t * layer, lv_draw_task_t * t)
 {
     LV_PROFILER_BEGIN;
@@ -114,6 +139,11 @@ void lv_draw_finalize_task_creation(lv_layer_t * layer, lv_draw_task_t * t)
 
     lv_draw_global_info_t * info = &_draw_info;
 
+#if LV_DRAW_TASK_INDEX_CELLS
+    /*The real area is set after adding the task (e.g. for shadows)*/
+    _lv_draw_task_index_add(layer, t);
+#endif
+
     /*Send LV_EVENT_DRAW_TASK_ADDED and dispatch only on the "main" draw_task
      *and not on the draw tasks added in the event.
      *Sending LV_EVENT_DRAW_TASK_ADDED events might cause recursive event sends and besides
@@ -182,6 +212,10 @@ bool lv_draw_dispatch_layer(lv_display_t * disp, lv_layer_t * layer)
             if(t_prev) t_prev->next = t->next;      /*Remove by it by assigning the next task to the previous*/
             else layer->draw_task_head = t_next;    /*If it was the head, set the next as head*/
 
+#if LV_DRAW_TASK_INDEX_CELLS
+            _lv_draw_task_index_remove(layer, t);
+#endif
+
             /*If it was layer drawing free the layer too*/
             if(t->type == LV_DRAW_TASK_TYPE_LAYER) {
                 lv_draw_image_dsc_t * draw_image_dsc = t->draw_dsc;
@@ -210,17 +244,19 @@ bool lv_draw_dispatch_layer(lv_display_t * disp, lv_layer_t * layer)
                     }
 
                     if(disp->layer_deinit) disp->layer_deinit(disp, layer_drawn);
+                    _lv_draw_layer_deinit(layer_drawn);
                     lv_free(layer_drawn);
                 }
             }
-            lv_draw_label_dsc_t * draw_label_dsc = lv_draw_task_get_label_dsc(t);
-            if(draw_label_dsc && draw_label_dsc->text_local) {
-                lv_free((void *)draw_label_dsc->text);
-                draw_label_dsc->text = NULL;
+#if LV_DRAW_ARENA_CHUNK_SIZE
+            /*The task is freed with the arena. So is its descriptor, unless it was allocated by the caller*/
+            if(!t->_dsc_in_arena) {
+                free_dsc(t);
             }
-
-            lv_free(t->draw_dsc);
+#else
+            free_dsc(t);
             lv_free(t);
+#endif
         }
         else {
             t_prev = t;
@@ -228,6 +264,13 @@ bool lv_draw_dispatch_layer(lv_display_t * disp, lv_layer_t * layer)
         t = t_next;
     }
 
+#if LV_DRAW_ARENA_CHUNK_SIZE
+    /*Nothing refers to the memory of the finished tasks anymore*/
+    if(layer->draw_task_head == NULL) {
+        _lv_draw_arena_reset(&layer->_arena);
+    }
+#endif
+
     bool render_running = false;
 
     /*This layer is ready, enable blending its buffer*/
@@ -248,6 +291,13 @@ bool lv_draw_dispatch_layer(lv_display_t * disp, lv_layer_t * layer)
     }
     /*Assign draw tasks to the draw_units*/
     else {
+#if LV_USE_DRAW_CULL
+        /*Wait until all the tasks are added and the covered ones are culled*/
+        if(layer->_cull_pending) {
+            LV_PROFILER_END;
+            return false;
+        }
+#endif
         /*Find a draw unit which is not busy and can take at least one task*/
         /*Let all draw units to pick draw tasks*/
         lv_draw_unit_t * u = _draw_info.unit_head;
@@ -321,6 +371,15 @@ uint32_t lv_draw_get_dependent_count(lv_draw_task_t * t_check)
     LV_PROFILER_BEGIN;
     uint32_t cnt = 0;
 
+#if LV_DRAW_TASK_INDEX_CELLS
+    lv_draw_dsc_base_t * base_dsc = t_check->draw_dsc;
+    if(base_dsc && base_dsc->layer && _lv_draw_task_index_is_usable(base_dsc->layer)) {
+        cnt = _lv_draw_task_index_get_dependent_count(base_dsc->layer, t_check);
+        LV_PROFILER_END;
+        return cnt;
+    }
+#endif
+
     lv_draw_task_t * t = t_check->next;
     while(t) {
         if((t->state == LV_DRAW_TASK_STATE_QUEUED || t->state == LV_DRAW_TASK_STATE_WAITING) &&
@@ -334,6 +393,23 @@ uint32_t lv_draw_get_dependent_count(lv_draw_task_t * t_check)
     return cnt;
 }
 
+#if LV_DRAW_ARENA_CHUNK_SIZE
+
+const lv_draw_arena_stats_t * lv_draw_get_arena_stats(void)
+{
+    return &_draw_info.arena_stats;
+}
+
+void lv_draw_reset_arena_stats(void)
+{
+    /*The memory held now stays*/
+    uint32_t size = _draw_info.arena_stats.size;
+    lv_memzero(&_draw_info.arena_stats, sizeof(lv_draw_arena_stats_t));
+    _draw_info.arena_stats.size = size;
+}
+
+#endif /*LV_DRAW_ARENA_CHUNK_SIZE*/
+
 lv_layer_t * lv_draw_layer_create(lv_layer_t * parent_layer, lv_color_format_t color_format, const lv_area_t * area)
 {
     lv_display_t * disp = _lv_refr_get_disp_refreshing();
@@ -345,6 +421,10 @@ lv_layer_t * lv_draw_layer_create(lv_layer_t * parent_layer, lv_color_format_t c
     new_layer->_clip_area = *area;
     new_layer->buf_area = *area;
     new_layer->color_format = color_format;
+#if LV_USE_DRAW_CULL
+    /*Created while the tasks of the parent are collected: collect its tasks too*/
+    new_layer->_cull_pending = parent_layer->_cull_pending;
+#endif
 
     if(disp->layer_head) {
         lv_layer_t * tail = disp->layer_head;
@@ -358,6 +438,15 @@ lv_layer_t * lv_draw_layer_create(lv_layer_t * parent_layer, lv_color_format_t c
     return new_layer;
 }
 
+void _lv_draw_layer_deinit(lv_layer_t * layer)
+{
+#if LV_DRAW_ARENA_CHUNK_SIZE
+    _lv_draw_arena_deinit(&layer->_arena);
+#else
+    LV_UNUSED(layer);
+#endif
+}
+
 void * lv_draw_layer_alloc_buf(lv_layer_t * layer)
 {
     /*If the buffer of the layer is already allocated return it*/
@@ -405,6 +494,15 @@ void * lv_draw_layer_go_to_xy(lv_layer_t * layer, int32_t x, int32_t y)
 static bool is_independent(lv_layer_t * layer, lv_draw_task_t * t_check)
 {
     LV_PROFILER_BEGIN;
+#if LV_DRAW_TASK_INDEX_CELLS
+    /*Check only the tasks in the same cells*/
+    if(_lv_draw_task_index_is_usable(layer)) {
+        bool independent = !_lv_draw_task_index_overlaps_older(layer, t_check);
+        LV_PROFILER_END;
+        return independent;
+    }
+#endif
+
     lv_draw_task_t * t = layer->draw_task_head;
 
     /*If t_check is outside of the older tasks then it's independent*/
@@ -422,3 +520,18 @@ static bool is_independent(lv_layer_t * layer, lv_draw_task_t * t_check)
 
     return true;
 }
+
+/**
+ * Free the draw descriptor of a task, and the text of a label if it's a copy
+ * @param t     pointer to a draw task
+ */
+static void free_dsc(lv_draw_task_t * t)
+{
+    lv_draw_label_dsc_t * draw_label_dsc = lv_draw_task_get_label_dsc(t);
+    if(draw_label_dsc && draw_label_dsc->text_local) {
+        lv_free((void *)draw_label_dsc->text);
+        draw_label_dsc->text = NULL;
+    }
+
+    lv_free(t->draw_dsc);
+}
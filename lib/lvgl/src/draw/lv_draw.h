@@ -22,6 +22,9 @@ extern "C" {
 #include "lv_image_decoder.h"
 #include "../osal/lv_os.h"
 #include "lv_draw_buf.h"
+#include "lv_draw_task_index.h"
+#include "lv_draw_arena.h"
+#include "lv_draw_cull.h"
 
 /*********************
  *      DEFINES
@@ -96,6 +99,22 @@ struct _lv_draw_task_t {
      */
     uint8_t preference_score;
 
+    /** Increasing in the order the tasks are added to the layer, to tell which one is older*/
+    uint32_t _seq;
+
+#if LV_DRAW_TASK_INDEX_CELLS
+    /** The cells of the layer's task index where the task is listed*/
+    uint8_t _cell_x1;
+    uint8_t _cell_y1;
+    uint8_t _cell_x2;
+    uint8_t _cell_y2;
+    bool _indexed;
+#endif
+
+#if LV_DRAW_ARENA_CHUNK_SIZE
+    /** `draw_dsc` (and the text of a label) is on the layer's arena, see `lv_draw_task_alloc_dsc()`*/
+    bool _dsc_in_arena;
+#endif
 };
 
 typedef struct {
@@ -172,6 +191,24 @@ struct _lv_layer_t  {
     lv_layer_t * next;
     bool all_tasks_added;
     void * user_data;
+
+    /** `_seq` of the next draw task*/
+    uint32_t _task_seq;
+
+#if LV_DRAW_TASK_INDEX_CELLS
+    /** The draw tasks by area*/
+    _lv_draw_task_index_t _task_index;
+#endif
+
+#if LV_DRAW_ARENA_CHUNK_SIZE
+    /** Memory of the draw tasks, reset when all of them are finished*/
+    _lv_draw_arena_t _arena;
+#endif
+
+#if LV_USE_DRAW_CULL
+    /** Draw tasks are being added, dispatch them only after `_lv_draw_cull_layer()`*/
+    bool _cull_pending;
+#endif
 };
 
 typedef struct {
@@ -194,6 +231,9 @@ typedef struct {
 #endif
     lv_mutex_t circle_cache_mutex;
     bool task_running;
+#if LV_DRAW_ARENA_CHUNK_SIZE
+    lv_draw_arena_stats_t arena_stats;
+#endif
 } lv_draw_global_info_t;
 
 /**********************
@@ -226,6 +266,16 @@ void * lv_draw_create_unit(size_t size);
  */
 lv_draw_task_t * lv_draw_add_task(lv_layer_t * layer, const lv_area_t * coords);
 
+/**
+ * Allocate the draw descriptor of a draw task. With `LV_DRAW_ARENA_CHUNK_SIZE` it's on the arena of the layer,
+ * else it's allocated with `lv_malloc()`. It's freed with the draw task in both cases.
+ * @param layer     pointer to the layer of the draw task
+ * @param t         pointer to a draw task, its `draw_dsc` is set
+ * @param size      size of the descriptor in bytes
+ * @return          pointer to the descriptor, not initialized
+ */
+void * lv_draw_task_alloc_dsc(lv_layer_t * layer, lv_draw_task_t * t, size_t size);
+
 /**
  * Needs to be called when a draw task is created and configured.
  * It will send an event about the new draw task to the widget
@@ -279,6 +329,21 @@ lv_draw_task_t * lv_draw_get_next_available_task(lv_layer_t * layer, lv_draw_tas
  */
 uint32_t lv_draw_get_dependent_count(lv_draw_task_t * t_check);
 
+#if LV_DRAW_ARENA_CHUNK_SIZE
+
+/**
+ * Get the statistics of the draw task memory of all the layers
+ * @return          the statistics since the last `lv_draw_reset_arena_stats()`
+ */
+const lv_draw_arena_stats_t * lv_draw_get_arena_stats(void);
+
+/**
+ * Reset the counters and the high water mark of `lv_draw_get_arena_stats()`
+ */
+void lv_draw_reset_arena_stats(void);
+
+#endif /*LV_DRAW_ARENA_CHUNK_SIZE*/
+
 /**
  * Create a new layer on a parent layer
  * @param parent_layer      the parent layer to which the layer will be merged when it's rendered
@@ -288,6 +353,13 @@ uint32_t lv_draw_get_dependent_count(lv_draw_task_t * t_check);
  */
 lv_layer_t * lv_draw_layer_create(lv_layer_t * parent_layer, lv_color_format_t color_format, const lv_area_t * area);
 
+/**
+ * Free the memory a layer keeps for its draw tasks.
+ * Call it when all the draw tasks of the layer are finished, before freeing or reusing it.
+ * @param layer             pointer to a layer
+ */
+void _lv_draw_layer_deinit(lv_layer_t * layer);
+
 /**
  * Try to allocate a buffer for the layer.
  * @param layer             pointer to a layer
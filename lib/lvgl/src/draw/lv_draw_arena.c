@@ -0,0 +1,131 @@
+/**
+ * @file lv_draw_arena.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw_arena.h"
+#if LV_DRAW_ARENA_CHUNK_SIZE
+
+#include "../core/lv_global.h"
+#include "../stdlib/lv_mem.h"
+#include "../stdlib/lv_string.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define _stats LV_GLOBAL_DEFAULT()->draw_info.arena_stats
+
+#define ALIGN_SIZE(s)   (((s) + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+#define HEADER_SIZE     ALIGN_SIZE(sizeof(_lv_draw_arena_chunk_t))
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static _lv_draw_arena_chunk_t * next_chunk(_lv_draw_arena_t * arena, uint32_t size);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void * _lv_draw_arena_alloc(_lv_draw_arena_t * arena, size_t size)
+{
+    size = ALIGN_SIZE(size);
+
+    if(arena->cur == NULL || arena->cur_used + size > arena->cur->size) {
+        _lv_draw_arena_chunk_t * c = next_chunk(arena, size);
+        if(c == NULL) return NULL;
+        arena->cur = c;
+        arena->cur_used = 0;
+    }
+
+    void * p = (uint8_t *)arena->cur + HEADER_SIZE + arena->cur_used;
+    arena->cur_used += size;
+    arena->used += size;
+
+    _stats.alloc_cnt++;
+    if(arena->used > _stats.high_water) _stats.high_water = arena->used;
+
+    return p;
+}
+
+char * _lv_draw_arena_strdup(_lv_draw_arena_t * arena, const char * str)
+{
+    size_t len = lv_strlen(str) + 1;
+    char * dst = _lv_draw_arena_alloc(arena, len);
+    if(dst == NULL) return NULL;
+
+    lv_memcpy(dst, str, len);
+    return dst;
+}
+
+void _lv_draw_arena_reset(_lv_draw_arena_t * arena)
+{
+    if(arena->used == 0) return;
+
+    arena->cur = arena->head;
+    arena->cur_used = 0;
+    arena->used = 0;
+    _stats.reset_cnt++;
+}
+
+void _lv_draw_arena_deinit(_lv_draw_arena_t * arena)
+{
+    _lv_draw_arena_chunk_t * c = arena->head;
+    while(c) {
+        _lv_draw_arena_chunk_t * next = c->next;
+        _stats.size -= HEADER_SIZE + c->size;
+        lv_free(c);
+        c = next;
+    }
+    lv_memzero(arena, sizeof(*arena));
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Get the next chunk with at least `size` free bytes: a kept one or a new one.
+ * Kept chunks which are too small for it (only for very large allocations) are skipped until the reset.
+ */
+static _lv_draw_arena_chunk_t * next_chunk(_lv_draw_arena_t * arena, uint32_t size)
+{
+    _lv_draw_arena_chunk_t * prev = arena->cur;
+    _lv_draw_arena_chunk_t * c = prev ? prev->next : arena->head;
+    while(c && c->size < size) {
+        prev = c;
+        c = c->next;
+    }
+    if(c) return c;
+
+    uint32_t chunk_size = LV_MAX(LV_DRAW_ARENA_CHUNK_SIZE - HEADER_SIZE, size);
+    c = lv_malloc(HEADER_SIZE + chunk_size);
+    LV_ASSERT_MALLOC(c);
+    if(c == NULL) return NULL;
+
+    c->next = NULL;
+    c->size = chunk_size;
+    if(prev) prev->next = c;
+    else arena->head = c;
+
+    _stats.chunk_alloc_cnt++;
+    _stats.size += HEADER_SIZE + chunk_size;
+    return c;
+}
+
+#endif /*LV_DRAW_ARENA_CHUNK_SIZE*/
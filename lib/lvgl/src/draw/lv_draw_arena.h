@@ -0,0 +1,96 @@
+/**
+ * @file lv_draw_arena.h
+ * Memory of the draw tasks of a layer, their descriptors and the copied texts of labels.
+ * It's allocated by moving a pointer in chunks of `LV_DRAW_ARENA_CHUNK_SIZE` bytes, nothing is freed
+ * one by one. When all the draw tasks of the layer are finished the arena is reset and the chunks
+ * are used again for the next tasks, so a refresh needs an `lv_malloc()` only if it draws more than before.
+ */
+
+#ifndef LV_DRAW_ARENA_H
+#define LV_DRAW_ARENA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_conf_internal.h"
+#include <stddef.h>
+#include "../misc/lv_types.h"
+
+#if LV_DRAW_ARENA_CHUNK_SIZE
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/** Statistics of the arenas of all the layers, see `lv_draw_get_arena_stats()`*/
+typedef struct {
+    uint32_t alloc_cnt;         /**< Allocations from the arenas, each one an `lv_malloc()` and `lv_free()` saved*/
+    uint32_t chunk_alloc_cnt;   /**< `lv_malloc()` calls for new chunks*/
+    uint32_t reset_cnt;         /**< Times a layer finished all its tasks and its arena was reset*/
+    uint32_t high_water;        /**< The most bytes a layer used before a reset*/
+    uint32_t size;              /**< Bytes held in chunks by all the arenas now*/
+} lv_draw_arena_stats_t;
+
+typedef struct _lv_draw_arena_chunk_t {
+    struct _lv_draw_arena_chunk_t * next;
+    uint32_t size;              /**< Bytes for allocations after this header*/
+} _lv_draw_arena_chunk_t;
+
+typedef struct {
+    _lv_draw_arena_chunk_t * head;  /**< All the chunks, kept after a reset*/
+    _lv_draw_arena_chunk_t * cur;   /**< Allocating from this chunk*/
+    uint32_t cur_used;              /**< Bytes allocated from `cur`*/
+    uint32_t used;                  /**< Bytes allocated since the last reset*/
+} _lv_draw_arena_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Allocate memory which stays valid until the arena is reset
+ * @param arena     pointer to an arena
+ * @param size      size in bytes
+ * @return          pointer to the memory, aligned to a pointer, or NULL if out of memory
+ */
+void * _lv_draw_arena_alloc(_lv_draw_arena_t * arena, size_t size);
+
+/**
+ * Copy a string to an arena
+ * @param arena     pointer to an arena
+ * @param str       the string to copy
+ * @return          the copy, or NULL if out of memory
+ */
+char * _lv_draw_arena_strdup(_lv_draw_arena_t * arena, const char * str);
+
+/**
+ * Make all the memory of the arena available again. The chunks are kept for reuse.
+ * @param arena     pointer to an arena
+ */
+void _lv_draw_arena_reset(_lv_draw_arena_t * arena);
+
+/**
+ * Free the chunks of an arena
+ * @param arena     pointer to an arena
+ */
+void _lv_draw_arena_deinit(_lv_draw_arena_t * arena);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_DRAW_ARENA_CHUNK_SIZE*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_DRAW_ARENA_H*/
@@ -0,0 +1,231 @@
+/**
+ * @file lv_draw_cull.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw.h"
+#if LV_USE_DRAW_CULL
+
+#include "lv_draw_rect.h"
+#include "lv_draw_image.h"
+#include "../core/lv_refr.h"
+#include "../display/lv_display_private.h"
+#include "../stdlib/lv_mem.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct {
+    lv_area_t area;     /**< The area the task surely overwrites*/
+    uint32_t pos;       /**< Position of the task in the list*/
+} cover_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool get_cover_area(const lv_draw_task_t * t, lv_area_t * cover);
+static bool is_cullable(const lv_draw_task_t * t);
+static void clip_uncovered(lv_area_t * a, const lv_area_t * cover);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void _lv_draw_cull_layer(lv_layer_t * layer)
+{
+    LV_PROFILER_BEGIN;
+    layer->_cull_pending = false;
+
+    /*Collect the opaque tasks*/
+    lv_area_t a;
+    uint32_t cover_cnt = 0;
+    lv_draw_task_t * t;
+    for(t = layer->draw_task_head; t; t = t->next) {
+        if(get_cover_area(t, &a)) cover_cnt++;
+    }
+    if(cover_cnt == 0) {
+        LV_PROFILER_END;
+        return;
+    }
+
+#if LV_DRAW_ARENA_CHUNK_SIZE
+    cover_t * covers = _lv_draw_arena_alloc(&layer->_arena, cover_cnt * sizeof(cover_t));
+#else
+    cover_t * covers = lv_malloc(cover_cnt * sizeof(cover_t));
+#endif
+    LV_ASSERT_MALLOC(covers);
+    if(covers == NULL) {
+        LV_PROFILER_END;
+        return;
+    }
+
+    uint32_t i = 0;
+    uint32_t pos = 0;
+    for(t = layer->draw_task_head; t; t = t->next, pos++) {
+        if(get_cover_area(t, &covers[i].area)) {
+            covers[i].pos = pos;
+            i++;
+        }
+    }
+
+    /*Only the newer opaque tasks hide a task*/
+    uint32_t culled_tasks = 0;
+    uint32_t culled_px = 0;
+    uint32_t first = 0;
+    pos = 0;
+    for(t = layer->draw_task_head; t; t = t->next, pos++) {
+        while(first < cover_cnt && covers[first].pos <= pos) first++;
+        if(first == cover_cnt) break;
+        if(!is_cullable(t)) continue;
+        if(!_lv_area_intersect(&a, &t->_real_area, &t->clip_area)) continue;
+
+        uint32_t size_ori = lv_area_get_size(&a);
+        bool covered = false;
+        for(i = first; i < cover_cnt; i++) {
+            if(_lv_area_is_in(&a, &covers[i].area, 0)) {
+                covered = true;
+                break;
+            }
+            clip_uncovered(&a, &covers[i].area);
+        }
+
+        if(covered) {
+            /*The dispatcher removes it as if it was drawn*/
+            t->state = LV_DRAW_TASK_STATE_READY;
+            culled_tasks++;
+            culled_px += size_ori;
+        }
+        else {
+            uint32_t size = lv_area_get_size(&a);
+            if(size < size_ori) {
+                t->clip_area = a;
+                culled_px += size_ori - size;
+            }
+        }
+    }
+
+#if LV_DRAW_ARENA_CHUNK_SIZE == 0
+    lv_free(covers);
+#endif
+
+    lv_display_t * disp = _lv_refr_get_disp_refreshing();
+    if(disp) {
+        disp->flush_stats.culled_tasks += culled_tasks;
+        disp->flush_stats.culled_px += culled_px;
+    }
+    LV_PROFILER_END;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Get the area a task surely overwrites with opaque pixels, whatever is below it
+ * @param t         a draw task
+ * @param cover     store the area here
+ * @return          true: `t` covers `cover`; false: it might let some of the pixels below through
+ */
+static bool get_cover_area(const lv_draw_task_t * t, lv_area_t * cover)
+{
+    if(t->state == LV_DRAW_TASK_STATE_READY) return false;
+
+    lv_area_t a = t->area;
+    if(t->type == LV_DRAW_TASK_TYPE_FILL) {
+        const lv_draw_fill_dsc_t * dsc = t->draw_dsc;
+        if(dsc->opa < LV_OPA_MAX) return false;
+        if(dsc->grad.dir != LV_GRAD_DIR_NONE) {
+            uint32_t i;
+            for(i = 0; i < dsc->grad.stops_count; i++) {
+                if(dsc->grad.stops[i].opa < LV_OPA_MAX) return false;
+            }
+        }
+
+        /*Leave out the rounded corners: keep the larger band between them*/
+        int32_t w = lv_area_get_width(&a);
+        int32_t h = lv_area_get_height(&a);
+        int32_t r = LV_MIN(dsc->radius, LV_MIN(w, h) / 2);
+        if(r > 0) {
+            if(w >= h) {
+                a.x1 += r;
+                a.x2 -= r;
+            }
+            else {
+                a.y1 += r;
+                a.y2 -= r;
+            }
+        }
+    }
+    else if(t->type == LV_DRAW_TASK_TYPE_IMAGE) {
+        /*Only images drawn 1:1, without alpha, which surely can be decoded*/
+        const lv_draw_image_dsc_t * dsc = t->draw_dsc;
+        if(dsc->opa < LV_OPA_MAX || dsc->rotation || dsc->skew_x || dsc->skew_y) return false;
+        if(dsc->scale_x != LV_SCALE_NONE || dsc->scale_y != LV_SCALE_NONE) return false;
+        if(dsc->blend_mode != LV_BLEND_MODE_NORMAL || dsc->tile || dsc->bitmap_mask_src) return false;
+        if(lv_image_src_get_type(dsc->src) != LV_IMAGE_SRC_VARIABLE) return false;
+        if(dsc->header.cf != LV_COLOR_FORMAT_RGB565 && dsc->header.cf != LV_COLOR_FORMAT_RGB888 &&
+           dsc->header.cf != LV_COLOR_FORMAT_XRGB8888) return false;
+        if(lv_area_get_width(&a) != dsc->header.w || lv_area_get_height(&a) != dsc->header.h) return false;
+    }
+    else {
+        return false;
+    }
+
+    return _lv_area_intersect(cover, &a, &t->clip_area);
+}
+
+/**
+ * Check if a task can be dropped or clipped. Layers and masks are kept, and so are vector
+ * tasks which free their paths when drawn.
+ */
+static bool is_cullable(const lv_draw_task_t * t)
+{
+    if(t->state != LV_DRAW_TASK_STATE_QUEUED) return false;
+
+    switch(t->type) {
+        case LV_DRAW_TASK_TYPE_FILL:
+        case LV_DRAW_TASK_TYPE_BORDER:
+        case LV_DRAW_TASK_TYPE_BOX_SHADOW:
+        case LV_DRAW_TASK_TYPE_LABEL:
+        case LV_DRAW_TASK_TYPE_IMAGE:
+        case LV_DRAW_TASK_TYPE_LINE:
+        case LV_DRAW_TASK_TYPE_ARC:
+        case LV_DRAW_TASK_TYPE_TRIANGLE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Cut a side of an area if it's covered along the whole side
+ */
+static void clip_uncovered(lv_area_t * a, const lv_area_t * cover)
+{
+    if(cover->x1 <= a->x1 && cover->x2 >= a->x2) {
+        if(cover->y1 <= a->y1 && cover->y2 >= a->y1) a->y1 = cover->y2 + 1;
+        else if(cover->y1 <= a->y2 && cover->y2 >= a->y2) a->y2 = cover->y1 - 1;
+    }
+    else if(cover->y1 <= a->y1 && cover->y2 >= a->y2) {
+        if(cover->x1 <= a->x1 && cover->x2 >= a->x1) a->x1 = cover->x2 + 1;
+        else if(cover->x1 <= a->x2 && cover->x2 >= a->x2) a->x2 = cover->x1 - 1;
+    }
+}
+
+#endif /*LV_USE_DRAW_CULL*/
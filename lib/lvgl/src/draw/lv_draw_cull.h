@@ -0,0 +1,54 @@
+/**
+ * @file lv_draw_cull.h
+ * Occlusion culling of the draw tasks of a layer.
+ * While the tasks of a layer are added they are not dispatched. When all are added, the tasks
+ * covered by a newer opaque fill or image are dropped, and the ones covered on a side are clipped,
+ * so the pixels which would be overwritten anyway are not rendered.
+ */
+
+#ifndef LV_DRAW_CULL_H
+#define LV_DRAW_CULL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_conf_internal.h"
+#include "../misc/lv_types.h"
+
+#if LV_USE_DRAW_CULL
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Drop or clip the queued draw tasks of a layer which are covered by newer opaque tasks,
+ * and let the layer's tasks be dispatched. The culled tasks and pixels are added to the
+ * flush statistics of the display being refreshed.
+ * @param layer     a layer whose tasks are all added, with `_cull_pending` set
+ */
+void _lv_draw_cull_layer(lv_layer_t * layer);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_DRAW_CULL*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_DRAW_CULL_H*/
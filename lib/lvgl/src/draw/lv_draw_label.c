@@ -84,14 +84,18 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_layer_t * layer, const lv_draw_label
     LV_PROFILER_BEGIN;
     lv_draw_task_t * t = lv_draw_add_task(layer, coords);
 
-    t->draw_dsc = lv_malloc(sizeof(*dsc));
+    lv_draw_task_alloc_dsc(layer, t, sizeof(*dsc));
     lv_memcpy(t->draw_dsc, dsc, sizeof(*dsc));
     t->type = LV_DRAW_TASK_TYPE_LABEL;
 
     /*The text is stored in a local variable so malloc memory for it*/
     if(dsc->text_local) {
         lv_draw_label_dsc_t * new_dsc = t->draw_dsc;
+#if LV_DRAW_ARENA_CHUNK_SIZE
+        new_dsc->text = _lv_draw_arena_strdup(&layer->_arena, dsc->text);
+#else
         new_dsc->text = lv_strdup(dsc->text);
+#endif
     }
 
     lv_draw_finalize_task_creation(layer, t);
@@ -0,0 +1,274 @@
+/**
+ * @file lv_draw_task_index.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw.h"
+#if LV_DRAW_TASK_INDEX_CELLS
+
+#include "../stdlib/lv_mem.h"
+#include "../stdlib/lv_string.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define CELL_SIZE_MIN   8   /*Tasks in a cell when its list is allocated*/
+
+#if LV_DRAW_TASK_INDEX_CELLS > 255
+#error "LV_DRAW_TASK_INDEX_CELLS can be 255 at most"
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool create_grid(_lv_draw_task_index_t * index, const lv_area_t * area);
+static void delete_grid(_lv_draw_task_index_t * index);
+static void get_cell_range(const _lv_draw_task_index_t * index, const lv_area_t * a, int32_t * x1, int32_t * y1,
+                           int32_t * x2, int32_t * y2);
+static bool cell_insert(_lv_draw_task_index_cell_t * cell, lv_draw_task_t * t);
+static void cell_remove(_lv_draw_task_index_cell_t * cell, lv_draw_task_t * t);
+static void remove_from_cells(_lv_draw_task_index_t * index, lv_draw_task_t * t);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void _lv_draw_task_index_add(lv_layer_t * layer, lv_draw_task_t * t)
+{
+    _lv_draw_task_index_t * index = &layer->_task_index;
+
+    if(t->_indexed) {
+        remove_from_cells(index, t);
+    }
+    else {
+        if(index->task_cnt == 0 && !create_grid(index, &layer->buf_area)) {
+            index->failed = true;
+        }
+        index->task_cnt++;
+        t->_indexed = true;
+    }
+
+    if(index->cells == NULL) return;
+
+    /*List the task where it might draw: its area and real area (e.g. a shadow) together*/
+    lv_area_t a;
+    _lv_area_join(&a, &t->area, &t->_real_area);
+    int32_t x1, y1, x2, y2;
+    get_cell_range(index, &a, &x1, &y1, &x2, &y2);
+    t->_cell_x1 = (uint8_t)x1;
+    t->_cell_y1 = (uint8_t)y1;
+    t->_cell_x2 = (uint8_t)x2;
+    t->_cell_y2 = (uint8_t)y2;
+
+    int32_t x, y;
+    for(y = y1; y <= y2; y++) {
+        _lv_draw_task_index_cell_t * cell = &index->cells[y * index->cols];
+        for(x = x1; x <= x2; x++) {
+            if(!cell_insert(&cell[x], t)) index->failed = true;
+        }
+    }
+}
+
+void _lv_draw_task_index_remove(lv_layer_t * layer, lv_draw_task_t * t)
+{
+    _lv_draw_task_index_t * index = &layer->_task_index;
+    if(!t->_indexed) return;
+
+    remove_from_cells(index, t);
+    t->_indexed = false;
+    index->task_cnt--;
+
+    /*The layer is empty: the next task might come for an other buffer area*/
+    if(index->task_cnt == 0) {
+        delete_grid(index);
+        index->failed = false;
+        layer->_task_seq = 0;
+    }
+}
+
+bool _lv_draw_task_index_is_usable(lv_layer_t * layer)
+{
+    return layer->_task_index.cells && !layer->_task_index.failed;
+}
+
+bool _lv_draw_task_index_overlaps_older(lv_layer_t * layer, lv_draw_task_t * t_check)
+{
+    _lv_draw_task_index_t * index = &layer->_task_index;
+    int32_t x1, y1, x2, y2;
+    get_cell_range(index, &t_check->_real_area, &x1, &y1, &x2, &y2);
+
+    int32_t x, y;
+    for(y = y1; y <= y2; y++) {
+        _lv_draw_task_index_cell_t * cell = &index->cells[y * index->cols];
+        for(x = x1; x <= x2; x++) {
+            /*Only the beginning of the list is older*/
+            uint32_t i;
+            for(i = 0; i < cell[x].cnt; i++) {
+                lv_draw_task_t * t = cell[x].tasks[i];
+                if(t->_seq >= t_check->_seq) break;
+                if(t->state != LV_DRAW_TASK_STATE_READY) {
+                    lv_area_t a;
+                    if(_lv_area_intersect(&a, &t->_real_area, &t_check->_real_area)) return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+uint32_t _lv_draw_task_index_get_dependent_count(lv_layer_t * layer, lv_draw_task_t * t_check)
+{
+    _lv_draw_task_index_t * index = &layer->_task_index;
+    int32_t x1, y1, x2, y2;
+    get_cell_range(index, &t_check->area, &x1, &y1, &x2, &y2);
+
+    uint32_t cnt = 0;
+    int32_t x, y;
+    for(y = y1; y <= y2; y++) {
+        _lv_draw_task_index_cell_t * cell = &index->cells[y * index->cols];
+        for(x = x1; x <= x2; x++) {
+            /*Only the end of the list is newer*/
+            int32_t i;
+            for(i = cell[x].cnt - 1; i >= 0; i--) {
+                lv_draw_task_t * t = cell[x].tasks[i];
+                if(t->_seq <= t_check->_seq) break;
+
+                /*A task can be listed in more cells: count it only in the first common one*/
+                if(x != LV_MAX(x1, t->_cell_x1) || y != LV_MAX(y1, t->_cell_y1)) continue;
+
+                if((t->state == LV_DRAW_TASK_STATE_QUEUED || t->state == LV_DRAW_TASK_STATE_WAITING) &&
+                   _lv_area_is_on(&t_check->area, &t->area)) {
+                    cnt++;
+                }
+            }
+        }
+    }
+
+    return cnt;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Split an area to about `LV_DRAW_TASK_INDEX_CELLS` cells, as square as possible.
+ * E.g. a 480x40 band of a partial buffer is split to 28x2 cells.
+ * @param index     the index to initialize
+ * @param area      the area to split
+ * @return          false: out of memory
+ */
+static bool create_grid(_lv_draw_task_index_t * index, const lv_area_t * area)
+{
+    int32_t w = LV_MAX(lv_area_get_width(area), 1);
+    int32_t h = LV_MAX(lv_area_get_height(area), 1);
+
+    int32_t cols = 1;
+    while(cols < LV_DRAW_TASK_INDEX_CELLS && (int64_t)cols * cols * h < (int64_t)LV_DRAW_TASK_INDEX_CELLS * w) cols++;
+    int32_t rows = LV_MAX(LV_DRAW_TASK_INDEX_CELLS / cols, 1);
+
+    index->cells = lv_malloc_zeroed(cols * rows * sizeof(_lv_draw_task_index_cell_t));
+    LV_ASSERT_MALLOC(index->cells);
+    if(index->cells == NULL) return false;
+
+    index->area = *area;
+    index->cols = (uint16_t)cols;
+    index->rows = (uint16_t)rows;
+    index->cell_w = (w + cols - 1) / cols;
+    index->cell_h = (h + rows - 1) / rows;
+    return true;
+}
+
+static void delete_grid(_lv_draw_task_index_t * index)
+{
+    if(index->cells == NULL) return;
+
+    uint32_t i;
+    for(i = 0; i < (uint32_t)index->cols * index->rows; i++) {
+        lv_free(index->cells[i].tasks);
+    }
+    lv_free(index->cells);
+    index->cells = NULL;
+}
+
+/**
+ * Get the cells an area touches. The parts out of the grid belong to the cells on its edges.
+ */
+static void get_cell_range(const _lv_draw_task_index_t * index, const lv_area_t * a, int32_t * x1, int32_t * y1,
+                           int32_t * x2, int32_t * y2)
+{
+    *x1 = LV_CLAMP(0, (a->x1 - index->area.x1) / index->cell_w, index->cols - 1);
+    *y1 = LV_CLAMP(0, (a->y1 - index->area.y1) / index->cell_h, index->rows - 1);
+    *x2 = LV_CLAMP(*x1, (a->x2 - index->area.x1) / index->cell_w, index->cols - 1);
+    *y2 = LV_CLAMP(*y1, (a->y2 - index->area.y1) / index->cell_h, index->rows - 1);
+}
+
+/**
+ * Insert a task keeping the list ordered by `_seq`.
+ * New tasks are added to the end, only a moved task might go before some others.
+ */
+static bool cell_insert(_lv_draw_task_index_cell_t * cell, lv_draw_task_t * t)
+{
+    if(cell->cnt == cell->size) {
+        uint32_t new_size = cell->size ? cell->size * 2 : CELL_SIZE_MIN;
+        if(new_size > UINT16_MAX) return false;
+        lv_draw_task_t ** new_tasks = lv_realloc(cell->tasks, new_size * sizeof(lv_draw_task_t *));
+        LV_ASSERT_MALLOC(new_tasks);
+        if(new_tasks == NULL) return false;
+        cell->tasks = new_tasks;
+        cell->size = (uint16_t)new_size;
+    }
+
+    uint32_t i = cell->cnt;
+    while(i > 0 && cell->tasks[i - 1]->_seq > t->_seq) {
+        cell->tasks[i] = cell->tasks[i - 1];
+        i--;
+    }
+    cell->tasks[i] = t;
+    cell->cnt++;
+    return true;
+}
+
+static void cell_remove(_lv_draw_task_index_cell_t * cell, lv_draw_task_t * t)
+{
+    /*Usually the oldest tasks are ready first, so search from the beginning*/
+    uint32_t i;
+    for(i = 0; i < cell->cnt; i++) {
+        if(cell->tasks[i] == t) {
+            lv_memmove(&cell->tasks[i], &cell->tasks[i + 1], (cell->cnt - i - 1) * sizeof(lv_draw_task_t *));
+            cell->cnt--;
+            return;
+        }
+    }
+}
+
+static void remove_from_cells(_lv_draw_task_index_t * index, lv_draw_task_t * t)
+{
+    if(index->cells == NULL) return;
+
+    int32_t x, y;
+    for(y = t->_cell_y1; y <= t->_cell_y2; y++) {
+        _lv_draw_task_index_cell_t * cell = &index->cells[y * index->cols];
+        for(x = t->_cell_x1; x <= t->_cell_x2; x++) {
+            cell_remove(&cell[x], t);
+        }
+    }
+}
+
+#endif /*LV_DRAW_TASK_INDEX_CELLS*/
@@ -0,0 +1,102 @@
+/**
+ * @file lv_draw_task_index.h
+ * Index of the pending draw tasks of a layer by area.
+ * The layer's buffer area is split to a grid of cells and every cell lists the draw tasks
+ * touching it, oldest first. So finding the older tasks a task overlaps (or the newer tasks
+ * overlapping it) needs to check only the tasks in its cells, not all the tasks of the layer.
+ */
+
+#ifndef LV_DRAW_TASK_INDEX_H
+#define LV_DRAW_TASK_INDEX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_conf_internal.h"
+#include "../misc/lv_types.h"
+#include "../misc/lv_area.h"
+
+#if LV_DRAW_TASK_INDEX_CELLS
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct {
+    lv_draw_task_t ** tasks;    /**< The tasks touching the cell, by increasing `_seq`*/
+    uint16_t cnt;
+    uint16_t size;
+} _lv_draw_task_index_cell_t;
+
+typedef struct {
+    _lv_draw_task_index_cell_t * cells;     /**< `cols * rows` cells, NULL if there are no tasks*/
+    lv_area_t area;             /**< Area covered by the cells: the layer's `buf_area` when the first task was added*/
+    int32_t cell_w;
+    int32_t cell_h;
+    uint16_t cols;
+    uint16_t rows;
+    uint32_t task_cnt;          /**< Number of tasks added and not removed yet*/
+    bool failed;                /**< Out of memory: some tasks are missing from the cells until the layer is empty*/
+} _lv_draw_task_index_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Add a draw task to the index of its layer, or move it if its area has changed since it was added.
+ * The grid is created for the layer's `buf_area` with the first task.
+ * @param layer     the layer of the task
+ * @param t         the draw task, `_seq` already set
+ */
+void _lv_draw_task_index_add(lv_layer_t * layer, lv_draw_task_t * t);
+
+/**
+ * Remove a draw task from the index of its layer. The grid is freed with the last task.
+ * @param layer     the layer of the task
+ * @param t         the draw task
+ */
+void _lv_draw_task_index_remove(lv_layer_t * layer, lv_draw_task_t * t);
+
+/**
+ * Check if the index has all the tasks of the layer, i.e. it can answer the queries below.
+ * @param layer     pointer to a layer
+ * @return          true: the index can be used; false: check the list of tasks instead
+ */
+bool _lv_draw_task_index_is_usable(lv_layer_t * layer);
+
+/**
+ * Check if an older, not ready task overlaps the real area of `t_check`
+ * @param layer     the layer of the task
+ * @param t_check   the task to check
+ * @return          true: `t_check` depends on an older task
+ */
+bool _lv_draw_task_index_overlaps_older(lv_layer_t * layer, lv_draw_task_t * t_check);
+
+/**
+ * Count the newer queued or waiting tasks whose area is on the area of `t_check`
+ * @param layer     the layer of the task
+ * @param t_check   the task whose dependent tasks shall be counted
+ * @return          number of tasks depending on `t_check`
+ */
+uint32_t _lv_draw_task_index_get_dependent_count(lv_layer_t * layer, lv_draw_task_t * t_check);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_DRAW_TASK_INDEX_CELLS*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_DRAW_TASK_INDEX_H*/
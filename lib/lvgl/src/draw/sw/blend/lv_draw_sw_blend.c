@@ -8,8 +8,10 @@
  *********************/
 #include "../lv_draw_sw.h"
 #include "lv_draw_sw_blend_to_rgb565.h"
+#include "lv_draw_sw_blend_to_rgb565_swapped.h"
 #include "lv_draw_sw_blend_to_argb8888.h"
 #include "lv_draw_sw_blend_to_rgb888.h"
+#include "../../../others/refr_heatmap/lv_refr_heatmap.h"
 
 #if LV_USE_DRAW_SW
 
@@ -70,10 +72,17 @@ void lv_draw_sw_blend(lv_draw_unit_t * draw_unit, const lv_draw_sw_blend_dsc_t *
                                  (blend_area.x1 - blend_dsc->mask_area->x1);
         }
 
+#if LV_USE_REFR_HEATMAP
+        _lv_refr_heatmap_add_blend(&blend_area, fill_dsc.mask_buf, fill_dsc.mask_buf ? fill_dsc.mask_stride : 0);
+#endif
+
         switch(layer->color_format) {
             case LV_COLOR_FORMAT_RGB565:
                 lv_draw_sw_blend_color_to_rgb565(&fill_dsc);
                 break;
+            case LV_COLOR_FORMAT_RGB565_SWAPPED:
+                lv_draw_sw_blend_color_to_rgb565_swapped(&fill_dsc);
+                break;
             case LV_COLOR_FORMAT_ARGB8888:
                 lv_draw_sw_blend_color_to_argb8888(&fill_dsc);
                 break;
@@ -128,11 +137,18 @@ void lv_draw_sw_blend(lv_draw_unit_t * draw_unit, const lv_draw_sw_blend_dsc_t *
         image_dsc.dest_buf = lv_draw_layer_go_to_xy(layer, blend_area.x1 - layer->buf_area.x1,
                                                     blend_area.y1 - layer->buf_area.y1);
 
+#if LV_USE_REFR_HEATMAP
+        _lv_refr_heatmap_add_blend(&blend_area, image_dsc.mask_buf, image_dsc.mask_buf ? image_dsc.mask_stride : 0);
+#endif
+
         switch(layer->color_format) {
             case LV_COLOR_FORMAT_RGB565:
             case LV_COLOR_FORMAT_RGB565A8:
                 lv_draw_sw_blend_image_to_rgb565(&image_dsc);
                 break;
+            case LV_COLOR_FORMAT_RGB565_SWAPPED:
+                lv_draw_sw_blend_image_to_rgb565_swapped(&image_dsc);
+                break;
             case LV_COLOR_FORMAT_ARGB8888:
                 lv_draw_sw_blend_image_to_argb8888(&image_dsc);
                 break;
@@ -0,0 +1,425 @@
+/**
+ * @file lv_draw_sw_blend_to_rgb565_swapped.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw_sw_blend_to_rgb565_swapped.h"
+#if LV_USE_DRAW_SW
+
+#include "lv_draw_sw_blend.h"
+#include "../../../misc/lv_math.h"
+#include "../../../display/lv_display.h"
+#include "../../../core/lv_refr.h"
+#include "../../../misc/lv_color.h"
+#include "../../../stdlib/lv_string.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static void /* LV_ATTRIBUTE_FAST_MEM */ rgb565_image_blend(_lv_draw_sw_blend_image_dsc_t * dsc);
+
+static void /* LV_ATTRIBUTE_FAST_MEM */ rgb888_image_blend(_lv_draw_sw_blend_image_dsc_t * dsc,
+                                                           const uint8_t src_px_size);
+
+static void /* LV_ATTRIBUTE_FAST_MEM */ argb8888_image_blend(_lv_draw_sw_blend_image_dsc_t * dsc);
+
+static void /* LV_ATTRIBUTE_FAST_MEM */ other_mode_image_blend(_lv_draw_sw_blend_image_dsc_t * dsc);
+
+static inline uint16_t /* LV_ATTRIBUTE_FAST_MEM */ swap16(uint16_t c);
+
+static inline uint16_t /* LV_ATTRIBUTE_FAST_MEM */ mix_to_swapped(uint16_t c, uint16_t dest_swapped, uint8_t mix);
+
+static inline uint16_t /* LV_ATTRIBUTE_FAST_MEM */ mix_24_to_swapped(const uint8_t * c1, uint16_t dest_swapped,
+                                                                      uint8_t mix);
+
+static inline uint16_t /* LV_ATTRIBUTE_FAST_MEM */ rgb888_to_u16(const uint8_t * c);
+
+static inline void * /* LV_ATTRIBUTE_FAST_MEM */ drawbuf_next_row(const void * buf, uint32_t stride);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Fill an area with a color in LV_COLOR_FORMAT_RGB565_SWAPPED (RGB565 with the high byte first).
+ * A full cover fill is as fast as with RGB565: the color is swapped once.
+ * Blending swaps the background pixel, mixes, and swaps the result back.
+ * @param dsc   the fill descriptor
+ */
+void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_color_to_rgb565_swapped(_lv_draw_sw_blend_fill_dsc_t * dsc)
+{
+    int32_t w = dsc->dest_w;
+    int32_t h = dsc->dest_h;
+    uint16_t color16 = lv_color_to_u16(dsc->color);
+    uint16_t color16_swapped = swap16(color16);
+    lv_opa_t opa = dsc->opa;
+    const lv_opa_t * mask = dsc->mask_buf;
+    int32_t mask_stride = dsc->mask_stride;
+    uint16_t * dest_buf_u16 = dsc->dest_buf;
+    int32_t dest_stride = dsc->dest_stride;
+
+    int32_t x;
+    int32_t y;
+
+    /*Simple fill*/
+    if(mask == NULL && opa >= LV_OPA_MAX)  {
+        uint32_t c32 = (uint32_t)color16_swapped + ((uint32_t)color16_swapped << 16);
+        for(y = 0; y < h; y++) {
+            x = 0;
+            if((lv_uintptr_t)&dest_buf_u16[0] & 0x3) {
+                dest_buf_u16[0] = color16_swapped;
+                x = 1;
+            }
+
+            uint32_t * dest32 = (uint32_t *)&dest_buf_u16[x];
+            for(; x < w - 7; x += 8) {
+                dest32[0] = c32;
+                dest32[1] = c32;
+                dest32[2] = c32;
+                dest32[3] = c32;
+                dest32 += 4;
+            }
+
+            for(; x < w; x++) {
+                dest_buf_u16[x] = color16_swapped;
+            }
+
+            dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
+        }
+    }
+    /*Opacity only*/
+    else if(mask == NULL && opa < LV_OPA_MAX) {
+        /*Backgrounds are mostly uniform, reuse the last result*/
+        uint16_t last_dest = dest_buf_u16[0] + 1; /*Set to value which is not equal to the first pixel*/
+        uint16_t last_res = 0;
+        for(y = 0; y < h; y++) {
+            for(x = 0; x < w; x++) {
+                if(dest_buf_u16[x] != last_dest) {
+                    last_dest = dest_buf_u16[x];
+                    last_res = mix_to_swapped(color16, last_dest, opa);
+                }
+                dest_buf_u16[x] = last_res;
+            }
+            dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
+        }
+    }
+    /*Masked with full opacity*/
+    else if(mask && opa >= LV_OPA_MAX) {
+        for(y = 0; y < h; y++) {
+            x = 0;
+            if((lv_uintptr_t)(mask) & 0x1) {
+                dest_buf_u16[x] = mix_to_swapped(color16, dest_buf_u16[x], mask[x]);
+                x++;
+            }
+
+            /*Glyphs and rounded corners: mostly fully covered or empty pairs*/
+            for(; x <= w - 2; x += 2) {
+                uint16_t mask16 = *((uint16_t *)&mask[x]);
+                if(mask16 == 0xFFFF) {
+                    dest_buf_u16[x + 0] = color16_swapped;
+                    dest_buf_u16[x + 1] = color16_swapped;
+                }
+                else if(mask16 != 0) {
+                    dest_buf_u16[x + 0] = mix_to_swapped(color16, dest_buf_u16[x + 0], mask[x + 0]);
+                    dest_buf_u16[x + 1] = mix_to_swapped(color16, dest_buf_u16[x + 1], mask[x + 1]);
+                }
+            }
+
+            for(; x < w ; x++) {
+                dest_buf_u16[x] = mix_to_swapped(color16, dest_buf_u16[x], mask[x]);
+            }
+            dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
+            mask += mask_stride;
+        }
+    }
+    /*Masked with opacity*/
+    else {
+        for(y = 0; y < h; y++) {
+            for(x = 0; x < w; x++) {
+                dest_buf_u16[x] = mix_to_swapped(color16, dest_buf_u16[x], LV_OPA_MIX2(mask[x], opa));
+            }
+            dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
+            mask += mask_stride;
+        }
+    }
+}
+
+void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_image_to_rgb565_swapped(_lv_draw_sw_blend_image_dsc_t * dsc)
+{
+    if(dsc->blend_mode != LV_BLEND_MODE_NORMAL) {
+        other_mode_image_blend(dsc);
+        return;
+    }
+
+    switch(dsc->src_color_format) {
+        case LV_COLOR_FORMAT_RGB565:
+            rgb565_image_blend(dsc);
+            break;
+        case LV_COLOR_FORMAT_RGB888:
+            rgb888_image_blend(dsc, 3);
+            break;
+        case LV_COLOR_FORMAT_XRGB8888:
+            rgb888_image_blend(dsc, 4);
+            break;
+        case LV_COLOR_FORMAT_ARGB8888:
+            argb8888_image_blend(dsc);
+            break;
+        default:
+            LV_LOG_WARN("Not supported source color format");
+            break;
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/*Layers are rendered in RGB565, only the display buffer is swapped*/
+static void LV_ATTRIBUTE_FAST_MEM rgb565_image_blend(_lv_draw_sw_blend_image_dsc_t * dsc)
+{
+    int32_t w = dsc->dest_w;
+    int32_t h = dsc->dest_h;
+    lv_opa_t opa = dsc->opa;
+    uint16_t * dest_buf_u16 = dsc->dest_buf;
+    int32_t dest_stride = dsc->dest_stride;
+    const uint16_t * src_buf_u16 = dsc->src_buf;
+    int32_t src_stride = dsc->src_stride;
+    const lv_opa_t * mask_buf = dsc->mask_buf;
+    int32_t mask_stride = dsc->mask_stride;
+
+    int32_t x;
+    int32_t y;
+
+    for(y = 0; y < h; y++) {
+        if(mask_buf == NULL && opa >= LV_OPA_MAX) {
+            for(x = 0; x < w; x++) dest_buf_u16[x] = swap16(src_buf_u16[x]);
+        }
+        else if(mask_buf == NULL) {
+            for(x = 0; x < w; x++) dest_buf_u16[x] = mix_to_swapped(src_buf_u16[x], dest_buf_u16[x], opa);
+        }
+        else if(opa >= LV_OPA_MAX) {
+            for(x = 0; x < w; x++) dest_buf_u16[x] = mix_to_swapped(src_buf_u16[x], dest_buf_u16[x], mask_buf[x]);
+        }
+        else {
+            for(x = 0; x < w; x++) {
+                dest_buf_u16[x] = mix_to_swapped(src_buf_u16[x], dest_buf_u16[x], LV_OPA_MIX2(mask_buf[x], opa));
+            }
+        }
+        dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
+        src_buf_u16 = drawbuf_next_row(src_buf_u16, src_stride);
+        if(mask_buf) mask_buf += mask_stride;
+    }
+}
+
+static void LV_ATTRIBUTE_FAST_MEM rgb888_image_blend(_lv_draw_sw_blend_image_dsc_t * dsc, const uint8_t src_px_size)
+{
+    int32_t w = dsc->dest_w;
+    int32_t h = dsc->dest_h;
+    lv_opa_t opa = dsc->opa;
+    uint16_t * dest_buf_u16 = dsc->dest_buf;
+    int32_t dest_stride = dsc->dest_stride;
+    const uint8_t * src_buf_u8 = dsc->src_buf;
+    int32_t src_stride = dsc->src_stride;
+    const lv_opa_t * mask_buf = dsc->mask_buf;
+    int32_t mask_stride = dsc->mask_stride;
+
+    int32_t dest_x;
+    int32_t src_x;
+    int32_t y;
+
+    for(y = 0; y < h; y++) {
+        for(dest_x = 0, src_x = 0; dest_x < w; dest_x++, src_x += src_px_size) {
+            lv_opa_t mix;
+            if(mask_buf == NULL) mix = opa >= LV_OPA_MAX ? LV_OPA_COVER : opa;
+            else if(opa >= LV_OPA_MAX) mix = mask_buf[dest_x];
+            else mix = LV_OPA_MIX2(mask_buf[dest_x], opa);
+
+            dest_buf_u16[dest_x] = mix_24_to_swapped(&src_buf_u8[src_x], dest_buf_u16[dest_x], mix);
+        }
+        dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
+        src_buf_u8 += src_stride;
+        if(mask_buf) mask_buf += mask_stride;
+    }
+}
+
+static void LV_ATTRIBUTE_FAST_MEM argb8888_image_blend(_lv_draw_sw_blend_image_dsc_t * dsc)
+{
+    int32_t w = dsc->dest_w;
+    int32_t h = dsc->dest_h;
+    lv_opa_t opa = dsc->opa;
+    uint16_t * dest_buf_u16 = dsc->dest_buf;
+    int32_t dest_stride = dsc->dest_stride;
+    const uint8_t * src_buf_u8 = dsc->src_buf;
+    int32_t src_stride = dsc->src_stride;
+    const lv_opa_t * mask_buf = dsc->mask_buf;
+    int32_t mask_stride = dsc->mask_stride;
+
+    int32_t dest_x;
+    int32_t src_x;
+    int32_t y;
+
+    for(y = 0; y < h; y++) {
+        for(dest_x = 0, src_x = 0; dest_x < w; dest_x++, src_x += 4) {
+            lv_opa_t mix = src_buf_u8[src_x + 3];
+            if(mask_buf == NULL) {
+                if(opa < LV_OPA_MAX) mix = LV_OPA_MIX2(mix, opa);
+            }
+            else {
+                if(opa >= LV_OPA_MAX) mix = LV_OPA_MIX2(mix, mask_buf[dest_x]);
+                else mix = LV_OPA_MIX3(mix, mask_buf[dest_x], opa);
+            }
+
+            dest_buf_u16[dest_x] = mix_24_to_swapped(&src_buf_u8[src_x], dest_buf_u16[dest_x], mix);
+        }
+        dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
+        src_buf_u8 += src_stride;
+        if(mask_buf) mask_buf += mask_stride;
+    }
+}
+
+/*Additive, subtractive and multiply blending of any source format, on the unswapped background*/
+static void LV_ATTRIBUTE_FAST_MEM other_mode_image_blend(_lv_draw_sw_blend_image_dsc_t * dsc)
+{
+    int32_t w = dsc->dest_w;
+    int32_t h = dsc->dest_h;
+    lv_opa_t opa = dsc->opa;
+    uint16_t * dest_buf_u16 = dsc->dest_buf;
+    int32_t dest_stride = dsc->dest_stride;
+    const uint8_t * src_buf_u8 = dsc->src_buf;
+    int32_t src_stride = dsc->src_stride;
+    const lv_opa_t * mask_buf = dsc->mask_buf;
+    int32_t mask_stride = dsc->mask_stride;
+
+    uint32_t src_px_size;
+    switch(dsc->src_color_format) {
+        case LV_COLOR_FORMAT_RGB565:
+            src_px_size = 2;
+            break;
+        case LV_COLOR_FORMAT_RGB888:
+            src_px_size = 3;
+            break;
+        case LV_COLOR_FORMAT_XRGB8888:
+        case LV_COLOR_FORMAT_ARGB8888:
+            src_px_size = 4;
+            break;
+        default:
+            LV_LOG_WARN("Not supported source color format");
+            return;
+    }
+
+    int32_t dest_x;
+    int32_t src_x;
+    int32_t y;
+
+    for(y = 0; y < h; y++) {
+        for(dest_x = 0, src_x = 0; dest_x < w; dest_x++, src_x += src_px_size) {
+            uint16_t src16;
+            lv_opa_t mix = opa;
+            if(src_px_size == 2) {
+                src16 = *(const uint16_t *)&src_buf_u8[src_x];
+            }
+            else {
+                src16 = rgb888_to_u16(&src_buf_u8[src_x]);
+                if(dsc->src_color_format == LV_COLOR_FORMAT_ARGB8888) mix = LV_OPA_MIX2(mix, src_buf_u8[src_x + 3]);
+            }
+            if(mask_buf) mix = LV_OPA_MIX2(mix, mask_buf[dest_x]);
+
+            uint16_t dest16 = swap16(dest_buf_u16[dest_x]);
+            lv_color16_t * src_c16 = (lv_color16_t *)&src16;
+            lv_color16_t * dest_c16 = (lv_color16_t *)&dest16;
+            uint16_t res;
+            switch(dsc->blend_mode) {
+                case LV_BLEND_MODE_ADDITIVE:
+                    if(src16 == 0x0000) continue;   /*Do not add pure black*/
+                    res = (LV_MIN(dest_c16->red + src_c16->red, 31)) << 11;
+                    res += (LV_MIN(dest_c16->green + src_c16->green, 63)) << 5;
+                    res += LV_MIN(dest_c16->blue + src_c16->blue, 31);
+                    break;
+                case LV_BLEND_MODE_SUBTRACTIVE:
+                    if(src16 == 0x0000) continue;   /*Do not subtract pure black*/
+                    res = (LV_MAX(dest_c16->red - src_c16->red, 0)) << 11;
+                    res += (LV_MAX(dest_c16->green - src_c16->green, 0)) << 5;
+                    res += LV_MAX(dest_c16->blue - src_c16->blue, 0);
+                    break;
+                case LV_BLEND_MODE_MULTIPLY:
+                    if(src16 == 0xffff) continue;   /*Do not multiply with pure white (considered as 1)*/
+                    res = ((dest_c16->red * src_c16->red) >> 5) << 11;
+                    res += ((dest_c16->green * src_c16->green) >> 6) << 5;
+                    res += (dest_c16->blue * src_c16->blue) >> 5;
+                    break;
+                default:
+                    LV_LOG_WARN("Not supported blend mode: %d", dsc->blend_mode);
+                    return;
+            }
+
+            dest_buf_u16[dest_x] = swap16(lv_color_16_16_mix(res, dest16, mix));
+        }
+        dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
+        src_buf_u8 += src_stride;
+        if(mask_buf) mask_buf += mask_stride;
+    }
+}
+
+static inline uint16_t LV_ATTRIBUTE_FAST_MEM swap16(uint16_t c)
+{
+    return (uint16_t)((c >> 8) | (c << 8));
+}
+
+/**
+ * Mix a native RGB565 color onto a swapped background pixel
+ * @param c             the color in RGB565
+ * @param dest_swapped  the background pixel in RGB565_SWAPPED
+ * @param mix           the opacity of `c`
+ * @return              the result in RGB565_SWAPPED
+ */
+static inline uint16_t LV_ATTRIBUTE_FAST_MEM mix_to_swapped(uint16_t c, uint16_t dest_swapped, uint8_t mix)
+{
+    if(mix == LV_OPA_COVER) return swap16(c);
+    if(mix == LV_OPA_TRANSP) return dest_swapped;
+    return swap16(lv_color_16_16_mix(c, swap16(dest_swapped), mix));
+}
+
+/*The same rounding as lv_color_24_16_mix() in lv_draw_sw_blend_to_rgb565.c*/
+static inline uint16_t LV_ATTRIBUTE_FAST_MEM mix_24_to_swapped(const uint8_t * c1, uint16_t dest_swapped, uint8_t mix)
+{
+    if(mix == LV_OPA_TRANSP) return dest_swapped;
+    if(mix == LV_OPA_COVER) return swap16(rgb888_to_u16(c1));
+
+    uint16_t c2 = swap16(dest_swapped);
+    lv_opa_t mix_inv = 255 - mix;
+    return swap16(((((c1[2] >> 3) * mix + ((c2 >> 11) & 0x1F) * mix_inv) << 3) & 0xF800) +
+                  ((((c1[1] >> 2) * mix + ((c2 >> 5) & 0x3F) * mix_inv) >> 3) & 0x07E0) +
+                  (((c1[0] >> 3) * mix + (c2 & 0x1F) * mix_inv) >> 8));
+}
+
+static inline uint16_t LV_ATTRIBUTE_FAST_MEM rgb888_to_u16(const uint8_t * c)
+{
+    return ((c[2] & 0xF8) << 8) + ((c[1] & 0xFC) << 3) + ((c[0] & 0xF8) >> 3);
+}
+
+static inline void * LV_ATTRIBUTE_FAST_MEM drawbuf_next_row(const void * buf, uint32_t stride)
+{
+    return (void *)((uint8_t *)buf + stride);
+}
+
+#endif
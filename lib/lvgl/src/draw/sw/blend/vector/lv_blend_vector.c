@@ -0,0 +1,293 @@
+/**
+ * @file lv_blend_vector.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_blend_vector.h"
+#if LV_USE_DRAW_SW && LV_BLEND_VECTOR_SUPPORTED
+
+#include "../../../../misc/lv_color.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define VEC_PX      8
+
+/*Narrower areas are left to C: with at most one vector step per row
+ *the setup and the pixel by pixel tail cost more than they save*/
+#define MIN_W       (2 * VEC_PX)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef uint16_t vec_u16_t __attribute__((vector_size(VEC_PX * sizeof(uint16_t))));
+typedef int16_t vec_i16_t __attribute__((vector_size(VEC_PX * sizeof(int16_t))));
+typedef uint8_t vec_u8_t __attribute__((vector_size(VEC_PX)));
+
+/*Which hook is blending: where the mix ratio comes from*/
+typedef enum {
+    MIX_OPA,
+    MIX_MASK,
+    MIX_MASK_OPA,
+} mix_src_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void fill_mix(_lv_draw_sw_blend_fill_dsc_t * dsc, mix_src_t src);
+static void rgb565_image_mix(_lv_draw_sw_blend_image_dsc_t * dsc, mix_src_t src);
+static inline void fill_px(uint16_t * dest, const lv_opa_t * mask, vec_u16_t color, vec_u16_t opa, mix_src_t src);
+static inline void rgb565_px(uint16_t * dest, const uint16_t * src_px, const lv_opa_t * mask, vec_u16_t opa,
+                             mix_src_t src);
+static inline vec_u16_t get_mix(const lv_opa_t * mask, vec_u16_t opa, mix_src_t src);
+static inline lv_opa_t get_mix_px(const lv_opa_t * mask, int32_t x, lv_opa_t opa, mix_src_t src);
+static inline vec_u16_t mix_16_16(vec_u16_t fg, vec_u16_t bg, vec_u16_t mix);
+static inline vec_u16_t load_u16(const uint16_t * p);
+static inline void store_u16(uint16_t * p, vec_u16_t v);
+static inline vec_u16_t load_mask(const lv_opa_t * mask);
+static inline void * drawbuf_next_row(const void * buf, uint32_t stride);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+lv_result_t _lv_color_blend_to_rgb565_vector(_lv_draw_sw_blend_fill_dsc_t * dsc)
+{
+    if(dsc->dest_w < MIN_W) return LV_RESULT_INVALID;
+
+    int32_t w = dsc->dest_w;
+    int32_t h = dsc->dest_h;
+    uint16_t color16 = lv_color_to_u16(dsc->color);
+    vec_u16_t color = {0};
+    color += color16;
+    uint16_t * dest_buf_u16 = dsc->dest_buf;
+
+    int32_t y;
+    for(y = 0; y < h; y++) {
+        int32_t x;
+        /*Several stores per step, or it is slower than the loop of C the compiler vectorizes*/
+        for(x = 0; x <= w - 4 * VEC_PX; x += 4 * VEC_PX) {
+            store_u16(&dest_buf_u16[x], color);
+            store_u16(&dest_buf_u16[x + VEC_PX], color);
+            store_u16(&dest_buf_u16[x + 2 * VEC_PX], color);
+            store_u16(&dest_buf_u16[x + 3 * VEC_PX], color);
+        }
+        for(; x <= w - VEC_PX; x += VEC_PX) {
+            store_u16(&dest_buf_u16[x], color);
+        }
+        for(; x < w; x++) {
+            dest_buf_u16[x] = color16;
+        }
+        dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dsc->dest_stride);
+    }
+    return LV_RESULT_OK;
+}
+
+lv_result_t _lv_color_blend_to_rgb565_with_opa_vector(_lv_draw_sw_blend_fill_dsc_t * dsc)
+{
+    if(dsc->dest_w < MIN_W) return LV_RESULT_INVALID;
+    fill_mix(dsc, MIX_OPA);
+    return LV_RESULT_OK;
+}
+
+lv_result_t _lv_color_blend_to_rgb565_with_mask_vector(_lv_draw_sw_blend_fill_dsc_t * dsc)
+{
+    if(dsc->dest_w < MIN_W) return LV_RESULT_INVALID;
+    fill_mix(dsc, MIX_MASK);
+    return LV_RESULT_OK;
+}
+
+lv_result_t _lv_color_blend_to_rgb565_mix_mask_opa_vector(_lv_draw_sw_blend_fill_dsc_t * dsc)
+{
+    if(dsc->dest_w < MIN_W) return LV_RESULT_INVALID;
+    fill_mix(dsc, MIX_MASK_OPA);
+    return LV_RESULT_OK;
+}
+
+lv_result_t _lv_rgb565_blend_normal_to_rgb565_with_opa_vector(_lv_draw_sw_blend_image_dsc_t * dsc)
+{
+    if(dsc->dest_w < MIN_W) return LV_RESULT_INVALID;
+    rgb565_image_mix(dsc, MIX_OPA);
+    return LV_RESULT_OK;
+}
+
+lv_result_t _lv_rgb565_blend_normal_to_rgb565_with_mask_vector(_lv_draw_sw_blend_image_dsc_t * dsc)
+{
+    if(dsc->dest_w < MIN_W) return LV_RESULT_INVALID;
+    rgb565_image_mix(dsc, MIX_MASK);
+    return LV_RESULT_OK;
+}
+
+lv_result_t _lv_rgb565_blend_normal_to_rgb565_mix_mask_opa_vector(_lv_draw_sw_blend_image_dsc_t * dsc)
+{
+    if(dsc->dest_w < MIN_W) return LV_RESULT_INVALID;
+    rgb565_image_mix(dsc, MIX_MASK_OPA);
+    return LV_RESULT_OK;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void fill_mix(_lv_draw_sw_blend_fill_dsc_t * dsc, mix_src_t src)
+{
+    int32_t w = dsc->dest_w;
+    int32_t h = dsc->dest_h;
+    uint16_t color16 = lv_color_to_u16(dsc->color);
+    vec_u16_t color = {0};
+    vec_u16_t opa = {0};
+    color += color16;
+    opa += dsc->opa;
+    uint16_t * dest_buf_u16 = dsc->dest_buf;
+    const lv_opa_t * mask_buf = dsc->mask_buf;
+
+    int32_t y;
+    for(y = 0; y < h; y++) {
+        int32_t x;
+        for(x = 0; x <= w - VEC_PX; x += VEC_PX) {
+            fill_px(&dest_buf_u16[x], mask_buf ? &mask_buf[x] : NULL, color, opa, src);
+        }
+        /*The last pixels one by one: the same results, and cheaper than a partial vector*/
+        for(; x < w; x++) {
+            dest_buf_u16[x] = lv_color_16_16_mix(color16, dest_buf_u16[x], get_mix_px(mask_buf, x, dsc->opa, src));
+        }
+        dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dsc->dest_stride);
+        if(mask_buf) mask_buf += dsc->mask_stride;
+    }
+}
+
+static void rgb565_image_mix(_lv_draw_sw_blend_image_dsc_t * dsc, mix_src_t src)
+{
+    int32_t w = dsc->dest_w;
+    int32_t h = dsc->dest_h;
+    vec_u16_t opa = {0};
+    opa += dsc->opa;
+    uint16_t * dest_buf_u16 = dsc->dest_buf;
+    const uint16_t * src_buf_u16 = dsc->src_buf;
+    const lv_opa_t * mask_buf = dsc->mask_buf;
+
+    int32_t y;
+    for(y = 0; y < h; y++) {
+        int32_t x;
+        for(x = 0; x <= w - VEC_PX; x += VEC_PX) {
+            rgb565_px(&dest_buf_u16[x], &src_buf_u16[x], mask_buf ? &mask_buf[x] : NULL, opa, src);
+        }
+        for(; x < w; x++) {
+            dest_buf_u16[x] = lv_color_16_16_mix(src_buf_u16[x], dest_buf_u16[x],
+                                                 get_mix_px(mask_buf, x, dsc->opa, src));
+        }
+        dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dsc->dest_stride);
+        src_buf_u16 = drawbuf_next_row(src_buf_u16, dsc->src_stride);
+        if(mask_buf) mask_buf += dsc->mask_stride;
+    }
+}
+
+static inline void fill_px(uint16_t * dest, const lv_opa_t * mask, vec_u16_t color, vec_u16_t opa, mix_src_t src)
+{
+    store_u16(dest, mix_16_16(color, load_u16(dest), get_mix(mask, opa, src)));
+}
+
+static inline void rgb565_px(uint16_t * dest, const uint16_t * src_px, const lv_opa_t * mask, vec_u16_t opa,
+                             mix_src_t src)
+{
+    store_u16(dest, mix_16_16(load_u16(src_px), load_u16(dest), get_mix(mask, opa, src)));
+}
+
+/**
+ * The mix ratio of `VEC_PX` pixels, without branching on the mask: a 0 or 255 mask
+ * costs the same as any other.
+ */
+static inline vec_u16_t get_mix(const lv_opa_t * mask, vec_u16_t opa, mix_src_t src)
+{
+    switch(src) {
+        case MIX_MASK:
+            return load_mask(mask);
+        case MIX_MASK_OPA:
+            /*LV_OPA_MIX2(), the product fits in 16 bits*/
+            return (load_mask(mask) * opa) >> 8;
+        default:
+            return opa;
+    }
+}
+
+/**
+ * The mix ratio of the pixel at `x`, for the pixels after the last full vector.
+ */
+static inline lv_opa_t get_mix_px(const lv_opa_t * mask, int32_t x, lv_opa_t opa, mix_src_t src)
+{
+    switch(src) {
+        case MIX_MASK:
+            return mask[x];
+        case MIX_MASK_OPA:
+            return LV_OPA_MIX2(mask[x], opa);
+        default:
+            return opa;
+    }
+}
+
+/**
+ * `lv_color_16_16_mix()`: bg + (fg - bg) * ((mix + 4) >> 3) / 32 per channel, rounded down.
+ * mix == 255 gives `fg` and mix < 4 gives `bg`, like the special cases of the C version.
+ */
+static inline vec_u16_t mix_16_16(vec_u16_t fg, vec_u16_t bg, vec_u16_t mix)
+{
+    vec_i16_t m = (vec_i16_t)((mix + 4) >> 3);
+
+    vec_i16_t fg_b = (vec_i16_t)(fg & 0x1F);
+    vec_i16_t bg_b = (vec_i16_t)(bg & 0x1F);
+    vec_i16_t fg_g = (vec_i16_t)((fg >> 5) & 0x3F);
+    vec_i16_t bg_g = (vec_i16_t)((bg >> 5) & 0x3F);
+    vec_i16_t fg_r = (vec_i16_t)(fg >> 11);
+    vec_i16_t bg_r = (vec_i16_t)(bg >> 11);
+
+    /*Signed, so >> rounds down*/
+    vec_u16_t b = (vec_u16_t)(bg_b + (((fg_b - bg_b) * m) >> 5));
+    vec_u16_t g = (vec_u16_t)(bg_g + (((fg_g - bg_g) * m) >> 5));
+    vec_u16_t r = (vec_u16_t)(bg_r + (((fg_r - bg_r) * m) >> 5));
+
+    return (r << 11) | (g << 5) | b;
+}
+
+static inline vec_u16_t load_u16(const uint16_t * p)
+{
+    vec_u16_t v;
+    __builtin_memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void store_u16(uint16_t * p, vec_u16_t v)
+{
+    __builtin_memcpy(p, &v, sizeof(v));
+}
+
+static inline vec_u16_t load_mask(const lv_opa_t * mask)
+{
+#if defined(__clang__) || __GNUC__ >= 9
+    vec_u8_t m;
+    __builtin_memcpy(&m, mask, sizeof(m));
+    return __builtin_convertvector(m, vec_u16_t);
+#else
+    vec_u16_t m;
+    int32_t i;
+    for(i = 0; i < VEC_PX; i++) m[i] = mask[i];
+    return m;
+#endif
+}
+
+static inline void * drawbuf_next_row(const void * buf, uint32_t stride)
+{
+    return (void *)((uint8_t *)buf + stride);
+}
+
+#endif /*LV_USE_DRAW_SW && LV_BLEND_VECTOR_SUPPORTED*/
@@ -0,0 +1,96 @@
+/**
+ * @file lv_blend_vector.h
+ * RGB565 fills and image blends written with GCC/Clang vector extensions, 8 pixels (128 bit) per step.
+ * The compiler maps them to the SIMD instructions of the target (NEON, SSE, AVX, RVV...)
+ * or to plain integer code where there are none. The results are bit exact with the C
+ * implementation.
+ * The kernels are built with every GCC or Clang, and are used by the renderer with
+ * `LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_VECTOR`. Areas narrower than 16 pixels are
+ * left to C: the kernels return `LV_RESULT_INVALID` for them.
+ */
+
+#ifndef LV_BLEND_VECTOR_H
+#define LV_BLEND_VECTOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../../../lv_conf_internal.h"
+#include "../lv_draw_sw_blend.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+#if defined(__GNUC__) || defined(__clang__)
+#define LV_BLEND_VECTOR_SUPPORTED   1
+#else
+#define LV_BLEND_VECTOR_SUPPORTED   0
+#endif
+
+#if LV_BLEND_VECTOR_SUPPORTED && LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_VECTOR
+
+#ifndef LV_DRAW_SW_COLOR_BLEND_TO_RGB565
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565(dsc) \
+    _lv_color_blend_to_rgb565_vector(dsc)
+#endif
+
+#ifndef LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_OPA
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_OPA(dsc) \
+    _lv_color_blend_to_rgb565_with_opa_vector(dsc)
+#endif
+
+#ifndef LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_MASK
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_MASK(dsc) \
+    _lv_color_blend_to_rgb565_with_mask_vector(dsc)
+#endif
+
+#ifndef LV_DRAW_SW_COLOR_BLEND_TO_RGB565_MIX_MASK_OPA
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_MIX_MASK_OPA(dsc) \
+    _lv_color_blend_to_rgb565_mix_mask_opa_vector(dsc)
+#endif
+
+#ifndef LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_OPA
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)  \
+    _lv_rgb565_blend_normal_to_rgb565_with_opa_vector(dsc)
+#endif
+
+#ifndef LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_MASK
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc)  \
+    _lv_rgb565_blend_normal_to_rgb565_with_mask_vector(dsc)
+#endif
+
+#ifndef LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc)  \
+    _lv_rgb565_blend_normal_to_rgb565_mix_mask_opa_vector(dsc)
+#endif
+
+#endif /*LV_BLEND_VECTOR_SUPPORTED && LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_VECTOR*/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+#if LV_BLEND_VECTOR_SUPPORTED
+
+lv_result_t _lv_color_blend_to_rgb565_vector(_lv_draw_sw_blend_fill_dsc_t * dsc);
+lv_result_t _lv_color_blend_to_rgb565_with_opa_vector(_lv_draw_sw_blend_fill_dsc_t * dsc);
+lv_result_t _lv_color_blend_to_rgb565_with_mask_vector(_lv_draw_sw_blend_fill_dsc_t * dsc);
+lv_result_t _lv_color_blend_to_rgb565_mix_mask_opa_vector(_lv_draw_sw_blend_fill_dsc_t * dsc);
+
+lv_result_t _lv_rgb565_blend_normal_to_rgb565_with_opa_vector(_lv_draw_sw_blend_image_dsc_t * dsc);
+lv_result_t _lv_rgb565_blend_normal_to_rgb565_with_mask_vector(_lv_draw_sw_blend_image_dsc_t * dsc);
+lv_result_t _lv_rgb565_blend_normal_to_rgb565_mix_mask_opa_vector(_lv_draw_sw_blend_image_dsc_t * dsc);
+
+#endif /*LV_BLEND_VECTOR_SUPPORTED*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_BLEND_VECTOR_H*/
@@ -0,0 +1,288 @@
+/**
+ * @file lv_blend_x86.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_blend_x86.h"
+#if LV_USE_DRAW_SW && LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_X86
+
+#if !defined(__SSE2__)
+    #error "LV_DRAW_SW_ASM_X86 needs at least SSE2"
+#endif
+
+#include <immintrin.h>
+#include "../../../../misc/lv_color.h"
+#include "../../../../stdlib/lv_string.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/*Which hook is blending: where the mix ratio comes from besides the alpha of the source*/
+typedef enum {
+    MIX_NONE,
+    MIX_OPA,
+    MIX_MASK,
+    MIX_MASK_OPA,
+} mix_src_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static lv_blend_x86_isa_t detect_isa(void);
+static inline void * drawbuf_next_row(const void * buf, uint32_t stride);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_blend_x86_isa_t isa;
+static bool isa_detected;
+
+/**********************
+ *      MACROS
+ **********************/
+
+#define DISPATCH(kernel, ...)                               \
+    do {                                                    \
+        switch(lv_blend_x86_get_isa()) {                    \
+            case LV_BLEND_X86_ISA_AVX2:                     \
+                kernel##_avx2(__VA_ARGS__);                 \
+                return LV_RESULT_OK;                        \
+            case LV_BLEND_X86_ISA_SSE2:                     \
+                kernel##_sse2(__VA_ARGS__);                 \
+                return LV_RESULT_OK;                        \
+            default:                                        \
+                return LV_RESULT_INVALID;                   \
+        }                                                   \
+    } while(0)
+
+/**********************
+ *      KERNELS
+ **********************/
+
+/*SSE2: 8 pixels at once*/
+static inline __m128i load_mask_sse2(const lv_opa_t * mask)
+{
+    return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)mask), _mm_setzero_si128());
+}
+
+static inline void load_xrgb_sse2(const uint8_t * src, __m128i * r, __m128i * g, __m128i * b, __m128i * a)
+{
+    __m128i lo = _mm_loadu_si128((const __m128i *)src);
+    __m128i hi = _mm_loadu_si128((const __m128i *)(src + 16));
+    __m128i ff = _mm_set1_epi32(0xFF);
+    *b = _mm_packs_epi32(_mm_and_si128(lo, ff), _mm_and_si128(hi, ff));
+    *g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(lo, 8), ff), _mm_and_si128(_mm_srli_epi32(hi, 8), ff));
+    *r = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(lo, 16), ff), _mm_and_si128(_mm_srli_epi32(hi, 16), ff));
+    *a = _mm_packs_epi32(_mm_srli_epi32(lo, 24), _mm_srli_epi32(hi, 24));
+}
+
+#define VEC                 __m128i
+#define VEC_PX              8
+#define ISA(name)           name##_sse2
+#define TARGET
+#define V(op)               _mm_##op
+#define VLOAD(p)            _mm_loadu_si128((const __m128i *)(p))
+#define VSTORE(p, v)        _mm_storeu_si128((__m128i *)(p), v)
+#define VAND                _mm_and_si128
+#define VOR                 _mm_or_si128
+#define VANDNOT             _mm_andnot_si128
+#define VLOAD_MASK          load_mask_sse2
+#define VLOAD_XRGB          load_xrgb_sse2
+#include "lv_blend_x86_kernels.h"
+#undef VEC
+#undef VEC_PX
+#undef ISA
+#undef TARGET
+#undef V
+#undef VLOAD
+#undef VSTORE
+#undef VAND
+#undef VOR
+#undef VANDNOT
+#undef VLOAD_MASK
+#undef VLOAD_XRGB
+
+/*AVX2: 16 pixels at once. Only called if the CPU has it.*/
+static inline AVX2_TARGET __m256i load_mask_avx2(const lv_opa_t * mask)
+{
+    return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)mask));
+}
+
+/*The packing works on the 128 bit halves, put the 64 bit quarters back in order*/
+static inline AVX2_TARGET __m256i pack_avx2(__m256i lo, __m256i hi)
+{
+    return _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), 0xD8);
+}
+
+static inline AVX2_TARGET void load_xrgb_avx2(const uint8_t * src, __m256i * r, __m256i * g, __m256i * b,
+                                              __m256i * a)
+{
+    __m256i lo = _mm256_loadu_si256((const __m256i *)src);
+    __m256i hi = _mm256_loadu_si256((const __m256i *)(src + 32));
+    __m256i ff = _mm256_set1_epi32(0xFF);
+    *b = pack_avx2(_mm256_and_si256(lo, ff), _mm256_and_si256(hi, ff));
+    *g = pack_avx2(_mm256_and_si256(_mm256_srli_epi32(lo, 8), ff), _mm256_and_si256(_mm256_srli_epi32(hi, 8), ff));
+    *r = pack_avx2(_mm256_and_si256(_mm256_srli_epi32(lo, 16), ff), _mm256_and_si256(_mm256_srli_epi32(hi, 16), ff));
+    *a = pack_avx2(_mm256_srli_epi32(lo, 24), _mm256_srli_epi32(hi, 24));
+}
+
+#define VEC                 __m256i
+#define VEC_PX              16
+#define ISA(name)           name##_avx2
+#define TARGET              AVX2_TARGET
+#define V(op)               _mm256_##op
+#define VLOAD(p)            _mm256_loadu_si256((const __m256i *)(p))
+#define VSTORE(p, v)        _mm256_storeu_si256((__m256i *)(p), v)
+#define VAND                _mm256_and_si256
+#define VOR                 _mm256_or_si256
+#define VANDNOT             _mm256_andnot_si256
+#define VLOAD_MASK          load_mask_avx2
+#define VLOAD_XRGB          load_xrgb_avx2
+#include "lv_blend_x86_kernels.h"
+#undef VEC
+#undef VEC_PX
+#undef ISA
+#undef TARGET
+#undef V
+#undef VLOAD
+#undef VSTORE
+#undef VAND
+#undef VOR
+#undef VANDNOT
+#undef VLOAD_MASK
+#undef VLOAD_XRGB
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+lv_blend_x86_isa_t lv_blend_x86_get_isa(void)
+{
+    /*Racing draw threads detect the same*/
+    if(!isa_detected) {
+        isa = detect_isa();
+        isa_detected = true;
+    }
+    return isa;
+}
+
+lv_blend_x86_isa_t lv_blend_x86_set_isa(lv_blend_x86_isa_t new_isa)
+{
+    lv_blend_x86_isa_t best = detect_isa();
+    isa = new_isa < best ? new_isa : best;
+    isa_detected = true;
+    return isa;
+}
+
+const char * lv_blend_x86_isa_to_str(lv_blend_x86_isa_t i)
+{
+    switch(i) {
+        case LV_BLEND_X86_ISA_SSE2:
+            return "SSE2";
+        case LV_BLEND_X86_ISA_AVX2:
+            return "AVX2";
+        default:
+            return "C";
+    }
+}
+
+lv_result_t _lv_color_blend_to_rgb565_with_opa_x86(_lv_draw_sw_blend_fill_dsc_t * dsc)
+{
+    DISPATCH(fill_rgb565_mix, dsc, MIX_OPA);
+}
+
+lv_result_t _lv_color_blend_to_rgb565_with_mask_x86(_lv_draw_sw_blend_fill_dsc_t * dsc)
+{
+    DISPATCH(fill_rgb565_mix, dsc, MIX_MASK);
+}
+
+lv_result_t _lv_color_blend_to_rgb565_mix_mask_opa_x86(_lv_draw_sw_blend_fill_dsc_t * dsc)
+{
+    DISPATCH(fill_rgb565_mix, dsc, MIX_MASK_OPA);
+}
+
+lv_result_t _lv_rgb565_blend_normal_to_rgb565_with_opa_x86(_lv_draw_sw_blend_image_dsc_t * dsc)
+{
+    DISPATCH(rgb565_image, dsc, MIX_OPA);
+}
+
+lv_result_t _lv_rgb565_blend_normal_to_rgb565_with_mask_x86(_lv_draw_sw_blend_image_dsc_t * dsc)
+{
+    DISPATCH(rgb565_image, dsc, MIX_MASK);
+}
+
+lv_result_t _lv_rgb565_blend_normal_to_rgb565_mix_mask_opa_x86(_lv_draw_sw_blend_image_dsc_t * dsc)
+{
+    DISPATCH(rgb565_image, dsc, MIX_MASK_OPA);
+}
+
+lv_result_t _lv_rgb888_blend_normal_to_rgb565_x86(_lv_draw_sw_blend_image_dsc_t * dsc, uint32_t src_px_size)
+{
+    if(src_px_size != 4) return LV_RESULT_INVALID;
+    DISPATCH(xrgb8888_image, dsc, MIX_NONE, false);
+}
+
+lv_result_t _lv_rgb888_blend_normal_to_rgb565_with_opa_x86(_lv_draw_sw_blend_image_dsc_t * dsc, uint32_t src_px_size)
+{
+    if(src_px_size != 4) return LV_RESULT_INVALID;
+    DISPATCH(xrgb8888_image, dsc, MIX_OPA, false);
+}
+
+lv_result_t _lv_rgb888_blend_normal_to_rgb565_with_mask_x86(_lv_draw_sw_blend_image_dsc_t * dsc, uint32_t src_px_size)
+{
+    if(src_px_size != 4) return LV_RESULT_INVALID;
+    DISPATCH(xrgb8888_image, dsc, MIX_MASK, false);
+}
+
+lv_result_t _lv_rgb888_blend_normal_to_rgb565_mix_mask_opa_x86(_lv_draw_sw_blend_image_dsc_t * dsc,
+                                                               uint32_t src_px_size)
+{
+    if(src_px_size != 4) return LV_RESULT_INVALID;
+    DISPATCH(xrgb8888_image, dsc, MIX_MASK_OPA, false);
+}
+
+lv_result_t _lv_argb8888_blend_normal_to_rgb565_x86(_lv_draw_sw_blend_image_dsc_t * dsc)
+{
+    DISPATCH(xrgb8888_image, dsc, MIX_NONE, true);
+}
+
+lv_result_t _lv_argb8888_blend_normal_to_rgb565_with_opa_x86(_lv_draw_sw_blend_image_dsc_t * dsc)
+{
+    DISPATCH(xrgb8888_image, dsc, MIX_OPA, true);
+}
+
+lv_result_t _lv_argb8888_blend_normal_to_rgb565_with_mask_x86(_lv_draw_sw_blend_image_dsc_t * dsc)
+{
+    DISPATCH(xrgb8888_image, dsc, MIX_MASK, true);
+}
+
+lv_result_t _lv_argb8888_blend_normal_to_rgb565_mix_mask_opa_x86(_lv_draw_sw_blend_image_dsc_t * dsc)
+{
+    DISPATCH(xrgb8888_image, dsc, MIX_MASK_OPA, true);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static lv_blend_x86_isa_t detect_isa(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? LV_BLEND_X86_ISA_AVX2 : LV_BLEND_X86_ISA_SSE2;
+}
+
+static inline void * drawbuf_next_row(const void * buf, uint32_t stride)
+{
+    return (void *)((uint8_t *)buf + stride);
+}
+
+#endif /*LV_USE_DRAW_SW && LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_X86*/
@@ -0,0 +1,162 @@
+/**
+ * @file lv_blend_x86.h
+ * SSE2 and AVX2 blending for x86 hosts (simulators, Linux builds).
+ * The instruction set is picked at runtime with cpuid: AVX2 if the CPU has it, else SSE2.
+ * The results are bit exact with the C implementation.
+ */
+
+#ifndef LV_BLEND_X86_H
+#define LV_BLEND_X86_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../../../lv_conf_internal.h"
+#include "../lv_draw_sw_blend.h"
+
+#ifdef LV_DRAW_SW_X86_CUSTOM_INCLUDE
+#include LV_DRAW_SW_X86_CUSTOM_INCLUDE
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/*The plain RGB565 fill and copy, the fills of 32 bit destinations and the RGB565 swap
+ *of C are vectorized well by the compiler*/
+
+#ifndef LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_OPA
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_OPA(dsc) \
+    _lv_color_blend_to_rgb565_with_opa_x86(dsc)
+#endif
+
+#ifndef LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_MASK
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_MASK(dsc) \
+    _lv_color_blend_to_rgb565_with_mask_x86(dsc)
+#endif
+
+#ifndef LV_DRAW_SW_COLOR_BLEND_TO_RGB565_MIX_MASK_OPA
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_MIX_MASK_OPA(dsc) \
+    _lv_color_blend_to_rgb565_mix_mask_opa_x86(dsc)
+#endif
+
+#ifndef LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_OPA
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)  \
+    _lv_rgb565_blend_normal_to_rgb565_with_opa_x86(dsc)
+#endif
+
+#ifndef LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_MASK
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc)  \
+    _lv_rgb565_blend_normal_to_rgb565_with_mask_x86(dsc)
+#endif
+
+#ifndef LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc)  \
+    _lv_rgb565_blend_normal_to_rgb565_mix_mask_opa_x86(dsc)
+#endif
+
+/*Only XRGB8888, RGB888 (3 bytes per pixel) is left to C*/
+
+#ifndef LV_DRAW_SW_RGB888_BLEND_NORMAL_TO_RGB565
+#define LV_DRAW_SW_RGB888_BLEND_NORMAL_TO_RGB565(dsc, src_px_size)  \
+    _lv_rgb888_blend_normal_to_rgb565_x86(dsc, src_px_size)
+#endif
+
+#ifndef LV_DRAW_SW_RGB888_BLEND_NORMAL_TO_RGB565_WITH_OPA
+#define LV_DRAW_SW_RGB888_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc, src_px_size)  \
+    _lv_rgb888_blend_normal_to_rgb565_with_opa_x86(dsc, src_px_size)
+#endif
+
+#ifndef LV_DRAW_SW_RGB888_BLEND_NORMAL_TO_RGB565_WITH_MASK
+#define LV_DRAW_SW_RGB888_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc, src_px_size)  \
+    _lv_rgb888_blend_normal_to_rgb565_with_mask_x86(dsc, src_px_size)
+#endif
+
+#ifndef LV_DRAW_SW_RGB888_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA
+#define LV_DRAW_SW_RGB888_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc, src_px_size)  \
+    _lv_rgb888_blend_normal_to_rgb565_mix_mask_opa_x86(dsc, src_px_size)
+#endif
+
+#ifndef LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565(dsc)  \
+    _lv_argb8888_blend_normal_to_rgb565_x86(dsc)
+#endif
+
+#ifndef LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_WITH_OPA
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)  \
+    _lv_argb8888_blend_normal_to_rgb565_with_opa_x86(dsc)
+#endif
+
+#ifndef LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_WITH_MASK
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc)  \
+    _lv_argb8888_blend_normal_to_rgb565_with_mask_x86(dsc)
+#endif
+
+#ifndef LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc)  \
+    _lv_argb8888_blend_normal_to_rgb565_mix_mask_opa_x86(dsc)
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef enum {
+    LV_BLEND_X86_ISA_NONE,      /**< Use the C implementation*/
+    LV_BLEND_X86_ISA_SSE2,
+    LV_BLEND_X86_ISA_AVX2,
+} lv_blend_x86_isa_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Get the instruction set the blending uses. Detected on the first call.
+ * @return          the instruction set
+ */
+lv_blend_x86_isa_t lv_blend_x86_get_isa(void);
+
+/**
+ * Use an other instruction set than the detected one, e.g. to compare them.
+ * @param isa       the instruction set, not more than the CPU has
+ * @return          the instruction set used from now on: `isa`, or the best the CPU has
+ */
+lv_blend_x86_isa_t lv_blend_x86_set_isa(lv_blend_x86_isa_t isa);
+
+/**
+ * Get the name of an instruction set, e.g. "AVX2".
+ * @param isa       the instruction set
+ * @return          the name
+ */
+const char * lv_blend_x86_isa_to_str(lv_blend_x86_isa_t isa);
+
+lv_result_t _lv_color_blend_to_rgb565_with_opa_x86(_lv_draw_sw_blend_fill_dsc_t * dsc);
+lv_result_t _lv_color_blend_to_rgb565_with_mask_x86(_lv_draw_sw_blend_fill_dsc_t * dsc);
+lv_result_t _lv_color_blend_to_rgb565_mix_mask_opa_x86(_lv_draw_sw_blend_fill_dsc_t * dsc);
+
+lv_result_t _lv_rgb565_blend_normal_to_rgb565_with_opa_x86(_lv_draw_sw_blend_image_dsc_t * dsc);
+lv_result_t _lv_rgb565_blend_normal_to_rgb565_with_mask_x86(_lv_draw_sw_blend_image_dsc_t * dsc);
+lv_result_t _lv_rgb565_blend_normal_to_rgb565_mix_mask_opa_x86(_lv_draw_sw_blend_image_dsc_t * dsc);
+
+lv_result_t _lv_rgb888_blend_normal_to_rgb565_x86(_lv_draw_sw_blend_image_dsc_t * dsc, uint32_t src_px_size);
+lv_result_t _lv_rgb888_blend_normal_to_rgb565_with_opa_x86(_lv_draw_sw_blend_image_dsc_t * dsc, uint32_t src_px_size);
+lv_result_t _lv_rgb888_blend_normal_to_rgb565_with_mask_x86(_lv_draw_sw_blend_image_dsc_t * dsc, uint32_t src_px_size);
+lv_result_t _lv_rgb888_blend_normal_to_rgb565_mix_mask_opa_x86(_lv_draw_sw_blend_image_dsc_t * dsc,
+                                                               uint32_t src_px_size);
+
+lv_result_t _lv_argb8888_blend_normal_to_rgb565_x86(_lv_draw_sw_blend_image_dsc_t * dsc);
+lv_result_t _lv_argb8888_blend_normal_to_rgb565_with_opa_x86(_lv_draw_sw_blend_image_dsc_t * dsc);
+lv_result_t _lv_argb8888_blend_normal_to_rgb565_with_mask_x86(_lv_draw_sw_blend_image_dsc_t * dsc);
+lv_result_t _lv_argb8888_blend_normal_to_rgb565_mix_mask_opa_x86(_lv_draw_sw_blend_image_dsc_t * dsc);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_BLEND_X86_H*/
@@ -0,0 +1,224 @@
+/**
+ * @file lv_blend_x86_kernels.h
+ * The blending kernels of lv_blend_x86.c, included there once per instruction set.
+ * Before including it the following have to be defined:
+ *  - VEC, VEC_PX: the vector type and the RGB565 pixels in it
+ *  - ISA(name): the name of a function for this instruction set
+ *  - TARGET: the attribute enabling the instruction set on a function
+ *  - V(op): an intrinsic working on 16 and 32 bit lanes, e.g. V(add_epi16)
+ *  - VLOAD, VSTORE, VAND, VOR, VANDNOT: the intrinsics working on the whole vector
+ *  - VLOAD_MASK(mask): `VEC_PX` mask bytes into 16 bit lanes
+ *  - VLOAD_XRGB(src, r, g, b, a): the channels of `VEC_PX` 32 bit pixels into 16 bit lanes
+ *
+ * Every pixel is in a 16 bit lane and is calculated the same way as the C implementation
+ * does, so the results are bit exact with it.
+ */
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static inline TARGET VEC ISA(opa_mix2)(VEC a1, VEC a2)
+{
+    return V(srli_epi16)(V(mullo_epi16)(a1, a2), 8);
+}
+
+static inline TARGET VEC ISA(opa_mix3)(VEC a1, VEC a2, VEC a3)
+{
+    /*a1 * a2 fits in 16 bits, the high half of the next product is the >> 16*/
+    return V(mulhi_epu16)(V(mullo_epi16)(a1, a2), a3);
+}
+
+/**
+ * The mix ratio of `VEC_PX` pixels.
+ * @param alpha     alpha of the source pixels
+ * @param has_alpha false: the source is opaque and `alpha` is ignored
+ * @param mask      the mask of the first pixel, or NULL
+ * @param opa       the opacity in every lane
+ * @param src       the hook which is calling, with or without mask and opacity
+ */
+static inline TARGET VEC ISA(get_mix)(VEC alpha, bool has_alpha, const lv_opa_t * mask, VEC opa, mix_src_t src)
+{
+    VEC m;
+    switch(src) {
+        case MIX_OPA:
+            return has_alpha ? ISA(opa_mix2)(alpha, opa) : opa;
+        case MIX_MASK:
+            m = VLOAD_MASK(mask);
+            return has_alpha ? ISA(opa_mix2)(alpha, m) : m;
+        case MIX_MASK_OPA:
+            m = VLOAD_MASK(mask);
+            return has_alpha ? ISA(opa_mix3)(alpha, m, opa) : ISA(opa_mix2)(m, opa);
+        default:
+            return has_alpha ? alpha : V(set1_epi16)(0xFF);
+    }
+}
+
+/**
+ * `lv_color_16_16_mix()`: bg + (fg - bg) * ((mix + 4) >> 3) / 32 per channel, rounded down.
+ * mix == 255 gives `fg` and mix < 4 gives `bg`, like the special cases of the C version.
+ */
+static inline TARGET VEC ISA(mix_16_16)(VEC fg, VEC bg, VEC mix)
+{
+    VEC m = V(srli_epi16)(V(add_epi16)(mix, V(set1_epi16)(4)), 3);
+    VEC mask5 = V(set1_epi16)(0x1F);
+    VEC mask6 = V(set1_epi16)(0x3F);
+
+    VEC fg_b = VAND(fg, mask5);
+    VEC bg_b = VAND(bg, mask5);
+    VEC fg_g = VAND(V(srli_epi16)(fg, 5), mask6);
+    VEC bg_g = VAND(V(srli_epi16)(bg, 5), mask6);
+    VEC fg_r = V(srli_epi16)(fg, 11);
+    VEC bg_r = V(srli_epi16)(bg, 11);
+
+    VEC b = V(add_epi16)(bg_b, V(srai_epi16)(V(mullo_epi16)(V(sub_epi16)(fg_b, bg_b), m), 5));
+    VEC g = V(add_epi16)(bg_g, V(srai_epi16)(V(mullo_epi16)(V(sub_epi16)(fg_g, bg_g), m), 5));
+    VEC r = V(add_epi16)(bg_r, V(srai_epi16)(V(mullo_epi16)(V(sub_epi16)(fg_r, bg_r), m), 5));
+
+    return VOR(VOR(V(slli_epi16)(r, 11), V(slli_epi16)(g, 5)), b);
+}
+
+/**
+ * `lv_color_24_16_mix()` of lv_draw_sw_blend_to_rgb565.c:
+ * (fg * mix + bg * (255 - mix)) >> 8 per channel, with the RGB888 source cut to RGB565.
+ */
+static inline TARGET VEC ISA(mix_24_16)(VEC r8, VEC g8, VEC b8, VEC bg, VEC mix)
+{
+    VEC mix_inv = V(sub_epi16)(V(set1_epi16)(0xFF), mix);
+    VEC fg_r = V(srli_epi16)(r8, 3);
+    VEC fg_g = V(srli_epi16)(g8, 2);
+    VEC fg_b = V(srli_epi16)(b8, 3);
+    VEC bg_r = V(srli_epi16)(bg, 11);
+    VEC bg_g = VAND(V(srli_epi16)(bg, 5), V(set1_epi16)(0x3F));
+    VEC bg_b = VAND(bg, V(set1_epi16)(0x1F));
+
+    VEC r = V(srli_epi16)(V(add_epi16)(V(mullo_epi16)(fg_r, mix), V(mullo_epi16)(bg_r, mix_inv)), 8);
+    VEC g = V(srli_epi16)(V(add_epi16)(V(mullo_epi16)(fg_g, mix), V(mullo_epi16)(bg_g, mix_inv)), 8);
+    VEC b = V(srli_epi16)(V(add_epi16)(V(mullo_epi16)(fg_b, mix), V(mullo_epi16)(bg_b, mix_inv)), 8);
+    VEC res = VOR(VOR(V(slli_epi16)(r, 11), V(slli_epi16)(g, 5)), b);
+
+    /*The special cases: 255 is the source as it is, 0 the background*/
+    VEC fg = VOR(VOR(V(slli_epi16)(fg_r, 11), V(slli_epi16)(fg_g, 5)), fg_b);
+    VEC is_cover = V(cmpeq_epi16)(mix, V(set1_epi16)(0xFF));
+    VEC is_transp = V(cmpeq_epi16)(mix, V(set1_epi16)(0));
+    res = VOR(VAND(is_cover, fg), VANDNOT(is_cover, res));
+    return VOR(VAND(is_transp, bg), VANDNOT(is_transp, res));
+}
+
+static inline TARGET void ISA(fill_rgb565_px)(uint16_t * dest, const lv_opa_t * mask, VEC color, VEC opa,
+                                              mix_src_t src)
+{
+    VEC mix = ISA(get_mix)(opa, false, mask, opa, src);
+    VSTORE(dest, ISA(mix_16_16)(color, VLOAD(dest), mix));
+}
+
+static void TARGET ISA(fill_rgb565_mix)(_lv_draw_sw_blend_fill_dsc_t * dsc, mix_src_t src)
+{
+    int32_t w = dsc->dest_w;
+    int32_t h = dsc->dest_h;
+    VEC color = V(set1_epi16)((int16_t)lv_color_to_u16(dsc->color));
+    VEC opa = V(set1_epi16)(dsc->opa);
+    uint16_t * dest_buf_u16 = dsc->dest_buf;
+    const lv_opa_t * mask_buf = dsc->mask_buf;
+
+    int32_t y;
+    for(y = 0; y < h; y++) {
+        int32_t x;
+        for(x = 0; x <= w - VEC_PX; x += VEC_PX) {
+            ISA(fill_rgb565_px)(&dest_buf_u16[x], mask_buf ? &mask_buf[x] : NULL, color, opa, src);
+        }
+        if(x < w) {
+            uint16_t dest_tail[VEC_PX] = {0};
+            lv_opa_t mask_tail[VEC_PX] = {0};
+            lv_memcpy(dest_tail, &dest_buf_u16[x], (w - x) * sizeof(uint16_t));
+            if(mask_buf) lv_memcpy(mask_tail, &mask_buf[x], w - x);
+            ISA(fill_rgb565_px)(dest_tail, mask_tail, color, opa, src);
+            lv_memcpy(&dest_buf_u16[x], dest_tail, (w - x) * sizeof(uint16_t));
+        }
+        dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dsc->dest_stride);
+        if(mask_buf) mask_buf += dsc->mask_stride;
+    }
+}
+
+static inline TARGET void ISA(rgb565_px)(uint16_t * dest, const uint16_t * src, const lv_opa_t * mask, VEC opa,
+                                         mix_src_t mix_src)
+{
+    VEC mix = ISA(get_mix)(opa, false, mask, opa, mix_src);
+    VSTORE(dest, ISA(mix_16_16)(VLOAD(src), VLOAD(dest), mix));
+}
+
+static void TARGET ISA(rgb565_image)(_lv_draw_sw_blend_image_dsc_t * dsc, mix_src_t mix_src)
+{
+    int32_t w = dsc->dest_w;
+    int32_t h = dsc->dest_h;
+    VEC opa = V(set1_epi16)(dsc->opa);
+    uint16_t * dest_buf_u16 = dsc->dest_buf;
+    const uint16_t * src_buf_u16 = dsc->src_buf;
+    const lv_opa_t * mask_buf = dsc->mask_buf;
+
+    int32_t y;
+    for(y = 0; y < h; y++) {
+        int32_t x;
+        for(x = 0; x <= w - VEC_PX; x += VEC_PX) {
+            ISA(rgb565_px)(&dest_buf_u16[x], &src_buf_u16[x], mask_buf ? &mask_buf[x] : NULL, opa, mix_src);
+        }
+        if(x < w) {
+            uint16_t dest_tail[VEC_PX] = {0};
+            uint16_t src_tail[VEC_PX] = {0};
+            lv_opa_t mask_tail[VEC_PX] = {0};
+            lv_memcpy(dest_tail, &dest_buf_u16[x], (w - x) * sizeof(uint16_t));
+            lv_memcpy(src_tail, &src_buf_u16[x], (w - x) * sizeof(uint16_t));
+            if(mask_buf) lv_memcpy(mask_tail, &mask_buf[x], w - x);
+            ISA(rgb565_px)(dest_tail, src_tail, mask_tail, opa, mix_src);
+            lv_memcpy(&dest_buf_u16[x], dest_tail, (w - x) * sizeof(uint16_t));
+        }
+        dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dsc->dest_stride);
+        src_buf_u16 = drawbuf_next_row(src_buf_u16, dsc->src_stride);
+        if(mask_buf) mask_buf += dsc->mask_stride;
+    }
+}
+
+static inline TARGET void ISA(xrgb8888_px)(uint16_t * dest, const uint8_t * src, const lv_opa_t * mask, VEC opa,
+                                           mix_src_t mix_src, bool has_alpha)
+{
+    VEC r, g, b, a;
+    VLOAD_XRGB(src, &r, &g, &b, &a);
+    VEC mix = ISA(get_mix)(a, has_alpha, mask, opa, mix_src);
+    VSTORE(dest, ISA(mix_24_16)(r, g, b, VLOAD(dest), mix));
+}
+
+/**
+ * XRGB8888 or ARGB8888 to RGB565.
+ * @param has_alpha     true: ARGB8888, the alpha channel is mixed in too
+ */
+static void TARGET ISA(xrgb8888_image)(_lv_draw_sw_blend_image_dsc_t * dsc, mix_src_t mix_src, bool has_alpha)
+{
+    int32_t w = dsc->dest_w;
+    int32_t h = dsc->dest_h;
+    VEC opa = V(set1_epi16)(dsc->opa);
+    uint16_t * dest_buf_u16 = dsc->dest_buf;
+    const uint8_t * src_buf_u8 = dsc->src_buf;
+    const lv_opa_t * mask_buf = dsc->mask_buf;
+
+    int32_t y;
+    for(y = 0; y < h; y++) {
+        int32_t x;
+        for(x = 0; x <= w - VEC_PX; x += VEC_PX) {
+            ISA(xrgb8888_px)(&dest_buf_u16[x], &src_buf_u8[x * 4], mask_buf ? &mask_buf[x] : NULL, opa, mix_src,
+                             has_alpha);
+        }
+        if(x < w) {
+            uint16_t dest_tail[VEC_PX] = {0};
+            uint32_t src_tail[VEC_PX] = {0};
+            lv_opa_t mask_tail[VEC_PX] = {0};
+            lv_memcpy(dest_tail, &dest_buf_u16[x], (w - x) * sizeof(uint16_t));
+            lv_memcpy(src_tail, &src_buf_u8[x * 4], (w - x) * sizeof(uint32_t));
+            if(mask_buf) lv_memcpy(mask_tail, &mask_buf[x], w - x);
+            ISA(xrgb8888_px)(dest_tail, (const uint8_t *)src_tail, mask_tail, opa, mix_src, has_alpha);
+            lv_memcpy(&dest_buf_u16[x], dest_tail, (w - x) * sizeof(uint16_t));
+        }
+        dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dsc->dest_stride);
+        src_buf_u8 += dsc->src_stride;
+        if(mask_buf) mask_buf += dsc->mask_stride;
+    }
+}
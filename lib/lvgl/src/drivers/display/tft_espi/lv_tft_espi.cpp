@@ -14,18 +14,39 @@
 /*********************
  *      DEFINES
  *********************/
+/*Fixed cost of a flush: the SPI transaction, CS, setting the address window (11 bytes with D/C toggles)*/
+#ifndef LV_TFT_ESPI_FLUSH_COST_NS
+    #define LV_TFT_ESPI_FLUSH_COST_NS 15000
+#endif
+
+#if defined(ESP32_DMA)
+/*The DMA interrupt calls `lv_display_flush_ready()` and through it `lv_tick_get()`: they have to be
+ *in IRAM, or an interrupt while the flash cache is disabled crashes*/
+#define LV_TFT_ESPI_STR(x) LV_TFT_ESPI_STR2(x)
+#define LV_TFT_ESPI_STR2(x) #x
+static_assert(sizeof(LV_TFT_ESPI_STR(LV_ATTRIBUTE_FLUSH_READY)) > 1 &&
+              sizeof(LV_TFT_ESPI_STR(LV_ATTRIBUTE_TICK_INC)) > 1,
+              "Set LV_ATTRIBUTE_FLUSH_READY and LV_ATTRIBUTE_TICK_INC to IRAM_ATTR in lv_conf.h");
+#endif
 
 /**********************
  *      TYPEDEFS
  **********************/
 typedef struct {
     TFT_eSPI * tft;
+    lv_display_t * disp;
 } lv_tft_espi_t;
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static lv_tft_espi_t * tft_create(uint32_t hor_res, uint32_t ver_res);
 static void flush_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map);
+#if defined(ESP32_DMA)
+    static void flush_dma_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map);
+    static void flush_dma_wait_cb(lv_display_t * disp);
+    static void dma_done_cb(void * user_data);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -40,13 +61,52 @@ static void flush_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * px_m
  **********************/
 
 lv_display_t * lv_tft_espi_create(uint32_t hor_res, uint32_t ver_res, void * buf, uint32_t buf_size_bytes)
+{
+    lv_tft_espi_t * dsc = tft_create(hor_res, ver_res);
+    if(dsc == NULL) return NULL;
+
+    lv_display_set_flush_cb(dsc->disp, flush_cb);
+    lv_display_set_buffers(dsc->disp, (void *)buf, NULL, buf_size_bytes, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    return dsc->disp;
+}
+
+lv_display_t * lv_tft_espi_create_dma(uint32_t hor_res, uint32_t ver_res, void * buf1, void * buf2,
+                                      uint32_t buf_size_bytes)
+{
+    lv_tft_espi_t * dsc = tft_create(hor_res, ver_res);
+    if(dsc == NULL) return NULL;
+
+#if defined(ESP32_DMA)
+    dsc->tft->setDMADoneCallback(dma_done_cb, dsc);
+    if(dsc->tft->initDMA()) {
+        /*Keep CS low: ending the write would wait for the DMA*/
+        dsc->tft->startWrite();
+        lv_display_set_flush_cb(dsc->disp, flush_dma_cb);
+        lv_display_set_flush_wait_cb(dsc->disp, flush_dma_wait_cb);
+    }
+    else
+#endif
+    {
+        LV_LOG_WARN("No DMA, flushing blocks");
+        lv_display_set_flush_cb(dsc->disp, flush_cb);
+    }
+
+    lv_display_set_buffers(dsc->disp, buf1, buf2, buf_size_bytes, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    return dsc->disp;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static lv_tft_espi_t * tft_create(uint32_t hor_res, uint32_t ver_res)
 {
     lv_tft_espi_t * dsc = (lv_tft_espi_t *)lv_malloc_zeroed(sizeof(lv_tft_espi_t));
     LV_ASSERT_MALLOC(dsc);
     if(dsc == NULL) return NULL;
 
-    lv_display_t * disp = lv_display_create(hor_res, ver_res);
-    if(disp == NULL) {
+    dsc->disp = lv_display_create(hor_res, ver_res);
+    if(dsc->disp == NULL) {
         lv_free(dsc);
         return NULL;
     }
@@ -54,15 +114,12 @@ lv_display_t * lv_tft_espi_create(uint32_t hor_res, uint32_t ver_res, void * buf
     dsc->tft = new TFT_eSPI(hor_res, ver_res);
     dsc->tft->begin();          /* TFT init */
     dsc->tft->setRotation(3);   /* Landscape orientation, flipped */
-    lv_display_set_driver_data(disp, (void *)dsc);
-    lv_display_set_flush_cb(disp, flush_cb);
-    lv_display_set_buffers(disp, (void *)buf, NULL, buf_size_bytes, LV_DISPLAY_RENDER_MODE_PARTIAL);
-    return disp;
-}
+    lv_display_set_driver_data(dsc->disp, (void *)dsc);
 
-/**********************
- *   STATIC FUNCTIONS
- **********************/
+    /*8 clocks per byte*/
+    lv_display_set_flush_cost(dsc->disp, LV_TFT_ESPI_FLUSH_COST_NS, (uint32_t)(8000000000ULL / SPI_FREQUENCY));
+    return dsc;
+}
 
 static void flush_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map)
 {
@@ -71,13 +128,54 @@ static void flush_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * px_m
     uint32_t w = (area->x2 - area->x1 + 1);
     uint32_t h = (area->y2 - area->y1 + 1);
 
+    /*Rendered in LV_COLOR_FORMAT_RGB565_SWAPPED the buffer is already in the panel's byte order*/
+    bool swap = lv_display_get_color_format(disp) != LV_COLOR_FORMAT_RGB565_SWAPPED;
+
     dsc->tft->startWrite();
     dsc->tft->setAddrWindow(area->x1, area->y1, w, h);
-    dsc->tft->pushColors((uint16_t *)px_map, w * h, true);
+    dsc->tft->pushColors((uint16_t *)px_map, w * h, swap);
     dsc->tft->endWrite();
 
     lv_display_flush_ready(disp);
 
 }
 
+#if defined(ESP32_DMA)
+
+/*Start the transfer and return. With two buffers LVGL renders into the other one meanwhile,
+ *the DMA interrupt hands this one back.*/
+static void flush_dma_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map)
+{
+    lv_tft_espi_t * dsc = (lv_tft_espi_t *)lv_display_get_driver_data(disp);
+
+    /*The previous transfer is done (its interrupt returned the buffer), collect it*/
+    dsc->tft->dmaWait();
+
+    /*Colors go out MSB first. pushImageDMA() swaps an RGB565 buffer in place before the transfer,
+     *an RGB565_SWAPPED one goes out untouched.*/
+    dsc->tft->setSwapBytes(lv_display_get_color_format(disp) != LV_COLOR_FORMAT_RGB565_SWAPPED);
+
+    int32_t w = lv_area_get_width(area);
+    int32_t h = lv_area_get_height(area);
+    dsc->tft->pushImageDMA(area->x1, area->y1, w, h, (uint16_t *)px_map);
+
+    /*Nothing was queued, e.g. the area was clipped away*/
+    if(dsc->tft->spiBusyCheck == 0) lv_display_flush_ready(disp);
+}
+
+/*Sleep in the SPI driver instead of spinning on the flushing flag*/
+static void flush_dma_wait_cb(lv_display_t * disp)
+{
+    lv_tft_espi_t * dsc = (lv_tft_espi_t *)lv_display_get_driver_data(disp);
+    dsc->tft->dmaWait();
+}
+
+static void IRAM_ATTR dma_done_cb(void * user_data)
+{
+    lv_tft_espi_t * dsc = (lv_tft_espi_t *)user_data;
+    lv_display_flush_ready(dsc->disp);
+}
+
+#endif /*ESP32_DMA*/
+
 #endif /*LV_USE_TFT_ESPI*/
@@ -28,8 +28,34 @@ extern "C" {
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
+/**
+ * Create a display which sends the rendered areas with blocking SPI writes.
+ * The flush cost (`lv_display_set_flush_cost()`) is set from `SPI_FREQUENCY` and
+ * `LV_TFT_ESPI_FLUSH_COST_NS`, for both create functions.
+ * @param hor_res           horizontal resolution
+ * @param ver_res           vertical resolution
+ * @param buf               the render buffer
+ * @param buf_size_bytes    size of the buffer in bytes
+ * @return                  the created display
+ */
 lv_display_t * lv_tft_espi_create(uint32_t hor_res, uint32_t ver_res, void * buf, uint32_t buf_size_bytes);
 
+/**
+ * Create a display which sends the rendered areas with DMA and renders the next area
+ * into the other buffer meanwhile. The DMA interrupt calls `lv_display_flush_ready()`.
+ * The display keeps the SPI bus for itself. Falls back to blocking flushes without DMA.
+ * With `lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565_SWAPPED)` LVGL renders
+ * in the panel's byte order and the buffers are sent without swapping (for both create functions).
+ * @param hor_res           horizontal resolution
+ * @param ver_res           vertical resolution
+ * @param buf1              a render buffer, DMA capable
+ * @param buf2              the other render buffer of the same size, DMA capable
+ * @param buf_size_bytes    size of one buffer in bytes
+ * @return                  the created display
+ */
+lv_display_t * lv_tft_espi_create_dma(uint32_t hor_res, uint32_t ver_res, void * buf1, void * buf2,
+                                      uint32_t buf_size_bytes);
+
 /**********************
  *      MACROS
  **********************/
@@ -122,6 +122,15 @@ void lv_binfont_destroy(lv_font_t * font)
     const lv_font_fmt_txt_dsc_t * dsc = font->dsc;
     if(dsc == NULL) return;
 
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+    /*A new font could be allocated at the same address*/
+    lv_font_fmt_txt_drop_cache();
+#endif
+
+#if LV_USE_FONT_FMT_TXT_LUT
+    lv_font_fmt_txt_delete_lut(font);
+#endif
+
     if(dsc->kern_classes == 0) {
         const lv_font_fmt_txt_kern_pair_t * kern_dsc = dsc->kern_dsc;
         if(NULL != kern_dsc) {
@@ -22,6 +22,16 @@
     #define font_rle LV_GLOBAL_DEFAULT()->font_fmt_rle
 #endif /*LV_USE_FONT_COMPRESSED*/
 
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+    #define glyph_cache_p (&LV_GLOBAL_DEFAULT()->font_fmt_txt_cache)
+#endif /*LV_FONT_FMT_TXT_CACHE_SIZE*/
+
+#if LV_USE_FONT_FMT_TXT_LUT
+    #define lut_head (LV_GLOBAL_DEFAULT()->font_fmt_txt_lut_head)
+    #define LUT_DIRECT_CNT 256      /*U+0000..U+00FF*/
+    #define LUT_HASH_MUL 2654435761u
+#endif /*LV_USE_FONT_FMT_TXT_LUT*/
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -30,14 +40,55 @@ typedef struct {
     uint32_t gid_right;
 } kern_pair_ref_t;
 
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+typedef struct {
+    lv_cache_slot_size_t slot;      /**< The size of `bitmap`*/
+    const lv_font_t * font;
+    uint32_t gid;
+    uint8_t bpp;
+    uint8_t * bitmap;               /**< The decoded A8 bitmap*/
+} glyph_cache_data_t;
+#endif /*LV_FONT_FMT_TXT_CACHE_SIZE*/
+
+#if LV_USE_FONT_FMT_TXT_LUT
+struct _lv_font_fmt_txt_lut_t {
+    lv_font_fmt_txt_lut_t * next;
+    const lv_font_t * font;
+    uint16_t direct[LUT_DIRECT_CNT];    /**< Glyph IDs of U+0000..U+00FF*/
+    uint32_t * letters;                 /**< Hashed code points of the other glyphs, 0: empty slot*/
+    uint16_t * gids;                    /**< Glyph IDs of `letters`*/
+    uint32_t mask;                      /**< Slot count - 1, the slot count is a power of 2*/
+    uint8_t shift;                      /**< 32 - log2(slot count)*/
+};
+#endif /*LV_USE_FONT_FMT_TXT_LUT*/
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter);
+static uint32_t search_cmaps(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t letter);
 static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t gid_right);
 static int32_t unicode_list_compare(const void * ref, const void * element);
 static int32_t kern_pair_8_compare(const void * ref, const void * element);
 static int32_t kern_pair_16_compare(const void * ref, const void * element);
+static bool decode_glyph(const lv_font_fmt_txt_dsc_t * fdsc, const lv_font_fmt_txt_glyph_dsc_t * gdsc,
+                         uint8_t * bitmap_out);
+
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+    static lv_result_t get_cached_bitmap(const lv_font_t * font, uint32_t gid, uint8_t * bitmap_out);
+    static lv_cache_compare_res_t glyph_cache_compare_cb(const glyph_cache_data_t * lhs, const glyph_cache_data_t * rhs);
+    static bool glyph_cache_create_cb(glyph_cache_data_t * node, void * user_data);
+    static void glyph_cache_free_cb(glyph_cache_data_t * node, void * user_data);
+#endif /*LV_FONT_FMT_TXT_CACHE_SIZE*/
+
+#if LV_USE_FONT_FMT_TXT_LUT
+    static lv_result_t lut_build(lv_font_fmt_txt_lut_t * lut, const lv_font_fmt_txt_dsc_t * fdsc);
+    static lv_result_t lut_add_cmaps(lv_font_fmt_txt_lut_t * lut, const lv_font_fmt_txt_dsc_t * fdsc, uint32_t * cnt);
+    static lv_result_t lut_insert(lv_font_fmt_txt_lut_t * lut, const lv_font_fmt_txt_dsc_t * fdsc, uint32_t letter);
+    static inline const lv_font_fmt_txt_lut_t * lut_find(const lv_font_t * font);
+    static inline uint32_t lut_get(const lv_font_fmt_txt_lut_t * lut, uint32_t letter);
+    static void lut_free(lv_font_fmt_txt_lut_t * lut);
+#endif /*LV_USE_FONT_FMT_TXT_LUT*/
 
 #if LV_USE_FONT_COMPRESSED
     static void decompress(const uint8_t * in, uint8_t * out, int32_t w, int32_t h, uint8_t bpp, bool prefilter);
@@ -92,6 +143,198 @@ const void * lv_font_get_bitmap_fmt_txt(lv_font_glyph_dsc_t * g_dsc, uint32_t un
     int32_t gsize = (int32_t) gdsc->box_w * gdsc->box_h;
     if(gsize == 0) return NULL;
 
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+    if(get_cached_bitmap(font, gid, bitmap_out) == LV_RESULT_OK) return draw_buf;
+#endif
+
+    if(!decode_glyph(fdsc, gdsc, bitmap_out)) return NULL;
+
+    return draw_buf;
+}
+
+bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t * dsc_out, uint32_t unicode_letter,
+                                   uint32_t unicode_letter_next)
+{
+    /*It fixes a strange compiler optimization issue: https://github.com/lvgl/lvgl/issues/4370*/
+    bool is_tab = unicode_letter == '\t';
+    if(is_tab) {
+        unicode_letter = ' ';
+    }
+    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
+    uint32_t gid = get_glyph_dsc_id(font, unicode_letter);
+    if(!gid) return false;
+
+    int8_t kvalue = 0;
+    if(fdsc->kern_dsc) {
+        uint32_t gid_next = get_glyph_dsc_id(font, unicode_letter_next);
+        if(gid_next) {
+            kvalue = get_kern_value(font, gid, gid_next);
+        }
+    }
+
+    /*Put together a glyph dsc*/
+    const lv_font_fmt_txt_glyph_dsc_t * gdsc = &fdsc->glyph_dsc[gid];
+
+    int32_t kv = ((int32_t)((int32_t)kvalue * fdsc->kern_scale) >> 4);
+
+    uint32_t adv_w = gdsc->adv_w;
+    if(is_tab) adv_w *= 2;
+
+    adv_w += kv;
+    adv_w  = (adv_w + (1 << 3)) >> 4;
+
+    dsc_out->adv_w = adv_w;
+    dsc_out->box_h = gdsc->box_h;
+    dsc_out->box_w = gdsc->box_w;
+    dsc_out->ofs_x = gdsc->ofs_x;
+    dsc_out->ofs_y = gdsc->ofs_y;
+    dsc_out->format = (uint8_t)fdsc->bpp;
+    dsc_out->is_placeholder = false;
+
+    if(is_tab) dsc_out->box_w = dsc_out->box_w * 2;
+
+    return true;
+}
+
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+
+void _lv_font_fmt_txt_cache_init(void)
+{
+    lv_memzero(glyph_cache_p, sizeof(lv_font_fmt_txt_cache_t));
+    lv_mutex_init(&glyph_cache_p->lock);
+
+    glyph_cache_p->cache = lv_cache_create(&lv_cache_class_lru_rb_size,
+    sizeof(glyph_cache_data_t), LV_FONT_FMT_TXT_CACHE_SIZE, (lv_cache_ops_t) {
+        .compare_cb = (lv_cache_compare_cb_t)glyph_cache_compare_cb,
+        .create_cb = (lv_cache_create_cb_t)glyph_cache_create_cb,
+        .free_cb = (lv_cache_free_cb_t)glyph_cache_free_cb,
+    });
+    LV_ASSERT_MALLOC(glyph_cache_p->cache);
+}
+
+void _lv_font_fmt_txt_cache_deinit(void)
+{
+    if(glyph_cache_p->cache) lv_cache_destroy(glyph_cache_p->cache, NULL);
+    glyph_cache_p->cache = NULL;
+    lv_mutex_delete(&glyph_cache_p->lock);
+}
+
+void lv_font_fmt_txt_set_cache_size(uint32_t size)
+{
+    if(glyph_cache_p->cache == NULL) return;
+
+    /*Drop first, so that the new budget is kept even if it's smaller than what's cached now*/
+    lv_cache_drop_all(glyph_cache_p->cache, NULL);
+    lv_cache_set_max_size(glyph_cache_p->cache, size, NULL);
+}
+
+void lv_font_fmt_txt_drop_cache(void)
+{
+    if(glyph_cache_p->cache == NULL) return;
+
+    lv_cache_drop_all(glyph_cache_p->cache, NULL);
+}
+
+void lv_font_fmt_txt_get_cache_stats(lv_font_fmt_txt_cache_stats_t * stats)
+{
+    LV_ASSERT_NULL(stats);
+
+    lv_memzero(stats, sizeof(lv_font_fmt_txt_cache_stats_t));
+    if(glyph_cache_p->cache == NULL) return;
+
+    lv_mutex_lock(&glyph_cache_p->lock);
+    stats->hit_cnt = glyph_cache_p->hit_cnt;
+    stats->miss_cnt = glyph_cache_p->miss_cnt;
+    lv_mutex_unlock(&glyph_cache_p->lock);
+
+    stats->size = lv_cache_get_size(glyph_cache_p->cache, NULL);
+    stats->max_size = lv_cache_get_max_size(glyph_cache_p->cache, NULL);
+}
+
+void lv_font_fmt_txt_reset_cache_stats(void)
+{
+    lv_mutex_lock(&glyph_cache_p->lock);
+    glyph_cache_p->hit_cnt = 0;
+    glyph_cache_p->miss_cnt = 0;
+    lv_mutex_unlock(&glyph_cache_p->lock);
+}
+
+#endif /*LV_FONT_FMT_TXT_CACHE_SIZE*/
+
+#if LV_USE_FONT_FMT_TXT_LUT
+
+lv_result_t lv_font_fmt_txt_create_lut(const lv_font_t * font)
+{
+    LV_ASSERT_NULL(font);
+
+    if(font->get_glyph_dsc != lv_font_get_glyph_dsc_fmt_txt || font->dsc == NULL) return LV_RESULT_INVALID;
+    if(lut_find(font)) return LV_RESULT_OK;
+
+    lv_font_fmt_txt_lut_t * lut = lv_malloc_zeroed(sizeof(lv_font_fmt_txt_lut_t));
+    LV_ASSERT_MALLOC(lut);
+    if(lut == NULL) return LV_RESULT_INVALID;
+
+    lut->font = font;
+    if(lut_build(lut, font->dsc) != LV_RESULT_OK) {
+        lut_free(lut);
+        return LV_RESULT_INVALID;
+    }
+
+    lut->next = lut_head;
+    lut_head = lut;
+
+    return LV_RESULT_OK;
+}
+
+void lv_font_fmt_txt_delete_lut(const lv_font_t * font)
+{
+    lv_font_fmt_txt_lut_t ** prev_next = &lut_head;
+    while(*prev_next) {
+        lv_font_fmt_txt_lut_t * lut = *prev_next;
+        if(lut->font == font) {
+            *prev_next = lut->next;
+            lut_free(lut);
+            return;
+        }
+        prev_next = &lut->next;
+    }
+}
+
+uint32_t lv_font_fmt_txt_get_lut_size(const lv_font_t * font)
+{
+    const lv_font_fmt_txt_lut_t * lut = lut_find(font);
+    if(lut == NULL) return 0;
+
+    uint32_t size = sizeof(lv_font_fmt_txt_lut_t);
+    if(lut->letters) size += (lut->mask + 1) * (sizeof(lut->letters[0]) + sizeof(lut->gids[0]));
+    return size;
+}
+
+void _lv_font_fmt_txt_lut_deinit(void)
+{
+    while(lut_head) {
+        lv_font_fmt_txt_lut_t * lut = lut_head;
+        lut_head = lut->next;
+        lut_free(lut);
+    }
+}
+
+#endif /*LV_USE_FONT_FMT_TXT_LUT*/
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Convert the bitmap of a glyph to A8
+ * @param fdsc          descriptor of the font
+ * @param gdsc          descriptor of the glyph
+ * @param bitmap_out    store the bitmap here, its stride is `lv_draw_buf_width_to_stride(box_w, LV_COLOR_FORMAT_A8)`
+ * @return              true: converted; false: the bitmap format is not supported
+ */
+static bool decode_glyph(const lv_font_fmt_txt_dsc_t * fdsc, const lv_font_fmt_txt_glyph_dsc_t * gdsc,
+                         uint8_t * bitmap_out)
+{
     if(fdsc->bitmap_format == LV_FONT_FMT_TXT_PLAIN) {
         const uint8_t * bitmap_in = &fdsc->glyph_bitmap[gdsc->bitmap_index];
         uint8_t * bitmap_out_tmp = bitmap_out;
@@ -149,7 +392,7 @@ const void * lv_font_get_bitmap_fmt_txt(lv_font_glyph_dsc_t * g_dsc, uint32_t un
                 bitmap_out_tmp += stride;
             }
         }
-        return draw_buf;
+        return true;
     }
     /*Handle compressed bitmap*/
     else {
@@ -157,71 +400,117 @@ const void * lv_font_get_bitmap_fmt_txt(lv_font_glyph_dsc_t * g_dsc, uint32_t un
         bool prefilter = fdsc->bitmap_format == LV_FONT_FMT_TXT_COMPRESSED;
         decompress(&fdsc->glyph_bitmap[gdsc->bitmap_index], bitmap_out, gdsc->box_w, gdsc->box_h,
                    (uint8_t)fdsc->bpp, prefilter);
-        return draw_buf;
+        return true;
 #else /*!LV_USE_FONT_COMPRESSED*/
         LV_LOG_WARN("Compressed fonts is used but LV_USE_FONT_COMPRESSED is not enabled in lv_conf.h");
-        return NULL;
+        return false;
 #endif
     }
 
-    /*If not returned earlier then the letter is not found in this font*/
-    return NULL;
+
+    return false;
 }
 
-bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t * dsc_out, uint32_t unicode_letter,
-                                   uint32_t unicode_letter_next)
-{
-    /*It fixes a strange compiler optimization issue: https://github.com/lvgl/lvgl/issues/4370*/
-    bool is_tab = unicode_letter == '\t';
-    if(is_tab) {
-        unicode_letter = ' ';
-    }
-    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
-    uint32_t gid = get_glyph_dsc_id(font, unicode_letter);
-    if(!gid) return false;
+#if LV_FONT_FMT_TXT_CACHE_SIZE
 
-    int8_t kvalue = 0;
-    if(fdsc->kern_dsc) {
-        uint32_t gid_next = get_glyph_dsc_id(font, unicode_letter_next);
-        if(gid_next) {
-            kvalue = get_kern_value(font, gid, gid_next);
-        }
-    }
+/**
+ * Copy the A8 bitmap of a glyph from the cache, decoding and adding it first if it's not there
+ * @param font          pointer to a font in the native format
+ * @param gid           ID of a glyph with a bitmap in `font`
+ * @param bitmap_out    store the bitmap here, its stride is `lv_draw_buf_width_to_stride(box_w, LV_COLOR_FORMAT_A8)`
+ * @return              LV_RESULT_OK: copied; LV_RESULT_INVALID: the cache is disabled or the glyph doesn't fit,
+ *                      decode it directly
+ */
+static lv_result_t get_cached_bitmap(const lv_font_t * font, uint32_t gid, uint8_t * bitmap_out)
+{
+    if(glyph_cache_p->cache == NULL) return LV_RESULT_INVALID;
 
-    /*Put together a glyph dsc*/
+    const lv_font_fmt_txt_dsc_t * fdsc = (const lv_font_fmt_txt_dsc_t *)font->dsc;
     const lv_font_fmt_txt_glyph_dsc_t * gdsc = &fdsc->glyph_dsc[gid];
 
-    int32_t kv = ((int32_t)((int32_t)kvalue * fdsc->kern_scale) >> 4);
+    glyph_cache_data_t search_key;
+    lv_memzero(&search_key, sizeof(search_key));
+    search_key.font = font;
+    search_key.gid = gid;
+    search_key.bpp = (uint8_t)fdsc->bpp;
+    search_key.slot.size = lv_draw_buf_width_to_stride(gdsc->box_w, LV_COLOR_FORMAT_A8) * gdsc->box_h;
 
-    uint32_t adv_w = gdsc->adv_w;
-    if(is_tab) adv_w *= 2;
+    /*The cache refuses (and logs) entries larger than its budget, which is 0 if disabled*/
+    if(search_key.slot.size > lv_cache_get_max_size(glyph_cache_p->cache, NULL)) return LV_RESULT_INVALID;
 
-    adv_w += kv;
-    adv_w  = (adv_w + (1 << 3)) >> 4;
+    /*The bitmap is decoded in `glyph_cache_create_cb()` under the cache's lock*/
+    bool decoded = false;
+    lv_cache_entry_t * entry = lv_cache_acquire_or_create(glyph_cache_p->cache, &search_key, &decoded);
+    if(entry == NULL) return LV_RESULT_INVALID;
 
-    dsc_out->adv_w = adv_w;
-    dsc_out->box_h = gdsc->box_h;
-    dsc_out->box_w = gdsc->box_w;
-    dsc_out->ofs_x = gdsc->ofs_x;
-    dsc_out->ofs_y = gdsc->ofs_y;
-    dsc_out->format = (uint8_t)fdsc->bpp;
-    dsc_out->is_placeholder = false;
+    lv_mutex_lock(&glyph_cache_p->lock);
+    if(decoded) glyph_cache_p->miss_cnt++;
+    else glyph_cache_p->hit_cnt++;
+    lv_mutex_unlock(&glyph_cache_p->lock);
 
-    if(is_tab) dsc_out->box_w = dsc_out->box_w * 2;
+    glyph_cache_data_t * cached = lv_cache_entry_get_data(entry);
+    lv_memcpy(bitmap_out, cached->bitmap, cached->slot.size);
+    lv_cache_release(glyph_cache_p->cache, entry, NULL);
+
+    return LV_RESULT_OK;
+}
 
+static lv_cache_compare_res_t glyph_cache_compare_cb(const glyph_cache_data_t * lhs, const glyph_cache_data_t * rhs)
+{
+    if(lhs->font != rhs->font) return lhs->font > rhs->font ? 1 : -1;
+    if(lhs->gid != rhs->gid) return lhs->gid > rhs->gid ? 1 : -1;
+    if(lhs->bpp != rhs->bpp) return lhs->bpp > rhs->bpp ? 1 : -1;
+    return 0;
+}
+
+static bool glyph_cache_create_cb(glyph_cache_data_t * node, void * user_data)
+{
+    const lv_font_fmt_txt_dsc_t * fdsc = (const lv_font_fmt_txt_dsc_t *)node->font->dsc;
+
+    node->bitmap = lv_malloc(node->slot.size);
+    LV_ASSERT_MALLOC(node->bitmap);
+    if(node->bitmap == NULL) return false;
+
+    if(!decode_glyph(fdsc, &fdsc->glyph_dsc[node->gid], node->bitmap)) {
+        lv_free(node->bitmap);
+        node->bitmap = NULL;
+        return false;
+    }
+
+    *(bool *)user_data = true;
     return true;
 }
 
-/**********************
- *   STATIC FUNCTIONS
- **********************/
+static void glyph_cache_free_cb(glyph_cache_data_t * node, void * user_data)
+{
+    LV_UNUSED(user_data);
+
+    lv_free(node->bitmap);
+    node->bitmap = NULL;
+}
+
+#endif /*LV_FONT_FMT_TXT_CACHE_SIZE*/
 
 static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
 {
     if(letter == '\0') return 0;
 
-    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
+#if LV_USE_FONT_FMT_TXT_LUT
+    const lv_font_fmt_txt_lut_t * lut = lut_find(font);
+    if(lut) return lut_get(lut, letter);
+#endif
+
+    return search_cmaps((const lv_font_fmt_txt_dsc_t *)font->dsc, letter);
+}
 
+/**
+ * Find the glyph of a code point in the cmaps of a font
+ * @param fdsc      descriptor of the font
+ * @param letter    a UNICODE code point
+ * @return          the ID of the glyph, 0 if the font doesn't have it
+ */
+static uint32_t search_cmaps(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t letter)
+{
     uint16_t i;
     for(i = 0; i < fdsc->cmap_num; i++) {
 
@@ -265,6 +554,126 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
 
 }
 
+#if LV_USE_FONT_FMT_TXT_LUT
+
+/**
+ * Fill the lookup table of a font from its cmaps
+ * @param lut       a zeroed table
+ * @param fdsc      descriptor of the font
+ * @return          LV_RESULT_OK: built; LV_RESULT_INVALID: out of memory or a glyph ID doesn't fit into 16 bits
+ */
+static lv_result_t lut_build(lv_font_fmt_txt_lut_t * lut, const lv_font_fmt_txt_dsc_t * fdsc)
+{
+    uint32_t letter;
+    for(letter = 1; letter < LUT_DIRECT_CNT; letter++) {
+        uint32_t gid = search_cmaps(fdsc, letter);
+        if(gid > UINT16_MAX) return LV_RESULT_INVALID;
+        lut->direct[letter] = (uint16_t)gid;
+    }
+
+    /*Count the code points first to size the hash table, at most 3/4 of the slots are used*/
+    uint32_t cnt = 0;
+    lut_add_cmaps(lut, fdsc, &cnt);
+    if(cnt == 0) return LV_RESULT_OK;
+
+    uint32_t slot_cnt = 8;
+    uint8_t shift = 32 - 3;
+    while(slot_cnt < cnt + cnt / 3 + 1) {
+        slot_cnt <<= 1;
+        shift--;
+    }
+
+    lut->letters = lv_malloc_zeroed(slot_cnt * sizeof(lut->letters[0]));
+    lut->gids = lv_malloc(slot_cnt * sizeof(lut->gids[0]));
+    LV_ASSERT_MALLOC(lut->letters);
+    LV_ASSERT_MALLOC(lut->gids);
+    if(lut->letters == NULL || lut->gids == NULL) return LV_RESULT_INVALID;
+
+    lut->mask = slot_cnt - 1;
+    lut->shift = shift;
+
+    return lut_add_cmaps(lut, fdsc, NULL);
+}
+
+/**
+ * Go through the code points above U+00FF which are in the range of a cmap
+ * @param lut       count them if `cnt` is not NULL, else add their glyphs to the hash table of `lut`
+ * @param fdsc      descriptor of the font
+ * @param cnt       if not NULL, store the number of code points here
+ * @return          LV_RESULT_OK or LV_RESULT_INVALID if a glyph ID doesn't fit into 16 bits
+ */
+static lv_result_t lut_add_cmaps(lv_font_fmt_txt_lut_t * lut, const lv_font_fmt_txt_dsc_t * fdsc, uint32_t * cnt)
+{
+    uint16_t i;
+    for(i = 0; i < fdsc->cmap_num; i++) {
+        const lv_font_fmt_txt_cmap_t * cmap = &fdsc->cmaps[i];
+        bool sparse = cmap->type == LV_FONT_FMT_TXT_CMAP_SPARSE_TINY || cmap->type == LV_FONT_FMT_TXT_CMAP_SPARSE_FULL;
+        uint32_t len = sparse ? cmap->list_length : cmap->range_length;
+        uint32_t j;
+        for(j = 0; j < len; j++) {
+            uint32_t letter = cmap->range_start + (sparse ? cmap->unicode_list[j] : j);
+            if(letter < LUT_DIRECT_CNT) continue;
+
+            if(cnt) (*cnt)++;
+            else if(lut_insert(lut, fdsc, letter) != LV_RESULT_OK) return LV_RESULT_INVALID;
+        }
+    }
+
+    return LV_RESULT_OK;
+}
+
+/**
+ * Add the glyph of a code point to the hash table.
+ * The glyph is searched like without the table, so overlapping cmaps resolve the same.
+ */
+static lv_result_t lut_insert(lv_font_fmt_txt_lut_t * lut, const lv_font_fmt_txt_dsc_t * fdsc, uint32_t letter)
+{
+    uint32_t gid = search_cmaps(fdsc, letter);
+    if(gid == 0) return LV_RESULT_OK;
+    if(gid > UINT16_MAX) return LV_RESULT_INVALID;
+
+    uint32_t i = (letter * LUT_HASH_MUL) >> lut->shift;
+    while(lut->letters[i]) {
+        if(lut->letters[i] == letter) return LV_RESULT_OK;
+        i = (i + 1) & lut->mask;
+    }
+
+    lut->letters[i] = letter;
+    lut->gids[i] = (uint16_t)gid;
+    return LV_RESULT_OK;
+}
+
+static inline const lv_font_fmt_txt_lut_t * lut_find(const lv_font_t * font)
+{
+    const lv_font_fmt_txt_lut_t * lut = lut_head;
+    while(lut && lut->font != font) lut = lut->next;
+    return lut;
+}
+
+static inline uint32_t lut_get(const lv_font_fmt_txt_lut_t * lut, uint32_t letter)
+{
+    if(letter < LUT_DIRECT_CNT) return lut->direct[letter];
+    if(lut->letters == NULL) return 0;
+
+    /*There is always an empty slot to stop at*/
+    uint32_t i = (letter * LUT_HASH_MUL) >> lut->shift;
+    while(lut->letters[i]) {
+        if(lut->letters[i] == letter) return lut->gids[i];
+        i = (i + 1) & lut->mask;
+    }
+
+    return 0;
+}
+
+static void lut_free(lv_font_fmt_txt_lut_t * lut)
+{
+    lv_free(lut->letters);
+    lv_free(lut->gids);
+    lv_free(lut);
+}
+
+#endif /*LV_USE_FONT_FMT_TXT_LUT*/
+
 static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t gid_right)
 {
     lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
@@ -17,6 +17,8 @@ extern "C" {
 #include <stddef.h>
 #include <stdbool.h>
 #include "lv_font.h"
+#include "../osal/lv_os.h"
+#include "../misc/cache/lv_cache.h"
 
 /*********************
  *      DEFINES
@@ -210,6 +212,26 @@ typedef struct {
 } lv_font_fmt_rle_t;
 #endif
 
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+typedef struct {
+    uint32_t hit_cnt;       /**< Glyphs copied from the cache*/
+    uint32_t miss_cnt;      /**< Glyphs decoded and added to the cache*/
+    uint32_t size;          /**< Bytes of bitmaps in the cache now*/
+    uint32_t max_size;      /**< The budget, see `lv_font_fmt_txt_set_cache_size()`*/
+} lv_font_fmt_txt_cache_stats_t;
+
+typedef struct {
+    lv_cache_t * cache;     /**< Decoded A8 bitmaps by font, glyph ID and bpp*/
+    lv_mutex_t lock;        /**< Protects the counters*/
+    uint32_t hit_cnt;
+    uint32_t miss_cnt;
+} lv_font_fmt_txt_cache_t;
+#endif
+
+#if LV_USE_FONT_FMT_TXT_LUT
+typedef struct _lv_font_fmt_txt_lut_t lv_font_fmt_txt_lut_t;
+#endif
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -236,6 +258,76 @@ const void * lv_font_get_bitmap_fmt_txt(lv_font_glyph_dsc_t * g_dsc, uint32_t un
 bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t * dsc_out, uint32_t unicode_letter,
                                    uint32_t unicode_letter_next);
 
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+
+/**
+ * Create the glyph bitmap cache with `LV_FONT_FMT_TXT_CACHE_SIZE` budget. Called by `lv_init()`.
+ */
+void _lv_font_fmt_txt_cache_init(void);
+
+/**
+ * Free the glyph bitmap cache. Called by `lv_deinit()`.
+ */
+void _lv_font_fmt_txt_cache_deinit(void);
+
+/**
+ * Set the memory budget of the glyph bitmap cache. The cached glyphs are dropped.
+ * @param size      the budget in bytes, 0: decode the glyphs every time they are drawn
+ */
+void lv_font_fmt_txt_set_cache_size(uint32_t size);
+
+/**
+ * Drop all the glyphs from the cache, e.g. because a font was freed whose address might be reused
+ */
+void lv_font_fmt_txt_drop_cache(void);
+
+/**
+ * Get the statistics of the glyph bitmap cache
+ * @param stats     store the counters since the last `lv_font_fmt_txt_reset_cache_stats()` and the sizes here
+ */
+void lv_font_fmt_txt_get_cache_stats(lv_font_fmt_txt_cache_stats_t * stats);
+
+/**
+ * Reset the hit and miss counters of the glyph bitmap cache
+ */
+void lv_font_fmt_txt_reset_cache_stats(void);
+
+#endif /*LV_FONT_FMT_TXT_CACHE_SIZE*/
+
+#if LV_USE_FONT_FMT_TXT_LUT
+
+/**
+ * Build a table to find the glyphs of a font in constant time instead of searching its cmaps.
+ * U+0000..U+00FF are looked up directly, the other code points of the font are hashed.
+ * It pays off for fonts with large or sparse cmaps, e.g. Latin text with symbols or CJK. For glyphs
+ * in a few short ranges the cmap search is about as fast.
+ * Call it when no rendering is in progress, e.g. after loading the font.
+ * @param font      a font in LVGL's own format, e.g. a built-in one or one from `lv_binfont_create()`
+ * @return          LV_RESULT_OK: built or already had one; LV_RESULT_INVALID: not such a font or out of memory
+ */
+lv_result_t lv_font_fmt_txt_create_lut(const lv_font_t * font);
+
+/**
+ * Delete the lookup table of a font, its glyphs are searched in the cmaps again.
+ * Call it when no rendering is in progress. `lv_binfont_destroy()` calls it too.
+ * @param font      pointer to a font
+ */
+void lv_font_fmt_txt_delete_lut(const lv_font_t * font);
+
+/**
+ * Get the memory used by the lookup table of a font
+ * @param font      pointer to a font
+ * @return          the size in bytes, 0 if the font has no table
+ */
+uint32_t lv_font_fmt_txt_get_lut_size(const lv_font_t * font);
+
+/**
+ * Delete the lookup tables of all fonts. Called by `lv_deinit()`.
+ */
+void _lv_font_fmt_txt_lut_deinit(void);
+
+#endif /*LV_USE_FONT_FMT_TXT_LUT*/
+
 /**********************
  *      MACROS
  **********************/
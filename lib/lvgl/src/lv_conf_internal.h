@@ -26,6 +26,8 @@
 #define LV_DRAW_SW_ASM_NONE         0
 #define LV_DRAW_SW_ASM_NEON         1
 #define LV_DRAW_SW_ASM_HELIUM       2
+#define LV_DRAW_SW_ASM_X86          3
+#define LV_DRAW_SW_ASM_VECTOR       4
 #define LV_DRAW_SW_ASM_CUSTOM       255
 
 /* Handle special Kconfig options */
@@ -263,6 +265,36 @@
     #endif
 #endif
 
+/*Index the pending draw tasks of a layer in a grid of this many cells (e.g. 64) to find the tasks a task overlaps faster, 0: check all of them*/
+#ifndef LV_DRAW_TASK_INDEX_CELLS
+    #ifdef CONFIG_LV_DRAW_TASK_INDEX_CELLS
+        #define LV_DRAW_TASK_INDEX_CELLS CONFIG_LV_DRAW_TASK_INDEX_CELLS
+    #else
+        #define LV_DRAW_TASK_INDEX_CELLS    0
+    #endif
+#endif
+
+/*The draw tasks of a layer, their descriptors and label texts are allocated in chunks of this size
+ *(e.g. 4 * 1024) which are reused when all the tasks of the layer are finished, instead of `lv_malloc()`
+ *one by one. 0: allocate and free them one by one*/
+#ifndef LV_DRAW_ARENA_CHUNK_SIZE
+    #ifdef CONFIG_LV_DRAW_ARENA_CHUNK_SIZE
+        #define LV_DRAW_ARENA_CHUNK_SIZE CONFIG_LV_DRAW_ARENA_CHUNK_SIZE
+    #else
+        #define LV_DRAW_ARENA_CHUNK_SIZE    0   /*[bytes]*/
+    #endif
+#endif
+
+/*Don't render what's covered anyway: when all the draw tasks of a layer are added, drop or clip
+ *the ones under a newer opaque fill or image. See `lv_display_set_draw_cull()`*/
+#ifndef LV_USE_DRAW_CULL
+    #ifdef CONFIG_LV_USE_DRAW_CULL
+        #define LV_USE_DRAW_CULL CONFIG_LV_USE_DRAW_CULL
+    #else
+        #define LV_USE_DRAW_CULL            0
+    #endif
+#endif
+
 #ifndef LV_USE_DRAW_SW
     #ifdef _LV_KCONFIG_PRESENT
         #ifdef CONFIG_LV_USE_DRAW_SW
@@ -762,6 +794,16 @@
     #endif
 #endif
 
+/*1: Count the blends of every pixel and the invalidations of every object,
+ *see `lv_refr_heatmap_enable()`*/
+#ifndef LV_USE_REFR_HEATMAP
+    #ifdef CONFIG_LV_USE_REFR_HEATMAP
+        #define LV_USE_REFR_HEATMAP CONFIG_LV_USE_REFR_HEATMAP
+    #else
+        #define LV_USE_REFR_HEATMAP 0
+    #endif
+#endif
+
 /*1: Draw a red overlay for ARGB layers and a green overlay for RGB layers*/
 #ifndef LV_USE_LAYER_DEBUG
     #ifdef CONFIG_LV_USE_LAYER_DEBUG
@@ -826,6 +868,18 @@
     #endif
 #endif
 
+/*Objects with `LV_OBJ_FLAG_RENDER_CACHE` are rendered once with their children into a buffer and drawn
+ *from it until something in them changes. The buffers are accounted in the image cache (`LV_CACHE_DEF_SIZE`
+ *has to be > 0) and this is the limit for all of them, keep it below `LV_CACHE_DEF_SIZE`.
+ *0: ignore the flag*/
+#ifndef LV_OBJ_RENDER_CACHE_SIZE
+    #ifdef CONFIG_LV_OBJ_RENDER_CACHE_SIZE
+        #define LV_OBJ_RENDER_CACHE_SIZE CONFIG_LV_OBJ_RENDER_CACHE_SIZE
+    #else
+        #define LV_OBJ_RENDER_CACHE_SIZE 0
+    #endif
+#endif
+
 /*Number of stops allowed per gradient. Increase this to allow more stops.
  *This adds (sizeof(lv_color_t) + 1) bytes per additional stop*/
 #ifndef LV_GRADIENT_MAX_STOPS
@@ -958,7 +1012,7 @@
     #endif
 #endif
 
-/*Define a custom attribute to `lv_tick_inc` function*/
+/*Define a custom attribute to `lv_tick_inc` and `lv_tick_get` functions*/
 #ifndef LV_ATTRIBUTE_TICK_INC
     #ifdef CONFIG_LV_ATTRIBUTE_TICK_INC
         #define LV_ATTRIBUTE_TICK_INC CONFIG_LV_ATTRIBUTE_TICK_INC
@@ -976,7 +1030,8 @@
     #endif
 #endif
 
-/*Define a custom attribute to `lv_display_flush_ready` function*/
+/*Define a custom attribute to `lv_display_flush_ready` function,
+ *e.g. `IRAM_ATTR` on ESP32 if it's called from a DMA interrupt (set `LV_ATTRIBUTE_TICK_INC` too)*/
 #ifndef LV_ATTRIBUTE_FLUSH_READY
     #ifdef CONFIG_LV_ATTRIBUTE_FLUSH_READY
         #define LV_ATTRIBUTE_FLUSH_READY CONFIG_LV_ATTRIBUTE_FLUSH_READY
@@ -1300,6 +1355,27 @@
     #endif
 #endif
 
+/*Size of the cache of decoded glyph bitmaps in bytes, 0: disable it.
+ *The A8 bitmaps of the built-in and the loaded fonts are kept by font, glyph and bpp,
+ *so e.g. the glyphs of compressed fonts are decompressed once instead of every time they are drawn.*/
+#ifndef LV_FONT_FMT_TXT_CACHE_SIZE
+    #ifdef CONFIG_LV_FONT_FMT_TXT_CACHE_SIZE
+        #define LV_FONT_FMT_TXT_CACHE_SIZE CONFIG_LV_FONT_FMT_TXT_CACHE_SIZE
+    #else
+        #define LV_FONT_FMT_TXT_CACHE_SIZE 0
+    #endif
+#endif
+
+/*Enable `lv_font_fmt_txt_create_lut()` to find the glyphs of a font in constant time:
+ *U+0000..U+00FF from a table, the other code points from a hash table, instead of searching the cmaps.*/
+#ifndef LV_USE_FONT_FMT_TXT_LUT
+    #ifdef CONFIG_LV_USE_FONT_FMT_TXT_LUT
+        #define LV_USE_FONT_FMT_TXT_LUT CONFIG_LV_USE_FONT_FMT_TXT_LUT
+    #else
+        #define LV_USE_FONT_FMT_TXT_LUT 0
+    #endif
+#endif
+
 /*Enable drawing placeholders when glyph dsc is not found*/
 #ifndef LV_USE_FONT_PLACEHOLDER
     #ifdef _LV_KCONFIG_PRESENT
@@ -2473,6 +2549,35 @@
         #endif
     #endif
 
+    /*1: Measure the time from an input (see `lv_sysmon_latency_input()`) until the refresh
+     * showing it was flushed. Cheap enough to keep enabled in production.
+     * Requires `LV_USE_SYSMON = 1`*/
+    #ifndef LV_USE_LATENCY_MONITOR
+        #ifdef CONFIG_LV_USE_LATENCY_MONITOR
+            #define LV_USE_LATENCY_MONITOR CONFIG_LV_USE_LATENCY_MONITOR
+        #else
+            #define LV_USE_LATENCY_MONITOR 0
+        #endif
+    #endif
+    #if LV_USE_LATENCY_MONITOR
+        #ifndef LV_USE_LATENCY_MONITOR_POS
+            #ifdef CONFIG_LV_USE_LATENCY_MONITOR_POS
+                #define LV_USE_LATENCY_MONITOR_POS CONFIG_LV_USE_LATENCY_MONITOR_POS
+            #else
+                #define LV_USE_LATENCY_MONITOR_POS LV_ALIGN_TOP_RIGHT
+            #endif
+        #endif
+
+        /*0: Displays the latency on the screen, 1: Prints it using log, 2: Only the `lv_sysmon_get_latency()` API*/
+        #ifndef LV_USE_LATENCY_MONITOR_LOG_MODE
+            #ifdef CONFIG_LV_USE_LATENCY_MONITOR_LOG_MODE
+                #define LV_USE_LATENCY_MONITOR_LOG_MODE CONFIG_LV_USE_LATENCY_MONITOR_LOG_MODE
+            #else
+                #define LV_USE_LATENCY_MONITOR_LOG_MODE 0
+            #endif
+        #endif
+    #endif
+
 #endif /*LV_USE_SYSMON*/
 
 /*1: Enable the runtime performance profiler*/
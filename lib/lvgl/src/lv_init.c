@@ -203,6 +203,14 @@ void lv_init(void)
     _lv_image_decoder_init();
     lv_bin_decoder_init();  /*LVGL built-in binary image decoder*/
 
+#if LV_OBJ_RENDER_CACHE_SIZE
+    _lv_obj_render_cache_init();
+#endif
+
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+    _lv_font_fmt_txt_cache_init();
+#endif
+
 #if LV_USE_DRAW_VG_LITE
     lv_draw_vg_lite_init();
 #endif
@@ -358,6 +366,14 @@ void lv_deinit(void)
 
     _lv_image_decoder_deinit();
 
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+    _lv_font_fmt_txt_cache_deinit();
+#endif
+
+#if LV_USE_FONT_FMT_TXT_LUT
+    _lv_font_fmt_txt_lut_deinit();
+#endif
+
     _lv_refr_deinit();
 
     _lv_obj_style_deinit();
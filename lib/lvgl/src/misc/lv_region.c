@@ -0,0 +1,267 @@
+/**
+ * @file lv_region.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_region.h"
+#include "lv_assert.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/*Pieces waiting to be added while cutting an area around the others*/
+#define PENDING_MAX 16
+
+/*Areas processed by one addition per area of capacity before only merging*/
+#define SPLIT_BUDGET 8
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void add_one(lv_region_t * region, lv_area_t * a, lv_area_t * pending, uint32_t * pending_cnt,
+                    bool can_split);
+static void merge_cheapest(lv_region_t * region, lv_area_t * a);
+static bool merge_is_cheaper(const lv_region_t * region, const lv_area_t * a, uint32_t r_idx);
+static uint32_t subtract(lv_area_t res[], const lv_area_t * a, const lv_area_t * r);
+static void remove_area(lv_region_t * region, uint32_t i);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void _lv_region_init(lv_region_t * region, lv_area_t * areas, uint32_t capacity, uint32_t area_cost)
+{
+    LV_ASSERT_NULL(areas);
+    LV_ASSERT(capacity > 0);
+
+    region->areas = areas;
+    region->cnt = 0;
+    region->capacity = capacity;
+    region->area_cost = area_cost;
+    region->band_px = 0;
+}
+
+void _lv_region_set_cost(lv_region_t * region, uint32_t area_cost, uint32_t band_px)
+{
+    region->area_cost = area_cost;
+    region->band_px = band_px;
+}
+
+void _lv_region_clear(lv_region_t * region)
+{
+    region->cnt = 0;
+}
+
+void _lv_region_add(lv_region_t * region, const lv_area_t * area)
+{
+    lv_area_t pending[PENDING_MAX];
+    uint32_t pending_cnt = 0;
+
+    uint32_t budget = region->capacity * SPLIT_BUDGET;
+
+    pending[pending_cnt++] = *area;
+    while(pending_cnt > 0) {
+        pending_cnt--;
+        lv_area_t a = pending[pending_cnt];
+        add_one(region, &a, pending, &pending_cnt, budget > 0);
+        if(budget > 0) budget--;
+    }
+}
+
+uint64_t _lv_region_get_cost(const lv_region_t * region)
+{
+    uint64_t cost = 0;
+    uint32_t i;
+    for(i = 0; i < region->cnt; i++) {
+        cost += _lv_region_get_area_cost(region, &region->areas[i]);
+    }
+    return cost;
+}
+
+uint64_t _lv_region_get_area_cost(const lv_region_t * region, const lv_area_t * area)
+{
+    uint32_t bands = 1;
+    if(region->band_px) {
+        int32_t w = lv_area_get_width(area);
+        int32_t h = lv_area_get_height(area);
+        int32_t rows = (int32_t)(region->band_px / (uint32_t)w);
+        if(rows < 1) rows = 1;
+        bands = (uint32_t)((h + rows - 1) / rows);
+    }
+
+    return (uint64_t)lv_area_get_size(area) + (uint64_t)region->area_cost * bands;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Merge `a` with the areas where it's cheaper, then store it, or queue the pieces of it
+ * which are not covered by an overlapping area.
+ * Without `can_split` overlapping areas are merged, so the number of areas only decreases
+ * and the addition is guaranteed to end.
+ */
+static void add_one(lv_region_t * region, lv_area_t * a, lv_area_t * pending, uint32_t * pending_cnt,
+                    bool can_split)
+{
+    uint32_t i = 0;
+    while(i < region->cnt) {
+        lv_area_t * r = &region->areas[i];
+        if(_lv_area_is_in(a, r, 0)) return;
+
+        if(_lv_area_is_in(r, a, 0)) {
+            remove_area(region, i);
+            continue;
+        }
+
+        if(merge_is_cheaper(region, a, i)) {
+            _lv_area_join(a, a, r);
+            remove_area(region, i);
+            /*The larger area might be worth merging with the ones already checked*/
+            i = 0;
+            continue;
+        }
+        i++;
+    }
+
+    /*Keep the areas disjoint: queue the parts of `a` which are not covered yet*/
+    for(i = 0; i < region->cnt; i++) {
+        lv_area_t * r = &region->areas[i];
+        if(!_lv_area_is_on(a, r)) continue;
+
+        if(can_split && *pending_cnt + 4 <= PENDING_MAX) {
+            *pending_cnt += subtract(&pending[*pending_cnt], a, r);
+        }
+        else {
+            /*Too fragmented, draw the common bounding box*/
+            lv_area_t joined;
+            _lv_area_join(&joined, a, r);
+            remove_area(region, i);
+            pending[(*pending_cnt)++] = joined;
+        }
+        return;
+    }
+
+    if(region->cnt == region->capacity) {
+        merge_cheapest(region, a);
+        return;
+    }
+
+    region->areas[region->cnt++] = *a;
+}
+
+/**
+ * The region is full and `a` overlaps none of its areas: merge it with the area
+ * which adds the least cost, together with everything the result overlaps.
+ */
+static void merge_cheapest(lv_region_t * region, lv_area_t * a)
+{
+    uint32_t best = 0;
+    uint64_t best_added = UINT64_MAX;
+    uint32_t i;
+    for(i = 0; i < region->cnt; i++) {
+        lv_area_t joined;
+        _lv_area_join(&joined, a, &region->areas[i]);
+        uint64_t added = _lv_region_get_area_cost(region, &joined) -
+                         _lv_region_get_area_cost(region, &region->areas[i]);
+        if(added < best_added) {
+            best_added = added;
+            best = i;
+        }
+    }
+
+    _lv_area_join(a, a, &region->areas[best]);
+    remove_area(region, best);
+
+    i = 0;
+    while(i < region->cnt) {
+        if(_lv_area_is_on(a, &region->areas[i])) {
+            _lv_area_join(a, a, &region->areas[i]);
+            remove_area(region, i);
+            i = 0;
+            continue;
+        }
+        i++;
+    }
+
+    region->areas[region->cnt++] = *a;
+}
+
+/**
+ * Is drawing the bounding box of `a` and the `r_idx`th area cheaper than drawing them separately?
+ * Separately the common part is drawn only once, but there are more bands. The bounding box
+ * might need more bands too, if it's taller than a band.
+ * A bounding box which partly covers a third area doesn't count as cheaper: that area would
+ * cut it into pieces again, and those might merge back the same way forever.
+ */
+static bool merge_is_cheaper(const lv_region_t * region, const lv_area_t * a, uint32_t r_idx)
+{
+    const lv_area_t * r = &region->areas[r_idx];
+    lv_area_t joined;
+    _lv_area_join(&joined, a, r);
+
+    uint64_t separate = _lv_region_get_area_cost(region, a) + _lv_region_get_area_cost(region, r);
+    lv_area_t common;
+    if(_lv_area_intersect(&common, a, r)) separate -= lv_area_get_size(&common);
+
+    if(_lv_region_get_area_cost(region, &joined) > separate) return false;
+
+    uint32_t i;
+    for(i = 0; i < region->cnt; i++) {
+        if(i == r_idx) continue;
+        const lv_area_t * o = &region->areas[i];
+        if(_lv_area_is_on(&joined, o) && !_lv_area_is_on(a, o) && !_lv_area_is_in(o, &joined, 0)) return false;
+    }
+
+    return true;
+}
+
+/**
+ * The parts of `a` outside of `r`, in bands: above, below, then left and right of `r`.
+ * `a` and `r` have to overlap.
+ * @return the number of parts in `res` (max 4)
+ */
+static uint32_t subtract(lv_area_t res[], const lv_area_t * a, const lv_area_t * r)
+{
+    uint32_t cnt = 0;
+    int32_t y1 = a->y1;
+    int32_t y2 = a->y2;
+
+    if(a->y1 < r->y1) {
+        lv_area_set(&res[cnt++], a->x1, a->y1, a->x2, r->y1 - 1);
+        y1 = r->y1;
+    }
+    if(a->y2 > r->y2) {
+        lv_area_set(&res[cnt++], a->x1, r->y2 + 1, a->x2, a->y2);
+        y2 = r->y2;
+    }
+    if(a->x1 < r->x1) {
+        lv_area_set(&res[cnt++], a->x1, y1, r->x1 - 1, y2);
+    }
+    if(a->x2 > r->x2) {
+        lv_area_set(&res[cnt++], r->x2 + 1, y1, a->x2, y2);
+    }
+    return cnt;
+}
+
+static void remove_area(lv_region_t * region, uint32_t i)
+{
+    region->cnt--;
+    region->areas[i] = region->areas[region->cnt];
+}
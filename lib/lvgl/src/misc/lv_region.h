@@ -0,0 +1,104 @@
+/**
+ * @file lv_region.h
+ * A set of non-overlapping areas with a fixed capacity, e.g. the invalidated areas of a display.
+ * Adding an area merges it with the others when drawing their bounding box is cheaper
+ * than drawing them separately. The cost of an area is its pixel count plus a fixed cost
+ * per band (a flush, a walk of the object tree): an area is drawn in bands of at most
+ * `band_px` pixels. When the set is full the cheapest merge is done instead of
+ * invalidating everything.
+ */
+
+#ifndef LV_REGION_H
+#define LV_REGION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "lv_types.h"
+#include "lv_area.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/** Description of a region*/
+typedef struct {
+    lv_area_t * areas;      /**< Storage for `capacity` areas, the first `cnt` are used*/
+    uint32_t cnt;
+    uint32_t capacity;
+    uint32_t area_cost;     /**< Fixed cost of one more band, in pixels*/
+    uint32_t band_px;       /**< Max. pixels in a band, 0: an area is always drawn at once*/
+} lv_region_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Init an empty region. Areas are drawn at once until `_lv_region_set_cost()` says otherwise.
+ * @param region    pointer to an `lv_region_t` variable to initialize
+ * @param areas     storage for the areas, it has to live as long as the region
+ * @param capacity  the number of areas in `areas`, at least 1
+ * @param area_cost fixed cost of an area compared to the cost of one pixel
+ */
+void _lv_region_init(lv_region_t * region, lv_area_t * areas, uint32_t capacity, uint32_t area_cost);
+
+/**
+ * Set how areas are drawn. Used by the next additions.
+ * @param region    pointer to a region
+ * @param area_cost fixed cost of a band compared to the cost of one pixel
+ * @param band_px   max. pixels drawn in a band (e.g. the size of the draw buffer),
+ *                  full lines each. 0: areas are drawn at once.
+ */
+void _lv_region_set_cost(lv_region_t * region, uint32_t area_cost, uint32_t band_px);
+
+/**
+ * Remove all areas.
+ * @param region    pointer to a region
+ */
+void _lv_region_clear(lv_region_t * region);
+
+/**
+ * Add an area. It's merged with the areas where that's cheaper, and the rest of it is cut
+ * into pieces which don't overlap the others. The region covers `area` afterwards.
+ * Takes O(capacity) time amortized.
+ * @param region    pointer to a region
+ * @param area      the area to add
+ */
+void _lv_region_add(lv_region_t * region, const lv_area_t * area);
+
+/**
+ * Get the total cost: pixels plus the fixed cost of each band.
+ * @param region    pointer to a region
+ * @return          the cost
+ */
+uint64_t _lv_region_get_cost(const lv_region_t * region);
+
+/**
+ * Get the cost of drawing one area: its pixels plus the fixed cost of each band.
+ * @param region    pointer to a region
+ * @param area      an area
+ * @return          the cost
+ */
+uint64_t _lv_region_get_area_cost(const lv_region_t * region, const lv_area_t * area);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_REGION_H*/
@@ -0,0 +1,238 @@
+/**
+ * @file lv_refr_heatmap.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_refr_heatmap.h"
+#if LV_USE_REFR_HEATMAP
+
+#include "../../core/lv_refr.h"
+#include "../../display/lv_display_private.h"
+#include "../../stdlib/lv_string.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct _lv_refr_heatmap_t {
+    uint16_t * buf;
+    lv_refr_heatmap_obj_t * objs;
+    uint32_t obj_cap;
+    uint32_t obj_cnt;
+    lv_refr_heatmap_stats_t stats;
+} lv_refr_heatmap_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static lv_refr_heatmap_obj_t * find_obj(lv_refr_heatmap_t * hm, const lv_obj_t * obj);
+static size_t get_buf_size(lv_display_t * disp);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const char * reason_names[_LV_INV_REASON_LAST] = {
+    "content", "layout", "style", "state", "scroll", "tree", "display"
+};
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_refr_heatmap_enable(lv_display_t * disp, uint16_t * buf, lv_refr_heatmap_obj_t * objs, uint32_t obj_cnt)
+{
+    LV_ASSERT_NULL(disp);
+
+    if(disp->refr_heatmap == NULL) {
+        disp->refr_heatmap = lv_malloc(sizeof(lv_refr_heatmap_t));
+        LV_ASSERT_MALLOC(disp->refr_heatmap);
+        if(disp->refr_heatmap == NULL) return;
+    }
+
+    lv_refr_heatmap_t * hm = disp->refr_heatmap;
+    hm->buf = buf;
+    hm->objs = objs;
+    hm->obj_cap = objs ? obj_cnt : 0;
+    lv_refr_heatmap_reset(disp);
+
+    if(buf) {
+        lv_memzero(buf, get_buf_size(disp));
+    }
+}
+
+void lv_refr_heatmap_disable(lv_display_t * disp)
+{
+    LV_ASSERT_NULL(disp);
+
+    lv_free(disp->refr_heatmap);
+    disp->refr_heatmap = NULL;
+}
+
+void lv_refr_heatmap_reset(lv_display_t * disp)
+{
+    LV_ASSERT_NULL(disp);
+
+    lv_refr_heatmap_t * hm = disp->refr_heatmap;
+    if(hm == NULL) return;
+
+    hm->obj_cnt = 0;
+    lv_memzero(&hm->stats, sizeof(hm->stats));
+}
+
+const lv_refr_heatmap_obj_t * lv_refr_heatmap_get_objs(lv_display_t * disp, uint32_t * cnt)
+{
+    LV_ASSERT_NULL(disp);
+
+    lv_refr_heatmap_t * hm = disp->refr_heatmap;
+    *cnt = hm ? hm->obj_cnt : 0;
+    return hm ? hm->objs : NULL;
+}
+
+const lv_refr_heatmap_stats_t * lv_refr_heatmap_get_stats(lv_display_t * disp)
+{
+    LV_ASSERT_NULL(disp);
+
+    lv_refr_heatmap_t * hm = disp->refr_heatmap;
+    return hm ? &hm->stats : NULL;
+}
+
+const char * lv_refr_heatmap_reason_to_str(lv_inv_reason_t reason)
+{
+    if(reason >= _LV_INV_REASON_LAST) return "unknown";
+    return reason_names[reason];
+}
+
+void _lv_refr_heatmap_add_inv(lv_display_t * disp, const lv_obj_t * obj, lv_inv_reason_t reason,
+                              const lv_area_t * area)
+{
+    lv_refr_heatmap_t * hm = disp->refr_heatmap;
+    if(hm == NULL) return;
+
+    uint32_t px = lv_area_get_size(area);
+    hm->stats.inv_px += px;
+
+    lv_refr_heatmap_obj_t * o = find_obj(hm, obj);
+    if(o == NULL) {
+        hm->stats.dropped++;
+        return;
+    }
+
+    o->last_area = *area;
+    o->inv_cnt++;
+    o->inv_px += px;
+    if(reason < _LV_INV_REASON_LAST) o->reason_cnt[reason]++;
+}
+
+void _lv_refr_heatmap_frame_start(lv_display_t * disp)
+{
+    lv_refr_heatmap_t * hm = disp->refr_heatmap;
+    if(hm == NULL) return;
+
+    hm->stats.frames++;
+    hm->stats.max_blends = 0;
+
+    uint32_t i;
+    for(i = 0; i < disp->inv_region.cnt; i++) {
+        hm->stats.rendered_px += lv_area_get_size(&disp->inv_region.areas[i]);
+    }
+
+    if(hm->buf) {
+        lv_memzero(hm->buf, get_buf_size(disp));
+    }
+}
+
+void _lv_refr_heatmap_add_blend(const lv_area_t * area, const lv_opa_t * mask, int32_t mask_stride)
+{
+    lv_display_t * disp = _lv_refr_get_disp_refreshing();
+    if(disp == NULL || !disp->rendering_in_progress) return;
+
+    lv_refr_heatmap_t * hm = disp->refr_heatmap;
+    if(hm == NULL) return;
+
+    /*Layers can be partly outside of the screen*/
+    lv_area_t scr_area;
+    lv_area_t a;
+    int32_t hor_res = lv_display_get_horizontal_resolution(disp);
+    lv_area_set(&scr_area, 0, 0, hor_res - 1, lv_display_get_vertical_resolution(disp) - 1);
+    if(!_lv_area_intersect(&a, area, &scr_area)) return;
+
+    int32_t w = lv_area_get_width(&a);
+    if(mask) mask += (a.y1 - area->y1) * mask_stride + (a.x1 - area->x1);
+
+    if(hm->buf == NULL) {
+        if(mask == NULL) {
+            hm->stats.blended_px += lv_area_get_size(&a);
+            return;
+        }
+        int32_t y;
+        for(y = a.y1; y <= a.y2; y++) {
+            int32_t x;
+            for(x = 0; x < w; x++) hm->stats.blended_px += mask[x] != 0;
+            mask += mask_stride;
+        }
+        return;
+    }
+
+    uint32_t max = hm->stats.max_blends;
+    uint64_t blended = 0;
+    int32_t y;
+    for(y = a.y1; y <= a.y2; y++) {
+        uint16_t * row = &hm->buf[y * hor_res + a.x1];
+        int32_t x;
+        for(x = 0; x < w; x++) {
+            if(mask && mask[x] == 0) continue;
+            if(row[x] < UINT16_MAX) row[x]++;
+            if(row[x] > max) max = row[x];
+            blended++;
+        }
+        if(mask) mask += mask_stride;
+    }
+
+    hm->stats.max_blends = max;
+    hm->stats.blended_px += blended;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * The report of an object, a new one if it's not there yet.
+ * Objects are told apart by their class too, as a deleted object's memory can be reused.
+ * @return  the report, NULL if it's full
+ */
+static lv_refr_heatmap_obj_t * find_obj(lv_refr_heatmap_t * hm, const lv_obj_t * obj)
+{
+    const lv_obj_class_t * class_p = obj ? obj->class_p : NULL;
+
+    uint32_t i;
+    for(i = 0; i < hm->obj_cnt; i++) {
+        if(hm->objs[i].obj == obj && hm->objs[i].class_p == class_p) return &hm->objs[i];
+    }
+
+    if(hm->obj_cnt == hm->obj_cap) return NULL;
+
+    lv_refr_heatmap_obj_t * o = &hm->objs[hm->obj_cnt++];
+    lv_memzero(o, sizeof(*o));
+    o->obj = obj;
+    o->class_p = class_p;
+    return o;
+}
+
+static size_t get_buf_size(lv_display_t * disp)
+{
+    return (size_t)lv_display_get_horizontal_resolution(disp) * lv_display_get_vertical_resolution(disp) *
+           sizeof(uint16_t);
+}
+
+#endif /*LV_USE_REFR_HEATMAP*/
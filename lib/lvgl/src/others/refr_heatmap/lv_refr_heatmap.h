@@ -0,0 +1,134 @@
+/**
+ * @file lv_refr_heatmap.h
+ * Instrumentation of the refresh: how many times every pixel is blended in a frame (the
+ * overdraw), and which objects invalidate how much, and why.
+ * Counted by the software renderer, and not atomically: with more than one draw unit
+ * some blends might be lost.
+ */
+
+#ifndef LV_REFR_HEATMAP_H
+#define LV_REFR_HEATMAP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../../core/lv_obj.h"
+
+#if LV_USE_REFR_HEATMAP
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/** The invalidations of one object*/
+typedef struct {
+    const lv_obj_t * obj;                       /**< NULL: not an object, e.g. a screen load*/
+    const lv_obj_class_t * class_p;             /**< The class, also when the object is deleted since*/
+    lv_area_t last_area;                        /**< The last invalidated area, on the screen*/
+    uint32_t inv_cnt;                           /**< Number of invalidations*/
+    uint64_t inv_px;                            /**< Invalidated pixels, on the screen*/
+    uint32_t reason_cnt[_LV_INV_REASON_LAST];   /**< Invalidations per `lv_inv_reason_t`*/
+} lv_refr_heatmap_obj_t;
+
+typedef struct {
+    uint32_t frames;        /**< Refreshes which rendered something*/
+    uint64_t inv_px;        /**< Invalidated pixels, the same pixel as often as it was invalidated*/
+    uint64_t rendered_px;   /**< Pixels of the rendered areas*/
+    uint64_t blended_px;    /**< Blended pixels; divided by `rendered_px` it's the average overdraw*/
+    uint32_t max_blends;    /**< The most blends of one pixel in the last frame*/
+    uint32_t dropped;       /**< Invalidations not counted per object, the report was full*/
+} lv_refr_heatmap_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Start counting on a display. The counters are reset.
+ * @param disp      pointer to a display
+ * @param buf       `hor_res * ver_res` counters for the blends of every pixel, reset at the
+ *                  start of every frame, so it's the heatmap of the last one. NULL: only count
+ *                  the blends in the statistics.
+ * @param objs      storage for the report per object, NULL: no report
+ * @param obj_cnt   the number of objects in `objs`
+ * @note            Counting stops when the resolution changes, as the heatmap has the old size.
+ */
+void lv_refr_heatmap_enable(lv_display_t * disp, uint16_t * buf, lv_refr_heatmap_obj_t * objs, uint32_t obj_cnt);
+
+/**
+ * Stop counting on a display. The buffers can be freed afterwards.
+ * @param disp      pointer to a display
+ */
+void lv_refr_heatmap_disable(lv_display_t * disp);
+
+/**
+ * Reset the report and the statistics.
+ * @param disp      pointer to a display
+ */
+void lv_refr_heatmap_reset(lv_display_t * disp);
+
+/**
+ * Get the report per object, in the order the objects first invalidated something.
+ * @param disp      pointer to a display
+ * @param cnt       set to the number of objects in the report
+ * @return          the report, NULL if the display isn't counting
+ */
+const lv_refr_heatmap_obj_t * lv_refr_heatmap_get_objs(lv_display_t * disp, uint32_t * cnt);
+
+/**
+ * Get the statistics since the start or the last reset.
+ * @param disp      pointer to a display
+ * @return          the statistics, NULL if the display isn't counting
+ */
+const lv_refr_heatmap_stats_t * lv_refr_heatmap_get_stats(lv_display_t * disp);
+
+/**
+ * Get the name of an invalidation reason, e.g. "style".
+ * @param reason    an `lv_inv_reason_t`
+ * @return          the name
+ */
+const char * lv_refr_heatmap_reason_to_str(lv_inv_reason_t reason);
+
+/**
+ * Count an invalidation. Called by `_lv_inv_area_from()`.
+ * @param disp      the display
+ * @param obj       the invalidated object, NULL if not an object
+ * @param reason    why it was invalidated
+ * @param area      the invalidated area, on the screen
+ */
+void _lv_refr_heatmap_add_inv(lv_display_t * disp, const lv_obj_t * obj, lv_inv_reason_t reason,
+                              const lv_area_t * area);
+
+/**
+ * Start a frame: reset the heatmap and count the areas to render.
+ * @param disp      the display being refreshed
+ */
+void _lv_refr_heatmap_frame_start(lv_display_t * disp);
+
+/**
+ * Count a blend of the software renderer on the display being refreshed.
+ * @param area      the blended area, in screen coordinates
+ * @param mask      mask of the first pixel of `area`, NULL: every pixel is blended
+ * @param mask_stride   stride of `mask` in bytes
+ */
+void _lv_refr_heatmap_add_blend(const lv_area_t * area, const lv_opa_t * mask, int32_t mask_stride);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_REFR_HEATMAP*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_REFR_HEATMAP_H*/
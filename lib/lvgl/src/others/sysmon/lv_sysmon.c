@@ -12,6 +12,7 @@
 #if LV_USE_SYSMON
 
 #include "../../core/lv_global.h"
+#include "../../display/lv_display_private.h"
 #include "../../misc/lv_async.h"
 #include "../../stdlib/lv_string.h"
 #include "../../widgets/label/lv_label.h"
@@ -37,10 +38,52 @@
     #define _USE_MEM_MONITOR   0
 #endif
 
+#if defined(LV_USE_LATENCY_MONITOR) && LV_USE_LATENCY_MONITOR
+    #define sysmon_latency LV_GLOBAL_DEFAULT()->sysmon_latency
+    #define _USE_LATENCY_MONITOR   1
+#else
+    #define _USE_LATENCY_MONITOR   0
+#endif
+
+/*Latency histogram: 1 ms buckets below LATENCY_HIST_FINE, then 4 ms buckets. The last one collects the rest.*/
+#define LATENCY_HIST_FINE       64
+#define LATENCY_HIST_SHIFT      2
+#define LATENCY_HIST_SIZE       128
+
 /**********************
  *      TYPEDEFS
  **********************/
 
+#if _USE_LATENCY_MONITOR
+typedef struct {
+    uint32_t hist[LATENCY_HIST_SIZE];
+    uint32_t cnt;
+    uint64_t sum;
+    uint32_t min;
+    uint32_t max;
+} latency_hist_t;
+
+/*Inputs waiting for the same step of the pipeline*/
+typedef struct {
+    uint32_t input_cnt;     /*0: the slot is empty*/
+    uint32_t t_input;       /*Arrival of the oldest input*/
+    uint32_t t_refr;
+    uint32_t t_render;
+} latency_batch_t;
+
+typedef struct {
+    lv_display_t * disp;
+    latency_batch_t pending;    /*Applied, but no refresh started since*/
+    latency_batch_t active;     /*Drawn by the refresh in progress*/
+    latency_batch_t flushing;   /*Rendered, waiting for the last area to be flushed*/
+    latency_hist_t refr;
+    latency_hist_t render;
+    latency_hist_t flush;
+    uint32_t input_cnt;
+    bool updated;           /*Measured something since the last report*/
+} latency_info_t;
+#endif
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
@@ -55,6 +98,17 @@
     static void mem_observer_cb(lv_observer_t * observer, lv_subject_t * subject);
 #endif
 
+#if _USE_LATENCY_MONITOR
+    static void latency_disp_event_cb(lv_event_t * e);
+    static void latency_flush_done(latency_info_t * info, uint32_t t_flush);
+    static void latency_hist_add(latency_hist_t * hist, uint32_t ms);
+    static void latency_hist_get(const latency_hist_t * hist, lv_sysmon_latency_stage_t * stage);
+    #if LV_USE_LATENCY_MONITOR_LOG_MODE != 2
+        static void latency_update_timer_cb(lv_timer_t * t);
+        static void latency_observer_cb(lv_observer_t * observer, lv_subject_t * subject);
+    #endif
+#endif
+
 /**********************
  *  STATIC VARIABLES
  **********************/
@@ -80,6 +134,15 @@ void _lv_sysmon_builtin_init(void)
     lv_subject_init_pointer(&sysmon_mem.subject, &mem_info);
     sysmon_mem.timer = lv_timer_create(mem_update_timer_cb, SYSMON_REFR_PERIOD_DEF, &mem_info);
 #endif
+
+#if _USE_LATENCY_MONITOR
+    static latency_info_t latency_info;
+    lv_memzero(&latency_info, sizeof(latency_info));
+    lv_subject_init_pointer(&sysmon_latency.subject, &latency_info);
+#if LV_USE_LATENCY_MONITOR_LOG_MODE != 2
+    sysmon_latency.timer = lv_timer_create(latency_update_timer_cb, SYSMON_REFR_PERIOD_DEF, &latency_info);
+#endif
+#endif
 }
 
 void _lv_sysmon_builtin_deinit(void)
@@ -91,6 +154,10 @@ void _lv_sysmon_builtin_deinit(void)
 #if _USE_MEM_MONITOR
     lv_timer_delete(sysmon_mem.timer);
 #endif
+
+#if _USE_LATENCY_MONITOR && LV_USE_LATENCY_MONITOR_LOG_MODE != 2
+    lv_timer_delete(sysmon_latency.timer);
+#endif
 }
 
 lv_obj_t * lv_sysmon_create(lv_obj_t * parent)
@@ -105,6 +172,44 @@ lv_obj_t * lv_sysmon_create(lv_obj_t * parent)
     return label;
 }
 
+#if _USE_LATENCY_MONITOR
+
+void lv_sysmon_latency_input(uint32_t t_input)
+{
+    latency_info_t * info = (latency_info_t *)lv_subject_get_pointer(&sysmon_latency.subject);
+
+    /*Follow the default display from its first input*/
+    if(info->disp == NULL) {
+        info->disp = lv_display_get_default();
+        if(info->disp == NULL) return;
+        lv_display_add_event_cb(info->disp, latency_disp_event_cb, LV_EVENT_ALL, info);
+    }
+
+    latency_batch_t * b = &info->pending;
+    if(b->input_cnt == 0 || (int32_t)(t_input - b->t_input) < 0) b->t_input = t_input;
+    b->input_cnt++;
+}
+
+void lv_sysmon_get_latency(lv_sysmon_latency_t * latency)
+{
+    const latency_info_t * info = lv_subject_get_pointer(&sysmon_latency.subject);
+    latency_hist_get(&info->refr, &latency->refr);
+    latency_hist_get(&info->render, &latency->render);
+    latency_hist_get(&info->flush, &latency->flush);
+    latency->input_cnt = info->input_cnt;
+}
+
+void lv_sysmon_latency_reset(void)
+{
+    latency_info_t * info = (latency_info_t *)lv_subject_get_pointer(&sysmon_latency.subject);
+    lv_memzero(&info->refr, sizeof(info->refr));
+    lv_memzero(&info->render, sizeof(info->render));
+    lv_memzero(&info->flush, sizeof(info->flush));
+    info->input_cnt = 0;
+}
+
+#endif /*_USE_LATENCY_MONITOR*/
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -183,6 +288,19 @@ static void perf_update_timer_cb(lv_timer_t * t)
     lv_timer_t * disp_refr_timer = lv_display_get_refr_timer(NULL);
     uint32_t disp_refr_period = disp_refr_timer->period;
 
+    /*The state of the adaptive refresh period. It changes within a report, so the FPS is limited by the shortest one*/
+    info->calculated.refr_period = disp_refr_period;
+    const lv_display_pacing_state_t * pacing = lv_display_get_pacing(NULL);
+    if(pacing) {
+        lv_display_t * disp = lv_display_get_default();
+        info->calculated.pacing_cost = pacing->cost_avg_us;
+        info->calculated.pacing_bus = pacing->bus_avg_us;
+        info->calculated.pacing_overruns = pacing->overruns - info->measured.pacing_overruns;
+        info->calculated.pacing_saturated = pacing->saturated;
+        info->measured.pacing_overruns = pacing->overruns;
+        disp_refr_period = LV_MAX(disp->pacing.min_period, 1);
+    }
+
     info->calculated.fps = info->measured.refr_interval_sum ? (1000 * info->measured.refr_cnt / time_since_last_report) : 0;
     info->calculated.fps = LV_MIN(info->calculated.fps,
                                   1000 / disp_refr_period);   /*Limit due to possible off-by-one error*/
@@ -209,6 +327,7 @@ static void perf_update_timer_cb(lv_timer_t * t)
     lv_sysmon_perf_info_t prev_info = *info;
     lv_memzero(info, sizeof(lv_sysmon_perf_info_t));
     info->measured.refr_start = prev_info.measured.refr_start;
+    info->measured.pacing_overruns = prev_info.measured.pacing_overruns;
     info->calculated.cpu_avg_total = prev_info.calculated.cpu_avg_total;
     info->calculated.fps_avg_total = prev_info.calculated.fps_avg_total;
     info->calculated.run_cnt = prev_info.calculated.run_cnt;
@@ -230,7 +349,26 @@ static void perf_observer_cb(lv_observer_t * observer, lv_subject_t * subject)
            perf->calculated.fps, perf->measured.refr_cnt, perf->measured.render_cnt,
            perf->calculated.refr_avg_time, perf->calculated.render_avg_time, perf->calculated.flush_avg_time,
            perf->calculated.cpu);
+    if(perf->calculated.pacing_cost) {
+        LV_LOG("sysmon: "
+               "period %" LV_PRIu32 "ms (refr %" LV_PRIu32 "us | bus %" LV_PRIu32 "us%s), %" LV_PRIu32 " overruns\n",
+               perf->calculated.refr_period, perf->calculated.pacing_cost, perf->calculated.pacing_bus,
+               perf->calculated.pacing_saturated ? ", saturated" : "", perf->calculated.pacing_overruns);
+    }
 #else
+    if(perf->calculated.pacing_cost) {
+        lv_label_set_text_fmt(
+            label,
+            "%" LV_PRIu32" FPS, %" LV_PRIu32 "%% CPU\n"
+            "%" LV_PRIu32" ms (%" LV_PRIu32" | %" LV_PRIu32")\n"
+            "period %" LV_PRIu32 " ms%s",
+            perf->calculated.fps, perf->calculated.cpu,
+            perf->calculated.render_avg_time + perf->calculated.flush_avg_time,
+            perf->calculated.render_avg_time, perf->calculated.flush_avg_time,
+            perf->calculated.refr_period, perf->calculated.pacing_saturated ? " (max)" : ""
+        );
+        return;
+    }
     lv_label_set_text_fmt(
         label,
         "%" LV_PRIu32" FPS, %" LV_PRIu32 "%% CPU\n"
@@ -283,4 +421,168 @@ static void mem_observer_cb(lv_observer_t * observer, lv_subject_t * subject)
 
 #endif
 
+#if _USE_LATENCY_MONITOR
+
+/**
+ * Move the inputs along the refresh pipeline:
+ * pending -(REFR_START)-> active -(RENDER_READY)-> flushing -(flush ready)-> measured
+ * The flush ready tick is recorded by `lv_display_flush_ready()` for the last area.
+ */
+static void latency_disp_event_cb(lv_event_t * e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+    latency_info_t * info = lv_event_get_user_data(e);
+    lv_display_t * disp = info->disp;
+
+    switch(code) {
+        case LV_EVENT_REFR_START:
+            info->active = info->pending;
+            info->active.t_refr = lv_tick_get();
+            info->pending.input_cnt = 0;
+            break;
+        case LV_EVENT_FLUSH_START:
+            /*Nothing is flushed while an area is still being sent, so the previous refresh is complete*/
+            if(info->flushing.input_cnt) latency_flush_done(info, disp->last_flush_ready);
+            break;
+        case LV_EVENT_RENDER_READY:
+            if(info->flushing.input_cnt) latency_flush_done(info, disp->last_flush_ready);
+            if(info->active.input_cnt) {
+                info->flushing = info->active;
+                info->flushing.t_render = lv_tick_get();
+                info->active.input_cnt = 0;
+            }
+            /*With a synchronous flush_cb the last area is already out*/
+            if(info->flushing.input_cnt && !disp->flushing) latency_flush_done(info, disp->last_flush_ready);
+            break;
+        case LV_EVENT_FLUSH_WAIT_FINISH:
+            if(info->flushing.input_cnt && !disp->flushing) latency_flush_done(info, disp->last_flush_ready);
+            break;
+        case LV_EVENT_REFR_READY:
+            /*Nothing was rendered so the inputs are still to be shown*/
+            if(info->active.input_cnt) {
+                latency_batch_t * b = &info->pending;
+                if(b->input_cnt == 0 || (int32_t)(info->active.t_input - b->t_input) < 0) b->t_input = info->active.t_input;
+                b->input_cnt += info->active.input_cnt;
+                info->active.input_cnt = 0;
+            }
+            if(info->flushing.input_cnt && !disp->flushing) latency_flush_done(info, disp->last_flush_ready);
+            break;
+        default:
+            break;
+    }
+}
+
+static void latency_flush_done(latency_info_t * info, uint32_t t_flush)
+{
+    latency_batch_t * b = &info->flushing;
+    latency_hist_add(&info->refr, b->t_refr - b->t_input);
+    latency_hist_add(&info->render, b->t_render - b->t_input);
+    latency_hist_add(&info->flush, t_flush - b->t_input);
+    info->input_cnt += b->input_cnt;
+    info->updated = true;
+    b->input_cnt = 0;
+}
+
+static void latency_hist_add(latency_hist_t * hist, uint32_t ms)
+{
+    /*An input stamped slightly ahead of the tick reads as a huge unsigned value*/
+    if((int32_t)ms < 0) ms = 0;
+
+    uint32_t i = ms < LATENCY_HIST_FINE ? ms : LATENCY_HIST_FINE + ((ms - LATENCY_HIST_FINE) >> LATENCY_HIST_SHIFT);
+    hist->hist[LV_MIN(i, LATENCY_HIST_SIZE - 1)]++;
+
+    if(hist->cnt == 0 || ms < hist->min) hist->min = ms;
+    if(ms > hist->max) hist->max = ms;
+    hist->sum += ms;
+    hist->cnt++;
+}
+
+static uint32_t latency_hist_percentile(const latency_hist_t * hist, uint32_t pct)
+{
+    uint32_t rank = (hist->cnt * pct + 99) / 100;
+    uint32_t acc = 0;
+    uint32_t i;
+    for(i = 0; i < LATENCY_HIST_SIZE - 1; i++) {
+        acc += hist->hist[i];
+        if(acc >= rank) break;
+    }
+
+    /*Upper bound of the bucket, but never more than what was measured*/
+    uint32_t ms = i < LATENCY_HIST_FINE ? i : LATENCY_HIST_FINE + ((i - LATENCY_HIST_FINE + 1) << LATENCY_HIST_SHIFT) - 1;
+    return LV_MIN(ms, hist->max);
+}
+
+static void latency_hist_get(const latency_hist_t * hist, lv_sysmon_latency_stage_t * stage)
+{
+    stage->cnt = hist->cnt;
+    if(hist->cnt == 0) {
+        stage->min = stage->avg = stage->p95 = stage->p99 = stage->max = 0;
+        return;
+    }
+
+    stage->min = hist->min;
+    stage->avg = (uint32_t)(hist->sum / hist->cnt);
+    stage->p95 = latency_hist_percentile(hist, 95);
+    stage->p99 = latency_hist_percentile(hist, 99);
+    stage->max = hist->max;
+}
+
+#if LV_USE_LATENCY_MONITOR_LOG_MODE != 2
+
+static void latency_update_timer_cb(lv_timer_t * t)
+{
+    /*Wait for a display*/
+    if(!sysmon_latency.inited && lv_display_get_default()) {
+        lv_obj_t * obj = lv_sysmon_create(lv_layer_sys());
+        lv_obj_align(obj, LV_USE_LATENCY_MONITOR_POS, 0, 0);
+        lv_subject_add_observer_obj(&sysmon_latency.subject, latency_observer_cb, obj, NULL);
+#if LV_USE_LATENCY_MONITOR_LOG_MODE
+        lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+#endif
+        sysmon_latency.inited = true;
+    }
+
+    if(!sysmon_latency.inited) return;
+
+    /*Only notify when something new was measured to not redraw the label in vain*/
+    latency_info_t * info = lv_timer_get_user_data(t);
+    if(!info->updated) return;
+    info->updated = false;
+
+    lv_subject_set_pointer(&sysmon_latency.subject, info);
+}
+
+static void latency_observer_cb(lv_observer_t * observer, lv_subject_t * subject)
+{
+    lv_obj_t * label = lv_observer_get_target(observer);
+    const latency_info_t * info = lv_subject_get_pointer(subject);
+
+    lv_sysmon_latency_stage_t flush;
+    latency_hist_get(&info->flush, &flush);
+
+#if LV_USE_LATENCY_MONITOR_LOG_MODE
+    LV_UNUSED(label);
+    lv_sysmon_latency_stage_t render;
+    latency_hist_get(&info->render, &render);
+    LV_LOG("sysmon: "
+           "latency %" LV_PRIu32 " inputs in %" LV_PRIu32 " refreshes, "
+           "min %" LV_PRIu32 " avg %" LV_PRIu32 " p95 %" LV_PRIu32 " p99 %" LV_PRIu32 " max %" LV_PRIu32 "ms "
+           "(rendered after %" LV_PRIu32 "ms avg)\n",
+           info->input_cnt, flush.cnt,
+           flush.min, flush.avg, flush.p95, flush.p99, flush.max,
+           render.avg);
+#else
+    lv_label_set_text_fmt(
+        label,
+        "%" LV_PRIu32 " ms input lag\n"
+        "p95 %" LV_PRIu32 " | p99 %" LV_PRIu32 " ms",
+        flush.avg, flush.p95, flush.p99
+    );
+#endif /*LV_USE_LATENCY_MONITOR_LOG_MODE*/
+}
+
+#endif /*LV_USE_LATENCY_MONITOR_LOG_MODE != 2*/
+
+#endif /*_USE_LATENCY_MONITOR*/
+
 #endif /*LV_USE_SYSMON*/
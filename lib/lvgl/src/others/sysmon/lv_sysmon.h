@@ -57,6 +57,7 @@ typedef struct {
         uint32_t flush_not_in_render_start;
         uint32_t flush_not_in_render_elaps_sum;
         uint32_t last_report_timestamp;
+        uint32_t pacing_overruns;
         uint32_t render_in_progress : 1;
     } measured;
 
@@ -69,11 +70,42 @@ typedef struct {
         uint32_t cpu_avg_total;
         uint32_t fps_avg_total;
         uint32_t run_cnt;
+        uint32_t refr_period;           /**< Refresh period in ms, see `lv_display_set_pacing()`*/
+        uint32_t pacing_cost;           /**< Average refresh time of the adaptive period in us, 0: not adaptive*/
+        uint32_t pacing_bus;            /**< Average bus time of a refresh in us*/
+        uint32_t pacing_overruns;       /**< Refreshes longer than the period since the last report*/
+        bool pacing_saturated;          /**< The period is pinned at its maximum*/
     } calculated;
 
 } lv_sysmon_perf_info_t;
 #endif
 
+#if LV_USE_LATENCY_MONITOR
+/**
+ * Distribution of one stage of the input latency in milliseconds.
+ * Percentiles are rounded up to the histogram's resolution (1 ms below 64 ms, 4 ms above).
+ */
+typedef struct {
+    uint32_t cnt;   /**< Number of refreshes measured*/
+    uint32_t min;
+    uint32_t avg;
+    uint32_t p95;
+    uint32_t p99;
+    uint32_t max;
+} lv_sysmon_latency_stage_t;
+
+/**
+ * Time from an input (`lv_sysmon_latency_input()`) until the refresh showing it
+ * reached each stage. Inputs shown by the same refresh are measured from the oldest one.
+ */
+typedef struct {
+    lv_sysmon_latency_stage_t refr;     /**< Until `LV_EVENT_REFR_START`*/
+    lv_sysmon_latency_stage_t render;   /**< Until `LV_EVENT_RENDER_READY`*/
+    lv_sysmon_latency_stage_t flush;    /**< Until `lv_display_flush_ready()` of the last area, i.e. on the panel*/
+    uint32_t input_cnt;                 /**< Number of inputs shown*/
+} lv_sysmon_latency_t;
+#endif
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -92,6 +124,28 @@ lv_obj_t * lv_sysmon_create(lv_obj_t * parent);
  */
 void lv_sysmon_set_refr_period(lv_obj_t * obj, uint32_t period);
 
+#if LV_USE_LATENCY_MONITOR
+
+/**
+ * Tell the latency monitor that an input was applied to the UI.
+ * Call it from the LVGL thread after the widgets were updated, only if something was invalidated.
+ * @param t_input   tick (`lv_tick_get()`) when the input arrived, e.g. when its bytes were received
+ */
+void lv_sysmon_latency_input(uint32_t t_input);
+
+/**
+ * Get the input latency measured since start-up or the last `lv_sysmon_latency_reset()`.
+ * @param latency   receives the statistics
+ */
+void lv_sysmon_get_latency(lv_sysmon_latency_t * latency);
+
+/**
+ * Clear the latency statistics.
+ */
+void lv_sysmon_latency_reset(void);
+
+#endif /*LV_USE_LATENCY_MONITOR*/
+
 /**
  * Initialize built-in system monitor, such as performance and memory monitor.
  */
@@ -43,7 +43,7 @@ LV_ATTRIBUTE_TICK_INC void lv_tick_inc(uint32_t tick_period)
     state_p->sys_time += tick_period;
 }
 
-uint32_t lv_tick_get(void)
+LV_ATTRIBUTE_TICK_INC uint32_t lv_tick_get(void)
 {
     lv_tick_state_t * state_p = &state;
 
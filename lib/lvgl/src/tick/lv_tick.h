@@ -50,10 +50,11 @@ typedef struct {
 LV_ATTRIBUTE_TICK_INC void lv_tick_inc(uint32_t tick_period);
 
 /**
- * Get the elapsed milliseconds since start up
+ * Get the elapsed milliseconds since start up.
+ * It's also called by `lv_display_flush_ready()`, so it has `LV_ATTRIBUTE_TICK_INC` too.
  * @return          the elapsed milliseconds
  */
-uint32_t lv_tick_get(void);
+LV_ATTRIBUTE_TICK_INC uint32_t lv_tick_get(void);
 
 /**
  * Get the elapsed milliseconds since a previous time stamp
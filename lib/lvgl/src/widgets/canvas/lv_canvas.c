@@ -337,6 +337,7 @@ void lv_canvas_finish_layer(lv_obj_t * canvas, lv_layer_t * layer)
         lv_draw_dispatch_wait_for_request();
         lv_draw_dispatch_layer(lv_obj_get_display(canvas), layer);
     }
+    _lv_draw_layer_deinit(layer);
 }
 
 /**********************
@@ -163,7 +163,7 @@ void lv_canvas_fill_bg(lv_obj_t * obj, lv_color_t color, lv_opa_t opa);
 void lv_canvas_init_layer(lv_obj_t * canvas, lv_layer_t * layer);
 
 /**
- * Wait until all the drawings are finished on layer.
+ * Wait until all the drawings are finished on layer and free the memory of its draw tasks.
  * Needs to be usd in pair with `lv_canvas_init_layer`.
  * @param canvas    pointer to a canvas
  * @param layer     pointer to a layer to finalize
@@ -0,0 +1,269 @@
+/**
+ * @file dashboard.cpp
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "dashboard.h"
+#include <stdio.h>
+#include <string.h>
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void set_label_int(lv_obj_t *label, const char *fmt, int value, int *shown_value);
+static void set_label_str(lv_obj_t *label, const char *value, char *shown_value, size_t shown_size);
+static void flush_stats_cb(lv_event_t *e);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+/* Dashboard UI Elements */
+static lv_obj_t *speed_label;
+static lv_obj_t *range_label;
+static lv_obj_t *avg_wh_label;
+static lv_obj_t *trip_label;
+static lv_obj_t *odo_label;
+static lv_obj_t *avg_kmh_label;
+static lv_obj_t *motor_temp_label;
+static lv_obj_t *battery_temp_label;
+static lv_obj_t *mode_label;
+static lv_obj_t *status_label;
+static lv_obj_t *time_label;
+
+static dashboard_stats_t dash_stats;
+
+/* Values currently shown by the labels. Only fields that differ from these are re-rendered;
+ * `shown_valid` is cleared whenever the labels are (re)created. */
+static telemetry_data_t shown;
+static bool shown_valid = false;
+static int shown_minutes = -1;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void create_ev_dashboard_ui(void) {
+  lv_obj_t *scr = lv_scr_act();
+  lv_obj_clean(scr);
+  lv_obj_set_style_bg_color(scr, lv_color_hex(0xe5e5e5), 0);
+
+  /* New labels: the next update has to write all of them */
+  shown_valid = false;
+  shown_minutes = -1;
+
+  /* Top bar */
+  lv_obj_t *top_bar = lv_obj_create(scr);
+  lv_obj_set_size(top_bar, DASHBOARD_HOR_RES, 60);
+  lv_obj_align(top_bar, LV_ALIGN_TOP_MID, 0, 0);
+  lv_obj_set_style_bg_color(top_bar, lv_color_white(), 0);
+  lv_obj_set_style_border_width(top_bar, 0, 0);
+  lv_obj_set_style_radius(top_bar, 0, 0);
+  lv_obj_set_style_pad_all(top_bar, 0, 0);
+
+  // Time
+  time_label = lv_label_create(top_bar);
+  lv_label_set_text(time_label, "9:41 AM");
+  lv_obj_set_style_text_color(time_label, lv_color_black(), 0);
+  lv_obj_set_style_text_font(time_label, &lv_font_montserrat_18, 0);
+  lv_obj_align(time_label, LV_ALIGN_CENTER, 0, 0);
+
+  // Menu button (left)
+  lv_obj_t *menu_btn = lv_label_create(top_bar);
+  lv_label_set_text(menu_btn, "Menu");
+  lv_obj_set_style_text_font(menu_btn, &lv_font_montserrat_16, 0);
+  lv_obj_align(menu_btn, LV_ALIGN_LEFT_MID, 10, 0);
+
+  // Map button (right)
+  lv_obj_t *map_btn = lv_label_create(top_bar);
+  lv_label_set_text(map_btn, "Map");
+  lv_obj_set_style_text_font(map_btn, &lv_font_montserrat_16, 0);
+  lv_obj_align(map_btn, LV_ALIGN_RIGHT_MID, -10, 0);
+
+  /* Status badge */
+  lv_obj_t *status_badge = lv_obj_create(scr);
+  lv_obj_set_size(status_badge, 140, 40);
+  lv_obj_align(status_badge, LV_ALIGN_TOP_MID, 0, 70);
+  lv_obj_set_style_bg_color(status_badge, lv_color_hex(0x333333), 0);
+  lv_obj_set_style_radius(status_badge, 20, 0);
+  lv_obj_set_style_border_width(status_badge, 0, 0);
+
+  status_label = lv_label_create(status_badge);
+  lv_label_set_text(status_label, "DISARMED");
+  lv_obj_set_style_text_color(status_label, lv_color_white(), 0);
+  lv_obj_set_style_text_font(status_label, &lv_font_montserrat_16, 0);
+  lv_obj_center(status_label);
+
+  /* Main speed display (center) */
+  speed_label = lv_label_create(scr);
+  lv_label_set_text(speed_label, "0");
+  lv_obj_set_style_text_color(speed_label, lv_color_black(), 0);
+  lv_obj_set_style_text_font(speed_label, &lv_font_montserrat_48, 0);
+  lv_obj_align(speed_label, LV_ALIGN_CENTER, 0, -20);
+
+  // "Km/h" label
+  lv_obj_t *kmh_label = lv_label_create(scr);
+  lv_label_set_text(kmh_label, "Km/h");
+  lv_obj_set_style_text_color(kmh_label, lv_color_black(), 0);
+  lv_obj_set_style_text_font(kmh_label, &lv_font_montserrat_16, 0);
+  lv_obj_align(kmh_label, LV_ALIGN_CENTER, 0, 20);
+
+  /* Mode selector (center bottom) */
+  lv_obj_t *mode_container = lv_obj_create(scr);
+  lv_obj_set_size(mode_container, 200, 60);
+  lv_obj_align(mode_container, LV_ALIGN_CENTER, 0, 80);
+  lv_obj_set_style_bg_color(mode_container, lv_color_white(), 0);
+  lv_obj_set_style_radius(mode_container, 10, 0);
+  lv_obj_set_style_border_width(mode_container, 0, 0);
+
+  lv_obj_t *mode_text = lv_label_create(mode_container);
+  lv_label_set_text(mode_text, "Mode");
+  lv_obj_set_style_text_color(mode_text, lv_color_black(), 0);
+  lv_obj_set_style_text_font(mode_text, &lv_font_montserrat_14, 0);
+  lv_obj_align(mode_text, LV_ALIGN_TOP_MID, 0, 3);
+
+  mode_label = lv_label_create(mode_container);
+  lv_label_set_text(mode_label, "Eco");
+  lv_obj_set_style_text_color(mode_label, lv_color_hex(0x00cc00), 0);
+  lv_obj_set_style_text_font(mode_label, &lv_font_montserrat_20, 0);
+  lv_obj_align(mode_label, LV_ALIGN_CENTER, 0, 15);
+
+  /* Left side info */
+  range_label = lv_label_create(scr);
+  lv_label_set_text(range_label, "Range 130 km");
+  lv_obj_set_style_text_color(range_label, lv_color_black(), 0);
+  lv_obj_set_style_text_font(range_label, &lv_font_montserrat_16, 0);
+  lv_obj_align(range_label, LV_ALIGN_LEFT_MID, 10, -60);
+
+  avg_wh_label = lv_label_create(scr);
+  lv_label_set_text(avg_wh_label, "Avg. 40 W/km");
+  lv_obj_set_style_text_color(avg_wh_label, lv_color_black(), 0);
+  lv_obj_set_style_text_font(avg_wh_label, &lv_font_montserrat_16, 0);
+  lv_obj_align(avg_wh_label, LV_ALIGN_LEFT_MID, 10, -20);
+
+  /* Right side info */
+  motor_temp_label = lv_label_create(scr);
+  lv_label_set_text(motor_temp_label, "Motor 30°C");
+  lv_obj_set_style_text_color(motor_temp_label, lv_color_black(), 0);
+  lv_obj_set_style_text_font(motor_temp_label, &lv_font_montserrat_16, 0);
+  lv_obj_align(motor_temp_label, LV_ALIGN_RIGHT_MID, -10, -60);
+
+  battery_temp_label = lv_label_create(scr);
+  lv_label_set_text(battery_temp_label, "Battery 30°C");
+  lv_obj_set_style_text_color(battery_temp_label, lv_color_black(), 0);
+  lv_obj_set_style_text_font(battery_temp_label, &lv_font_montserrat_16, 0);
+  lv_obj_align(battery_temp_label, LV_ALIGN_RIGHT_MID, -10, -20);
+
+  /* Bottom bar (trip/odo/avg) */
+  lv_obj_t *bottom_bar = lv_obj_create(scr);
+  lv_obj_set_size(bottom_bar, DASHBOARD_HOR_RES, 50);
+  lv_obj_align(bottom_bar, LV_ALIGN_BOTTOM_MID, 0, 0);
+  lv_obj_set_style_bg_color(bottom_bar, lv_color_white(), 0);
+  lv_obj_set_style_border_width(bottom_bar, 0, 0);
+  lv_obj_set_style_radius(bottom_bar, 0, 0);
+
+  trip_label = lv_label_create(bottom_bar);
+  lv_label_set_text(trip_label, "TRIP 130 km");
+  lv_obj_set_style_text_color(trip_label, lv_color_black(), 0);
+  lv_obj_set_style_text_font(trip_label, &lv_font_montserrat_14, 0);
+  lv_obj_align(trip_label, LV_ALIGN_LEFT_MID, 20, 0);
+
+  odo_label = lv_label_create(bottom_bar);
+  lv_label_set_text(odo_label, "ODO 1300 km");
+  lv_obj_set_style_text_color(odo_label, lv_color_black(), 0);
+  lv_obj_set_style_text_font(odo_label, &lv_font_montserrat_14, 0);
+  lv_obj_align(odo_label, LV_ALIGN_CENTER, 0, 0);
+
+  avg_kmh_label = lv_label_create(bottom_bar);
+  lv_label_set_text(avg_kmh_label, "AVG. 40 km/h");
+  lv_obj_set_style_text_color(avg_kmh_label, lv_color_black(), 0);
+  lv_obj_set_style_text_font(avg_kmh_label, &lv_font_montserrat_14, 0);
+  lv_obj_align(avg_kmh_label, LV_ALIGN_RIGHT_MID, -20, 0);
+}
+
+void update_time_display(uint32_t uptime_ms) {
+  uint32_t now = uptime_ms / 1000;
+  int hours = (now / 3600) % 24;
+  int minutes = (now / 60) % 60;
+
+  /* The label only shows minutes: don't redraw it every second */
+  int total_minutes = hours * 60 + minutes;
+  if (total_minutes == shown_minutes) return;
+  shown_minutes = total_minutes;
+  
+  char time_str[16];
+  snprintf(time_str, sizeof(time_str), "%d:%02d AM", hours == 0 ? 12 : hours, minutes);
+  lv_label_set_text(time_label, time_str);
+}
+
+bool update_dashboard(const telemetry_data_t *dash) {
+  uint32_t touched = dash_stats.labels_touched;
+  dash_stats.updates++;
+
+  set_label_int(speed_label, "%d", dash->speed, &shown.speed);
+  set_label_int(range_label, "Range %d km", dash->range, &shown.range);
+  set_label_int(avg_wh_label, "Avg. %d W/km", dash->avg_wh, &shown.avg_wh);
+  set_label_int(trip_label, "TRIP %d km", dash->trip, &shown.trip);
+  set_label_int(odo_label, "ODO %d km", dash->odo, &shown.odo);
+  set_label_int(avg_kmh_label, "AVG. %d km/h", dash->avg_kmh, &shown.avg_kmh);
+  set_label_int(motor_temp_label, "Motor %d°C", dash->motor_temp, &shown.motor_temp);
+  set_label_int(battery_temp_label, "Battery %d°C", dash->battery_temp, &shown.battery_temp);
+  set_label_str(mode_label, dash->mode, shown.mode, sizeof(shown.mode));
+  set_label_str(status_label, dash->status, shown.status, sizeof(shown.status));
+  shown_valid = true;
+
+  return dash_stats.labels_touched != touched;
+}
+
+void dashboard_attach_stats(lv_display_t *disp) {
+  lv_display_add_event_cb(disp, flush_stats_cb, LV_EVENT_FLUSH_START, NULL);
+}
+
+const dashboard_stats_t *dashboard_get_stats(void) {
+  return &dash_stats;
+}
+
+void dashboard_reset_stats(void) {
+  memset(&dash_stats, 0, sizeof(dash_stats));
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* Set a label to `fmt` formatted with `value` if it is not already showing it */
+static void set_label_int(lv_obj_t *label, const char *fmt, int value, int *shown_value) {
+  if (shown_valid && *shown_value == value) {
+    dash_stats.labels_skipped++;
+    return;
+  }
+
+  char buf[32];
+  snprintf(buf, sizeof(buf), fmt, value);
+  lv_label_set_text(label, buf);
+  *shown_value = value;
+  dash_stats.labels_touched++;
+}
+
+static void set_label_str(lv_obj_t *label, const char *value, char *shown_value, size_t shown_size) {
+  if (shown_valid && strcmp(shown_value, value) == 0) {
+    dash_stats.labels_skipped++;
+    return;
+  }
+
+  lv_label_set_text(label, value);
+  snprintf(shown_value, shown_size, "%s", value);
+  dash_stats.labels_touched++;
+}
+
+/* Count what actually goes over the bus */
+static void flush_stats_cb(lv_event_t *e) {
+  const lv_area_t *area = (const lv_area_t *)lv_event_get_param(e);
+  lv_display_t *disp = (lv_display_t *)lv_event_get_current_target(e);
+  uint32_t px = lv_area_get_size(area);
+  dash_stats.flushes++;
+  dash_stats.px_flushed += px;
+  dash_stats.bytes_flushed += px * lv_color_format_get_size(lv_display_get_color_format(disp));
+}
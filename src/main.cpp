@@ -4,11 +4,17 @@
 #include <lvgl.h>
 #include <TFT_eSPI.h>
 #include <Wire.h>
-#include <GT911.h>
+#include <esp_timer.h>
+#include <gt911.h>
+#include "telemetry.h"
+#include "dashboard.h"
+#include "telemetry_rec.h"
+#include "telemetry_ingest.h"
+#include "run_loop.h"
 
 #define SD_CS 5
-#define TFT_HOR_RES 480
-#define TFT_VER_RES 320
+#define TFT_HOR_RES DASHBOARD_HOR_RES
+#define TFT_VER_RES DASHBOARD_VER_RES
 
 /* Touch pins */
 #define TOUCH_SDA 33
@@ -16,50 +22,98 @@
 #define TOUCH_INT 21
 #define TOUCH_RST 25
 
-GT911 ts = GT911();
-void *draw_buf;
+/* Lines per draw buffer */
+#define DRAW_BUF_LINES 40
+#define DRAW_BUF_SIZE (TFT_HOR_RES * DRAW_BUF_LINES * (LV_COLOR_DEPTH / 8))
+
+/* How often the dashboard statistics are printed */
+#define STATS_PERIOD_MS 5000
+
+/* Longest sleep of the main loop; it wakes earlier for timers and input */
+#define LOOP_MAX_SLEEP_MS 1000
+
+/* Set to 1 to record the received telemetry on the SD card for replaying it
+ * with host/bench/telemetry_replay */
+#define TELEMETRY_RECORD 0
+#define TELEMETRY_REC_PATH "/telemetry.rec"
+
+/* Render into one buffer while the other one is sent with DMA. The display
+ * then keeps the SPI bus, so not while recording to the SD card. */
+#define DISPLAY_DMA (!TELEMETRY_RECORD)
+
+/* Refresh period adapted to the rendering and SPI time: refresh soon after
+ * telemetry changed something, but at most half of the time refreshing */
+#define REFR_MIN_PERIOD_MS 10
+#define REFR_MAX_PERIOD_MS 100
+#define REFR_CPU_BUDGET    50
+
+/* Read on INT pulses only, see lib/GT911 */
+gt911_t touch;
+void *draw_buf[2];
 lv_display_t *disp; // MAKE GLOBAL
 
 /* Buffer to store image data in RAM */
 uint8_t *image_data = NULL;
 uint32_t image_size = 0;
 
-/* Dashboard UI Elements */
-lv_obj_t *speed_label;
-lv_obj_t *range_label;
-lv_obj_t *avg_wh_label;
-lv_obj_t *trip_label;
-lv_obj_t *odo_label;
-lv_obj_t *avg_kmh_label;
-lv_obj_t *motor_temp_label;
-lv_obj_t *battery_temp_label;
-lv_obj_t *mode_label;
-lv_obj_t *status_label;
-lv_obj_t *time_label;
-
-/* Dashboard data */
-int speed = 0;
-int range = 130;
-int avg_wh = 40;
-int trip = 130;
-int odo = 1300;
-int avg_kmh = 40;
-int motor_temp = 30;
-int battery_temp = 30;
-String mode = "Eco";
-String status = "DISARMED";
-
-/* Touch callback */
-void my_touch_read(lv_indev_t *indev, lv_indev_data_t *data) {
-  uint8_t touches = ts.touched(GT911_MODE_POLLING);
-  if (touches) {
-    GTPoint *p = ts.getPoints();
-    data->point.x = TFT_HOR_RES - p->y;
-    data->point.y = p->x;
-    data->state = LV_INDEV_STATE_PRESSED;
-  } else {
-    data->state = LV_INDEV_STATE_RELEASED;
-  }
+/* Dashboard data. Telemetry is received by its own task (needs LV_USE_OS
+ * LV_OS_FREERTOS in lv_conf.h) and applied once per refresh. */
+telemetry_data_t dash;
+telemetry_ingest_t ingest;
+bool ingest_task = false;
+
+/* Sleeps until the next LVGL timer; the telemetry task and the touch
+ * interrupt wake it */
+run_loop_t run_loop;
+
+#if TELEMETRY_RECORD
+File rec_file;
+telemetry_rec_t recorder;
+unsigned long last_rec_flush = 0;
+
+static size_t rec_write_cb(void *user_data, const uint8_t *data, size_t len) {
+  return ((File *)user_data)->write(data, len);
+}
+#endif
+
+/* GT911 register access over Wire */
+static bool touch_i2c_read(void *user_data, uint16_t reg, uint8_t *buf, size_t len) {
+  Wire.beginTransmission(GT911_ADDR_5D);
+  Wire.write(reg >> 8);
+  Wire.write(reg & 0xFF);
+  if (Wire.endTransmission(false) != 0) return false;
+  if ((size_t)Wire.requestFrom(GT911_ADDR_5D, (int)len) != len) return false;
+  for (size_t i = 0; i < len; i++) buf[i] = Wire.read();
+  return true;
+}
+
+static bool touch_i2c_write(void *user_data, uint16_t reg, const uint8_t *buf, size_t len) {
+  Wire.beginTransmission(GT911_ADDR_5D);
+  Wire.write(reg >> 8);
+  Wire.write(reg & 0xFF);
+  Wire.write(buf, len);
+  return Wire.endTransmission() == 0;
+}
+
+/* Reset the controller, selecting address 0x5D with INT held low */
+static void touch_reset(void) {
+  pinMode(TOUCH_INT, OUTPUT);
+  pinMode(TOUCH_RST, OUTPUT);
+  digitalWrite(TOUCH_INT, LOW);
+  digitalWrite(TOUCH_RST, LOW);
+  delay(11);
+  digitalWrite(TOUCH_RST, HIGH);
+  delay(6);
+  pinMode(TOUCH_INT, INPUT);
+  delay(50);
+}
+
+/* The report is read in loop(), the pulse only wakes it */
+static void IRAM_ATTR touch_isr(void) {
+  gt911_irq(&touch);
+#if LV_USE_OS == LV_OS_FREERTOS
+  run_loop_wake_isr(&run_loop);
+#endif
 }
 
 /* Load image from SD card into RAM */
@@ -96,278 +150,134 @@ bool load_image_to_ram(const char *path) {
   return true;
 }
 
-/* Update time display */
-void update_time_display() {
-  unsigned long now = millis() / 1000;
-  int hours = (now / 3600) % 24;
-  int minutes = (now / 60) % 60;
-  
-  char time_str[16];
-  snprintf(time_str, sizeof(time_str), "%d:%02d AM", hours == 0 ? 12 : hours, minutes);
-  lv_label_set_text(time_label, time_str);
+/* Microseconds for the band and refresh times of the display. Called from the DMA interrupt too. */
+static uint32_t IRAM_ATTR display_time_cb(void) {
+  return (uint32_t)esp_timer_get_time();
 }
 
-/* Update dashboard values */
-void update_dashboard() {
-  Serial.println("=== Updating dashboard ===");
-  char buf[32];
-  
-  // Speed
-  snprintf(buf, sizeof(buf), "%d", speed);
-  lv_label_set_text(speed_label, buf);
-  Serial.printf("Speed: %s\n", buf);
-  
-  // Range
-  snprintf(buf, sizeof(buf), "Range %d km", range);
-  lv_label_set_text(range_label, buf);
-  Serial.printf("Range: %s\n", buf);
-  
-  // Avg W/km
-  snprintf(buf, sizeof(buf), "Avg. %d W/km", avg_wh);
-  lv_label_set_text(avg_wh_label, buf);
-  
-  // Trip
-  snprintf(buf, sizeof(buf), "TRIP %d km", trip);
-  lv_label_set_text(trip_label, buf);
-  
-  // ODO
-  snprintf(buf, sizeof(buf), "ODO %d km", odo);
-  lv_label_set_text(odo_label, buf);
-  
-  // Avg km/h
-  snprintf(buf, sizeof(buf), "AVG. %d km/h", avg_kmh);
-  lv_label_set_text(avg_kmh_label, buf);
-  
-  // Motor temp
-  snprintf(buf, sizeof(buf), "Motor %d°C", motor_temp);
-  lv_label_set_text(motor_temp_label, buf);
-  
-  // Battery temp
-  snprintf(buf, sizeof(buf), "Battery %d°C", battery_temp);
-  lv_label_set_text(battery_temp_label, buf);
-  
-  // Mode
-  lv_label_set_text(mode_label, mode.c_str());
-  Serial.printf("Mode: %s\n", mode.c_str());
-  
-  // Status
-  lv_label_set_text(status_label, status.c_str());
-  Serial.printf("Status: %s\n", status.c_str());
-  
-  // Time
-  update_time_display();
-  
-  // CRITICAL: Force display refresh
-  lv_refr_now(disp);
-  Serial.println("Display refreshed");
-  Serial.println("========================");
+/* Print and reset the dashboard statistics */
+static void print_dashboard_stats(lv_timer_t *timer) {
+  /* Also while idle, to see how much the loop sleeps */
+  Serial.printf("Loop: %u iterations, %u woken early, %u ms asleep\n",
+                (unsigned)run_loop.stats.iterations, (unsigned)run_loop.stats.woken,
+                (unsigned)run_loop.stats.slept_ms);
+  lv_memzero(&run_loop.stats, sizeof(run_loop.stats));
+
+  /* No I2C transactions while nobody touches the panel */
+  const gt911_stats_t *ts = &touch.stats;
+  Serial.printf("Touch: %u interrupts, %u reports (%u dropped, %u timed out), %u I2C transactions, %u errors\n",
+                (unsigned)touch.irq_cnt, (unsigned)ts->reports, (unsigned)ts->dropped, (unsigned)ts->timeouts,
+                (unsigned)ts->i2c, (unsigned)ts->errors);
+  lv_memzero(&touch.stats, sizeof(touch.stats));
+
+  const dashboard_stats_t *st = dashboard_get_stats();
+  if (st->updates == 0) return;
+
+  unsigned updates = st->updates;
+  Serial.printf("Dashboard: %u updates, %u.%u labels/update (%u skipped), %u px/update in %u flushes\n",
+                updates,
+                (unsigned)st->labels_touched / updates,
+                (unsigned)(st->labels_touched * 10 / updates) % 10,
+                (unsigned)st->labels_skipped,
+                (unsigned)st->px_flushed / updates,
+                (unsigned)st->flushes);
+  const lv_display_flush_stats_t *fs = lv_display_get_flush_stats(NULL);
+  Serial.printf("Last frame: %u flushes, %u bytes, ~%u us on the bus, %u of %u tiles unchanged, %u px culled\n",
+                (unsigned)fs->flush_cnt, (unsigned)fs->bytes, (unsigned)fs->bus_time_us,
+                (unsigned)fs->tiles_skipped, (unsigned)fs->tiles_checked, (unsigned)fs->culled_px);
+  const lv_display_pacing_state_t *ps = lv_display_get_pacing(NULL);
+  if (ps) {
+    Serial.printf("Refresh: every %u ms, %u us rendering, %u us on the bus%s, %u overruns\n", (unsigned)ps->period,
+                  (unsigned)ps->cost_avg_us, (unsigned)ps->bus_avg_us, ps->saturated ? " (saturated)" : "",
+                  (unsigned)ps->overruns);
+  }
+#if LV_DRAW_ARENA_CHUNK_SIZE
+  /* No new chunks once the arenas grew to the largest frame */
+  const lv_draw_arena_stats_t *as = lv_draw_get_arena_stats();
+  Serial.printf("Draw arena: %u allocations (%u/update), %u new chunks, %u bytes at most, %u bytes held\n",
+                (unsigned)as->alloc_cnt, (unsigned)as->alloc_cnt / updates, (unsigned)as->chunk_alloc_cnt,
+                (unsigned)as->high_water, (unsigned)as->size);
+  lv_draw_reset_arena_stats();
+#endif
+#if LV_OBJ_RENDER_CACHE_SIZE
+  /* Objects with LV_OBJ_FLAG_RENDER_CACHE drawn from their buffers instead of rendered again */
+  const lv_obj_render_cache_stats_t *rs = lv_obj_get_render_cache_stats();
+  Serial.printf("Render cache: %u drawn from the cache, %u rendered, %u dropped, %u bytes held\n",
+                (unsigned)rs->hit_cnt, (unsigned)rs->render_cnt, (unsigned)rs->drop_cnt, (unsigned)rs->size);
+  lv_obj_reset_render_cache_stats();
+#endif
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+  /* Glyphs copied from the cache instead of unpacked again */
+  lv_font_fmt_txt_cache_stats_t gs;
+  lv_font_fmt_txt_get_cache_stats(&gs);
+  Serial.printf("Glyph cache: %u hits, %u misses, %u/%u bytes\n", (unsigned)gs.hit_cnt, (unsigned)gs.miss_cnt,
+                (unsigned)gs.size, (unsigned)gs.max_size);
+  lv_font_fmt_txt_reset_cache_stats();
+#endif
+  dashboard_reset_stats();
+
+  const telemetry_ingest_stats_t *is = &ingest.stats;
+  Serial.printf("Telemetry: %u frames, %u merged by the reader, %u records in %u drains\n",
+                (unsigned)is->frames, (unsigned)is->merged, (unsigned)is->records, (unsigned)is->drains);
+
+#if LV_USE_SYSMON && LV_USE_LATENCY_MONITOR
+  /* Time from the first byte of a frame until it was on the panel */
+  lv_sysmon_latency_t lat;
+  lv_sysmon_get_latency(&lat);
+  Serial.printf("Latency: %u inputs, min %u, avg %u, p95 %u, p99 %u, max %u ms\n",
+                (unsigned)lat.input_cnt, (unsigned)lat.flush.min, (unsigned)lat.flush.avg,
+                (unsigned)lat.flush.p95, (unsigned)lat.flush.p99, (unsigned)lat.flush.max);
+  lv_sysmon_latency_reset();
+#endif
 }
 
-/* Create EV Dashboard UI */
-void create_ev_dashboard_ui() {
-  Serial.println("Creating EV dashboard UI...");
-  
-  lv_obj_t *scr = lv_scr_act();
-  lv_obj_clean(scr);
-  lv_obj_set_style_bg_color(scr, lv_color_hex(0xe5e5e5), 0);
-
-  /* Top bar */
-  lv_obj_t *top_bar = lv_obj_create(scr);
-  lv_obj_set_size(top_bar, TFT_HOR_RES, 60);
-  lv_obj_align(top_bar, LV_ALIGN_TOP_MID, 0, 0);
-  lv_obj_set_style_bg_color(top_bar, lv_color_white(), 0);
-  lv_obj_set_style_border_width(top_bar, 0, 0);
-  lv_obj_set_style_radius(top_bar, 0, 0);
-  lv_obj_set_style_pad_all(top_bar, 0, 0);
-
-  // Time
-  time_label = lv_label_create(top_bar);
-  lv_label_set_text(time_label, "9:41 AM");
-  lv_obj_set_style_text_color(time_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(time_label, &lv_font_montserrat_18, 0);
-  lv_obj_align(time_label, LV_ALIGN_CENTER, 0, 0);
-
-  // Menu button (left)
-  lv_obj_t *menu_btn = lv_label_create(top_bar);
-  lv_label_set_text(menu_btn, "Menu");
-  lv_obj_set_style_text_font(menu_btn, &lv_font_montserrat_16, 0);
-  lv_obj_align(menu_btn, LV_ALIGN_LEFT_MID, 10, 0);
-
-  // Map button (right)
-  lv_obj_t *map_btn = lv_label_create(top_bar);
-  lv_label_set_text(map_btn, "Map");
-  lv_obj_set_style_text_font(map_btn, &lv_font_montserrat_16, 0);
-  lv_obj_align(map_btn, LV_ALIGN_RIGHT_MID, -10, 0);
-
-  /* Status badge */
-  lv_obj_t *status_badge = lv_obj_create(scr);
-  lv_obj_set_size(status_badge, 140, 40);
-  lv_obj_align(status_badge, LV_ALIGN_TOP_MID, 0, 70);
-  lv_obj_set_style_bg_color(status_badge, lv_color_hex(0x333333), 0);
-  lv_obj_set_style_radius(status_badge, 20, 0);
-  lv_obj_set_style_border_width(status_badge, 0, 0);
-
-  status_label = lv_label_create(status_badge);
-  lv_label_set_text(status_label, "DISARMED");
-  lv_obj_set_style_text_color(status_label, lv_color_white(), 0);
-  lv_obj_set_style_text_font(status_label, &lv_font_montserrat_16, 0);
-  lv_obj_center(status_label);
-
-  /* Main speed display (center) */
-  speed_label = lv_label_create(scr);
-  lv_label_set_text(speed_label, "0");
-  lv_obj_set_style_text_color(speed_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(speed_label, &lv_font_montserrat_48, 0);
-  lv_obj_align(speed_label, LV_ALIGN_CENTER, 0, -20);
-
-  // "Km/h" label
-  lv_obj_t *kmh_label = lv_label_create(scr);
-  lv_label_set_text(kmh_label, "Km/h");
-  lv_obj_set_style_text_color(kmh_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(kmh_label, &lv_font_montserrat_16, 0);
-  lv_obj_align(kmh_label, LV_ALIGN_CENTER, 0, 20);
-
-  /* Mode selector (center bottom) */
-  lv_obj_t *mode_container = lv_obj_create(scr);
-  lv_obj_set_size(mode_container, 200, 60);
-  lv_obj_align(mode_container, LV_ALIGN_CENTER, 0, 80);
-  lv_obj_set_style_bg_color(mode_container, lv_color_white(), 0);
-  lv_obj_set_style_radius(mode_container, 10, 0);
-  lv_obj_set_style_border_width(mode_container, 0, 0);
-
-  lv_obj_t *mode_text = lv_label_create(mode_container);
-  lv_label_set_text(mode_text, "Mode");
-  lv_obj_set_style_text_color(mode_text, lv_color_black(), 0);
-  lv_obj_set_style_text_font(mode_text, &lv_font_montserrat_14, 0);
-  lv_obj_align(mode_text, LV_ALIGN_TOP_MID, 0, 3);
-
-  mode_label = lv_label_create(mode_container);
-  lv_label_set_text(mode_label, "Eco");
-  lv_obj_set_style_text_color(mode_label, lv_color_hex(0x00cc00), 0);
-  lv_obj_set_style_text_font(mode_label, &lv_font_montserrat_20, 0);
-  lv_obj_align(mode_label, LV_ALIGN_CENTER, 0, 15);
-
-  /* Left side info */
-  range_label = lv_label_create(scr);
-  lv_label_set_text(range_label, "Range 130 km");
-  lv_obj_set_style_text_color(range_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(range_label, &lv_font_montserrat_16, 0);
-  lv_obj_align(range_label, LV_ALIGN_LEFT_MID, 10, -60);
-
-  avg_wh_label = lv_label_create(scr);
-  lv_label_set_text(avg_wh_label, "Avg. 40 W/km");
-  lv_obj_set_style_text_color(avg_wh_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(avg_wh_label, &lv_font_montserrat_16, 0);
-  lv_obj_align(avg_wh_label, LV_ALIGN_LEFT_MID, 10, -20);
-
-  /* Right side info */
-  motor_temp_label = lv_label_create(scr);
-  lv_label_set_text(motor_temp_label, "Motor 30°C");
-  lv_obj_set_style_text_color(motor_temp_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(motor_temp_label, &lv_font_montserrat_16, 0);
-  lv_obj_align(motor_temp_label, LV_ALIGN_RIGHT_MID, -10, -60);
-
-  battery_temp_label = lv_label_create(scr);
-  lv_label_set_text(battery_temp_label, "Battery 30°C");
-  lv_obj_set_style_text_color(battery_temp_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(battery_temp_label, &lv_font_montserrat_16, 0);
-  lv_obj_align(battery_temp_label, LV_ALIGN_RIGHT_MID, -10, -20);
-
-  /* Bottom bar (trip/odo/avg) */
-  lv_obj_t *bottom_bar = lv_obj_create(scr);
-  lv_obj_set_size(bottom_bar, TFT_HOR_RES, 50);
-  lv_obj_align(bottom_bar, LV_ALIGN_BOTTOM_MID, 0, 0);
-  lv_obj_set_style_bg_color(bottom_bar, lv_color_white(), 0);
-  lv_obj_set_style_border_width(bottom_bar, 0, 0);
-  lv_obj_set_style_radius(bottom_bar, 0, 0);
-
-  trip_label = lv_label_create(bottom_bar);
-  lv_label_set_text(trip_label, "TRIP 130 km");
-  lv_obj_set_style_text_color(trip_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(trip_label, &lv_font_montserrat_14, 0);
-  lv_obj_align(trip_label, LV_ALIGN_LEFT_MID, 20, 0);
-
-  odo_label = lv_label_create(bottom_bar);
-  lv_label_set_text(odo_label, "ODO 1300 km");
-  lv_obj_set_style_text_color(odo_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(odo_label, &lv_font_montserrat_14, 0);
-  lv_obj_align(odo_label, LV_ALIGN_CENTER, 0, 0);
-
-  avg_kmh_label = lv_label_create(bottom_bar);
-  lv_label_set_text(avg_kmh_label, "AVG. 40 km/h");
-  lv_obj_set_style_text_color(avg_kmh_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(avg_kmh_label, &lv_font_montserrat_14, 0);
-  lv_obj_align(avg_kmh_label, LV_ALIGN_RIGHT_MID, -20, 0);
+/* Read what the serial port has without waiting for a complete line.
+ * Runs in the telemetry task, which also owns the capture file. */
+static size_t serial_read_cb(void *user_data, uint8_t *buf, size_t max_len) {
+  int avail = Serial.available();
+  if (avail <= 0) {
+    delay(1);
+    return 0;
+  }
 
-  Serial.println("EV dashboard UI created!");
+  size_t n = Serial.readBytes(buf, avail < (int)max_len ? avail : max_len);
+#if TELEMETRY_RECORD
+  if (rec_file) {
+    telemetry_rec_add(&recorder, millis(), buf, n);
+    if (millis() - last_rec_flush > 1000) {
+      rec_file.flush();
+      last_rec_flush = millis();
+    }
+  }
+#endif
+  return n;
 }
 
-/* Parse serial input and update values */
-void parse_serial_input(String input) {
-  Serial.println("=== Parsing input ===");
-  Serial.printf("Input: %s\n", input.c_str());
-  
-  int idx;
-  
-  if ((idx = input.indexOf("speed:")) >= 0) {
-    int comma_pos = input.indexOf(',', idx);
-    if (comma_pos < 0) comma_pos = input.length();
-    speed = input.substring(idx + 6, comma_pos).toInt();
-    Serial.printf("Parsed speed: %d\n", speed);
-  }
-  if ((idx = input.indexOf("range:")) >= 0) {
-    int comma_pos = input.indexOf(',', idx);
-    if (comma_pos < 0) comma_pos = input.length();
-    range = input.substring(idx + 6, comma_pos).toInt();
-    Serial.printf("Parsed range: %d\n", range);
-  }
-  if ((idx = input.indexOf("avg_wh:")) >= 0) {
-    int comma_pos = input.indexOf(',', idx);
-    if (comma_pos < 0) comma_pos = input.length();
-    avg_wh = input.substring(idx + 7, comma_pos).toInt();
-  }
-  if ((idx = input.indexOf("trip:")) >= 0) {
-    int comma_pos = input.indexOf(',', idx);
-    if (comma_pos < 0) comma_pos = input.length();
-    trip = input.substring(idx + 5, comma_pos).toInt();
-  }
-  if ((idx = input.indexOf("odo:")) >= 0) {
-    int comma_pos = input.indexOf(',', idx);
-    if (comma_pos < 0) comma_pos = input.length();
-    odo = input.substring(idx + 4, comma_pos).toInt();
-  }
-  if ((idx = input.indexOf("avg_kmh:")) >= 0) {
-    int comma_pos = input.indexOf(',', idx);
-    if (comma_pos < 0) comma_pos = input.length();
-    avg_kmh = input.substring(idx + 8, comma_pos).toInt();
-  }
-  if ((idx = input.indexOf("motor:")) >= 0) {
-    int comma_pos = input.indexOf(',', idx);
-    if (comma_pos < 0) comma_pos = input.length();
-    motor_temp = input.substring(idx + 6, comma_pos).toInt();
-  }
-  if ((idx = input.indexOf("battery:")) >= 0) {
-    int comma_pos = input.indexOf(',', idx);
-    if (comma_pos < 0) comma_pos = input.length();
-    battery_temp = input.substring(idx + 8, comma_pos).toInt();
-  }
-  if ((idx = input.indexOf("mode:")) >= 0) {
-    int comma_pos = input.indexOf(',', idx);
-    if (comma_pos < 0) comma_pos = input.length();
-    mode = input.substring(idx + 5, comma_pos);
-    mode.trim();
-    Serial.printf("Parsed mode: %s\n", mode.c_str());
+/* The clock only changes once a minute, update_time_display() skips the rest */
+static void update_clock_cb(lv_timer_t *timer) {
+  update_time_display(millis());
+}
+
+/* Runs in the telemetry task when a frame was queued */
+static void telemetry_notify_cb(void *user_data) {
+  run_loop_wake(&run_loop);
+}
+
+/* Apply the telemetry received so far. The run loop makes this timer ready
+ * for every queued frame, and it sleeps while no telemetry comes in. Several
+ * frames applied within a refresh period are still drawn once. */
+static void telemetry_drain_cb(lv_timer_t *timer) {
+  uint32_t t_arrived;
+  if (telemetry_ingest_drain(&ingest, &dash, NULL, &t_arrived) == 0) {
+    lv_timer_pause(timer);
+    return;
   }
-  if ((idx = input.indexOf("status:")) >= 0) {
-    int comma_pos = input.indexOf(',', idx);
-    if (comma_pos < 0) comma_pos = input.length();
-    status = input.substring(idx + 7, comma_pos);
-    status.trim();
-    Serial.printf("Parsed status: %s\n", status.c_str());
+
+  if (update_dashboard(&dash)) {
+#if LV_USE_SYSMON && LV_USE_LATENCY_MONITOR
+    lv_sysmon_latency_input(t_arrived);
+#endif
   }
-  
-  Serial.println("Parsing complete, updating dashboard...");
-  update_dashboard();
 }
 
 void setup() {
@@ -375,9 +285,13 @@ void setup() {
   delay(2000);
   Serial.println("\n=== EV Dashboard ===");
 
+  telemetry_data_init(&dash);
+  telemetry_ingest_init(&ingest, serial_read_cb, NULL);
+  telemetry_ingest_set_notify_cb(&ingest, telemetry_notify_cb, NULL);
+
   /* Initialize SD Card */
   Serial.println("Initializing SD Card...");
-  SPIClass spi = SPIClass(VSPI);
+  static SPIClass spi = SPIClass(VSPI);
   spi.begin(18, 19, 23, SD_CS);
 
   if (!SD.begin(SD_CS, spi)) {
@@ -392,37 +306,61 @@ void setup() {
     while (1) delay(1000);
   }
 
+#if TELEMETRY_RECORD
+  rec_file = SD.open(TELEMETRY_REC_PATH, FILE_WRITE);
+  if (rec_file) {
+    telemetry_rec_start(&recorder, rec_write_cb, &rec_file);
+    Serial.println("Recording telemetry to " TELEMETRY_REC_PATH);
+  } else {
+    Serial.println("ERROR: Failed to open telemetry capture!");
+  }
+#else
   SD.end();
   Serial.println("SD card closed");
+#endif
 
   /* Initialize LVGL */
   lv_init();
   Serial.println("LVGL initialized");
 
   /* Initialize touch */
-  Wire.begin(TOUCH_SDA, TOUCH_SCL);
-  ts.begin(TOUCH_INT, TOUCH_RST);
-  Serial.println("Touch initialized");
-
-  /* Allocate draw buffer */
-  draw_buf = heap_caps_malloc(
-      TFT_HOR_RES * 40 * (LV_COLOR_DEPTH / 8),
-      MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
-
-  if (!draw_buf) {
-    Serial.println("ERROR: Draw buffer allocation failed!");
-    while (1) delay(1000);
+  Wire.begin(TOUCH_SDA, TOUCH_SCL, 400000);
+  touch_reset();
+  gt911_i2c_t touch_i2c = {touch_i2c_read, touch_i2c_write, NULL};
+  gt911_init(&touch, &touch_i2c);
+  if (gt911_probe(&touch)) {
+    Serial.printf("Touch initialized: GT%s, %ux%u\n", touch.product_id, touch.hor_res, touch.ver_res);
+  } else {
+    Serial.println("ERROR: Touch controller not found!");
+  }
+  /* Mounted rotated: x = TFT_HOR_RES - 1 - y, y = x */
+  gt911_set_flags(&touch, GT911_SWAP_XY | GT911_INVERT_X);
+
+  /* Allocate draw buffers */
+  for (int i = 0; i < (DISPLAY_DMA ? 2 : 1); i++) {
+    draw_buf[i] = heap_caps_malloc(DRAW_BUF_SIZE, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (!draw_buf[i]) {
+      Serial.println("ERROR: Draw buffer allocation failed!");
+      while (1) delay(1000);
+    }
   }
 
   /* Create display - MAKE GLOBAL */
-  disp = lv_tft_espi_create(
-      TFT_HOR_RES, TFT_VER_RES, draw_buf,
-      TFT_HOR_RES * 40 * (LV_COLOR_DEPTH / 8));
-
-  /* Setup touch input */
-  lv_indev_t *indev = lv_indev_create();
-  lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
-  lv_indev_set_read_cb(indev, my_touch_read);
+#if DISPLAY_DMA
+  disp = lv_tft_espi_create_dma(TFT_HOR_RES, TFT_VER_RES, draw_buf[0], draw_buf[1], DRAW_BUF_SIZE);
+#else
+  disp = lv_tft_espi_create(TFT_HOR_RES, TFT_VER_RES, draw_buf[0], DRAW_BUF_SIZE);
+#endif
+  /* Render in the panel's byte order, the flush sends the buffer as is */
+  lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565_SWAPPED);
+  /* Labels set to what they show already send nothing, changed ones only their changed tiles */
+  lv_display_set_tile_hash(disp, true);
+  lv_display_set_time_cb(disp, display_time_cb);
+
+  dashboard_attach_stats(disp);
+
+  /* Setup touch input, fed from loop() after INT pulses */
+  gt911_create_indev(&touch);
 
   /* Show splash screen */
   lv_obj_t *scr = lv_scr_act();
@@ -455,35 +393,53 @@ void setup() {
     image_data = NULL;
   }
 
+#if LV_USE_FONT_FMT_TXT_LUT
+  /* Find the glyphs of the dashboard's Latin fonts in a table instead of their cmaps */
+  const lv_font_t *lut_fonts[] = {&lv_font_montserrat_14, &lv_font_montserrat_16, &lv_font_montserrat_18,
+                                  &lv_font_montserrat_20, &lv_font_montserrat_48};
+  for (const lv_font_t *font : lut_fonts) lv_font_fmt_txt_create_lut(font);
+#endif
+
   /* Create dashboard */
+  Serial.println("Creating EV dashboard UI...");
   create_ev_dashboard_ui();
+  update_dashboard(&dash);
+  Serial.println("EV dashboard UI created!");
   lv_refr_now(disp);
 
+  static const lv_display_pacing_t pacing = {REFR_MIN_PERIOD_MS, REFR_MAX_PERIOD_MS, REFR_CPU_BUDGET};
+  lv_display_set_pacing(disp, &pacing);
+
+  /* Created after the display, so they run just before its refresh timer */
+  lv_timer_create(update_clock_cb, 1000, NULL);
+  lv_timer_create(print_dashboard_stats, STATS_PERIOD_MS, NULL);
+  lv_timer_t *drain_timer = lv_timer_create(telemetry_drain_cb, LV_DEF_REFR_PERIOD, NULL);
+
+  /* Ready before the reader task starts: its first frames wake the loop */
+  run_loop_init(&run_loop, LOOP_MAX_SLEEP_MS);
+  run_loop_set_wake_timer(&run_loop, drain_timer);
+
+  ingest_task = telemetry_ingest_start(&ingest, LV_THREAD_PRIO_MID) == LV_RESULT_OK;
+  if (!ingest_task) {
+    /* Without the task loop() polls the serial port, which waits 1 ms when idle */
+    Serial.println("No telemetry task, reading serial from loop()");
+    run_loop_deinit(&run_loop);
+    run_loop_init(&run_loop, 0);
+    run_loop_set_wake_timer(&run_loop, drain_timer);
+  }
+
+  /* For the level triggered modes catch the start of the level */
+  bool int_rising = touch.int_trigger == 0 || touch.int_trigger == 3;
+  attachInterrupt(digitalPinToInterrupt(TOUCH_INT), touch_isr, int_rising ? RISING : FALLING);
+
   Serial.println("\n=== Setup Complete ===");
   Serial.println("Send data in format:");
   Serial.println("speed:99,range:130,avg_wh:40,trip:130,odo:1300,avg_kmh:40,motor:30,battery:30,mode:Sport,status:ARMED");
+  Serial.println("or as binary telemetry frames (see telemetry.h)");
 }
 
-unsigned long last_time_update = 0;
-
 void loop() {
-  lv_timer_handler();
-  
-  // Update time every second
-  if (millis() - last_time_update > 1000) {
-    update_time_display();
-    last_time_update = millis();
-  }
-  
-  // Read serial input
-  if (Serial.available()) {
-    String input = Serial.readStringUntil('\n');
-    input.trim();
-    if (input.length() > 0) {
-      Serial.printf("Received: %s\n", input.c_str());
-      parse_serial_input(input);
-    }
-  }
-  
-  delay(5);
+  if (!ingest_task) telemetry_ingest_poll(&ingest);
+  gt911_handle(&touch);
+  run_loop_step(&run_loop);
 }
\ No newline at end of file
@@ -0,0 +1,189 @@
+/**
+ * @file run_loop.cpp
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "run_loop.h"
+
+#if LV_USE_OS == LV_OS_PTHREAD
+#include <errno.h>
+#include <time.h>
+#endif
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void resume_cb(void *data);
+static void os_init(run_loop_t *rl);
+static void os_deinit(run_loop_t *rl);
+static bool os_in_loop(run_loop_t *rl);
+static void os_signal(run_loop_t *rl);
+static bool os_wait(run_loop_t *rl, uint32_t ms);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void run_loop_init(run_loop_t *rl, uint32_t max_sleep_ms) {
+  lv_memzero(rl, sizeof(*rl));
+  rl->max_sleep_ms = max_sleep_ms;
+  os_init(rl);
+  lv_timer_handler_set_resume_cb(resume_cb, rl);
+}
+
+void run_loop_deinit(run_loop_t *rl) {
+  lv_timer_handler_set_resume_cb(NULL, NULL);
+  os_deinit(rl);
+}
+
+void run_loop_set_wake_timer(run_loop_t *rl, lv_timer_t *timer) {
+  rl->wake_timer = timer;
+}
+
+uint32_t run_loop_step(run_loop_t *rl) {
+  if (__atomic_exchange_n(&rl->wake_pending, false, __ATOMIC_ACQ_REL) && rl->wake_timer) {
+    lv_timer_resume(rl->wake_timer);
+    lv_timer_ready(rl->wake_timer);
+  }
+
+  uint32_t next = lv_timer_handler();
+  rl->stats.iterations++;
+
+  uint32_t ms = next < rl->max_sleep_ms ? next : rl->max_sleep_ms;
+  if (ms == 0) return 0;
+
+  uint32_t t0 = lv_tick_get();
+  if (os_wait(rl, ms)) rl->stats.woken++;
+  uint32_t slept = lv_tick_elaps(t0);
+  rl->stats.slept_ms += slept;
+  return slept;
+}
+
+void run_loop_wake(run_loop_t *rl) {
+  __atomic_store_n(&rl->wake_pending, true, __ATOMIC_RELEASE);
+  os_signal(rl);
+}
+
+#if LV_USE_OS == LV_OS_FREERTOS
+void run_loop_wake_isr(run_loop_t *rl) {
+  __atomic_store_n(&rl->wake_pending, true, __ATOMIC_RELEASE);
+
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(rl->task, &woken);
+  portYIELD_FROM_ISR(woken);
+}
+#endif
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* LVGL resumed a timer. In the loop's own task the next deadline is computed
+ * after lv_timer_handler() anyway, so only other tasks have to wake it. */
+static void resume_cb(void *data) {
+  run_loop_t *rl = (run_loop_t *)data;
+  if (!os_in_loop(rl)) os_signal(rl);
+}
+
+#if LV_USE_OS == LV_OS_FREERTOS
+
+static void os_init(run_loop_t *rl) {
+  rl->task = xTaskGetCurrentTaskHandle();
+}
+
+static void os_deinit(run_loop_t *rl) {
+  LV_UNUSED(rl);
+}
+
+static bool os_in_loop(run_loop_t *rl) {
+  return xTaskGetCurrentTaskHandle() == rl->task;
+}
+
+static void os_signal(run_loop_t *rl) {
+  xTaskNotifyGive(rl->task);
+}
+
+static bool os_wait(run_loop_t *rl, uint32_t ms) {
+  LV_UNUSED(rl);
+  return ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ms)) != 0;
+}
+
+#elif LV_USE_OS == LV_OS_PTHREAD
+
+static void os_init(run_loop_t *rl) {
+  rl->thread = pthread_self();
+  pthread_mutex_init(&rl->lock, NULL);
+
+  /* Deadlines must not move with the wall clock */
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&rl->cond, &attr);
+  pthread_condattr_destroy(&attr);
+}
+
+static void os_deinit(run_loop_t *rl) {
+  pthread_cond_destroy(&rl->cond);
+  pthread_mutex_destroy(&rl->lock);
+}
+
+static bool os_in_loop(run_loop_t *rl) {
+  return pthread_equal(pthread_self(), rl->thread);
+}
+
+static void os_signal(run_loop_t *rl) {
+  pthread_mutex_lock(&rl->lock);
+  rl->signaled = true;
+  pthread_cond_signal(&rl->cond);
+  pthread_mutex_unlock(&rl->lock);
+}
+
+static bool os_wait(run_loop_t *rl, uint32_t ms) {
+  struct timespec deadline;
+  clock_gettime(CLOCK_MONOTONIC, &deadline);
+  deadline.tv_sec += ms / 1000;
+  deadline.tv_nsec += (long)(ms % 1000) * 1000000;
+  if (deadline.tv_nsec >= 1000000000) {
+    deadline.tv_sec++;
+    deadline.tv_nsec -= 1000000000;
+  }
+
+  pthread_mutex_lock(&rl->lock);
+  while (!rl->signaled) {
+    if (pthread_cond_timedwait(&rl->cond, &rl->lock, &deadline) == ETIMEDOUT) break;
+  }
+  bool woken = rl->signaled;
+  rl->signaled = false;
+  pthread_mutex_unlock(&rl->lock);
+  return woken;
+}
+
+#else
+
+static void os_init(run_loop_t *rl) {
+  LV_UNUSED(rl);
+}
+
+static void os_deinit(run_loop_t *rl) {
+  LV_UNUSED(rl);
+}
+
+static bool os_in_loop(run_loop_t *rl) {
+  LV_UNUSED(rl);
+  return true;
+}
+
+static void os_signal(run_loop_t *rl) {
+  LV_UNUSED(rl);
+}
+
+static bool os_wait(run_loop_t *rl, uint32_t ms) {
+  LV_UNUSED(rl);
+  lv_delay_ms(ms);
+  return false;
+}
+
+#endif
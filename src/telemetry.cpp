@@ -0,0 +1,466 @@
+/**
+ * @file telemetry.cpp
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "telemetry.h"
+#include <stdio.h>
+#include <string.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define RX_MASK (TELEMETRY_RX_BUF_SIZE - 1)
+
+#if (TELEMETRY_RX_BUF_SIZE & RX_MASK) != 0 || TELEMETRY_RX_BUF_SIZE < TELEMETRY_FRAME_MAX
+#error "TELEMETRY_RX_BUF_SIZE must be a power of two and hold a full frame"
+#endif
+
+/* Byte offsets inside the v1 payload */
+#define V1_FIELD_MASK   0
+#define V1_SEQ          2
+#define V1_SPEED        4
+#define V1_RANGE        6
+#define V1_AVG_WH       8
+#define V1_AVG_KMH      10
+#define V1_MOTOR_TEMP   12
+#define V1_BATTERY_TEMP 14
+#define V1_TRIP         16
+#define V1_ODO          20
+#define V1_MODE         24
+#define V1_STATUS       (V1_MODE + TELEMETRY_MODE_LEN)
+
+#if V1_STATUS + TELEMETRY_STATUS_LEN != TELEMETRY_PAYLOAD_V1_SIZE
+#error "v1 payload layout does not add up"
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+  const char *key;
+  uint8_t key_len;
+  telemetry_field_t field;
+} ascii_key_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static inline uint32_t rx_used(const telemetry_rx_t *rx);
+static inline uint8_t rx_peek(const telemetry_rx_t *rx, uint32_t ofs);
+static uint16_t rx_peek_u16(const telemetry_rx_t *rx, uint32_t ofs);
+static uint32_t rx_peek_u32(const telemetry_rx_t *rx, uint32_t ofs);
+static void rx_peek_str(const telemetry_rx_t *rx, uint32_t ofs, char *dst, uint32_t len);
+static inline void rx_drop(telemetry_rx_t *rx, uint32_t n);
+static telemetry_format_t rx_poll_binary(telemetry_rx_t *rx, telemetry_data_t *data, uint16_t *changed);
+static telemetry_format_t rx_poll_ascii(telemetry_rx_t *rx, telemetry_data_t *data, uint16_t *changed);
+static int32_t parse_int(const char *s, const char *end);
+static void copy_trimmed(char *dst, size_t dst_size, const char *s, const char *end);
+static inline void put_u16(uint8_t *p, uint16_t v);
+static inline void put_u32(uint8_t *p, uint32_t v);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+/* CRC-16/CCITT-FALSE, one step per byte */
+static const uint16_t crc16_table[256] = {
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+  0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef,
+  0x1231, 0x0210, 0x3273, 0x2252, 0x52b5, 0x4294, 0x72f7, 0x62d6,
+  0x9339, 0x8318, 0xb37b, 0xa35a, 0xd3bd, 0xc39c, 0xf3ff, 0xe3de,
+  0x2462, 0x3443, 0x0420, 0x1401, 0x64e6, 0x74c7, 0x44a4, 0x5485,
+  0xa56a, 0xb54b, 0x8528, 0x9509, 0xe5ee, 0xf5cf, 0xc5ac, 0xd58d,
+  0x3653, 0x2672, 0x1611, 0x0630, 0x76d7, 0x66f6, 0x5695, 0x46b4,
+  0xb75b, 0xa77a, 0x9719, 0x8738, 0xf7df, 0xe7fe, 0xd79d, 0xc7bc,
+  0x48c4, 0x58e5, 0x6886, 0x78a7, 0x0840, 0x1861, 0x2802, 0x3823,
+  0xc9cc, 0xd9ed, 0xe98e, 0xf9af, 0x8948, 0x9969, 0xa90a, 0xb92b,
+  0x5af5, 0x4ad4, 0x7ab7, 0x6a96, 0x1a71, 0x0a50, 0x3a33, 0x2a12,
+  0xdbfd, 0xcbdc, 0xfbbf, 0xeb9e, 0x9b79, 0x8b58, 0xbb3b, 0xab1a,
+  0x6ca6, 0x7c87, 0x4ce4, 0x5cc5, 0x2c22, 0x3c03, 0x0c60, 0x1c41,
+  0xedae, 0xfd8f, 0xcdec, 0xddcd, 0xad2a, 0xbd0b, 0x8d68, 0x9d49,
+  0x7e97, 0x6eb6, 0x5ed5, 0x4ef4, 0x3e13, 0x2e32, 0x1e51, 0x0e70,
+  0xff9f, 0xefbe, 0xdfdd, 0xcffc, 0xbf1b, 0xaf3a, 0x9f59, 0x8f78,
+  0x9188, 0x81a9, 0xb1ca, 0xa1eb, 0xd10c, 0xc12d, 0xf14e, 0xe16f,
+  0x1080, 0x00a1, 0x30c2, 0x20e3, 0x5004, 0x4025, 0x7046, 0x6067,
+  0x83b9, 0x9398, 0xa3fb, 0xb3da, 0xc33d, 0xd31c, 0xe37f, 0xf35e,
+  0x02b1, 0x1290, 0x22f3, 0x32d2, 0x4235, 0x5214, 0x6277, 0x7256,
+  0xb5ea, 0xa5cb, 0x95a8, 0x8589, 0xf56e, 0xe54f, 0xd52c, 0xc50d,
+  0x34e2, 0x24c3, 0x14a0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+  0xa7db, 0xb7fa, 0x8799, 0x97b8, 0xe75f, 0xf77e, 0xc71d, 0xd73c,
+  0x26d3, 0x36f2, 0x0691, 0x16b0, 0x6657, 0x7676, 0x4615, 0x5634,
+  0xd94c, 0xc96d, 0xf90e, 0xe92f, 0x99c8, 0x89e9, 0xb98a, 0xa9ab,
+  0x5844, 0x4865, 0x7806, 0x6827, 0x18c0, 0x08e1, 0x3882, 0x28a3,
+  0xcb7d, 0xdb5c, 0xeb3f, 0xfb1e, 0x8bf9, 0x9bd8, 0xabbb, 0xbb9a,
+  0x4a75, 0x5a54, 0x6a37, 0x7a16, 0x0af1, 0x1ad0, 0x2ab3, 0x3a92,
+  0xfd2e, 0xed0f, 0xdd6c, 0xcd4d, 0xbdaa, 0xad8b, 0x9de8, 0x8dc9,
+  0x7c26, 0x6c07, 0x5c64, 0x4c45, 0x3ca2, 0x2c83, 0x1ce0, 0x0cc1,
+  0xef1f, 0xff3e, 0xcf5d, 0xdf7c, 0xaf9b, 0xbfba, 0x8fd9, 0x9ff8,
+  0x6e17, 0x7e36, 0x4e55, 0x5e74, 0x2e93, 0x3eb2, 0x0ed1, 0x1ef0,
+};
+
+static const ascii_key_t ascii_keys[] = {
+  {"speed",   5, TELEMETRY_FIELD_SPEED},
+  {"range",   5, TELEMETRY_FIELD_RANGE},
+  {"avg_wh",  6, TELEMETRY_FIELD_AVG_WH},
+  {"trip",    4, TELEMETRY_FIELD_TRIP},
+  {"odo",     3, TELEMETRY_FIELD_ODO},
+  {"avg_kmh", 7, TELEMETRY_FIELD_AVG_KMH},
+  {"motor",   5, TELEMETRY_FIELD_MOTOR_TEMP},
+  {"battery", 7, TELEMETRY_FIELD_BATTERY_TEMP},
+  {"mode",    4, TELEMETRY_FIELD_MODE},
+  {"status",  6, TELEMETRY_FIELD_STATUS},
+};
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void telemetry_data_init(telemetry_data_t *data) {
+  memset(data, 0, sizeof(*data));
+  data->speed = 0;
+  data->range = 130;
+  data->avg_wh = 40;
+  data->trip = 130;
+  data->odo = 1300;
+  data->avg_kmh = 40;
+  data->motor_temp = 30;
+  data->battery_temp = 30;
+  strcpy(data->mode, "Eco");
+  strcpy(data->status, "DISARMED");
+}
+
+void telemetry_rx_init(telemetry_rx_t *rx) {
+  memset(rx, 0, sizeof(*rx));
+}
+
+size_t telemetry_rx_free(const telemetry_rx_t *rx) {
+  return TELEMETRY_RX_BUF_SIZE - rx_used(rx);
+}
+
+size_t telemetry_rx_push(telemetry_rx_t *rx, const uint8_t *bytes, size_t len) {
+  size_t n = telemetry_rx_free(rx);
+  if (n > len) n = len;
+  rx->stats.overflows += (uint32_t)(len - n);
+
+  /* Copy in at most two runs: up to the end of the buffer, then from the start */
+  uint32_t pos = rx->tail & RX_MASK;
+  size_t first = TELEMETRY_RX_BUF_SIZE - pos;
+  if (first > n) first = n;
+  memcpy(&rx->buf[pos], bytes, first);
+  memcpy(&rx->buf[0], bytes + first, n - first);
+  rx->tail += (uint32_t)n;
+  return n;
+}
+
+telemetry_format_t telemetry_rx_poll(telemetry_rx_t *rx, telemetry_data_t *data, uint16_t *changed) {
+  if (changed) *changed = 0;
+
+  while (rx_used(rx) > 0) {
+    uint32_t head = rx->head;
+    telemetry_format_t res;
+    /* A frame starts a line: a sync byte inside a line is just a character of it */
+    if (rx_peek(rx, 0) == TELEMETRY_SYNC0 && (!rx->discard_line || rx->resync)) {
+      rx->discard_line = false;
+      res = rx_poll_binary(rx, data, changed);
+    } else {
+      res = rx_poll_ascii(rx, data, changed);
+    }
+    if (res != TELEMETRY_FORMAT_NONE) return res;
+
+    /* Nothing consumed: wait for more bytes */
+    if (rx->head == head) break;
+  }
+
+  return TELEMETRY_FORMAT_NONE;
+}
+
+uint16_t telemetry_parse_line(const char *line, size_t len, telemetry_data_t *data) {
+  uint16_t written = 0;
+  const char *p = line;
+  const char *end = line + len;
+
+  while (p < end) {
+    const char *tok_end = (const char *)memchr(p, ',', (size_t)(end - p));
+    if (tok_end == NULL) tok_end = end;
+
+    const char *colon = (const char *)memchr(p, ':', (size_t)(tok_end - p));
+    if (colon) {
+      const char *key = p;
+      const char *key_end = colon;
+      while (key < key_end && (*key == ' ' || *key == '\t')) key++;
+      while (key_end > key && (key_end[-1] == ' ' || key_end[-1] == '\t')) key_end--;
+      size_t key_len = (size_t)(key_end - key);
+
+      for (size_t i = 0; i < sizeof(ascii_keys) / sizeof(ascii_keys[0]); i++) {
+        const ascii_key_t *k = &ascii_keys[i];
+        if (k->key_len != key_len || memcmp(k->key, key, key_len) != 0) continue;
+
+        const char *val = colon + 1;
+        switch (k->field) {
+          case TELEMETRY_FIELD_SPEED:        data->speed = parse_int(val, tok_end); break;
+          case TELEMETRY_FIELD_RANGE:        data->range = parse_int(val, tok_end); break;
+          case TELEMETRY_FIELD_AVG_WH:       data->avg_wh = parse_int(val, tok_end); break;
+          case TELEMETRY_FIELD_TRIP:         data->trip = parse_int(val, tok_end); break;
+          case TELEMETRY_FIELD_ODO:          data->odo = parse_int(val, tok_end); break;
+          case TELEMETRY_FIELD_AVG_KMH:      data->avg_kmh = parse_int(val, tok_end); break;
+          case TELEMETRY_FIELD_MOTOR_TEMP:   data->motor_temp = parse_int(val, tok_end); break;
+          case TELEMETRY_FIELD_BATTERY_TEMP: data->battery_temp = parse_int(val, tok_end); break;
+          case TELEMETRY_FIELD_MODE:
+            copy_trimmed(data->mode, sizeof(data->mode), val, tok_end);
+            break;
+          case TELEMETRY_FIELD_STATUS:
+            copy_trimmed(data->status, sizeof(data->status), val, tok_end);
+            break;
+          default:
+            break;
+        }
+        written |= TELEMETRY_FIELD_BIT(k->field);
+        break;
+      }
+    }
+
+    p = tok_end + 1;
+  }
+
+  return written;
+}
+
+size_t telemetry_encode_frame(const telemetry_data_t *data, uint16_t mask, uint16_t seq,
+                              uint8_t *out, size_t out_size) {
+  const size_t frame_len = TELEMETRY_HEADER_SIZE + TELEMETRY_PAYLOAD_V1_SIZE + TELEMETRY_CRC_SIZE;
+  if (out_size < frame_len) return 0;
+
+  out[0] = TELEMETRY_SYNC0;
+  out[1] = TELEMETRY_SYNC1;
+  out[2] = TELEMETRY_VERSION;
+  out[3] = TELEMETRY_PAYLOAD_V1_SIZE;
+
+  uint8_t *pl = &out[TELEMETRY_HEADER_SIZE];
+  memset(pl, 0, TELEMETRY_PAYLOAD_V1_SIZE);
+  put_u16(pl + V1_FIELD_MASK, mask & TELEMETRY_FIELD_ALL);
+  put_u16(pl + V1_SEQ, seq);
+  put_u16(pl + V1_SPEED, (uint16_t)data->speed);
+  put_u16(pl + V1_RANGE, (uint16_t)data->range);
+  put_u16(pl + V1_AVG_WH, (uint16_t)data->avg_wh);
+  put_u16(pl + V1_AVG_KMH, (uint16_t)data->avg_kmh);
+  put_u16(pl + V1_MOTOR_TEMP, (uint16_t)data->motor_temp);
+  put_u16(pl + V1_BATTERY_TEMP, (uint16_t)data->battery_temp);
+  put_u32(pl + V1_TRIP, (uint32_t)data->trip);
+  put_u32(pl + V1_ODO, (uint32_t)data->odo);
+  snprintf((char *)pl + V1_MODE, TELEMETRY_MODE_LEN, "%s", data->mode);
+  snprintf((char *)pl + V1_STATUS, TELEMETRY_STATUS_LEN, "%s", data->status);
+
+  uint16_t crc = telemetry_crc16(0xFFFF, &out[2], 2 + TELEMETRY_PAYLOAD_V1_SIZE);
+  put_u16(&out[TELEMETRY_HEADER_SIZE + TELEMETRY_PAYLOAD_V1_SIZE], crc);
+  return frame_len;
+}
+
+uint16_t telemetry_crc16(uint16_t crc, const uint8_t *data, size_t len) {
+  while (len--) {
+    crc = (uint16_t)((crc << 8) ^ crc16_table[(uint8_t)((crc >> 8) ^ *data++)]);
+  }
+  return crc;
+}
+
+const char *telemetry_field_name(telemetry_field_t field) {
+  for (size_t i = 0; i < sizeof(ascii_keys) / sizeof(ascii_keys[0]); i++) {
+    if (ascii_keys[i].field == field) return ascii_keys[i].key;
+  }
+  return "?";
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static inline uint32_t rx_used(const telemetry_rx_t *rx) {
+  return rx->tail - rx->head;
+}
+
+static inline uint8_t rx_peek(const telemetry_rx_t *rx, uint32_t ofs) {
+  return rx->buf[(rx->head + ofs) & RX_MASK];
+}
+
+static uint16_t rx_peek_u16(const telemetry_rx_t *rx, uint32_t ofs) {
+  return (uint16_t)(rx_peek(rx, ofs) | (rx_peek(rx, ofs + 1) << 8));
+}
+
+static uint32_t rx_peek_u32(const telemetry_rx_t *rx, uint32_t ofs) {
+  return (uint32_t)rx_peek_u16(rx, ofs) | ((uint32_t)rx_peek_u16(rx, ofs + 2) << 16);
+}
+
+static void rx_peek_str(const telemetry_rx_t *rx, uint32_t ofs, char *dst, uint32_t len) {
+  for (uint32_t i = 0; i < len - 1; i++) dst[i] = (char)rx_peek(rx, ofs + i);
+  dst[len - 1] = '\0';
+}
+
+static inline void rx_drop(telemetry_rx_t *rx, uint32_t n) {
+  rx->head += n;
+}
+
+/* The frame is decoded straight out of the ring: nothing is copied except the final field values */
+static telemetry_format_t rx_poll_binary(telemetry_rx_t *rx, telemetry_data_t *data, uint16_t *changed) {
+  uint32_t avail = rx_used(rx);
+  if (avail < 2) return TELEMETRY_FORMAT_NONE;
+  if (rx_peek(rx, 1) != TELEMETRY_SYNC1) {
+    /* A lone sync byte: skip it and resynchronize */
+    rx->resync = true;
+    rx_drop(rx, 1);
+    return TELEMETRY_FORMAT_NONE;
+  }
+  if (avail < TELEMETRY_HEADER_SIZE) return TELEMETRY_FORMAT_NONE;
+
+  uint8_t version = rx_peek(rx, 2);
+  uint32_t len = rx_peek(rx, 3);
+  uint32_t frame_len = TELEMETRY_HEADER_SIZE + len + TELEMETRY_CRC_SIZE;
+  if (avail < frame_len) return TELEMETRY_FORMAT_NONE;
+
+  /* CRC over version..payload in at most two contiguous runs of the ring */
+  uint32_t crc_start = (rx->head + 2) & RX_MASK;
+  uint32_t crc_len = 2 + len;
+  uint32_t first = TELEMETRY_RX_BUF_SIZE - crc_start;
+  if (first > crc_len) first = crc_len;
+  uint16_t crc = telemetry_crc16(0xFFFF, &rx->buf[crc_start], first);
+  crc = telemetry_crc16(crc, &rx->buf[0], crc_len - first);
+  if (crc != rx_peek_u16(rx, TELEMETRY_HEADER_SIZE + len)) {
+    /* Could be a false sync inside other data: drop only the sync byte */
+    rx->stats.crc_errors++;
+    rx->resync = true;
+    rx_drop(rx, 1);
+    return TELEMETRY_FORMAT_NONE;
+  }
+
+  rx->resync = false;
+  if (version < 1 || len < TELEMETRY_PAYLOAD_V1_SIZE) {
+    rx->stats.version_errors++;
+    rx_drop(rx, frame_len);
+    return TELEMETRY_FORMAT_NONE;
+  }
+
+  const uint32_t pl = TELEMETRY_HEADER_SIZE;
+  uint16_t mask = rx_peek_u16(rx, pl + V1_FIELD_MASK) & TELEMETRY_FIELD_ALL;
+  uint16_t seq = rx_peek_u16(rx, pl + V1_SEQ);
+  /* A gap of more than half the range is taken for a restarted sender */
+  uint16_t gap = (uint16_t)(seq - rx->seq - 1);
+  if (rx->seq_valid && gap < 0x8000) rx->stats.frames_lost += gap;
+  rx->seq = seq;
+  rx->seq_valid = true;
+
+  if (mask & TELEMETRY_FIELD_BIT(TELEMETRY_FIELD_SPEED))
+    data->speed = (int16_t)rx_peek_u16(rx, pl + V1_SPEED);
+  if (mask & TELEMETRY_FIELD_BIT(TELEMETRY_FIELD_RANGE))
+    data->range = (int16_t)rx_peek_u16(rx, pl + V1_RANGE);
+  if (mask & TELEMETRY_FIELD_BIT(TELEMETRY_FIELD_AVG_WH))
+    data->avg_wh = (int16_t)rx_peek_u16(rx, pl + V1_AVG_WH);
+  if (mask & TELEMETRY_FIELD_BIT(TELEMETRY_FIELD_AVG_KMH))
+    data->avg_kmh = (int16_t)rx_peek_u16(rx, pl + V1_AVG_KMH);
+  if (mask & TELEMETRY_FIELD_BIT(TELEMETRY_FIELD_MOTOR_TEMP))
+    data->motor_temp = (int16_t)rx_peek_u16(rx, pl + V1_MOTOR_TEMP);
+  if (mask & TELEMETRY_FIELD_BIT(TELEMETRY_FIELD_BATTERY_TEMP))
+    data->battery_temp = (int16_t)rx_peek_u16(rx, pl + V1_BATTERY_TEMP);
+  if (mask & TELEMETRY_FIELD_BIT(TELEMETRY_FIELD_TRIP))
+    data->trip = (int32_t)rx_peek_u32(rx, pl + V1_TRIP);
+  if (mask & TELEMETRY_FIELD_BIT(TELEMETRY_FIELD_ODO))
+    data->odo = (int32_t)rx_peek_u32(rx, pl + V1_ODO);
+  if (mask & TELEMETRY_FIELD_BIT(TELEMETRY_FIELD_MODE))
+    rx_peek_str(rx, pl + V1_MODE, data->mode, TELEMETRY_MODE_LEN);
+  if (mask & TELEMETRY_FIELD_BIT(TELEMETRY_FIELD_STATUS))
+    rx_peek_str(rx, pl + V1_STATUS, data->status, TELEMETRY_STATUS_LEN);
+
+  rx_drop(rx, frame_len);
+  rx->stats.frames_binary++;
+  if (changed) *changed = mask;
+  return TELEMETRY_FORMAT_BINARY;
+}
+
+static telemetry_format_t rx_poll_ascii(telemetry_rx_t *rx, telemetry_data_t *data, uint16_t *changed) {
+  uint32_t avail = rx_used(rx);
+  uint32_t scan = avail < TELEMETRY_LINE_MAX ? avail : TELEMETRY_LINE_MAX;
+  uint32_t len;
+
+  /* After a bad frame the next sync byte may start a good one, and what's before it isn't a line */
+  for (len = 0; len < scan; len++) {
+    uint8_t c = rx_peek(rx, len);
+    if (c == '\n' || (rx->resync && c == TELEMETRY_SYNC0)) break;
+  }
+
+  if (len == scan) {
+    if (scan == TELEMETRY_LINE_MAX || rx->discard_line) {
+      /* Too long to ever be valid: throw it away up to the next newline */
+      if (!rx->discard_line) rx->stats.line_too_long++;
+      rx->discard_line = true;
+      rx_drop(rx, scan);
+    }
+    return TELEMETRY_FORMAT_NONE;
+  }
+
+  bool newline = rx_peek(rx, len) == '\n';
+  bool discard = rx->discard_line || !newline;
+  rx->discard_line = false;
+  if (newline) rx->resync = false;
+
+  /* Parse in place if the line does not wrap, otherwise linearize it on the stack */
+  uint32_t start = rx->head & RX_MASK;
+  const char *line = (const char *)&rx->buf[start];
+  char tmp[TELEMETRY_LINE_MAX];
+  if (start + len > TELEMETRY_RX_BUF_SIZE) {
+    for (uint32_t i = 0; i < len; i++) tmp[i] = (char)rx_peek(rx, i);
+    line = tmp;
+  }
+
+  uint32_t line_len = len;
+  while (line_len > 0 && (line[line_len - 1] == '\r' || line[line_len - 1] == ' ')) line_len--;
+
+  uint16_t written = 0;
+  if (!discard && line_len > 0) written = telemetry_parse_line(line, line_len, data);
+
+  rx_drop(rx, newline ? len + 1 : len);
+  if (written == 0) return TELEMETRY_FORMAT_NONE;
+
+  rx->stats.frames_ascii++;
+  if (changed) *changed = written;
+  return TELEMETRY_FORMAT_ASCII;
+}
+
+/* Like Arduino's String::toInt(): optional sign, then digits until the first non-digit */
+static int32_t parse_int(const char *s, const char *end) {
+  while (s < end && (*s == ' ' || *s == '\t')) s++;
+
+  bool neg = false;
+  if (s < end && (*s == '-' || *s == '+')) {
+    neg = *s == '-';
+    s++;
+  }
+
+  /* Clamp instead of overflowing on a long run of digits */
+  int64_t v = 0;
+  while (s < end && *s >= '0' && *s <= '9') {
+    if (v <= INT32_MAX) v = v * 10 + (*s - '0');
+    s++;
+  }
+  if (v > INT32_MAX) v = INT32_MAX;
+  return (int32_t)(neg ? -v : v);
+}
+
+static void copy_trimmed(char *dst, size_t dst_size, const char *s, const char *end) {
+  while (s < end && (*s == ' ' || *s == '\t' || *s == '\r')) s++;
+  while (end > s && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) end--;
+
+  size_t n = (size_t)(end - s);
+  if (n > dst_size - 1) n = dst_size - 1;
+  memcpy(dst, s, n);
+  dst[n] = '\0';
+}
+
+static inline void put_u16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void put_u32(uint8_t *p, uint32_t v) {
+  put_u16(p, (uint16_t)v);
+  put_u16(p + 2, (uint16_t)(v >> 16));
+}
@@ -0,0 +1,172 @@
+/**
+ * @file telemetry_ingest.cpp
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "telemetry_ingest.h"
+#include <string.h>
+
+#if LV_USE_OS == LV_OS_PTHREAD
+#include <time.h>
+#endif
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void ingest_thread_cb(void *user_data);
+static void queue_frame(telemetry_ingest_t *ing, uint16_t changed, uint32_t t_read);
+static void flush_pending(telemetry_ingest_t *ing);
+static void sleep_1ms(void);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void telemetry_ingest_init(telemetry_ingest_t *ing, telemetry_read_cb_t read_cb, void *user_data) {
+  memset(ing, 0, sizeof(*ing));
+  telemetry_queue_init(&ing->queue);
+  telemetry_rx_init(&ing->rx);
+  telemetry_data_init(&ing->data);
+  ing->read_cb = read_cb;
+  ing->user_data = user_data;
+}
+
+void telemetry_ingest_set_notify_cb(telemetry_ingest_t *ing, telemetry_notify_cb_t notify_cb, void *user_data) {
+  ing->notify_cb = notify_cb;
+  ing->notify_user_data = user_data;
+}
+
+lv_result_t telemetry_ingest_start(telemetry_ingest_t *ing, lv_thread_prio_t prio) {
+#if LV_USE_OS != LV_OS_NONE
+  ing->exit = false;
+  ing->running = true;
+  if (lv_thread_init(&ing->thread, prio, ingest_thread_cb, TELEMETRY_INGEST_STACK_SIZE, ing) != LV_RESULT_OK) {
+    ing->running = false;
+    return LV_RESULT_INVALID;
+  }
+  ing->started = true;
+  return LV_RESULT_OK;
+#else
+  LV_UNUSED(ing);
+  LV_UNUSED(prio);
+  return LV_RESULT_INVALID;
+#endif
+}
+
+void telemetry_ingest_stop(telemetry_ingest_t *ing) {
+  if (!ing->started) return;
+
+  /* Let the task finish its read and leave the queue alone before it goes away */
+  __atomic_store_n(&ing->exit, true, __ATOMIC_RELEASE);
+  while (__atomic_load_n(&ing->running, __ATOMIC_ACQUIRE)) sleep_1ms();
+
+#if LV_USE_OS != LV_OS_FREERTOS
+  /* Join it. A FreeRTOS task deletes itself when its function returned. */
+  lv_thread_delete(&ing->thread);
+#endif
+  ing->started = false;
+}
+
+void telemetry_ingest_poll(telemetry_ingest_t *ing) {
+  /* A frame held back by a full queue goes first, even if nothing new arrives */
+  flush_pending(ing);
+
+  uint8_t chunk[TELEMETRY_INGEST_CHUNK];
+  size_t len = ing->read_cb(ing->user_data, chunk, sizeof(chunk));
+  if (len == 0) return;
+  ing->stats.bytes += (uint32_t)len;
+
+  /* A frame arrived with its first byte: in this chunk if nothing is buffered */
+  uint32_t t_read = lv_tick_get();
+  if (ing->rx.head == ing->rx.tail) ing->t_frame = t_read;
+
+  const uint8_t *bytes = chunk;
+  while (len > 0) {
+    size_t pushed = telemetry_rx_push(&ing->rx, bytes, len);
+    bytes += pushed;
+    len -= pushed;
+
+    uint16_t changed;
+    while (telemetry_rx_poll(&ing->rx, &ing->data, &changed) != TELEMETRY_FORMAT_NONE) {
+      queue_frame(ing, changed, t_read);
+    }
+
+    /* Decoding always frees space, so this only guards against a corrupted context */
+    if (pushed == 0) break;
+  }
+}
+
+uint32_t telemetry_ingest_drain(telemetry_ingest_t *ing, telemetry_data_t *data, uint16_t *changed, uint32_t *t_ms) {
+  telemetry_record_t last;
+  uint32_t n = telemetry_queue_drain(&ing->queue, &last);
+  if (n == 0) {
+    if (changed) *changed = 0;
+    return 0;
+  }
+
+  *data = last.data;
+  if (changed) *changed = last.changed;
+  if (t_ms) *t_ms = last.t_ms;
+  ing->stats.drains++;
+  ing->stats.records += n;
+  return n;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void ingest_thread_cb(void *user_data) {
+  telemetry_ingest_t *ing = (telemetry_ingest_t *)user_data;
+  while (!__atomic_load_n(&ing->exit, __ATOMIC_ACQUIRE)) {
+    telemetry_ingest_poll(ing);
+  }
+  __atomic_store_n(&ing->running, false, __ATOMIC_RELEASE);
+}
+
+/* Queue the frame just decoded into `ing->data`. If the UI is behind, the
+ * frame replaces the one waiting for space: it carries all of its values
+ * anyway, only the changed fields and the oldest arrival have to be kept. */
+static void queue_frame(telemetry_ingest_t *ing, uint16_t changed, uint32_t t_read) {
+  telemetry_record_t *rec = &ing->pending;
+  if (ing->has_pending) {
+    /* The waiting record is given up, its fields live on in this one */
+    changed |= rec->changed;
+    ing->stats.merged++;
+    ing->queue.full++;
+  } else {
+    rec->t_ms = ing->t_frame;
+  }
+
+  rec->data = ing->data;
+  rec->changed = changed;
+  rec->id = ing->stats.frames++;
+  ing->has_pending = true;
+
+  /* The next frame starts in this chunk at the earliest */
+  ing->t_frame = t_read;
+
+  flush_pending(ing);
+}
+
+static void flush_pending(telemetry_ingest_t *ing) {
+  if (!ing->has_pending || !telemetry_queue_push(&ing->queue, &ing->pending)) return;
+
+  ing->has_pending = false;
+  if (ing->notify_cb) ing->notify_cb(ing->notify_user_data);
+}
+
+/* Give the reader task the CPU while waiting for it to exit (a tick on FreeRTOS) */
+static void sleep_1ms(void) {
+#if LV_USE_OS == LV_OS_FREERTOS
+  vTaskDelay(1);
+#elif LV_USE_OS == LV_OS_PTHREAD
+  struct timespec ts = {0, 1000000};
+  nanosleep(&ts, NULL);
+#else
+  lv_delay_ms(1);
+#endif
+}
@@ -0,0 +1,67 @@
+/**
+ * @file telemetry_queue.cpp
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "telemetry_queue.h"
+#include <string.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define QUEUE_MASK (TELEMETRY_QUEUE_LEN - 1)
+
+/* The index written by the other side is read with acquire and our own index
+ * is published with release, so a record is complete before it becomes
+ * visible and is not overwritten before it was copied out. */
+#define LOAD_ACQUIRE(p) __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+
+#if (TELEMETRY_QUEUE_LEN & QUEUE_MASK) != 0
+#error "TELEMETRY_QUEUE_LEN must be a power of 2"
+#endif
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void telemetry_queue_init(telemetry_queue_t *q) {
+  memset(q, 0, sizeof(*q));
+}
+
+bool telemetry_queue_push(telemetry_queue_t *q, const telemetry_record_t *rec) {
+  uint32_t head = q->head;
+  if (head - LOAD_ACQUIRE(&q->tail) >= TELEMETRY_QUEUE_LEN) return false;
+
+  q->rec[head & QUEUE_MASK] = *rec;
+  STORE_RELEASE(&q->head, head + 1);
+  return true;
+}
+
+bool telemetry_queue_pop(telemetry_queue_t *q, telemetry_record_t *rec) {
+  uint32_t tail = q->tail;
+  if (LOAD_ACQUIRE(&q->head) == tail) return false;
+
+  *rec = q->rec[tail & QUEUE_MASK];
+  STORE_RELEASE(&q->tail, tail + 1);
+  return true;
+}
+
+uint32_t telemetry_queue_drain(telemetry_queue_t *q, telemetry_record_t *last) {
+  uint32_t tail = q->tail;
+  uint32_t head = LOAD_ACQUIRE(&q->head);
+  if (head == tail) return 0;
+
+  /* Only the newest snapshot is copied, the older ones just add their fields */
+  uint16_t changed = 0;
+  for (uint32_t i = tail; i != head; i++) changed |= q->rec[i & QUEUE_MASK].changed;
+
+  *last = q->rec[(head - 1) & QUEUE_MASK];
+  last->changed = changed;
+  last->t_ms = q->rec[tail & QUEUE_MASK].t_ms;
+  STORE_RELEASE(&q->tail, head);
+  return head - tail;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file telemetry_rec.cpp
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "telemetry_rec.h"
+#include <string.h>
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void rec_write(telemetry_rec_t *rec, const uint8_t *data, size_t len);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void telemetry_rec_start(telemetry_rec_t *rec, telemetry_rec_write_cb_t write_cb, void *user_data) {
+  memset(rec, 0, sizeof(*rec));
+  rec->write_cb = write_cb;
+  rec->user_data = user_data;
+  rec_write(rec, (const uint8_t *)TELEMETRY_REC_MAGIC, TELEMETRY_REC_MAGIC_SIZE);
+}
+
+void telemetry_rec_add(telemetry_rec_t *rec, uint32_t t_ms, const uint8_t *bytes, size_t len) {
+  while (len > 0) {
+    size_t n = len > TELEMETRY_REC_MAX_LEN ? TELEMETRY_REC_MAX_LEN : len;
+
+    uint8_t hdr[TELEMETRY_REC_HEADER_SIZE];
+    hdr[0] = (uint8_t)t_ms;
+    hdr[1] = (uint8_t)(t_ms >> 8);
+    hdr[2] = (uint8_t)(t_ms >> 16);
+    hdr[3] = (uint8_t)(t_ms >> 24);
+    hdr[4] = (uint8_t)n;
+    hdr[5] = (uint8_t)(n >> 8);
+    rec_write(rec, hdr, sizeof(hdr));
+    rec_write(rec, bytes, n);
+
+    rec->records++;
+    rec->bytes += (uint32_t)n;
+    bytes += n;
+    len -= n;
+  }
+}
+
+bool telemetry_rec_is_capture(const uint8_t *buf, size_t len) {
+  return len >= TELEMETRY_REC_MAGIC_SIZE && memcmp(buf, TELEMETRY_REC_MAGIC, TELEMETRY_REC_MAGIC_SIZE) == 0;
+}
+
+bool telemetry_rec_next(const uint8_t *buf, size_t len, size_t *pos, telemetry_rec_entry_t *entry) {
+  size_t p = *pos;
+  if (p + TELEMETRY_REC_HEADER_SIZE > len) return false;
+
+  entry->t_ms = (uint32_t)buf[p] | ((uint32_t)buf[p + 1] << 8) | ((uint32_t)buf[p + 2] << 16) |
+                ((uint32_t)buf[p + 3] << 24);
+  entry->len = (uint16_t)(buf[p + 4] | (buf[p + 5] << 8));
+  p += TELEMETRY_REC_HEADER_SIZE;
+  if (p + entry->len > len) return false;
+
+  entry->data = &buf[p];
+  *pos = p + entry->len;
+  return true;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void rec_write(telemetry_rec_t *rec, const uint8_t *data, size_t len) {
+  if (rec->write_cb == NULL) return;
+  if (rec->write_cb(rec->user_data, data, len) != len) rec->write_errors++;
+}